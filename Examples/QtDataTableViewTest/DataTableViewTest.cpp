@@ -167,6 +167,8 @@ namespace DataTableViewTest
 
     // create our data table model, pass it to our views
     tableModel_ = new simQt::DataTableModel();
+    // let the model drop its table when the table is deleted
+    tableModel_->setDataTableManager(&ds->dataTableManager());
     ui_->DataTableTreeView->setModel(tableModel_);
     ui_->tableViewTest->setModel(tableModel_);
     // setting these causes bad performance with large tables
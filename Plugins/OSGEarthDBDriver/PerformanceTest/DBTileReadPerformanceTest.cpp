@@ -0,0 +1,246 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+/**
+ * Measures tile read throughput of the .db driver's SQLite layer.  Generates a test database with
+ * random tile blobs, then reads every tile from a varying number of threads, comparing a single
+ * shared handle with TsReadDataBuffer() against the per-reader connection pool with TsReadDataBlob().
+ *
+ * USAGE: DBTileReadPerformanceTest [numTiles] [tileBytes]
+ */
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "OpenThreads/Thread"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/Version.h"
+#include "simCore/Time/Utils.h"
+#include "QSError.h"
+#include "QSNodeID96.h"
+#include "SQLiteDataBaseReadUtil.h"
+#include "swapbytes.h"
+
+using namespace simVis_db;
+
+namespace
+{
+
+const char* DB_FILE_NAME = "DBTileReadPerformanceTest.db";
+const char* TABLE_NAME = "default";
+/** Number of times each thread reads its share of the tiles */
+const int NUM_PASSES = 4;
+
+/** Returns the node ID used for the given tile index */
+QSNodeId tileNodeId(int tile)
+{
+  return QSNodeId(static_cast<uint32_t>(tile));
+}
+
+/** Returns the face index used for the given tile index */
+FaceIndexType tileFace(int tile)
+{
+  return static_cast<FaceIndexType>(tile % 6);
+}
+
+/** Creates a database with a single "default" sets table holding numTiles random blobs */
+bool createDatabase(int numTiles, int tileBytes)
+{
+  remove(DB_FILE_NAME);
+  sqlite3* db = NULL;
+  if (sqlite3_open_v2(DB_FILE_NAME, &db, SQLITE_OPEN_READWRITE|SQLITE_OPEN_CREATE, NULL) != SQLITE_OK)
+  {
+    std::cerr << "Unable to create " << DB_FILE_NAME << std::endl;
+    sqlite3_close(db);
+    return false;
+  }
+
+  sqlite3_exec(db, "CREATE TABLE \"default\" (id BLOB PRIMARY KEY, data BLOB);", NULL, NULL, NULL);
+  sqlite3_exec(db, "BEGIN TRANSACTION;", NULL, NULL, NULL);
+  sqlite3_stmt* stmt = NULL;
+  sqlite3_prepare_v2(db, "INSERT INTO \"default\" VALUES (?, ?);", -1, &stmt, NULL);
+
+  std::vector<uint8_t> idBlob(sizeof(FaceIndexType) + QSNodeId().SizeOf());
+  std::vector<uint8_t> data(tileBytes);
+  unsigned int seed = 12345;
+  for (int tile = 0; tile < numTiles; ++tile)
+  {
+    // Incompressible data, similar to JPEG tiles
+    for (size_t k = 0; k < data.size(); ++k)
+    {
+      seed = seed * 1103515245 + 12345;
+      data[k] = static_cast<uint8_t>(seed >> 16);
+    }
+    const FaceIndexType face = tileFace(tile);
+    bewrite(&idBlob[0], &face);
+    tileNodeId(tile).Pack(&idBlob[sizeof(FaceIndexType)]);
+    sqlite3_bind_blob(stmt, 1, &idBlob[0], static_cast<int>(idBlob.size()), SQLITE_TRANSIENT);
+    sqlite3_bind_blob(stmt, 2, &data[0], static_cast<int>(data.size()), SQLITE_TRANSIENT);
+    sqlite3_step(stmt);
+    sqlite3_reset(stmt);
+  }
+  sqlite3_finalize(stmt);
+  sqlite3_exec(db, "COMMIT;", NULL, NULL, NULL);
+  sqlite3_close(db);
+  return true;
+}
+
+/** Reads every numThreads'th tile, starting at firstTile, summing the bytes read */
+class ReadThread : public OpenThreads::Thread
+{
+public:
+  ReadThread(const SQLiteDataBaseReadUtil& dbUtil, sqlite3* sharedDb, SQLiteReadConnectionPool* pool,
+    int firstTile, int numTiles, int numThreads)
+    : dbUtil_(dbUtil),
+      sharedDb_(sharedDb),
+      pool_(pool),
+      firstTile_(firstTile),
+      numTiles_(numTiles),
+      numThreads_(numThreads),
+      checksum_(0),
+      errors_(0)
+  {
+  }
+
+  virtual void run()
+  {
+    TextureDataType* buffer = NULL;
+    uint32_t bufferSize = 0;
+    for (int pass = 0; pass < NUM_PASSES; ++pass)
+    {
+      for (int tile = firstTile_; tile < numTiles_; tile += numThreads_)
+      {
+        if (pool_)
+        {
+          ScopedReadConnection connection(*pool_);
+          const uint8_t* blob = NULL;
+          uint32_t blobSize = 0;
+          if (!connection.get() || dbUtil_.TsReadDataBlob(connection.get()->readStmt, tileFace(tile), tileNodeId(tile), &blob, &blobSize) != QS_IS_OK || blobSize == 0)
+            ++errors_;
+          else
+            checksum_ += blob[0] + blob[blobSize - 1] + blobSize;
+        }
+        else
+        {
+          uint32_t rasterSize = 0;
+          if (dbUtil_.TsReadDataBuffer(sharedDb_, DB_FILE_NAME, TABLE_NAME, tileFace(tile), tileNodeId(tile), &buffer, &bufferSize, &rasterSize, false) != QS_IS_OK || rasterSize == 0)
+            ++errors_;
+          else
+            checksum_ += buffer[0] + buffer[rasterSize - 1] + rasterSize;
+        }
+      }
+    }
+    delete [] buffer;
+  }
+
+  uint64_t checksum() const { return checksum_; }
+  int errors() const { return errors_; }
+
+private:
+  const SQLiteDataBaseReadUtil& dbUtil_;
+  sqlite3* sharedDb_;
+  SQLiteReadConnectionPool* pool_;
+  int firstTile_;
+  int numTiles_;
+  int numThreads_;
+  uint64_t checksum_;
+  int errors_;
+};
+
+/** Reads all tiles with the given number of threads; returns tiles per second, or 0 on error */
+double readTiles(const SQLiteDataBaseReadUtil& dbUtil, sqlite3* sharedDb, SQLiteReadConnectionPool* pool,
+  int numTiles, int numThreads, uint64_t& checksum)
+{
+  std::vector<ReadThread*> threads;
+  for (int k = 0; k < numThreads; ++k)
+    threads.push_back(new ReadThread(dbUtil, sharedDb, pool, k, numTiles, numThreads));
+
+  const double start = simCore::getSystemTime();
+  for (std::vector<ReadThread*>::const_iterator i = threads.begin(); i != threads.end(); ++i)
+    (*i)->start();
+  for (std::vector<ReadThread*>::const_iterator i = threads.begin(); i != threads.end(); ++i)
+    (*i)->join();
+  const double elapsed = simCore::getSystemTime() - start;
+
+  int errors = 0;
+  checksum = 0;
+  for (std::vector<ReadThread*>::const_iterator i = threads.begin(); i != threads.end(); ++i)
+  {
+    errors += (*i)->errors();
+    checksum += (*i)->checksum();
+    delete *i;
+  }
+  if (errors != 0)
+  {
+    std::cerr << errors << " tile reads failed" << std::endl;
+    return 0.0;
+  }
+  return (elapsed > 0.0) ? (static_cast<double>(numTiles) * NUM_PASSES / elapsed) : 0.0;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  simCore::checkVersionThrow();
+  const int numTiles = (argc > 1) ? atoi(argv[1]) : 4000;
+  const int tileBytes = (argc > 2) ? atoi(argv[2]) : 16384;
+  if (numTiles <= 0 || tileBytes <= 0)
+  {
+    std::cerr << "USAGE: DBTileReadPerformanceTest [numTiles] [tileBytes]" << std::endl;
+    return 1;
+  }
+
+  std::cout << "Generating " << numTiles << " tiles of " << tileBytes << " bytes in " << DB_FILE_NAME << std::endl;
+  if (!createDatabase(numTiles, tileBytes))
+    return 1;
+
+  int rv = 0;
+  SQLiteDataBaseReadUtil dbUtil;
+  sqlite3* sharedDb = NULL;
+  if (dbUtil.OpenDataBaseFile(DB_FILE_NAME, &sharedDb, SQLITE_OPEN_READONLY|SQLITE_OPEN_FULLMUTEX) != QS_IS_OK)
+  {
+    std::cerr << "Unable to open " << DB_FILE_NAME << std::endl;
+    return 1;
+  }
+
+  const int maxThreads = simCore::sdkMax(1, OpenThreads::GetNumberOfProcessors());
+  for (int numThreads = 1; numThreads <= maxThreads; numThreads *= 2)
+  {
+    uint64_t sharedChecksum = 0;
+    uint64_t poolChecksum = 0;
+    const double sharedRate = readTiles(dbUtil, sharedDb, NULL, numTiles, numThreads, sharedChecksum);
+    SQLiteReadConnectionPool pool(dbUtil, DB_FILE_NAME, TABLE_NAME);
+    const double poolRate = readTiles(dbUtil, NULL, &pool, numTiles, numThreads, poolChecksum);
+
+    std::cout << numThreads << " thread(s): shared handle " << static_cast<int>(sharedRate) << " tiles/s, "
+      << "connection pool (" << pool.Size() << " connections) " << static_cast<int>(poolRate) << " tiles/s" << std::endl;
+    if (sharedRate == 0.0 || poolRate == 0.0 || sharedChecksum != poolChecksum)
+    {
+      std::cerr << "Tile data mismatch between read methods" << std::endl;
+      rv = 1;
+    }
+  }
+
+  sqlite3_close(sharedDb);
+  remove(DB_FILE_NAME);
+  return rv;
+}
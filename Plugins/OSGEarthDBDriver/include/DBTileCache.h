@@ -0,0 +1,158 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMDIS_PLUGIN_OSGEARTH_DB_TILE_CACHE_H
+#define SIMDIS_PLUGIN_OSGEARTH_DB_TILE_CACHE_H 1
+
+#include <list>
+#include <map>
+#include <string>
+#include "OpenThreads/Mutex"
+#include "osg/Object"
+#include "osg/ref_ptr"
+#include "QSCommonIntTypes.h"
+#include "QSNodeID96.h"
+
+namespace simVis_db
+{
+  /**
+   * Size-bounded, least-recently-used cache of decoded tiles, keyed by QS node.  Thread safe.
+   * Tiles from the same .db file are identical regardless of layer, so caches are shared by
+   * file name through getShared().  Tiles missing from the file are cached as NULL entries, so
+   * that repeated requests for them do not read the file again.
+   */
+  class DBTileCache : public osg::Referenced
+  {
+  public:
+    /** Identifies a decoded tile */
+    struct Key
+    {
+      FaceIndexType face;
+      QSNodeId node;
+      bool heightField;
+
+      Key(FaceIndexType inFace, const QSNodeId& inNode, bool inHeightField)
+        : face(inFace), node(inNode), heightField(inHeightField)
+      {
+      }
+      bool operator<(const Key& rhs) const;
+    };
+
+    /** Counters for tuning the cache size and prefetch */
+    struct Stats
+    {
+      /** Requests served from the cache */
+      unsigned int hits;
+      /** Requests that had to read and decode the tile */
+      unsigned int misses;
+      /** Tiles read by the prefetcher */
+      unsigned int prefetched;
+      /** Prefetched tiles that were later requested */
+      unsigned int prefetchHits;
+      /** Tiles removed to stay within the size limit */
+      unsigned int evictions;
+      /** Requests served from entries recording a tile missing from the file */
+      unsigned int missingHits;
+      /** Number of tiles currently cached */
+      size_t tiles;
+      /** Memory used by cached tiles, in bytes */
+      size_t bytes;
+      /** Total time spent serving hits, in seconds */
+      double hitSeconds;
+      /** Total time spent reading and decoding misses, in seconds */
+      double missSeconds;
+
+      Stats();
+      /** Fraction of requests served from the cache, 0 if none */
+      double hitRate() const;
+    };
+
+    /** Creates a cache holding up to maxBytes of decoded tiles */
+    explicit DBTileCache(size_t maxBytes);
+
+    /**
+     * Returns the cache shared by all sources reading the given file, creating it if needed.  The shared
+     * cache holds up to the largest maxBytes requested by any of its sources.
+     */
+    static osg::ref_ptr<DBTileCache> getShared(const std::string& pathname, size_t maxBytes);
+
+    /**
+     * Looks up a tile and marks it most recently used.  Callers must not modify the tile.
+     * @param key Tile to find
+     * @param tile Set to the cached tile; NULL if the tile is cached as missing from the file
+     * @return True if the tile is cached, including as missing
+     */
+    bool get(const Key& key, osg::ref_ptr<osg::Object>& tile);
+
+    /** Returns true if the tile is cached, including as missing, without affecting its LRU position */
+    bool contains(const Key& key) const;
+
+    /** Adds a decoded tile, evicting the least recently used tiles as needed.  A NULL tile records that the file has no such tile */
+    void insert(const Key& key, osg::Object* tile, bool prefetched);
+
+    /** Raises the memory limit to maxBytes if it is lower */
+    void growLimit(size_t maxBytes);
+
+    /** Records the time taken to serve a request from the cache */
+    void recordHit(double seconds);
+    /** Records the time taken to read and decode a tile that was not cached */
+    void recordMiss(double seconds);
+    /** Records a tile read by the prefetcher */
+    void recordPrefetch();
+
+    /** Returns a snapshot of the counters */
+    Stats stats() const;
+
+  protected:
+    virtual ~DBTileCache();
+
+  private:
+    struct Entry
+    {
+      Key key;
+      osg::ref_ptr<osg::Object> tile;
+      size_t bytes;
+      /** True for a prefetched tile that has not been requested yet */
+      bool prefetched;
+
+      Entry(const Key& inKey, osg::Object* inTile, size_t inBytes, bool inPrefetched)
+        : key(inKey), tile(inTile), bytes(inBytes), prefetched(inPrefetched)
+      {
+      }
+    };
+    typedef std::list<Entry> EntryList;
+
+    /** Returns the approximate memory used by an osg::Image or osg::HeightField, or by a missing tile entry if NULL */
+    static size_t sizeOf_(const osg::Object* tile);
+    /** Removes least recently used entries until within maxBytes_; requires mutex_ */
+    void evict_();
+
+    size_t maxBytes_;
+    mutable OpenThreads::Mutex mutex_;
+    /** Most recently used at the front */
+    EntryList lru_;
+    std::map<Key, EntryList::iterator> index_;
+    Stats stats_;
+  };
+
+} // namespace simVis_db
+
+#endif // SIMDIS_PLUGIN_OSGEARTH_DB_TILE_CACHE_H
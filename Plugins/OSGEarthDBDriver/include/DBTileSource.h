@@ -28,6 +28,7 @@
 #include "simVis/DBOptions.h"
 #include "simVis/osgEarthVersion.h"
 #include "sqlite/sqlite3.h"
+#include "DBTileCache.h"
 #include "SQLiteDataBaseReadUtil.h"
 #include "QSPosXYExtents.h"
 
@@ -46,10 +47,22 @@ namespace simVis_db
     virtual std::string getExtension() const;
     virtual int getPixelsPerTile() const;
 
+    /** Returns the counters of the decoded tile cache; all zero if the cache is disabled */
+    DBTileCache::Stats cacheStats() const;
+
   protected:
       virtual ~DBTileSource();
 
   private:
+      class PrefetchThread;
+
+      /** Serves a tile from the cache, or reads and caches it; returns an osg::Image or osg::HeightField */
+      osg::Object* fetchTile_(const osgEarth::TileKey& key, bool isHeightField);
+      /** Reads and decodes a tile into the cache on behalf of the prefetcher */
+      void prefetchTile_(const osgEarth::TileKey& key, bool isHeightField);
+      /** Queues the children and neighbors of a requested tile for prefetch */
+      void queuePrefetch_(const osgEarth::TileKey& key, bool isHeightField);
+
       bool decodeRaster_(
           int          rasterFormat,
           const char*  inputBuffer,
@@ -57,11 +70,17 @@ namespace simVis_db
           osg::ref_ptr<osg::Image>& out_image);
 
       osg::Image* createImage_(const osgEarth::TileKey& key, bool isHeightField);
+      osg::HeightField* createHeightField_(const osgEarth::TileKey& key);
 
       const simVis::DBOptions options_;
       std::string pathname_;
-      sqlite3* db_;
       SQLiteDataBaseReadUtil dbUtil_;
+      /** Read-only connections shared by the pager threads; NULL until initialized */
+      SQLiteReadConnectionPool* readPool_;
+      /** Decoded tiles, shared with other sources reading the same file; NULL if disabled */
+      osg::ref_ptr<DBTileCache> cache_;
+      /** Reads tiles near recent requests into cache_; NULL if disabled */
+      PrefetchThread* prefetchThread_;
 
       // layer metadata
       /** Defined in RasterCommon.h */
@@ -24,6 +24,8 @@
 #define SQLITE_DATABASE_READ_UTIL_H
 
 #include <string>
+#include <vector>
+#include "OpenThreads/Mutex"
 #include "sqlite/sqlite3.h"
 #include "simCore/Time/TimeClass.h"
 
@@ -148,6 +150,40 @@ namespace simVis_db
                                   uint32_t* currentRasterSize,
                                   bool allowLocalDB,
                                   bool displayErrorMessage=false) const;
+
+    /**
+     * Prepares the statement used by TsReadDataBlob() to read nodes from a sets table.
+     * The statement may be reused for any number of reads; caller is responsible for finalizing it
+     * @param[in] sqlite3Db Pointer to a SQLite database object
+     * @param[in] dataTableName Name of the table to access within the given database
+     * @param[out] stmt Prepared statement
+     * @param[in] displayErrorMessage Determines whether to display error messages to console when failing
+     * @return An error value, mapped to QsErrorType
+     */
+    QsErrorType TsPrepareReadDataStatement(sqlite3* sqlite3Db,
+                                           const std::string& dataTableName,
+                                           sqlite3_stmt** stmt,
+                                           bool displayErrorMessage=false) const;
+
+    /**
+     * Reads a node's data blob without copying it, using a statement from TsPrepareReadDataStatement().
+     * The blob is owned by SQLite and is only valid until the statement is reset; caller is responsible
+     * for calling sqlite3_reset() on the statement once done with the blob.
+     * @param[in] stmt Statement prepared by TsPrepareReadDataStatement()
+     * @param[in] faceIndex Mapping to a face index/orientation, used to create a SQLite idBlob
+     * @param[in] nodeID Used to fill the idBlob
+     * @param[out] blob Pointer to the node's data, or NULL if the node is not in the table
+     * @param[out] blobSize Size (bytes) of the data from the SQLite database
+     * @param[in] displayErrorMessage Determines whether to display error messages to console when failing
+     * @return An error value, mapped to QsErrorType
+     */
+    QsErrorType TsReadDataBlob(sqlite3_stmt* stmt,
+                               const FaceIndexType& faceIndex,
+                               const QSNodeId& nodeID,
+                               const uint8_t** blob,
+                               uint32_t* blobSize,
+                               bool displayErrorMessage=false) const;
+
   protected:
     int sizeOfIdBlob_;
 
@@ -170,6 +206,76 @@ namespace simVis_db
     int tsInsertSetIdTimeValue_;
   };
 
+  //=====================================================================================
+  /** Read-only database handle with a cached statement for reading node data, used by one thread at a time */
+  struct SQLiteReadConnection
+  {
+    sqlite3* db;
+    sqlite3_stmt* readStmt;
+  };
+
+  /**
+   * Pool of read-only connections to a single sets table.  Each concurrent reader acquires its own
+   * connection, so reads do not serialize on a shared handle.  Connections are opened on demand, so
+   * the pool grows to the number of threads reading at once, and are closed when the pool is deleted.
+   */
+  class SQLiteReadConnectionPool
+  {
+  public:
+    SQLiteReadConnectionPool(const SQLiteDataBaseReadUtil& dbUtil,
+                             const std::string& dbFileName,
+                             const std::string& dataTableName);
+    virtual ~SQLiteReadConnectionPool();
+
+    /** Returns an idle connection, opening a new one if all are in use; returns NULL on error.  Pass to Release() when done */
+    SQLiteReadConnection* Acquire();
+
+    /** Resets the connection's statement and returns it to the pool; NULL is ignored */
+    void Release(SQLiteReadConnection* connection);
+
+    /** Returns the number of connections opened by the pool */
+    size_t Size() const;
+
+  private:
+    /** Opens a new connection and prepares its statement; returns NULL on error */
+    SQLiteReadConnection* Open_() const;
+    /** Finalizes the statement and closes the handle of the given connection */
+    void Close_(SQLiteReadConnection* connection) const;
+
+    const SQLiteDataBaseReadUtil& dbUtil_;
+    const std::string dbFileName_;
+    const std::string dataTableName_;
+
+    mutable OpenThreads::Mutex mutex_;
+    std::vector<SQLiteReadConnection*> all_;
+    std::vector<SQLiteReadConnection*> idle_;
+  };
+
+  /** Acquires a connection from the pool on construction and releases it on destruction */
+  class ScopedReadConnection
+  {
+  public:
+    explicit ScopedReadConnection(SQLiteReadConnectionPool& pool)
+      : pool_(pool),
+        connection_(pool.Acquire())
+    {
+    }
+    ~ScopedReadConnection()
+    {
+      pool_.Release(connection_);
+    }
+
+    /** Returns the acquired connection, or NULL if the pool could not provide one */
+    SQLiteReadConnection* get() const
+    {
+      return connection_;
+    }
+
+  private:
+    SQLiteReadConnectionPool& pool_;
+    SQLiteReadConnection* connection_;
+  };
+
 #ifdef USE_SIMDIS_SDK
 } // namespace simVis_db
 #endif
@@ -0,0 +1,213 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include "OpenThreads/ScopedLock"
+#include "osg/Image"
+#include "osg/Shape"
+#include "osg/observer_ptr"
+#include "DBTileCache.h"
+
+using namespace simVis_db;
+
+namespace
+{
+  /** Caches shared between sources reading the same file; entries expire with their last source */
+  typedef std::map<std::string, osg::observer_ptr<DBTileCache> > SharedCacheMap;
+  OpenThreads::Mutex s_sharedMutex;
+  SharedCacheMap s_sharedCaches;
+}
+
+// --------------------------------------------------------------------------
+
+bool DBTileCache::Key::operator<(const Key& rhs) const
+{
+  if (face != rhs.face)
+    return face < rhs.face;
+  if (heightField != rhs.heightField)
+    return heightField < rhs.heightField;
+  return node < rhs.node;
+}
+
+DBTileCache::Stats::Stats()
+  : hits(0),
+    misses(0),
+    prefetched(0),
+    prefetchHits(0),
+    evictions(0),
+    missingHits(0),
+    tiles(0),
+    bytes(0),
+    hitSeconds(0.0),
+    missSeconds(0.0)
+{
+}
+
+double DBTileCache::Stats::hitRate() const
+{
+  const unsigned int requests = hits + misses;
+  return (requests == 0) ? 0.0 : static_cast<double>(hits) / requests;
+}
+
+// --------------------------------------------------------------------------
+
+DBTileCache::DBTileCache(size_t maxBytes)
+  : maxBytes_(maxBytes)
+{
+}
+
+DBTileCache::~DBTileCache()
+{
+}
+
+osg::ref_ptr<DBTileCache> DBTileCache::getShared(const std::string& pathname, size_t maxBytes)
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(s_sharedMutex);
+  osg::ref_ptr<DBTileCache> cache;
+  SharedCacheMap::iterator i = s_sharedCaches.find(pathname);
+  if (i != s_sharedCaches.end())
+    i->second.lock(cache);
+  if (!cache.valid())
+  {
+    cache = new DBTileCache(maxBytes);
+    s_sharedCaches[pathname] = cache.get();
+  }
+  else
+    cache->growLimit(maxBytes);
+
+  // Drop entries for files no longer in use
+  for (i = s_sharedCaches.begin(); i != s_sharedCaches.end();)
+  {
+    if (!i->second.valid())
+      s_sharedCaches.erase(i++);
+    else
+      ++i;
+  }
+  return cache;
+}
+
+bool DBTileCache::get(const Key& key, osg::ref_ptr<osg::Object>& tile)
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  std::map<Key, EntryList::iterator>::const_iterator i = index_.find(key);
+  if (i == index_.end())
+  {
+    tile = NULL;
+    return false;
+  }
+
+  EntryList::iterator entry = i->second;
+  if (entry->prefetched)
+  {
+    entry->prefetched = false;
+    ++stats_.prefetchHits;
+  }
+  if (!entry->tile.valid())
+    ++stats_.missingHits;
+  lru_.splice(lru_.begin(), lru_, entry);
+  tile = entry->tile;
+  return true;
+}
+
+bool DBTileCache::contains(const Key& key) const
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  return index_.find(key) != index_.end();
+}
+
+void DBTileCache::insert(const Key& key, osg::Object* tile, bool prefetched)
+{
+  const size_t bytes = sizeOf_(tile);
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  if (bytes > maxBytes_)
+    return;
+  std::map<Key, EntryList::iterator>::iterator i = index_.find(key);
+  if (i != index_.end())
+  {
+    // Another thread decoded the same tile; keep the newer copy
+    stats_.bytes -= i->second->bytes;
+    lru_.erase(i->second);
+    index_.erase(i);
+  }
+  lru_.push_front(Entry(key, tile, bytes, prefetched));
+  index_[key] = lru_.begin();
+  stats_.bytes += bytes;
+  evict_();
+}
+
+void DBTileCache::growLimit(size_t maxBytes)
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  if (maxBytes > maxBytes_)
+    maxBytes_ = maxBytes;
+}
+
+void DBTileCache::recordHit(double seconds)
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  ++stats_.hits;
+  stats_.hitSeconds += seconds;
+}
+
+void DBTileCache::recordMiss(double seconds)
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  ++stats_.misses;
+  stats_.missSeconds += seconds;
+}
+
+void DBTileCache::recordPrefetch()
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  ++stats_.prefetched;
+}
+
+DBTileCache::Stats DBTileCache::stats() const
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  Stats rv = stats_;
+  rv.tiles = lru_.size();
+  return rv;
+}
+
+size_t DBTileCache::sizeOf_(const osg::Object* tile)
+{
+  // Small fixed overhead per entry, so that many tiny tiles and missing tile entries still count against the limit
+  size_t bytes = sizeof(Entry) + 64;
+  const osg::Image* image = dynamic_cast<const osg::Image*>(tile);
+  if (image)
+    bytes += image->getTotalSizeInBytes();
+  const osg::HeightField* hf = dynamic_cast<const osg::HeightField*>(tile);
+  if (hf)
+    bytes += static_cast<size_t>(hf->getNumColumns()) * hf->getNumRows() * sizeof(float);
+  return bytes;
+}
+
+void DBTileCache::evict_()
+{
+  while (stats_.bytes > maxBytes_ && !lru_.empty())
+  {
+    const Entry& oldest = lru_.back();
+    stats_.bytes -= oldest.bytes;
+    index_.erase(oldest.key);
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+}
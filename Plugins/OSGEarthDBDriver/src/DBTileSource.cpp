@@ -20,7 +20,17 @@
  *
  */
 
+#include <deque>
+#include <istream>
+#include <memory>
+#include <streambuf>
+#include <utility>
+#include "OpenThreads/Condition"
+#include "OpenThreads/Mutex"
+#include "OpenThreads/ScopedLock"
+#include "OpenThreads/Thread"
 #include "simCore/Calc/Math.h"
+#include "simCore/Time/Utils.h"
 #include "osg/ValueObject"
 #include "osgEarth/Registry"
 #include "osgEarth/FileUtils"
@@ -115,21 +125,122 @@ namespace
     return true;
   }
 
+  /** Read-only stream buffer over memory owned by someone else, used to decode blobs in place without copying them */
+  class MemoryStreamBuffer : public std::streambuf
+  {
+  public:
+    MemoryStreamBuffer(const char* data, size_t size)
+    {
+      char* begin = const_cast<char*>(data);
+      setg(begin, begin, begin + size);
+    }
+
+  protected:
+    virtual std::streampos seekoff(std::streamoff off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+    {
+      if ((which & std::ios_base::in) == 0)
+        return std::streampos(std::streamoff(-1));
+      std::streamoff base = 0;
+      if (dir == std::ios_base::cur)
+        base = gptr() - eback();
+      else if (dir == std::ios_base::end)
+        base = egptr() - eback();
+      const std::streamoff pos = base + off;
+      if (pos < 0 || pos > egptr() - eback())
+        return std::streampos(std::streamoff(-1));
+      setg(eback(), eback() + pos, egptr());
+      return std::streampos(pos);
+    }
+
+    virtual std::streampos seekpos(std::streampos pos, std::ios_base::openmode which)
+    {
+      return seekoff(std::streamoff(pos), std::ios_base::beg, which);
+    }
+  };
+
   bool decompressZLIB(const char* input, int inputLen, std::string& output)
   {
     osgDB::BaseCompressor* comp = osgDB::Registry::instance()->getObjectWrapperManager()->findCompressor("zlib");
-    std::string inString(input, inputLen);
-    std::istringstream inStream(inString);
+    if (!comp)
+      return false;
+    MemoryStreamBuffer inBuffer(input, inputLen);
+    std::istream inStream(&inBuffer);
     return comp->decompress(inStream, output);
   }
 }
 
 // --------------------------------------------------------------------------
 
+/** Reads tiles near recent requests into the tile cache, most recently queued first */
+class DBTileSource::PrefetchThread : public OpenThreads::Thread
+{
+public:
+  explicit PrefetchThread(DBTileSource& source)
+    : source_(source),
+      done_(false)
+  {
+  }
+
+  /** Queues a tile for prefetch, discarding the oldest queued tile if the queue is full */
+  void push(const TileKey& key, bool isHeightField)
+  {
+    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+      queue_.push_back(std::make_pair(key, isHeightField));
+      // Requests move on quickly as the view changes, so stale prefetches are not worth keeping
+      if (queue_.size() > MAX_QUEUE_SIZE)
+        queue_.pop_front();
+    }
+    condition_.signal();
+  }
+
+  /** Discards queued tiles and waits for the thread to exit */
+  void stop()
+  {
+    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+      done_ = true;
+      queue_.clear();
+    }
+    condition_.broadcast();
+    join();
+  }
+
+  virtual void run()
+  {
+    while (true)
+    {
+      std::pair<TileKey, bool> request;
+      {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+        while (!done_ && queue_.empty())
+          condition_.wait(&mutex_);
+        if (done_)
+          return;
+        request = queue_.back();
+        queue_.pop_back();
+      }
+      source_.prefetchTile_(request.first, request.second);
+    }
+  }
+
+private:
+  static const size_t MAX_QUEUE_SIZE = 64;
+
+  DBTileSource& source_;
+  OpenThreads::Mutex mutex_;
+  OpenThreads::Condition condition_;
+  std::deque<std::pair<TileKey, bool> > queue_;
+  bool done_;
+};
+
+// --------------------------------------------------------------------------
+
 DBTileSource::DBTileSource(const TileSourceOptions& options)
   : osgEarth::TileSource(options),
     options_(options),
-    db_(NULL),
+    readPool_(NULL),
+    prefetchThread_(NULL),
     rasterFormat_(SPLIT_UNKNOWN),
     pixelLength_(128),
     shallowLevel_(0),
@@ -145,10 +256,20 @@ DBTileSource::DBTileSource(const TileSourceOptions& options)
 
 DBTileSource::~DBTileSource()
 {
-  if (db_)
+  if (prefetchThread_)
   {
-    sqlite3_close(db_);
+    prefetchThread_->stop();
+    delete prefetchThread_;
   }
+  if (cache_.valid())
+  {
+    const DBTileCache::Stats stats = cache_->stats();
+    OE_INFO << LC << "Tile cache for " << pathname_ << ": "
+      << stats.hits << " hits (" << stats.missingHits << " for missing tiles), " << stats.misses << " misses (" << static_cast<int>(stats.hitRate() * 100.0) << "%), "
+      << stats.prefetchHits << " of " << stats.prefetched << " prefetched tiles used, "
+      << stats.evictions << " evictions, " << stats.tiles << " tiles in " << stats.bytes << " bytes" << std::endl;
+  }
+  delete readPool_;
 }
 
 Status DBTileSource::initialize(const osgDB::Options* dbOptions)
@@ -157,15 +278,18 @@ Status DBTileSource::initialize(const osgDB::Options* dbOptions)
   {
     pathname_ = osgDB::findDataFile(options_.url()->full(), dbOptions);
 
-    if (dbUtil_.OpenDataBaseFile(pathname_, &db_, SQLITE_OPEN_READONLY | SQLITE_OPEN_FULLMUTEX) != QS_IS_OK)
+    // Metadata is read once on a temporary handle; tiles are read through readPool_
+    sqlite3* db = NULL;
+    if (dbUtil_.OpenDataBaseFile(pathname_, &db, SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX) != QS_IS_OK)
     {
-      db_ = NULL;
+      if (db)
+        sqlite3_close(db);
       return Status::Error(Stringify() << "Failed to open DB file at " << options_.url()->full());
     }
     else
     {
       QsErrorType err = dbUtil_.TsGetSetFromListOfSetsTable(
-        db_,
+        db,
         "default",
         rasterFormat_,
         pixelLength_,
@@ -184,12 +308,19 @@ Status DBTileSource::initialize(const osgDB::Options* dbOptions)
         deepLevel_ = simCore::sdkMin(deepLevel_, static_cast<int>(options_.deepestLevel().get()));
       }
 
+      sqlite3_close(db);
       if (err != QS_IS_OK)
-      {
-        sqlite3_close(db_);
-        db_ = NULL;
         return Status::Error(Stringify() << "Failed to read metadata for " << pathname_);
-      }
+
+      // Open the first read connection now, to fail early on a missing or malformed data table
+      std::unique_ptr<SQLiteReadConnectionPool> pool(new SQLiteReadConnectionPool(dbUtil_, pathname_, "default"));
+      SQLiteReadConnection* connection = pool->Acquire();
+      if (!connection)
+        return Status::Error(Stringify() << "Failed to prepare tile reads for " << pathname_);
+      pool->Release(connection);
+      delete readPool_;
+      readPool_ = pool.release();
+
       // Set up as a unified cube:
       Profile* profile = new osgEarth::UnifiedCubeProfile();
       // DB are expected to be wgs84, which Cube defaults to
@@ -244,6 +375,19 @@ Status DBTileSource::initialize(const osgDB::Options* dbOptions)
       jpgReader_ = osgDB::Registry::instance()->getReaderWriterForMimeType("image/jpeg");
       tifReader_ = osgDB::Registry::instance()->getReaderWriterForMimeType("image/tiff");
       rgbReader_ = osgDB::Registry::instance()->getReaderWriterForMimeType("image/x-rgb");
+
+      // Decoded tiles are shared with other layers on the same file; prefetch only helps if there is a cache to fill
+      const unsigned int cacheMegabytes = options_.tileCacheSize().get();
+      if (cacheMegabytes > 0)
+      {
+        cache_ = DBTileCache::getShared(pathname_, static_cast<size_t>(cacheMegabytes) * 1024 * 1024);
+        if (options_.prefetch().get() && !prefetchThread_)
+        {
+          prefetchThread_ = new PrefetchThread(*this);
+          prefetchThread_->setSchedulePriority(OpenThreads::Thread::THREAD_PRIORITY_LOW);
+          prefetchThread_->start();
+        }
+      }
     }
   }
 
@@ -261,12 +405,107 @@ int DBTileSource::getPixelsPerTile() const
 
 osg::Image* DBTileSource::createImage(const TileKey& key, ProgressCallback* progress)
 {
-  return createImage_(key, false);
+  return static_cast<osg::Image*>(fetchTile_(key, false));
 }
 
 osg::HeightField* DBTileSource::createHeightField(const TileKey& key, ProgressCallback* progress)
 {
-  if (!db_) return NULL;
+  return static_cast<osg::HeightField*>(fetchTile_(key, true));
+}
+
+DBTileCache::Stats DBTileSource::cacheStats() const
+{
+  return cache_.valid() ? cache_->stats() : DBTileCache::Stats();
+}
+
+osg::Object* DBTileSource::fetchTile_(const TileKey& key, bool isHeightField)
+{
+  if (!readPool_)
+    return NULL;
+  if (!cache_.valid())
+  {
+    if (isHeightField)
+      return createHeightField_(key);
+    return createImage_(key, false);
+  }
+
+  const double startTime = simCore::getSystemTime();
+  FaceIndexType faceId;
+  QSNodeId      nodeId;
+  osg::Vec2d    tileMin;
+  osg::Vec2d    tileMax;
+  convertTileKeyToQsKey(key, faceId, nodeId, tileMin, tileMax);
+  const DBTileCache::Key cacheKey(faceId, nodeId, isHeightField);
+
+  if (prefetchThread_)
+    queuePrefetch_(key, isHeightField);
+
+  // The engine may modify the tiles it receives, so the cache only ever hands out copies
+  osg::ref_ptr<osg::Object> cached;
+  if (cache_->get(cacheKey, cached))
+  {
+    // A NULL entry records a tile missing from the file
+    osg::Object* copy = cached.valid() ? cached->clone(osg::CopyOp::DEEP_COPY_ALL) : NULL;
+    cache_->recordHit(simCore::getSystemTime() - startTime);
+    return copy;
+  }
+
+  osg::ref_ptr<osg::Object> tile;
+  if (isHeightField)
+    tile = createHeightField_(key);
+  else
+    tile = createImage_(key, false);
+  cache_->insert(cacheKey, tile.valid() ? tile->clone(osg::CopyOp::DEEP_COPY_ALL) : NULL, false);
+  cache_->recordMiss(simCore::getSystemTime() - startTime);
+  return tile.release();
+}
+
+void DBTileSource::queuePrefetch_(const TileKey& key, bool isHeightField)
+{
+  // Neighbors are queued first so that children, the likeliest next requests as the view zooms in, are read first
+  const TileKey neighbors[4] = {
+    key.createNeighborKey(1, 0),
+    key.createNeighborKey(-1, 0),
+    key.createNeighborKey(0, 1),
+    key.createNeighborKey(0, -1)
+  };
+  for (unsigned int k = 0; k < 4; ++k)
+  {
+    if (neighbors[k].valid())
+      prefetchThread_->push(neighbors[k], isHeightField);
+  }
+
+  if (key.getLevelOfDetail() >= static_cast<unsigned int>(deepLevel_))
+    return;
+  for (unsigned int quadrant = 0; quadrant < 4; ++quadrant)
+    prefetchThread_->push(key.createChildKey(quadrant), isHeightField);
+}
+
+void DBTileSource::prefetchTile_(const TileKey& key, bool isHeightField)
+{
+  FaceIndexType faceId;
+  QSNodeId      nodeId;
+  osg::Vec2d    tileMin;
+  osg::Vec2d    tileMax;
+  convertTileKeyToQsKey(key, faceId, nodeId, tileMin, tileMax);
+  const DBTileCache::Key cacheKey(faceId, nodeId, isHeightField);
+  if (cache_->contains(cacheKey))
+    return;
+
+  osg::ref_ptr<osg::Object> tile;
+  if (isHeightField)
+    tile = createHeightField_(key);
+  else
+    tile = createImage_(key, false);
+  // Missing tiles are cached too, so that requests for them do not read the file again
+  cache_->insert(cacheKey, tile.get(), tile.valid());
+  if (tile.valid())
+    cache_->recordPrefetch();
+}
+
+osg::HeightField* DBTileSource::createHeightField_(const TileKey& key)
+{
+  if (!readPool_) return NULL;
 
   osg::ref_ptr<osg::HeightField> result;
 
@@ -284,21 +523,22 @@ osg::HeightField* DBTileSource::createHeightField(const TileKey& key, ProgressCa
     return NULL;
   }
 
-  // Query the database
-  TextureDataType* buf = NULL;
-  uint32_t bufSize =0;
+  // Query the database; the blob belongs to the connection's statement, so the connection is held through decode
+  ScopedReadConnection connection(*readPool_);
+  if (!connection.get())
+  {
+    OE_WARN << "Failed to open a read connection for " << key.str() << std::endl;
+    return NULL;
+  }
+  const uint8_t* buf = NULL;
   uint32_t currentRasterSize =0;
 
-  QsErrorType err = dbUtil_.TsReadDataBuffer(
-    db_,
-    pathname_,
-    "default",
+  QsErrorType err = dbUtil_.TsReadDataBlob(
+    connection.get()->readStmt,
     faceId,
     nodeId,
     &buf,
-    &bufSize,
-    &currentRasterSize,
-    false);             // AllowLocalDB: no, we created it ourselves
+    &currentRasterSize);
 
   if (err == QS_IS_OK)
   {
@@ -406,13 +646,12 @@ osg::HeightField* DBTileSource::createHeightField(const TileKey& key, ProgressCa
     OE_WARN << "Failed to read heightfield from " << key.str() << std::endl;
   }
 
-  delete [] buf;
   return result.release();
 }
 
 osg::Image* DBTileSource::createImage_(const TileKey& key, bool isHeightField)
 {
-  if (!db_)
+  if (!readPool_)
     return NULL;
 
   osg::ref_ptr<osg::Image> result;
@@ -437,21 +676,23 @@ osg::Image* DBTileSource::createImage_(const TileKey& key, bool isHeightField)
     return NULL;
   }
 
-  // Query the database
-  TextureDataType* buf = NULL;
-  uint32_t bufSize =0;
+  // Query the database; the blob belongs to the connection's statement, so the connection is held through decode
+  ScopedReadConnection connection(*readPool_);
+  if (!connection.get())
+  {
+    OE_WARN << "Failed to open a read connection for " << key.str() << std::endl;
+    return NULL;
+  }
+  const uint8_t* buf = NULL;
   uint32_t currentRasterSize =0;
 
-  QsErrorType err = dbUtil_.TsReadDataBuffer(
-    db_,
-    pathname_,
-    "default",
+  QsErrorType err = dbUtil_.TsReadDataBlob(
+    connection.get()->readStmt,
     faceId,
     nodeId,
     &buf,
-    &bufSize,
     &currentRasterSize,
-    false, true);             // AllowLocalDB: no, we created it ourselves
+    true);
 
   if (err == QS_IS_OK)
   {
@@ -541,7 +782,6 @@ osg::Image* DBTileSource::createImage_(const TileKey& key, bool isHeightField)
     OE_WARN << "Failed to read image from " << key.str() << std::endl;
   }
 
-  delete [] buf;
   return result.release();
 }
 
@@ -592,8 +832,8 @@ void makeImage(int size, GLenum internalFormat, GLenum pixelFormat, GLenum type,
 // Uses one of OSG's native ReaderWriter's to read image data from a buffer.
 static bool readNativeImage(osgDB::ReaderWriter* reader, const char* inBuf, int inBufLen, osg::ref_ptr<osg::Image>& outImage)
 {
-  std::string inString(inBuf, inBufLen);
-  std::istringstream inStream(inString);
+  MemoryStreamBuffer inBuffer(inBuf, inBufLen);
+  std::istream inStream(&inBuffer);
   osgDB::ReaderWriter::ReadResult result = reader->readImage(inStream);
   outImage = result.getImage();
   if (result.error() || !outImage.valid())
@@ -225,46 +225,22 @@ QsErrorType SQLiteDataBaseReadUtil::TsReadDataBuffer(sqlite3* sqlite3Db,
       return tmpReturnValue;
   }
 
-  string sqlCommand;
-  sqlCommand = textureSetSelectFileCommand1_;
-  sqlCommand.append(dataTableName);
-  sqlCommand.append(textureSetSelectFileCommand2_);
-
   // prepares the statement
   sqlite3_stmt* stmt = 0;
-  returnValue = sqlite3_prepare_v2(sqlite3Db, sqlCommand.c_str(), static_cast<int>(sqlCommand.length()), &stmt, NULL);
-  if (returnValue != SQLITE_OK)
+  tmpReturnValue = TsPrepareReadDataStatement(sqlite3Db, dataTableName, &stmt, displayErrorMessage);
+  if (tmpReturnValue != QS_IS_OK)
   {
-    if (displayErrorMessage && (returnValue != SQLITE_BUSY && returnValue != SQLITE_LOCKED))
-    {
-      cerr << "TsReadDataBuffer sqlite3_prepare_v2 Error(" << returnValue << "): " << dbFileName << "\n" << printExtendedErrorMessage(sqlite3Db);
-    }
-    if (stmt != NULL) sqlite3_finalize(stmt);
+    if (displayErrorMessage && tmpReturnValue != QS_IS_BUSY)
+      cerr << "TsReadDataBuffer prepare Error: " << dbFileName << "\n";
     if (localDb) sqlite3_close(sqlite3Db);
-    if ((returnValue == SQLITE_BUSY) ||
-       (returnValue == SQLITE_LOCKED))
-      return QS_IS_BUSY;
-    return QS_IS_PREPARE_ERROR;
-  }
-
-  // binds id
-  uint8_t* idBlob = new uint8_t[sizeOfIdBlob_];
-  bewrite(idBlob, &faceIndex);
-  nodeID.Pack(idBlob+sizeof(FaceIndexType));
-  returnValue = sqlite3_bind_blob(stmt, 1, idBlob, sizeOfIdBlob_, SQLITE_TRANSIENT);
-  if (returnValue != SQLITE_OK && displayErrorMessage)
-  {
-    cerr << "TsReadDataBuffer sqlite3_bind_blob Error(" << returnValue << "): " << dbFileName << "\n" << printExtendedErrorMessage(sqlite3Db);
+    return tmpReturnValue;
   }
-  delete [] idBlob;
 
-  // executes the statement
-  returnValue = sqlite3_step(stmt);
-  QsErrorType otherReturnValue = QS_IS_UNABLE_TO_READ_DATA_BUFFER;
-  if ((returnValue == SQLITE_ROW) || (returnValue == SQLITE_DONE))
+  // reads the data and copies it out before the statement is finalized
+  const uint8_t* blob = NULL;
+  QsErrorType otherReturnValue = TsReadDataBlob(stmt, faceIndex, nodeID, &blob, currentRasterSize, displayErrorMessage);
+  if (otherReturnValue == QS_IS_OK)
   {
-    // gets the data
-    *currentRasterSize = sqlite3_column_bytes(stmt, tsInsertFileIdData_ - 1);
     if ((*currentRasterSize > 0) && (*currentRasterSize <= static_cast<uint32_t>(gMaxBufferSize)))
     {
       if (*currentRasterSize > (*bufferSize))
@@ -274,25 +250,15 @@ QsErrorType SQLiteDataBaseReadUtil::TsReadDataBuffer(sqlite3* sqlite3Db,
         *buffer = new uint8_t[*currentRasterSize];
         *bufferSize = (*currentRasterSize);
       }
-      memcpy(*buffer, (const uint8_t*)sqlite3_column_blob(stmt, tsInsertFileIdData_-1), *currentRasterSize);
+      memcpy(*buffer, blob, *currentRasterSize);
     }
-    otherReturnValue = QS_IS_OK;
-  }
-  else if ((returnValue == SQLITE_BUSY) || (returnValue == SQLITE_LOCKED))
-  {
-    otherReturnValue = QS_IS_BUSY;
   }
-  else
+  else if (displayErrorMessage && otherReturnValue != QS_IS_BUSY)
   {
-    if (displayErrorMessage)
-    {
-      cerr << "TsReadDataBuffer sqlite3_step Error(" << returnValue << "): " << dbFileName << "\n";
-      cerr << "not done (" << nodeID.FormatAsHex().c_str() << ") " << printExtendedErrorMessage(sqlite3Db);
-    }
-    otherReturnValue = QS_IS_UNABLE_TO_READ_DATA_BUFFER;
+    cerr << "TsReadDataBuffer read Error: " << dbFileName << "\n";
   }
 
-  if (stmt != NULL) sqlite3_finalize(stmt);
+  sqlite3_finalize(stmt);
   if (localDb)
   {
     returnValue = sqlite3_close(sqlite3Db);
@@ -304,6 +270,98 @@ QsErrorType SQLiteDataBaseReadUtil::TsReadDataBuffer(sqlite3* sqlite3Db,
   return otherReturnValue;
 }
 
+//-------------------------------------------------------------------------------------
+QsErrorType SQLiteDataBaseReadUtil::TsPrepareReadDataStatement(sqlite3* sqlite3Db,
+                                                               const string& dataTableName,
+                                                               sqlite3_stmt** stmt,
+                                                               bool displayErrorMessage) const
+{
+#ifdef DATABASE_UTIL_FUNCTION_ENTRY_DEBUG
+  cerr << "DBUTIL FUNCTION TsPrepareReadDataStatement  " << __LINE__ << "\n";
+#endif
+  if (stmt == NULL)
+    return QS_IS_UNEXPECTED_NULL;
+  *stmt = NULL;
+  if (sqlite3Db == NULL)
+    return QS_IS_DB_NOT_INITIALIZED;
+  if (dataTableName.empty())
+    return QS_IS_EMPTY_TABLE_NAME;
+
+  string sqlCommand;
+  sqlCommand = textureSetSelectFileCommand1_;
+  sqlCommand.append(dataTableName);
+  sqlCommand.append(textureSetSelectFileCommand2_);
+
+  const int returnValue = sqlite3_prepare_v2(sqlite3Db, sqlCommand.c_str(), static_cast<int>(sqlCommand.length()), stmt, NULL);
+  if (returnValue == SQLITE_OK)
+    return QS_IS_OK;
+
+  if (displayErrorMessage && (returnValue != SQLITE_BUSY && returnValue != SQLITE_LOCKED))
+  {
+    cerr << "TsPrepareReadDataStatement sqlite3_prepare_v2 Error(" << returnValue << "): " << dataTableName << "\n" << printExtendedErrorMessage(sqlite3Db);
+  }
+  if (*stmt != NULL)
+  {
+    sqlite3_finalize(*stmt);
+    *stmt = NULL;
+  }
+  if ((returnValue == SQLITE_BUSY) ||
+     (returnValue == SQLITE_LOCKED))
+    return QS_IS_BUSY;
+  return QS_IS_PREPARE_ERROR;
+}
+
+//-------------------------------------------------------------------------------------
+QsErrorType SQLiteDataBaseReadUtil::TsReadDataBlob(sqlite3_stmt* stmt,
+                                                   const FaceIndexType& faceIndex,
+                                                   const QSNodeId& nodeID,
+                                                   const uint8_t** blob,
+                                                   uint32_t* blobSize,
+                                                   bool displayErrorMessage) const
+{
+#ifdef DATABASE_UTIL_FUNCTION_ENTRY_DEBUG
+  cerr << "DBUTIL FUNCTION TsReadDataBlob  " << __LINE__ << "\n";
+#endif
+  if ((stmt == NULL) || (blob == NULL) || (blobSize == NULL))
+    return QS_IS_UNEXPECTED_NULL;
+  *blob = NULL;
+  *blobSize = 0;
+
+  // binds id; the id is small enough to pack on the stack, and SQLite copies it
+  uint8_t idBlob[sizeof(FaceIndexType) + 2 * sizeof(uint64_t)];
+  if (sizeOfIdBlob_ > static_cast<int>(sizeof(idBlob)))
+    return QS_IS_UNABLE_TO_READ_DATA_BUFFER;
+  bewrite(idBlob, &faceIndex);
+  nodeID.Pack(idBlob+sizeof(FaceIndexType));
+  sqlite3* sqlite3Db = sqlite3_db_handle(stmt);
+  int returnValue = sqlite3_bind_blob(stmt, 1, idBlob, sizeOfIdBlob_, SQLITE_TRANSIENT);
+  if (returnValue != SQLITE_OK && displayErrorMessage)
+  {
+    cerr << "TsReadDataBlob sqlite3_bind_blob Error(" << returnValue << ")\n" << printExtendedErrorMessage(sqlite3Db);
+  }
+
+  // executes the statement
+  returnValue = sqlite3_step(stmt);
+  if (returnValue == SQLITE_ROW)
+  {
+    // column_blob must be called before column_bytes to avoid a type conversion
+    *blob = static_cast<const uint8_t*>(sqlite3_column_blob(stmt, tsInsertFileIdData_ - 1));
+    *blobSize = static_cast<uint32_t>(sqlite3_column_bytes(stmt, tsInsertFileIdData_ - 1));
+    return QS_IS_OK;
+  }
+  if (returnValue == SQLITE_DONE)
+    return QS_IS_OK;
+  if ((returnValue == SQLITE_BUSY) || (returnValue == SQLITE_LOCKED))
+    return QS_IS_BUSY;
+
+  if (displayErrorMessage)
+  {
+    cerr << "TsReadDataBlob sqlite3_step Error(" << returnValue << ")\n";
+    cerr << "not done (" << nodeID.FormatAsHex().c_str() << ") " << printExtendedErrorMessage(sqlite3Db);
+  }
+  return QS_IS_UNABLE_TO_READ_DATA_BUFFER;
+}
+
 //-------------------------------------------------------------------------------------
 QsErrorType SQLiteDataBaseReadUtil::TsGetSetFromListOfSetsTable(sqlite3* sqlite3Db,
                                                                 const std::string& tableName,
@@ -402,3 +460,96 @@ QsErrorType SQLiteDataBaseReadUtil::TsGetSetFromListOfSetsTable(sqlite3* sqlite3
   return otherReturnValue;
 }
 
+
+//=====================================================================================
+SQLiteReadConnectionPool::SQLiteReadConnectionPool(const SQLiteDataBaseReadUtil& dbUtil,
+                                                   const std::string& dbFileName,
+                                                   const std::string& dataTableName)
+  : dbUtil_(dbUtil),
+    dbFileName_(dbFileName),
+    dataTableName_(dataTableName)
+{
+}
+
+//-------------------------------------------------------------------------------------
+SQLiteReadConnectionPool::~SQLiteReadConnectionPool()
+{
+  for (std::vector<SQLiteReadConnection*>::const_iterator iter = all_.begin(); iter != all_.end(); ++iter)
+    Close_(*iter);
+}
+
+//-------------------------------------------------------------------------------------
+SQLiteReadConnection* SQLiteReadConnectionPool::Acquire()
+{
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    if (!idle_.empty())
+    {
+      SQLiteReadConnection* connection = idle_.back();
+      idle_.pop_back();
+      return connection;
+    }
+  }
+
+  // Open outside the lock so other readers are not blocked on file I/O
+  SQLiteReadConnection* connection = Open_();
+  if (connection != NULL)
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    all_.push_back(connection);
+  }
+  return connection;
+}
+
+//-------------------------------------------------------------------------------------
+void SQLiteReadConnectionPool::Release(SQLiteReadConnection* connection)
+{
+  if (connection == NULL)
+    return;
+  // Resetting releases the read lock held by the statement and invalidates any blob pointer
+  sqlite3_reset(connection->readStmt);
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  idle_.push_back(connection);
+}
+
+//-------------------------------------------------------------------------------------
+size_t SQLiteReadConnectionPool::Size() const
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  return all_.size();
+}
+
+//-------------------------------------------------------------------------------------
+SQLiteReadConnection* SQLiteReadConnectionPool::Open_() const
+{
+  // Each handle is only used by one thread at a time, so SQLite's own connection mutex is not needed
+  sqlite3* db = NULL;
+  if (dbUtil_.OpenDataBaseFile(dbFileName_, &db, SQLITE_OPEN_READONLY|SQLITE_OPEN_NOMUTEX) != QS_IS_OK)
+  {
+    if (db != NULL)
+      sqlite3_close(db);
+    return NULL;
+  }
+
+  sqlite3_stmt* stmt = NULL;
+  if (dbUtil_.TsPrepareReadDataStatement(db, dataTableName_, &stmt, true) != QS_IS_OK)
+  {
+    sqlite3_close(db);
+    return NULL;
+  }
+
+  SQLiteReadConnection* connection = new SQLiteReadConnection;
+  connection->db = db;
+  connection->readStmt = stmt;
+  return connection;
+}
+
+//-------------------------------------------------------------------------------------
+void SQLiteReadConnectionPool::Close_(SQLiteReadConnection* connection) const
+{
+  sqlite3_finalize(connection->readStmt);
+  const int errorCode = sqlite3_close(connection->db);
+  if (errorCode != SQLITE_OK)
+    cerr << "sqlite3_close: " << printExtendedErrorMessage(connection->db);
+  delete connection;
+}
@@ -30,6 +30,7 @@
 #include "simCore/Calc/DatumConvert.h"
 #include "simCore/Calc/Geometry.h"
 #include "simCore/Calc/GogToGeoFence.h"
+#include "simCore/Calc/GridIndex.h"
 #include "simCore/Calc/Interpolation.h"
 #include "simCore/Calc/MagneticVariance.h"
 #include "simCore/Calc/Math.h"
@@ -63,6 +64,7 @@
 #include "simCore/String/Constants.h"
 #include "simCore/String/FilePatterns.h"
 #include "simCore/String/Format.h"
+#include "simCore/String/StringView.h"
 #include "simCore/String/TextFormatter.h"
 #include "simCore/String/TextReplacer.h"
 #include "simCore/String/Tokenizer.h"
@@ -0,0 +1,215 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <cmath>
+#include "simCore/Calc/GridIndex.h"
+
+namespace simCore
+{
+
+/** Limits cell count relative to point count, bounding memory for sparse or widely spread points */
+static const size_t MAX_CELLS_PER_POINT = 4;
+
+GridIndex::GridIndex(double cellSize)
+  : cellSize_(cellSize > 0.0 ? cellSize : 1.0),
+    builtCellSize_(cellSize_),
+    minX_(0.0),
+    minY_(0.0),
+    columns_(0),
+    rows_(0)
+{
+}
+
+GridIndex::~GridIndex()
+{
+}
+
+void GridIndex::setCellSize(double cellSize)
+{
+  if (cellSize > 0.0)
+    cellSize_ = cellSize;
+}
+
+double GridIndex::cellSize() const
+{
+  return cellSize_;
+}
+
+void GridIndex::clear()
+{
+  inserted_.clear();
+  points_.clear();
+  cellStart_.clear();
+  columns_ = 0;
+  rows_ = 0;
+}
+
+void GridIndex::reserve(size_t numPoints)
+{
+  inserted_.reserve(numPoints);
+}
+
+void GridIndex::insert(double x, double y, size_t item)
+{
+  if (!std::isfinite(x) || !std::isfinite(y))
+    return;
+  Point point;
+  point.x = x;
+  point.y = y;
+  point.item = item;
+  inserted_.push_back(point);
+}
+
+size_t GridIndex::size() const
+{
+  return inserted_.size();
+}
+
+bool GridIndex::empty() const
+{
+  return inserted_.empty();
+}
+
+size_t GridIndex::cell_(double value, double minValue, size_t numCells) const
+{
+  const double cell = floor((value - minValue) / builtCellSize_);
+  if (!(cell > 0.0))
+    return 0;
+  if (cell >= numCells - 1)
+    return numCells - 1;
+  return static_cast<size_t>(cell);
+}
+
+void GridIndex::build()
+{
+  points_.clear();
+  cellStart_.clear();
+  columns_ = 0;
+  rows_ = 0;
+  if (inserted_.empty())
+    return;
+
+  // Bound the grid by the points
+  double maxX = inserted_.front().x;
+  double maxY = inserted_.front().y;
+  minX_ = maxX;
+  minY_ = maxY;
+  for (std::vector<Point>::const_iterator i = inserted_.begin(); i != inserted_.end(); ++i)
+  {
+    minX_ = std::min(minX_, i->x);
+    minY_ = std::min(minY_, i->y);
+    maxX = std::max(maxX, i->x);
+    maxY = std::max(maxY, i->y);
+  }
+
+  // Grow the cells until the grid is no larger than a small multiple of the point count.  Dividing
+  // before subtracting keeps the cell counts finite even when the extent itself overflows a double.
+  const double maxCells = static_cast<double>(MAX_CELLS_PER_POINT * inserted_.size());
+  builtCellSize_ = cellSize_;
+  double columns = floor(maxX / builtCellSize_ - minX_ / builtCellSize_) + 1.0;
+  double rows = floor(maxY / builtCellSize_ - minY_ / builtCellSize_) + 1.0;
+  while (columns * rows > maxCells)
+  {
+    builtCellSize_ *= 2.0;
+    columns = floor(maxX / builtCellSize_ - minX_ / builtCellSize_) + 1.0;
+    rows = floor(maxY / builtCellSize_ - minY_ / builtCellSize_) + 1.0;
+  }
+  columns_ = static_cast<size_t>(columns);
+  rows_ = static_cast<size_t>(rows);
+
+  // Counting sort of the points into cells
+  std::vector<size_t> pointCells(inserted_.size());
+  cellStart_.assign(columns_ * rows_ + 1, 0);
+  for (size_t k = 0; k < inserted_.size(); ++k)
+  {
+    pointCells[k] = cell_(inserted_[k].y, minY_, rows_) * columns_ + cell_(inserted_[k].x, minX_, columns_);
+    ++cellStart_[pointCells[k] + 1];
+  }
+  for (size_t k = 1; k < cellStart_.size(); ++k)
+    cellStart_[k] += cellStart_[k - 1];
+
+  std::vector<size_t> next(cellStart_.begin(), cellStart_.end() - 1);
+  points_.resize(inserted_.size());
+  for (size_t k = 0; k < inserted_.size(); ++k)
+    points_[next[pointCells[k]]++] = inserted_[k];
+}
+
+void GridIndex::findWithinRadius(double x, double y, double radius, std::vector<Neighbor>& neighbors) const
+{
+  neighbors.clear();
+  if (cellStart_.empty() || radius < 0.0)
+    return;
+  // Reject queries that cannot touch the grid
+  if (x + radius < minX_ || y + radius < minY_ ||
+    x - radius > minX_ + columns_ * builtCellSize_ || y - radius > minY_ + rows_ * builtCellSize_)
+    return;
+
+  const double radiusSquared = radius * radius;
+  const size_t minColumn = cell_(x - radius, minX_, columns_);
+  const size_t maxColumn = cell_(x + radius, minX_, columns_);
+  const size_t minRow = cell_(y - radius, minY_, rows_);
+  const size_t maxRow = cell_(y + radius, minY_, rows_);
+  for (size_t row = minRow; row <= maxRow; ++row)
+  {
+    // Cells in a row are contiguous in points_
+    const size_t end = cellStart_[row * columns_ + maxColumn + 1];
+    for (size_t k = cellStart_[row * columns_ + minColumn]; k < end; ++k)
+    {
+      const double dx = points_[k].x - x;
+      const double dy = points_[k].y - y;
+      const double rangeSquared = dx * dx + dy * dy;
+      if (rangeSquared <= radiusSquared)
+        neighbors.push_back(Neighbor(rangeSquared, points_[k].item));
+    }
+  }
+  std::sort(neighbors.begin(), neighbors.end());
+}
+
+void GridIndex::findInBox(double x1, double y1, double x2, double y2, std::vector<size_t>& items) const
+{
+  items.clear();
+  if (cellStart_.empty())
+    return;
+  const double minX = std::min(x1, x2);
+  const double maxX = std::max(x1, x2);
+  const double minY = std::min(y1, y2);
+  const double maxY = std::max(y1, y2);
+  if (maxX < minX_ || maxY < minY_ || minX > minX_ + columns_ * builtCellSize_ || minY > minY_ + rows_ * builtCellSize_)
+    return;
+
+  const size_t minColumn = cell_(minX, minX_, columns_);
+  const size_t maxColumn = cell_(maxX, minX_, columns_);
+  const size_t minRow = cell_(minY, minY_, rows_);
+  const size_t maxRow = cell_(maxY, minY_, rows_);
+  for (size_t row = minRow; row <= maxRow; ++row)
+  {
+    const size_t end = cellStart_[row * columns_ + maxColumn + 1];
+    for (size_t k = cellStart_[row * columns_ + minColumn]; k < end; ++k)
+    {
+      const Point& point = points_[k];
+      if (point.x >= minX && point.x <= maxX && point.y >= minY && point.y <= maxY)
+        items.push_back(point.item);
+    }
+  }
+}
+
+}
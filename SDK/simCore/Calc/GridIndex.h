@@ -0,0 +1,118 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_CALC_GRIDINDEX_H
+#define SIMCORE_CALC_GRIDINDEX_H
+
+#include <utility>
+#include <vector>
+#include "simCore/Common/Export.h"
+
+namespace simCore
+{
+
+/**
+ * Uniform grid spatial index over 2-D points, such as screen positions in pixels.
+ * Points are accumulated with insert() and bucketed into cells by build(); the index
+ * can then answer any number of radius and box queries in time proportional to the
+ * number of points in the cells touched, rather than the total number of points.
+ *
+ * Each point carries a caller-defined item number, typically an index into a parallel
+ * container of the objects that were projected.  The same item may be inserted at
+ * several positions.
+ */
+class SDKCORE_EXPORT GridIndex
+{
+public:
+  /** Pair of squared distance and item, as returned by findWithinRadius() */
+  typedef std::pair<double, size_t> Neighbor;
+
+  /** Constructs an empty index; cell size should be on the order of the typical query radius */
+  explicit GridIndex(double cellSize = 32.0);
+  virtual ~GridIndex();
+
+  /** Changes the cell size; takes effect on the next build() */
+  void setCellSize(double cellSize);
+  /** Retrieves the cell size */
+  double cellSize() const;
+
+  /** Removes all points */
+  void clear();
+  /** Reserves space for the given number of points */
+  void reserve(size_t numPoints);
+  /** Adds a point; queries do not see it until build() is called.  Non-finite points are ignored. */
+  void insert(double x, double y, size_t item);
+  /** Buckets all inserted points into grid cells.  Call after inserting points and before querying. */
+  void build();
+
+  /** Number of points in the index */
+  size_t size() const;
+  /** Returns true if no points have been inserted */
+  bool empty() const;
+
+  /**
+   * Retrieves all points within the radius of (x,y), sorted by increasing squared distance.
+   * @param x X coordinate of the query center
+   * @param y Y coordinate of the query center
+   * @param radius Maximum distance, inclusive
+   * @param neighbors Filled with squared distance and item of each point found
+   */
+  void findWithinRadius(double x, double y, double radius, std::vector<Neighbor>& neighbors) const;
+
+  /**
+   * Retrieves the items of all points inside the box, boundaries inclusive, in no particular order.
+   * Corners may be given in any order.  Items inserted at several positions may be returned more than once.
+   */
+  void findInBox(double x1, double y1, double x2, double y2, std::vector<size_t>& items) const;
+
+private:
+  /** Single indexed point */
+  struct Point
+  {
+    double x;
+    double y;
+    size_t item;
+  };
+
+  /** Clamps a coordinate to a cell column or row */
+  size_t cell_(double value, double minValue, size_t numCells) const;
+
+  /** Requested cell size */
+  double cellSize_;
+  /** Cell size in use by the built grid, which grows to bound the number of cells */
+  double builtCellSize_;
+  /** Points as inserted */
+  std::vector<Point> inserted_;
+  /** Points ordered by cell, row major */
+  std::vector<Point> points_;
+  /** Offset into points_ of the first point in each cell, plus a final end offset */
+  std::vector<size_t> cellStart_;
+  /** Minimum corner of the grid */
+  double minX_;
+  double minY_;
+  /** Grid dimensions in cells */
+  size_t columns_;
+  size_t rows_;
+};
+
+}
+
+#endif /* SIMCORE_CALC_GRIDINDEX_H */
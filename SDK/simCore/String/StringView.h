@@ -0,0 +1,206 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMCORE_STRING_STRINGVIEW_H
+#define SIMCORE_STRING_STRINGVIEW_H
+
+#include <cstring>
+#include <ostream>
+#include <string>
+#include "simCore/Common/Common.h"
+
+namespace simCore
+{
+  /**
+   * Non-owning reference to a contiguous sequence of characters, such as a portion of a line read
+   * from a file.  Provides the subset of the C++17 std::string_view interface used by the parsing
+   * routines in simCore/String, so that tokens can be produced and converted without allocating.
+   * The referenced characters must outlive the view.
+   *
+   * Construction from std::string and C strings is explicit so that functions overloaded on
+   * std::string and StringView remain unambiguous for existing callers.
+   */
+  class StringView
+  {
+  public:
+    /** Sentinel position meaning "not found" or "until the end" */
+    static const size_t npos = static_cast<size_t>(-1);
+
+    /** Constructs an empty view */
+    StringView()
+      : data_(""),
+        size_(0)
+    {
+    }
+
+    /** Constructs a view of the first len characters of str */
+    StringView(const char* str, size_t len)
+      : data_(str),
+        size_(len)
+    {
+    }
+
+    /** Constructs a view of a NULL-terminated string */
+    explicit StringView(const char* str)
+      : data_(str),
+        size_(str ? strlen(str) : 0)
+    {
+    }
+
+    /** Constructs a view of the contents of a string; the view is invalidated if the string changes */
+    explicit StringView(const std::string& str)
+      : data_(str.data()),
+        size_(str.size())
+    {
+    }
+
+    /** Pointer to the first character; not necessarily NULL-terminated */
+    const char* data() const { return data_; }
+    /** Number of characters */
+    size_t size() const { return size_; }
+    /** Number of characters */
+    size_t length() const { return size_; }
+    /** True if there are no characters */
+    bool empty() const { return size_ == 0; }
+    /** Character at the given position; no bounds checking */
+    char operator[](size_t pos) const { return data_[pos]; }
+    /** Iterator to the first character */
+    const char* begin() const { return data_; }
+    /** Iterator past the last character */
+    const char* end() const { return data_ + size_; }
+
+    /** Returns a copy of the characters as a std::string */
+    std::string str() const { return std::string(data_, size_); }
+
+    /** Returns a view of up to len characters starting at pos; pos past the end returns an empty view */
+    StringView substr(size_t pos, size_t len = npos) const
+    {
+      if (pos >= size_)
+        return StringView(data_ + size_, 0);
+      const size_t avail = size_ - pos;
+      return StringView(data_ + pos, (len < avail) ? len : avail);
+    }
+
+    /** Returns the position of the first occurrence of c at or after pos, or npos */
+    size_t find(char c, size_t pos = 0) const
+    {
+      if (pos >= size_)
+        return npos;
+      const void* found = memchr(data_ + pos, c, size_ - pos);
+      return found ? static_cast<size_t>(static_cast<const char*>(found) - data_) : npos;
+    }
+
+    /** Returns the position of the first occurrence of the sequence at or after pos, or npos */
+    size_t find(const StringView& seq, size_t pos = 0) const
+    {
+      if (seq.size_ == 0)
+        return (pos <= size_) ? pos : npos;
+      while (seq.size_ <= size_ && pos <= size_ - seq.size_)
+      {
+        pos = find(seq.data_[0], pos);
+        if (pos == npos || pos > size_ - seq.size_)
+          return npos;
+        if (memcmp(data_ + pos, seq.data_, seq.size_) == 0)
+          return pos;
+        ++pos;
+      }
+      return npos;
+    }
+
+    /** Returns the position of the first occurrence of the NULL-terminated sequence at or after pos, or npos */
+    size_t find(const char* seq, size_t pos = 0) const
+    {
+      return find(StringView(seq), pos);
+    }
+
+    /** Returns the position of the first character at or after pos that is in chars, or npos */
+    size_t find_first_of(const StringView& chars, size_t pos = 0) const
+    {
+      for (; pos < size_; ++pos)
+      {
+        if (memchr(chars.data_, data_[pos], chars.size_) != NULL)
+          return pos;
+      }
+      return npos;
+    }
+
+    /** Returns the position of the first character at or after pos that is not in chars, or npos */
+    size_t find_first_not_of(const StringView& chars, size_t pos = 0) const
+    {
+      for (; pos < size_; ++pos)
+      {
+        if (memchr(chars.data_, data_[pos], chars.size_) == NULL)
+          return pos;
+      }
+      return npos;
+    }
+
+    /** Returns the position of the last character that is not in chars, or npos */
+    size_t find_last_not_of(const StringView& chars) const
+    {
+      for (size_t pos = size_; pos > 0; --pos)
+      {
+        if (memchr(chars.data_, data_[pos - 1], chars.size_) == NULL)
+          return pos - 1;
+      }
+      return npos;
+    }
+
+    /** Lexicographic comparison; returns negative, zero or positive like std::string::compare */
+    int compare(const StringView& rhs) const
+    {
+      const size_t len = (size_ < rhs.size_) ? size_ : rhs.size_;
+      const int rv = (len == 0) ? 0 : memcmp(data_, rhs.data_, len);
+      if (rv != 0)
+        return rv;
+      return (size_ < rhs.size_) ? -1 : ((size_ > rhs.size_) ? 1 : 0);
+    }
+
+    /** True if the characters are identical */
+    bool operator==(const StringView& rhs) const { return size_ == rhs.size_ && compare(rhs) == 0; }
+    /** True if the characters differ */
+    bool operator!=(const StringView& rhs) const { return !operator==(rhs); }
+    /** Lexicographic ordering, for use in ordered containers */
+    bool operator<(const StringView& rhs) const { return compare(rhs) < 0; }
+
+    /** True if the characters match the string */
+    bool operator==(const std::string& rhs) const { return operator==(StringView(rhs)); }
+    /** True if the characters differ from the string */
+    bool operator!=(const std::string& rhs) const { return !operator==(StringView(rhs)); }
+    /** True if the characters match the NULL-terminated string */
+    bool operator==(const char* rhs) const { return operator==(StringView(rhs)); }
+    /** True if the characters differ from the NULL-terminated string */
+    bool operator!=(const char* rhs) const { return !operator==(StringView(rhs)); }
+
+  private:
+    const char* data_;
+    size_t size_;
+  };
+
+  /** Writes the characters of the view to the stream */
+  inline std::ostream& operator<<(std::ostream& os, const StringView& view)
+  {
+    return os.write(view.data(), static_cast<std::streamsize>(view.size()));
+  }
+
+} // namespace simCore
+
+#endif /* SIMCORE_STRING_STRINGVIEW_H */
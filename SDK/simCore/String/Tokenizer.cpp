@@ -37,6 +37,17 @@ std::string simCore::extractWord(const std::string &line, size_t &endWordPos, si
   return line.substr(startPos, endWordPos - startPos);
 }
 
+simCore::StringView simCore::extractWord(const StringView &line, size_t &endWordPos, size_t startPos)
+{
+  endWordPos = line.find_first_of(StringView(" \t", 2), startPos);
+  if (endWordPos == StringView::npos)
+  {
+    endWordPos = line.size();
+  }
+
+  return line.substr(startPos, endWordPos - startPos);
+}
+
 /**
 * This function returns a substring portion of the line that spans between the given startPos and endWordPos values.
 * Leading white space is removed from the returned substring and only double quotes are allowed.
@@ -92,6 +103,60 @@ std::string simCore::extractWordWithQuotes(const std::string &line, size_t &endW
   return line.substr(startPos, endWordPos - startPos);
 }
 
+simCore::StringView simCore::extractWordWithQuotes(const StringView &line, size_t &endWordPos, size_t startPos)
+{
+  StringView delim(" \t\"", 3); // standard delimiters are whitespace or quote
+
+  size_t searchPos = startPos;
+  // if the token starts with quote
+  bool hasQuote = (startPos < line.size() && line[startPos] == '"');
+  if (hasQuote)
+  {
+    // and is at the end of the line
+    if (line.size() == startPos + 1)
+    {
+      endWordPos = line.size();
+      return line.substr(startPos, 1); // that's all there is
+    }
+
+    //else, start the search on the next char
+    ++searchPos;
+    delim = StringView("\"", 1); // in quote, stop only on quote
+  }
+
+  // find delimiter after start
+  endWordPos = line.find_first_of(delim, searchPos);
+
+  if (endWordPos == StringView::npos)
+  {
+    endWordPos = line.size();
+  }
+  else if (line[endWordPos] == '"')
+  {
+    if (hasQuote)
+    {
+      // found end quote, good to go
+      ++endWordPos;
+    }
+    else if (endWordPos + 1 == line.size())
+    {
+      // quote at end of line
+      ++endWordPos;
+    }
+    else // first quote
+    {
+      // find end quote
+      endWordPos = line.find('"', endWordPos + 1);
+      if (endWordPos == StringView::npos)
+        endWordPos = line.size();
+      else
+        ++endWordPos;
+    }
+  }
+
+  return line.substr(startPos, endWordPos - startPos);
+}
+
 /**
 * Tokenization helper function that returns the proper termination sequence, respecting quotes.
 * In the simple case, this returns an empty string, which implies that any whitespace breaks a
@@ -126,6 +191,35 @@ std::string simCore::getTerminateForStringPos(const std::string &str, size_t pos
   return "";
 }
 
+simCore::StringView simCore::getTerminateForStringPos(const StringView &str, size_t pos)
+{
+  // Note that pos == size() is treated as unquoted, matching the std::string version's NUL check
+  if (pos >= str.length())
+    return StringView();
+
+  // single quote
+  if (str[pos] == '\'')
+    return StringView("'", 1);
+
+  // double quote, check for triple
+  if (str[pos] == '"')
+  {
+    // if not enough characters for triple
+    if (pos + 3 > str.length())
+      return StringView("\"", 1);
+
+    // match three but not four
+    if (str[pos+1] == '"' && str[pos+2] == '"' && (pos + 3 == str.length() || str[pos+3] != '"'))
+      return StringView("\"\"\"", 3);
+
+    // double
+    return StringView("\"", 1);
+  }
+
+  // not quoted
+  return StringView();
+}
+
 /**
 * Calculates the position of first character after a termination string.  This
 * takes in as a parameter the termination string, which when empty means that any
@@ -186,6 +280,59 @@ size_t simCore::getFirstCharPosAfterString(const std::string &str, size_t start,
   return endOfStr;
 }
 
+size_t simCore::getFirstCharPosAfterString(const StringView &str, size_t start, const StringView &termString)
+{
+  if (termString.empty())
+  {
+    // no terminator, use whitespace
+    return str.find_first_of(StringView(simCore::STR_WHITE_SPACE_CHARS), start);
+  }
+
+  size_t pos = str.find(termString, start);
+  if (pos == StringView::npos)
+  {
+    // not found
+    return StringView::npos;
+  }
+
+  // single quotes can be escaped with a leading back slash
+  if ((termString == "\"") && (pos > 0))
+  {
+    // Need to search until an escaped quote is found
+    while (str[pos - 1] == '\\')
+    {
+      // Need to count the number of preceding back slashes
+      // If old number of preceding back slashes then the quote is escaped
+      // If even number of preceding back slashes then the quote is NOT escaped.
+      size_t counterPos = pos - 1;
+      unsigned int counter = 1;
+      while ((counterPos > 0) && (str[counterPos - 1] == '\\'))
+      {
+        ++counter;
+        --counterPos;
+      }
+
+      // if even number of preceding back slashes then the quote is NOT escaped, so kick out
+      if ((counter % 2) == 0)
+        break;
+
+      // look for the next possible quote
+      pos = str.find(termString, pos+1);
+      if (pos == StringView::npos)
+      {
+        // not found
+        return StringView::npos;
+      }
+    }
+  }
+
+  const size_t endOfStr = pos + termString.length();
+  if (endOfStr > str.length())
+    return StringView::npos;
+
+  return endOfStr;
+}
+
 /**
 * Removes extraneous quotes from 'inString', on the outside only
 */
@@ -214,6 +361,31 @@ std::string simCore::removeQuotes(const std::string &inString)
   return (lastPos >= nowPos) ? inString.substr(nowPos, (lastPos - nowPos) + 1) : "";
 }
 
+simCore::StringView simCore::removeQuotes(const StringView &inString)
+{
+  size_t lastPos = inString.size();
+  if (lastPos <= 1) // short string
+    return inString;
+
+  // get quote type
+  const char firstChar = inString[0];
+  if (firstChar != '\'' && firstChar != '"')
+    return inString; // not quoted
+
+  // compare nth with nth from end
+  --lastPos;
+  size_t nowPos = 0;
+  while (lastPos > nowPos &&
+    inString[ nowPos] == firstChar &&
+    inString[lastPos] == firstChar)
+  {
+    nowPos++; lastPos--;
+  }
+
+  // Substring it from [nowPos, lastPos] inclusive
+  return (lastPos >= nowPos) ? inString.substr(nowPos, (lastPos - nowPos) + 1) : StringView();
+}
+
 void simCore::removeQuotes(std::vector<std::string>& strVec)
 {
   for (std::vector<std::string>::iterator i = strVec.begin(); i != strVec.end(); ++i)
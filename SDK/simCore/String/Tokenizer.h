@@ -27,6 +27,7 @@
 #include <vector>
 #include "simCore/Common/Common.h"
 #include "simCore/String/Constants.h"
+#include "simCore/String/StringView.h"
 
 namespace simCore
 {
@@ -68,6 +69,46 @@ namespace simCore
     }
   }
 
+  /**
+  * StringView overload of stringTokenizer(); tokens reference the characters of 'str' rather than
+  * copying them, so 'str' must outlive the tokens.  Use with a container of StringView.
+  * @param[out] t STL container of StringView that supports push_back().
+  * @param[in ] str string to be split into tokens.
+  * @param[in ] delimiters delimiter value(s) for tokenizing.
+  * @param[in ] clear boolean for clearing STL container before new tokens are inserted.
+  * @param[in ] skipMultiple boolean, if true skips multiple delimiters encountered as a group
+  */
+  template<class T>
+  inline void stringTokenizer(T &t, const StringView &str, const StringView &delimiters = StringView(STR_WHITE_SPACE_CHARS), bool clear = true, bool skipMultiple = true)
+  {
+    if (clear)
+      t.clear();
+
+    // Skip delimiters at beginning.
+    size_t lastPos = 0;
+    if (skipMultiple)
+      lastPos = str.find_first_not_of(delimiters);
+
+    // go from non-delimiter to delimiter
+    size_t pos = str.find_first_of(delimiters, lastPos);
+    while (StringView::npos != pos || StringView::npos != lastPos)
+    {
+      // Found a token, add it to the STL container.
+      t.push_back(str.substr(lastPos, pos - lastPos));
+
+      // Skip delimiters.  Note: "not_of"
+      if (skipMultiple)
+        lastPos = str.find_first_not_of(delimiters, pos);
+      else if (pos != StringView::npos)
+        lastPos = pos + 1;
+      else
+        lastPos = StringView::npos;
+
+      // get next token
+      pos = str.find_first_of(delimiters, lastPos);
+    }
+  }
+
   /**
   * This function removes trailing white space from a string read from
   * a stream, then parses the string into tokens delimited by whitespace.
@@ -100,6 +141,15 @@ namespace simCore
   */
   SDKCORE_EXPORT std::string extractWord(const std::string &line, size_t &endWordPos, size_t startPos = 0);
 
+  /**
+  * StringView overload of extractWord(); returns a view into 'line' rather than a copy.
+  * @param[in ] line text to parse
+  * @param[out] endWordPos index of last character in the word
+  * @param[in ] startPos starting position to use
+  * @return the substring in line
+  */
+  SDKCORE_EXPORT StringView extractWord(const StringView &line, size_t &endWordPos, size_t startPos = 0);
+
   /**
   * This function returns a substring portion of the line that spans between the given startPos and endWordPos values.
   * Leading white space is removed from the returned substring and only double quotes are supported.
@@ -110,6 +160,15 @@ namespace simCore
   */
   SDKCORE_EXPORT std::string extractWordWithQuotes(const std::string &line, size_t &endWordPos, size_t startPos = 0);
 
+  /**
+  * StringView overload of extractWordWithQuotes(); returns a view into 'line' rather than a copy.
+  * @param[in ] line text to parse
+  * @param[out] endWordPos index of last character in the word
+  * @param[in ] startPos starting position to use
+  * @return the substring in line
+  */
+  SDKCORE_EXPORT StringView extractWordWithQuotes(const StringView &line, size_t &endWordPos, size_t startPos = 0);
+
   /**
   * Tokenization helper function that returns the proper termination sequence, respecting quotes.
   * In the simple case, this returns an empty string, which implies that any whitespace breaks a
@@ -122,6 +181,14 @@ namespace simCore
   */
   SDKCORE_EXPORT std::string getTerminateForStringPos(const std::string &str, size_t pos);
 
+  /**
+  * StringView overload of getTerminateForStringPos(); the returned view references static storage.
+  * @param[in ] str Source string
+  * @param[in ] pos Position to start the token, including any potential quotes
+  * @return Sequence that terminates the token; empty if any whitespace terminates the token
+  */
+  SDKCORE_EXPORT StringView getTerminateForStringPos(const StringView &str, size_t pos);
+
   /**
   * Calculates the position of first character after a termination string.  This
   * takes in as a parameter the termination string, which when empty means that any
@@ -135,6 +202,15 @@ namespace simCore
   */
   SDKCORE_EXPORT size_t getFirstCharPosAfterString(const std::string &str, size_t start, const std::string &termString);
 
+  /**
+  * StringView overload of getFirstCharPosAfterString(), used by the StringView quoteTokenizer().
+  * @param[in ] str Input string
+  * @param[in ] start Start position in the string to search for the termString
+  * @param[in ] termString When empty, search for whitespace; when non-empty, search for the sequence of characters as specified in this string
+  * @return Position of the first character after termString was found, or StringView::npos if the entire string was searched.
+  */
+  SDKCORE_EXPORT size_t getFirstCharPosAfterString(const StringView &str, size_t start, const StringView &termString);
+
   /**
   * Tokenizes 'str' based on white space while ignoring white space encountered within double quotes.
   * Leading white space is removed from the tokens and only double quotes are supported.
@@ -163,6 +239,34 @@ namespace simCore
     while (endWord != str.size());
   }
 
+  /**
+  * StringView overload of tokenizeWithQuotes(); tokens reference the characters of 'str'.
+  * @param[out] t STL container of StringView that supports push_back() and clear()
+  * @param[in ] str String to tokenize
+  * @param[in ] clear Clears the STL structure if true
+  */
+  template<class T>
+  void tokenizeWithQuotes(T &t, const StringView &str, bool clear = true)
+  {
+    if (clear)
+      t.clear();
+
+    const StringView spaces(" \t");
+    size_t endWord = 0;
+    do
+    {
+      // skip spaces before words
+      size_t startWord = str.find_first_not_of(spaces, endWord);
+      if (startWord == StringView::npos)
+        return;
+
+      // push the next token
+      t.push_back(extractWordWithQuotes(str, endWord, startWord));
+
+    }
+    while (endWord != str.size());
+  }
+
   /**
   * Tokenizes 'str', respecting single, double and triple quotes.
   * @param[out] t STL container that supports push_back() and clear()
@@ -197,6 +301,42 @@ namespace simCore
     }
   }
 
+  /**
+  * StringView overload of quoteTokenizer(); tokens reference the characters of 'str', including
+  * their quotes, and escaped double quotes are respected the same way.
+  * @param[out] t STL container of StringView that supports push_back() and clear()
+  * @param[in ] str String to tokenize
+  * @param[in ] clear Clears the STL structure if true
+  */
+  template<class T>
+  inline void quoteTokenizer(T &t, const StringView &str, bool clear = true)
+  {
+    if (clear)
+      t.clear();
+
+    const StringView whiteSpace(STR_WHITE_SPACE_CHARS);
+    // Skip delimiters at beginning.
+    size_t lastPos = str.find_first_not_of(whiteSpace, 0);
+    if (lastPos == StringView::npos)
+      return;
+
+    // Determine what token should terminate pos
+    StringView terminateString = getTerminateForStringPos(str, lastPos);
+    size_t pos = getFirstCharPosAfterString(str, lastPos+1, terminateString);
+    while (StringView::npos != pos || StringView::npos != lastPos)
+    {
+      // Got a token, push it back
+      t.push_back(str.substr(lastPos, pos - lastPos));
+
+      // Skip until the next non-whitespace
+      lastPos = str.find_first_not_of(whiteSpace, pos);
+
+      // Figure out the terminate string based on current position
+      terminateString = getTerminateForStringPos(str, lastPos);
+      pos = (StringView::npos == lastPos) ? lastPos : getFirstCharPosAfterString(str, lastPos+1, terminateString);
+    }
+  }
+
   /**
   * Processes a STL container of tokens to remove tokens that are impacted by a
   * comment string.  This function supports # and // comments, and comments
@@ -251,6 +391,13 @@ namespace simCore
   */
   SDKCORE_EXPORT std::string removeQuotes(const std::string &inString);
 
+  /**
+  * StringView overload of removeQuotes(); returns a view into 'inString' rather than a copy.
+  * @param[in ] inString String from which quotes should be removed
+  * @return View of inString without the extra quotes
+  */
+  SDKCORE_EXPORT StringView removeQuotes(const StringView &inString);
+
   /**
    * Removes the quotes (simCore::removeQuotes()) on all tokens in the vector strVec.
    * Vectorized format to remove extraneous quotes from 'inString', on the outside only.
@@ -287,6 +434,25 @@ namespace simCore
     }
   }
 
+  /** StringView overload of quoteCommentTokenizer(); tokens reference the characters of 'str'.
+  * @param[in ] str String to tokenize
+  * @param[out] t STL container of StringView that supports push_back() and clear()
+  */
+  template<class T>
+  inline void quoteCommentTokenizer(const StringView& str, T& t)
+  {
+    simCore::quoteTokenizer(t, str);
+
+    if (!t.empty())
+    {
+      simCore::removeCommentTokens(t);
+      for (typename T::iterator i = t.begin(); i != t.end(); ++i)
+      {
+        *i = simCore::removeQuotes(*i);
+      }
+    }
+  }
+
   /** Tokenizes 'str' taking into account quoted strings containing escaped quotes
   * e.g. "My grooviest token is \"Token\"" oh-yea "that's the one"
   * (three tokens)
@@ -26,6 +26,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <cerrno>
+#include <cstring>
 
 #ifndef _MSC_VER
 // needed for isdigit on non-MSVC systems
@@ -38,6 +39,211 @@
 #include "simCore/Calc/Math.h"
 
 
+namespace
+{
+
+/** Exact powers of ten representable in a double, used by the real number fast path */
+static const double EXACT_POWERS_OF_TEN[] = {
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+  1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20,
+  1e21, 1e22
+};
+/** Largest index into EXACT_POWERS_OF_TEN */
+static const int MAX_EXACT_POWER_OF_TEN = 22;
+/** Mantissas at or below 2^53 are exactly representable in a double */
+static const uint64_t MAX_EXACT_MANTISSA = static_cast<uint64_t>(1) << 53;
+/** Number of significant digits accumulated before switching to strtod() */
+static const int MAX_FAST_DIGITS = 19;
+
+/**
+ * Converts an optionally signed decimal integer with no surrounding white space, checking bounds
+ * against T.  Matches the strtol()-based isValidNumber() rules without requiring a NULL terminator.
+ */
+template <typename T>
+bool parseInteger(const simCore::StringView& token, T& val, bool permitPlusToken)
+{
+  val = 0;
+  const char* p = token.begin();
+  const char* end = token.end();
+  if (p == end)
+    return false;
+
+  bool negative = false;
+  if (*p == '-')
+  {
+    if (!std::numeric_limits<T>::is_signed)
+      return false;
+    negative = true;
+    ++p;
+  }
+  else if (*p == '+')
+  {
+    if (!permitPlusToken)
+      return false;
+    ++p;
+  }
+  if (p == end)
+    return false;
+
+  // Accumulate the magnitude; the negative limit is one larger than the positive limit
+  const uint64_t limit = static_cast<uint64_t>(std::numeric_limits<T>::max()) + (negative ? 1 : 0);
+  uint64_t magnitude = 0;
+  for (; p != end; ++p)
+  {
+    const unsigned int digit = static_cast<unsigned int>(static_cast<unsigned char>(*p)) - '0';
+    if (digit > 9)
+      return false;
+    if (magnitude > (limit - digit) / 10)
+      return false;
+    magnitude = magnitude * 10 + digit;
+  }
+
+  if (!negative)
+    val = static_cast<T>(magnitude);
+  else if (magnitude == limit)
+    val = std::numeric_limits<T>::min();
+  else
+    val = static_cast<T>(-static_cast<int64_t>(magnitude));
+  return true;
+}
+
+/**
+ * Converts a real number with no surrounding white space.  Validates the format directly, then
+ * computes the value exactly when the mantissa and power of ten are both exactly representable
+ * (correctly rounded, per Clinger's fast path).  Other values use strtod() on a NULL-terminated copy.
+ */
+bool parseReal(const simCore::StringView& token, double& val, bool permitPlusToken)
+{
+  val = 0.0;
+  const char* p = token.begin();
+  const char* end = token.end();
+  if (p == end)
+    return false;
+
+  bool negative = false;
+  if (*p == '-')
+  {
+    negative = true;
+    ++p;
+  }
+  else if (*p == '+')
+  {
+    if (!permitPlusToken)
+      return false;
+    ++p;
+  }
+
+  uint64_t mantissa = 0;
+  int numDigits = 0;
+  int exponent = 0;
+  bool foundDigit = false;
+  bool truncated = false;
+
+  // Integer portion
+  for (; p != end && isdigit(static_cast<unsigned char>(*p)); ++p)
+  {
+    foundDigit = true;
+    if (mantissa == 0 && *p == '0')
+      continue;
+    if (numDigits < MAX_FAST_DIGITS)
+    {
+      mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+      ++numDigits;
+    }
+    else
+    {
+      ++exponent;
+      truncated = true;
+    }
+  }
+
+  // Fractional portion
+  if (p != end && *p == '.')
+  {
+    for (++p; p != end && isdigit(static_cast<unsigned char>(*p)); ++p)
+    {
+      foundDigit = true;
+      if (mantissa == 0 && *p == '0')
+      {
+        --exponent;
+        continue;
+      }
+      if (numDigits < MAX_FAST_DIGITS)
+      {
+        mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+        ++numDigits;
+        --exponent;
+      }
+      else
+        truncated = true;
+    }
+  }
+
+  // Leading white space, inf, nan, and empty mantissas are all errors in the strtod() version too
+  if (!foundDigit)
+    return false;
+
+  // Exponent; strtod() would stop before a dangling 'e', which fails the end-of-string check
+  if (p != end && (*p == 'e' || *p == 'E'))
+  {
+    ++p;
+    bool negativeExponent = false;
+    if (p != end && (*p == '-' || *p == '+'))
+    {
+      negativeExponent = (*p == '-');
+      ++p;
+    }
+    if (p == end || !isdigit(static_cast<unsigned char>(*p)))
+      return false;
+    int explicitExponent = 0;
+    for (; p != end && isdigit(static_cast<unsigned char>(*p)); ++p)
+    {
+      // Saturate; anything this large overflows or underflows regardless
+      if (explicitExponent < 100000)
+        explicitExponent = explicitExponent * 10 + (*p - '0');
+    }
+    exponent += negativeExponent ? -explicitExponent : explicitExponent;
+  }
+
+  // Trailing characters, including hexadecimal 'x' and white space, are errors
+  if (p != end)
+    return false;
+
+  if (!truncated && mantissa <= MAX_EXACT_MANTISSA && exponent >= -MAX_EXACT_POWER_OF_TEN && exponent <= MAX_EXACT_POWER_OF_TEN)
+  {
+    double rv = static_cast<double>(mantissa);
+    if (exponent < 0)
+      rv /= EXACT_POWERS_OF_TEN[-exponent];
+    else
+      rv *= EXACT_POWERS_OF_TEN[exponent];
+    val = negative ? -rv : rv;
+    return true;
+  }
+
+  // Slow path: strtod() requires a NULL terminator
+  char buffer[64];
+  std::string longToken;
+  const char* start = buffer;
+  if (token.size() < sizeof(buffer))
+  {
+    memcpy(buffer, token.data(), token.size());
+    buffer[token.size()] = '\0';
+  }
+  else
+  {
+    longToken = token.str();
+    start = longToken.c_str();
+  }
+  const double rv = std::strtod(start, NULL);
+  // Must be finite
+  if (!finite(rv))
+    return false;
+  val = rv;
+  return true;
+}
+
+}
+
 namespace simCore
 {
 
@@ -377,4 +583,63 @@ bool isValidHexNumber(const std::string& token, int8_t& val, bool require0xPrefi
   return isValidHexNumberT<int8_t>(token, val, require0xPrefix);
 }
 
+bool isValidNumber(const StringView& token, uint64_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, uint32_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, uint16_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, uint8_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, int64_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, int32_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, int16_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, int8_t& val, bool permitPlusToken)
+{
+  return parseInteger(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, double& val, bool permitPlusToken)
+{
+  return parseReal(token, val, permitPlusToken);
+}
+
+bool isValidNumber(const StringView& token, float& val, bool permitPlusToken)
+{
+  val = 0.f;
+  double dVal;
+  if (!parseReal(token, dVal, permitPlusToken))
+    return false;
+  // Bounds check
+  if (dVal < -std::numeric_limits<float>::max() || dVal > std::numeric_limits<float>::max())
+    return false;
+  // Convert
+  val = static_cast<float>(dVal);
+  return true;
+}
+
 }
@@ -24,6 +24,7 @@
 
 #include <string>
 #include "simCore/Common/Common.h"
+#include "simCore/String/StringView.h"
 
 namespace simCore
 {
@@ -79,6 +80,30 @@ namespace simCore
   SDKCORE_EXPORT bool isValidNumber(const std::string& token, float& val, bool permitPlusToken=true);
   ///@}
 
+  ///@{
+  /**
+   * StringView overloads of isValidNumber(), accepting and rejecting the same inputs.  The token does
+   * not need to be NULL-terminated and no memory is allocated.  Integers are converted directly from
+   * the characters; real numbers whose significant digits (at most 19) form a mantissa no larger than
+   * 2^53, with a net power of ten of magnitude at most 22, are converted exactly without strtod(),
+   * falling back to strtod() on a stack copy otherwise.
+   * @param[in ] token String to validate
+   * @param[out] val Converted number, set to 0 if conversion fails
+   * @param[in ] permitPlusToken Permits positive '+' signs on the string; if false, having '+' is an error
+   * @return true if valid, false if not
+   */
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, uint64_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, uint32_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, uint16_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, uint8_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, int64_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, int32_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, int16_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, int8_t& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, double& val, bool permitPlusToken=true);
+  SDKCORE_EXPORT bool isValidNumber(const StringView& token, float& val, bool permitPlusToken=true);
+  ///@}
+
   ///@{
   /**
    * Determines if the incoming string is a valid hexadecimal number and then performs the conversion.
@@ -21,6 +21,7 @@
  */
 #include <sstream>
 #include <iomanip>
+#include <algorithm>
 #include <cassert>
 #include "simNotify/Notify.h"
 #include "simCore/Calc/Math.h"
@@ -34,6 +35,240 @@
 #include "simCore/Time/Exception.h"
 #include "simCore/Time/String.h"
 
+namespace
+{
+
+/** Number of leading strings examined by TimeFormatterRegistry::fromStrings() to detect the format */
+static const size_t BULK_DETECT_COUNT = 3;
+
+/** Built-in formats with a specialized bulk parser */
+enum BulkFormat
+{
+  BULK_NONE = 0,
+  BULK_SECONDS,
+  BULK_ORDINAL,
+  BULK_MONTHDAY,
+  BULK_DTG
+};
+
+/** Fixed capacity token container for simCore::stringTokenizer(), counting tokens past its capacity */
+class TimeFields
+{
+public:
+  TimeFields()
+    : size_(0)
+  {
+  }
+
+  void clear() { size_ = 0; }
+  void push_back(const simCore::StringView& field)
+  {
+    if (size_ < CAPACITY)
+      fields_[size_] = field;
+    ++size_;
+  }
+  size_t size() const { return size_; }
+  const simCore::StringView& operator[](size_t index) const { return fields_[index]; }
+
+private:
+  static const size_t CAPACITY = 4;
+  simCore::StringView fields_[CAPACITY];
+  size_t size_;
+};
+
+/** Equivalent to StringUtils::trim(removeQuotes(str)) without allocating */
+simCore::StringView cleanTimeString(const simCore::StringView& str)
+{
+  const simCore::StringView unquoted = simCore::removeQuotes(str);
+  const simCore::StringView whiteSpace(simCore::STR_WHITE_SPACE_CHARS);
+  const size_t first = unquoted.find_first_not_of(whiteSpace);
+  if (first == simCore::StringView::npos)
+    return simCore::StringView();
+  return unquoted.substr(first, unquoted.find_last_not_of(whiteSpace) - first + 1);
+}
+
+/** Equivalent to MonthDayTimeFormatter::monthStringToInt() */
+int monthViewToInt(const simCore::StringView& monthString)
+{
+  for (int month = 0; month < 12; ++month)
+  {
+    const std::string& name = simCore::ABBREV_MONTH_NAME[month];
+    if (name.size() != monthString.size())
+      continue;
+    size_t k = 0;
+    while (k < name.size() && tolower(static_cast<unsigned char>(name[k])) == tolower(static_cast<unsigned char>(monthString[k])))
+      ++k;
+    if (k == name.size())
+      return month;
+  }
+  return -1;
+}
+
+/** Equivalent to SecondsTimeFormatter::isStrictSecondsString(), also returning the value */
+bool strictSeconds(const simCore::StringView& str, double& seconds)
+{
+  return simCore::isValidNumber(str, seconds, false) && seconds >= 0 && seconds < 60 && str[0] != '.';
+}
+
+/** Equivalent to HoursTimeFormatter::isStrictHoursString() followed by HoursTimeFormatter::fromString() */
+bool strictHours(const simCore::StringView& str, simCore::Seconds& seconds)
+{
+  TimeFields hhmmss;
+  simCore::stringTokenizer(hhmmss, cleanTimeString(str), simCore::StringView(":", 1), false, false);
+  int hours = 0;
+  int minutes = 0;
+  double sec = 0.0;
+  if (hhmmss.size() == 3 &&
+    simCore::isValidNumber(hhmmss[0], hours, false) &&
+    hours >= 0 && hours < 24 &&
+    simCore::isValidNumber(hhmmss[1], minutes, false) &&
+    minutes >= 0 && minutes < 60 &&
+    strictSeconds(hhmmss[2], sec))
+  {
+    seconds = hours * 3600 + minutes * 60 + sec;
+    return true;
+  }
+  return false;
+}
+
+/** Converts strings accepted by SecondsTimeFormatter::canConvert() */
+bool bulkSeconds(const simCore::StringView& timeString, int referenceYear, simCore::TimeStamp& timeStamp)
+{
+  double seconds = 0.0;
+  if (!simCore::isValidNumber(cleanTimeString(timeString), seconds))
+    return false;
+  timeStamp = simCore::TimeStamp(referenceYear, seconds);
+  return true;
+}
+
+/** Converts strings accepted by OrdinalTimeFormatter::canConvert() */
+bool bulkOrdinal(const simCore::StringView& timeString, simCore::TimeStamp& timeStamp)
+{
+  TimeFields dayYearHours;
+  simCore::stringTokenizer(dayYearHours, cleanTimeString(timeString), simCore::StringView(" ", 1), false, true);
+  if (dayYearHours.size() != 3 || dayYearHours[0].size() > 3 || dayYearHours[1].size() != 4)
+    return false;
+
+  int year = 0;
+  int day = 0;
+  if (!simCore::isValidNumber(dayYearHours[1], year, false) || year <= 1900 || year > 9999 ||
+    !simCore::isValidNumber(dayYearHours[0], day, false) || day < 1)
+    return false;
+  try
+  {
+    if (day > simCore::daysPerYear(year - 1900))
+      return false;
+  }
+  catch (const simCore::TimeException&)
+  {
+    return false;
+  }
+
+  simCore::Seconds seconds;
+  if (!strictHours(dayYearHours[2], seconds))
+    return false;
+  timeStamp = simCore::TimeStamp(year, seconds + simCore::Seconds((day - 1) * 86400));
+  return true;
+}
+
+/** Converts strings accepted by MonthDayTimeFormatter::canConvert() */
+bool bulkMonthDay(const simCore::StringView& timeString, simCore::TimeStamp& timeStamp)
+{
+  TimeFields mdyh;
+  simCore::stringTokenizer(mdyh, cleanTimeString(timeString), simCore::StringView(" ", 1), false, true);
+  if (mdyh.size() != 4 || mdyh[0].size() != 3 || mdyh[1].size() > 2 || mdyh[2].size() != 4)
+    return false;
+
+  const int month = monthViewToInt(mdyh[0]);
+  int year = 0;
+  int monthDay = 0;
+  if (month == -1 || !simCore::isValidNumber(mdyh[2], year, false) || year < 1900 || year > 9999 ||
+    !simCore::isValidNumber(mdyh[1], monthDay) || monthDay <= 0)
+    return false;
+
+  simCore::Seconds seconds;
+  try
+  {
+    if (monthDay > simCore::daysPerMonth(year - 1900, month) || !strictHours(mdyh[3], seconds))
+      return false;
+    const int yearDay = simCore::getYearDay(month, monthDay, year - 1900);
+    timeStamp = simCore::TimeStamp(year, seconds + simCore::Seconds(yearDay * 86400));
+  }
+  catch (const simCore::TimeException&)
+  {
+    return false;
+  }
+  return true;
+}
+
+/** Converts strings accepted by DtgTimeFormatter::canConvert() */
+bool bulkDtg(const simCore::StringView& timeString, simCore::TimeStamp& timeStamp)
+{
+  TimeFields timesZoneMonth;
+  simCore::stringTokenizer(timesZoneMonth, cleanTimeString(timeString), simCore::StringView(" ", 1), false, true);
+  if (timesZoneMonth.size() != 3 || timesZoneMonth[1] != "Z" || timesZoneMonth[2].size() != 5)
+    return false;
+  const simCore::StringView& times = timesZoneMonth[0];
+  if (times.size() < 9 || times[6] != ':' || times[7] == '.' || times[8] == '.')
+    return false;
+
+  const int month = monthViewToInt(timesZoneMonth[2].substr(0, 3));
+  int year = 0;
+  if (month == -1 || !simCore::isValidNumber(timesZoneMonth[2].substr(3), year, false))
+    return false;
+  year += (year >= 70) ? 1900 : 2000; // Valid from 1970 to 2069
+
+  int monthDay = 0;
+  int hours = 0;
+  int minutes = 0;
+  double seconds = 0.0;
+  try
+  {
+    if (!strictSeconds(times.substr(7), seconds) ||
+      !simCore::isValidNumber(times.substr(0, 2), monthDay, false) ||
+      monthDay < 1 || monthDay > simCore::daysPerMonth(year - 1900, month) ||
+      !simCore::isValidNumber(times.substr(2, 2), hours, false) ||
+      hours < 0 || hours >= 24 ||
+      !simCore::isValidNumber(times.substr(4, 2), minutes, false) ||
+      minutes < 0 || minutes >= 60)
+      return false;
+    const int yearDay = simCore::getYearDay(month, monthDay, year - 1900);
+    timeStamp = simCore::TimeStamp(year, yearDay * 86400 + hours * 3600 + minutes * 60 + seconds);
+  }
+  catch (const simCore::TimeException&)
+  {
+    return false;
+  }
+  return true;
+}
+
+/** Converts a string with the specialized parser for the format; returns false if the string does not match */
+bool bulkFromString(BulkFormat format, const simCore::StringView& timeString, int referenceYear, simCore::TimeStamp& timeStamp)
+{
+  switch (format)
+  {
+  case BULK_SECONDS:
+    return bulkSeconds(timeString, referenceYear, timeStamp);
+  case BULK_ORDINAL:
+    return bulkOrdinal(timeString, timeStamp);
+  case BULK_MONTHDAY:
+    return bulkMonthDay(timeString, timeStamp);
+  case BULK_DTG:
+    return bulkDtg(timeString, timeStamp);
+  case BULK_NONE:
+    break;
+  }
+  return false;
+}
+
+/** Adapters so that fromStrings_() can treat std::string and StringView input alike */
+inline simCore::StringView toView(const std::string& str) { return simCore::StringView(str); }
+inline simCore::StringView toView(const simCore::StringView& str) { return str; }
+inline const std::string& toStdString(const std::string& str) { return str; }
+inline std::string toStdString(const simCore::StringView& str) { return str.str(); }
+
+}
+
 namespace simCore
 {
 
@@ -690,4 +925,56 @@ int TimeFormatterRegistry::fromString(const std::string& timeString, simCore::Ti
   return parser.fromString(timeString, timeStamp, referenceYear);
 }
 
+size_t TimeFormatterRegistry::fromStrings(const std::vector<std::string>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear) const
+{
+  return fromStrings_(timeStrings, timeStamps, referenceYear);
+}
+
+size_t TimeFormatterRegistry::fromStrings(const std::vector<simCore::StringView>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear) const
+{
+  return fromStrings_(timeStrings, timeStamps, referenceYear);
+}
+
+template <typename StringType>
+size_t TimeFormatterRegistry::fromStrings_(const std::vector<StringType>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear) const
+{
+  timeStamps.resize(timeStrings.size());
+  size_t numErrors = 0;
+
+  // Detect the format from the first strings; they must all agree to use a specialized parser
+  BulkFormat bulkFormat = BULK_NONE;
+  const size_t detectCount = std::min(BULK_DETECT_COUNT, timeStrings.size());
+  for (size_t k = 0; k < detectCount; ++k)
+  {
+    const TimeFormatter* detected = &formatter(toStdString(timeStrings[k]));
+    BulkFormat rowFormat = BULK_NONE;
+    if (detected == &formatter(TIMEFORMAT_SECONDS))
+      rowFormat = BULK_SECONDS;
+    else if (detected == &formatter(TIMEFORMAT_ORDINAL))
+      rowFormat = BULK_ORDINAL;
+    else if (detected == &formatter(TIMEFORMAT_MONTHDAY))
+      rowFormat = BULK_MONTHDAY;
+    else if (detected == &formatter(TIMEFORMAT_DTG))
+      rowFormat = BULK_DTG;
+
+    if (k == 0)
+      bulkFormat = rowFormat;
+    else if (rowFormat != bulkFormat)
+    {
+      bulkFormat = BULK_NONE;
+      break;
+    }
+  }
+
+  for (size_t k = 0; k < timeStrings.size(); ++k)
+  {
+    if (bulkFormat != BULK_NONE && bulkFromString(bulkFormat, toView(timeStrings[k]), referenceYear, timeStamps[k]))
+      continue;
+    // Fall back to probing all formatters
+    if (fromString(toStdString(timeStrings[k]), timeStamps[k], referenceYear) != 0)
+      ++numErrors;
+  }
+  return numErrors;
+}
+
 }
@@ -28,6 +28,7 @@
 #include <string>
 #include <iostream>
 #include "simCore/Common/Common.h"
+#include "simCore/String/StringView.h"
 #include "simCore/Time/Constants.h"
 
 namespace simCore
@@ -271,7 +272,34 @@ public:
    */
   int fromString(const std::string& timeString, simCore::TimeStamp& timeStamp, int referenceYear) const;
 
+  /**
+   * Converts a column of time strings, such as from a CSV import, to time stamps.  The format is
+   * detected from the first few strings using formatter().  If they all share a built-in seconds,
+   * ordinal, month-day or DTG format, the remaining strings are converted with a parser specialized
+   * for that format that does not allocate memory.  Strings that the specialized parser rejects, and
+   * all strings in other formats, are converted individually with fromString().
+   * @param timeStrings Time strings to convert
+   * @param timeStamps Receives one time stamp per input string, in order.  Strings that cannot be
+   *   converted produce the time stamp from fromString() on error.  Previous contents are replaced.
+   * @param referenceYear Reference year epoch for time formats that require a reference year.
+   * @return Number of strings that could not be converted; 0 on complete success.
+   */
+  size_t fromStrings(const std::vector<std::string>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear) const;
+
+  /**
+   * Converts a column of time strings to time stamps; see the std::string variant of fromStrings().
+   * @param timeStrings Time strings to convert; views must be valid for the duration of the call
+   * @param timeStamps Receives one time stamp per input string, in order
+   * @param referenceYear Reference year epoch for time formats that require a reference year.
+   * @return Number of strings that could not be converted; 0 on complete success.
+   */
+  size_t fromStrings(const std::vector<simCore::StringView>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear) const;
+
 private:
+  /** Implementation of fromStrings() for std::string and simCore::StringView input */
+  template <typename StringType>
+  size_t fromStrings_(const std::vector<StringType>& timeStrings, std::vector<simCore::TimeStamp>& timeStamps, int referenceYear) const;
+
   /** Maps built-in formatters by simCore::TimeFormat enumeration */
   std::map<int, TimeFormatterPtr> knownFormatters_;
   /** Vector of all registered formatters from foreign sources */
@@ -19,6 +19,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include "simData/DataStore.h"
 #include "simData/DataTable.h"
 
@@ -64,5 +65,14 @@ DataStore::~DataStore()
 {
 }
 
+void DataStore::changedIdList(IdList *ids) const
+{
+  // Without change tracking, any entity may have changed
+  IdList allIds;
+  idList(&allIds);
+  std::sort(allIds.begin(), allIds.end());
+  ids->insert(ids->end(), allIds.begin(), allIds.end());
+}
+
 } // namespace simData
 
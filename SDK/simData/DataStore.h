@@ -389,6 +389,15 @@ public: // methods
   /// Retrieve a list of IDs for all customs associated with a platform
   virtual void customRenderingIdListForHost(ObjectId hostid, IdList *ids) const = 0;
 
+  /**
+   * Retrieve a list of IDs for entities whose update slice, generic data, or category data changed
+   * during the most recent update().  IDs are appended to 'ids' in ascending order.  Entities without
+   * changes are not listed, so the cost of consuming the list is proportional to the number of changed
+   * entities.  The list is not pruned on removal, so it may name entities removed since the last update().
+   * The default implementation, for data stores that do not track changes, lists every entity.
+   */
+  virtual void changedIdList(IdList *ids) const;
+
   /// Retrieves the ObjectType for a particular ID
   virtual simData::ObjectType objectType(ObjectId id) const = 0;
 
@@ -153,6 +153,9 @@ public: // methods
   /// Retrieve a list of IDs for all custom renderings associated with a platform
   virtual void customRenderingIdListForHost(ObjectId hostid, IdList *ids) const {dataStore_->customRenderingIdListForHost(hostid, ids);}
 
+  /// Retrieve a list of IDs for entities whose update slice changed during the most recent update()
+  virtual void changedIdList(IdList *ids) const {dataStore_->changedIdList(ids);}
+
   /// Retrieves the ObjectType for a particular ID
   virtual simData::ObjectType objectType(ObjectId id) const {return dataStore_->objectType(id);}
 
@@ -132,18 +132,28 @@ EntryType* getEntry(ObjectId id, const EntryMapType *store, DataStore::Transacti
 }
 
 /**
- * Update sparse data set slices (GenericData and CategoryData)
+ * Update sparse data set slices (GenericData and CategoryData), appending the IDs of changed slices to 'changedIds'
  */
 template <typename EntryListType>
-void updateSparseSlices(EntryListType& entries, double time)
+void updateSparseSlices(EntryListType& entries, double time, DataStore::IdList& changedIds)
 {
   //for each entry
   for (typename EntryListType::const_iterator i = entries.begin(); i != entries.end(); ++i)
   {
-    i->second->update(time);
+    if (i->second->update(time))
+      changedIds.push_back(i->first);
   }
 }
 
+/**
+ * Appends the ID to 'ids' if the update slice changed (or still holds unprocessed data)
+ */
+void appendIfChanged(ObjectId id, const DataSliceBase& slice, DataStore::IdList& ids)
+{
+  if (slice.hasChanged() || slice.isDirty())
+    ids.push_back(id);
+}
+
 /**
 * Calls flush on any entries found for the specified id in the entity map, as well as the category and generic data maps
 */
@@ -392,6 +402,7 @@ void MemoryDataStore::clear()
     delete it->second;
   genericData_.clear();
   categoryData_.clear();
+  changedIds_.clear();
 
   // clear out the category name manager, since categories are scenario specific data
   categoryNameManager_->clear();
@@ -475,33 +486,38 @@ void MemoryDataStore::updatePlatforms_(double time)
     PlatformEntry* platform = iter->second;
     // apply commands
     platform->commands()->update(this, iter->first, time);
+    updatePlatform_(platform, time, fileMode);
+    appendIfChanged(iter->first, *platform->updates(), changedIds_);
+  }
+}
 
-    if (!platform->preferences()->commonprefs().datadraw())
-    {
-      // until we have datadraw, send NULL; once we have datadraw, we'll immediately update with valid data
-      platform->updates()->setCurrent(NULL);
-      continue;
-    }
+void MemoryDataStore::updatePlatform_(PlatformEntry* platform, double time, bool fileMode)
+{
+  if (!platform->preferences()->commonprefs().datadraw())
+  {
+    // until we have datadraw, send NULL; once we have datadraw, we'll immediately update with valid data
+    platform->updates()->setCurrent(NULL);
+    return;
+  }
 
-    if (fileMode)
+  if (fileMode)
+  {
+    const PlatformUpdateSlice* slice = platform->updates();
+    const double firstTime = slice->firstTime();
+    const bool staticPlatform = (firstTime == -1.0);
+    // do we need to expire a non-static platform?
+    if (!staticPlatform && (time < firstTime || time > slice->lastTime()))
     {
-      const PlatformUpdateSlice* slice = platform->updates();
-      const double firstTime = slice->firstTime();
-      const bool staticPlatform = (firstTime == -1.0);
-      // do we need to expire a non-static platform?
-      if (!staticPlatform && (time < firstTime || time > slice->lastTime()))
-      {
-        // platform is not valid/has expired
-        platform->updates()->setCurrent(NULL);
-        continue;
-      }
+      // platform is not valid/has expired
+      platform->updates()->setCurrent(NULL);
+      return;
     }
-
-    if (isInterpolationEnabled() && platform->preferences()->interpolatepos())
-      platform->updates()->update(time, interpolator_);
-    else
-      platform->updates()->update(time);
   }
+
+  if (isInterpolationEnabled() && platform->preferences()->interpolatepos())
+    platform->updates()->update(time, interpolator_);
+  else
+    platform->updates()->update(time);
 }
 
 void MemoryDataStore::updateTargetBeam_(ObjectId id, BeamEntry* beam, double time)
@@ -586,6 +602,7 @@ void MemoryDataStore::updateBeams_(double time)
       beamEntry->updates()->update(time, interpolator_);
     else
       beamEntry->updates()->update(time);
+    appendIfChanged(iter->first, *beamEntry->updates(), changedIds_);
   }
 }
 
@@ -727,6 +744,7 @@ void MemoryDataStore::updateGates_(double time)
         gateEntry->updates()->setChanged();
       }
     }
+    appendIfChanged(iter->first, *gateEntry->updates(), changedIds_);
   }
 }
 
@@ -746,6 +764,7 @@ void MemoryDataStore::updateLasers_(double time)
       laserEntry->updates()->update(time, interpolator_);
     else
       laserEntry->updates()->update(time);
+    appendIfChanged(iter->first, *laserEntry->updates(), changedIds_);
   }
 }
 
@@ -761,6 +780,7 @@ void MemoryDataStore::updateProjectors_(double time)
       projectorEntry->updates()->update(time, interpolator_);
     else
       projectorEntry->updates()->update(time);
+    appendIfChanged(iter->first, *projectorEntry->updates(), changedIds_);
   }
 }
 
@@ -785,6 +805,7 @@ void MemoryDataStore::updateLobGroups_(double time)
 
     // update the slice
     iter->second->updates()->update(time);
+    appendIfChanged(iter->first, *iter->second->updates(), changedIds_);
   }
 }
 
@@ -795,6 +816,7 @@ void MemoryDataStore::updateCustomRenderings_(double time)
   {
     // apply commands
     iter->second->commands()->update(this, iter->first, time);
+    appendIfChanged(iter->first, *iter->second->updates(), changedIds_);
   }
 }
 
@@ -909,11 +931,13 @@ void MemoryDataStore::update(double time)
   if (!hasChanged_ && time == lastUpdateTime_)
     return;
 
+  // Each entity update records whether the entity changed, so that consumers can skip the unchanged ones
+  changedIds_.clear();
   updatePlatforms_(time);
   updateBeams_(time);
   updateGates_(time);
 
-  updateSparseSlices(genericData_, time);
+  updateSparseSlices(genericData_, time, changedIds_);
 
   // Need to handle recursion so make a local copy
   ListenerList localCopy = listeners_;
@@ -924,6 +948,7 @@ void MemoryDataStore::update(double time)
     // if something changed
     if (i->second->update(time))
     {
+      changedIds_.push_back(i->first);
       // send notification
       const simData::ObjectType ot = objectType(i->first);
 
@@ -943,6 +968,10 @@ void MemoryDataStore::update(double time)
   updateLobGroups_(time);
   updateCustomRenderings_(time);
 
+  // Slice, generic data, and category data changes may name the same entity
+  std::sort(changedIds_.begin(), changedIds_.end());
+  changedIds_.erase(std::unique(changedIds_.begin(), changedIds_.end()), changedIds_.end());
+
   // After all the slice updates, set the new update time and notify observers
   lastUpdateTime_ = time;
   hasChanged_ = false;
@@ -1272,6 +1301,11 @@ void MemoryDataStore::customRenderingIdListForHost(ObjectId hostid, IdList *ids)
   }
 }
 
+void MemoryDataStore::changedIdList(IdList *ids) const
+{
+  ids->insert(ids->end(), changedIds_.begin(), changedIds_.end());
+}
+
 ///Retrieves the ObjectType for a particular ID
 simData::ObjectType MemoryDataStore::objectType(ObjectId id) const
 {
@@ -145,6 +145,9 @@ public:
   /// Retrieve a list of IDs for all customs associated with a platform
   virtual void customRenderingIdListForHost(ObjectId hostid, IdList *ids) const;
 
+  /// Retrieve a list of IDs for entities whose update slice, generic data, or category data changed during the most recent update()
+  virtual void changedIdList(IdList *ids) const;
+
   ///Retrieves the ObjectType for a particular ID
   virtual simData::ObjectType objectType(ObjectId id) const;
 
@@ -590,6 +593,8 @@ private:
 private:
   /// Updates all the platforms
   void updatePlatforms_(double time);
+  /// Updates a single platform; in file mode, platforms outside their data time range expire
+  void updatePlatform_(PlatformEntry* platform, double time, bool fileMode);
   /// Updates a target beam
   void updateTargetBeam_(ObjectId id, BeamEntry* beam, double time);
   /// Updates all the beams
@@ -636,6 +641,7 @@ private:
   ObjectId baseId_;          // Used for unique ID generation
   double   lastUpdateTime_;  // Last time sent to update(double)
   bool     hasChanged_; // has something changed since last update
+  IdList   changedIds_; // entities whose update slice, generic data, or category data changed in the last update, sorted
 
   // interpolation
   bool          interpolationEnabled_;
@@ -22,6 +22,11 @@
 #include <cassert>
 #include <vector>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 
 #include "simNotify/Notify.h"
 #include "simNotify/NotifyHandler.h"
@@ -44,6 +49,345 @@ namespace simNotify
 
     /// This is the last item in the 0 based list of enumerations; possible problem keeping this in sync with the enum
     const unsigned int numLevels_ = simNotify::NOTIFY_DEBUG_FP + 1;
+
+    /** Writes a complete message to the handler, including the handler's prefix */
+    void writeMessage(NotifySeverity severity, NotifyHandler& handler, const std::string& text)
+    {
+      handler.setSeverity(severity);
+      handler.notifyPrefix();
+      handler.notify(text);
+    }
+
+    /** Completed message waiting for the asynchronous writer */
+    struct QueuedMessage
+    {
+      NotifySeverity severity;
+      NotifyHandlerPtr handler;
+      std::string text;
+      std::atomic<QueuedMessage*> next;
+    };
+
+    /**
+     * Lock-free queue with any number of producers and a single consumer.  Producers link
+     * messages at the head with one atomic exchange; the consumer unlinks from the tail.  A
+     * stub node keeps the list non-empty so producers never contend with the consumer.
+     */
+    class MessageQueue
+    {
+    public:
+      MessageQueue()
+        : head_(&stub_),
+          tail_(&stub_)
+      {
+        stub_.next.store(NULL, std::memory_order_relaxed);
+      }
+
+      ~MessageQueue()
+      {
+        QueuedMessage* message = pop();
+        while (message != NULL)
+        {
+          delete message;
+          message = pop();
+        }
+      }
+
+      /** Adds a message; safe from any thread */
+      void push(QueuedMessage* message)
+      {
+        message->next.store(NULL, std::memory_order_relaxed);
+        QueuedMessage* prev = head_.exchange(message, std::memory_order_acq_rel);
+        prev->next.store(message, std::memory_order_release);
+      }
+
+      /** Removes the oldest message, or returns NULL if empty or a push is in progress; consumer thread only */
+      QueuedMessage* pop()
+      {
+        QueuedMessage* tail = tail_;
+        QueuedMessage* next = tail->next.load(std::memory_order_acquire);
+        if (tail == &stub_)
+        {
+          if (next == NULL)
+            return NULL;
+          tail_ = next;
+          tail = next;
+          next = next->next.load(std::memory_order_acquire);
+        }
+        if (next != NULL)
+        {
+          tail_ = next;
+          return tail;
+        }
+        // A producer has exchanged the head but not yet linked it
+        if (tail != head_.load(std::memory_order_acquire))
+          return NULL;
+        // Re-insert the stub so the last message can be unlinked
+        push(&stub_);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next != NULL)
+        {
+          tail_ = next;
+          return tail;
+        }
+        return NULL;
+      }
+
+    private:
+      QueuedMessage stub_;
+      std::atomic<QueuedMessage*> head_;
+      QueuedMessage* tail_;
+    };
+
+    /** Background thread that writes queued messages to their handlers */
+    class AsyncWriter
+    {
+    public:
+      AsyncWriter()
+        : running_(false),
+          stopping_(false),
+          sleeping_(false),
+          submitting_(0),
+          flushWaiting_(0),
+          queued_(0),
+          written_(0),
+          writerId_(std::thread::id())
+      {
+      }
+
+      ~AsyncWriter()
+      {
+        stop();
+      }
+
+      /** Returns true if the background thread is running */
+      bool isRunning() const
+      {
+        return running_.load(std::memory_order_relaxed);
+      }
+
+      /** Starts the background thread */
+      void start()
+      {
+        std::lock_guard<std::mutex> lock(startStopMutex_);
+        if (isRunning())
+          return;
+        stopping_.store(false);
+        thread_ = std::thread(&AsyncWriter::run_, this);
+        running_.store(true);
+      }
+
+      /** Writes all queued messages, then stops the background thread */
+      void stop()
+      {
+        std::lock_guard<std::mutex> lock(startStopMutex_);
+        if (!isRunning())
+          return;
+        stopping_.store(true);
+        wake_();
+        thread_.join();
+        writerId_.store(std::thread::id());
+        // Producers that saw the writer running before stopping_ was set are still queuing; any
+        // producer that starts after this point sees stopping_ and writes synchronously instead
+        while (submitting_.load() != 0)
+          std::this_thread::yield();
+        // Write anything queued by a thread that raced with the shutdown
+        QueuedMessage* message = queue_.pop();
+        while (message != NULL)
+        {
+          writeMessage(message->severity, *message->handler, message->text);
+          delete message;
+          written_.fetch_add(1);
+          message = queue_.pop();
+        }
+        // Only now may new messages bypass the writer, after everything queued before them is written
+        running_.store(false);
+        notifyFlush_();
+      }
+
+      /** Queues the message, or writes it immediately if the background thread is not running */
+      void submit(NotifySeverity severity, const NotifyHandlerPtr& handler, std::string& text)
+      {
+        // A handler that logs while the writer is writing must not queue to itself or wait on a
+        // stop() that is joining this thread
+        if (isWriterThread_())
+        {
+          writeMessage(severity, *handler, text);
+          return;
+        }
+        // Announce the submission before checking stopping_; stop() waits for announced
+        // submissions before its final drain, so no queued message is left behind
+        submitting_.fetch_add(1);
+        if (!isRunning() || stopping_.load())
+        {
+          submitting_.fetch_sub(1);
+          // Wait for any stop in progress so its queued messages are written first
+          if (stopping_.load())
+          {
+            std::lock_guard<std::mutex> lock(startStopMutex_);
+          }
+          writeMessage(severity, *handler, text);
+          return;
+        }
+        QueuedMessage* message = new QueuedMessage;
+        message->severity = severity;
+        message->handler = handler;
+        message->text.swap(text);
+        queued_.fetch_add(1);
+        queue_.push(message);
+        if (sleeping_.load())
+          wake_();
+        submitting_.fetch_sub(1);
+      }
+
+      /** Blocks until all messages queued before the call are written */
+      void flush()
+      {
+        if (!isRunning() || isWriterThread_())
+          return;
+        const uint64_t target = queued_.load();
+        // Announce the wait before checking written_; the writer checks flushWaiting_ after each
+        // write, so one of the two always sees the other
+        flushWaiting_.fetch_add(1);
+        wake_();
+        {
+          std::unique_lock<std::mutex> lock(flushMutex_);
+          while (written_.load() < target && isRunning())
+            flushCondition_.wait(lock);
+        }
+        flushWaiting_.fetch_sub(1);
+      }
+
+    private:
+      /** Background thread loop */
+      void run_()
+      {
+        writerId_.store(std::this_thread::get_id());
+        while (true)
+        {
+          QueuedMessage* message = queue_.pop();
+          if (message != NULL)
+          {
+            writeMessage(message->severity, *message->handler, message->text);
+            delete message;
+            written_.fetch_add(1);
+            if (flushWaiting_.load() != 0)
+              notifyFlush_();
+            continue;
+          }
+
+          // Exit only once every counted message is written
+          if (stopping_.load() && written_.load() == queued_.load())
+            return;
+
+          // Sleep until a producer signals; producers check sleeping_ after queuing, so a
+          // message counted after sleeping_ is set always wakes the thread
+          std::unique_lock<std::mutex> lock(wakeMutex_);
+          sleeping_.store(true);
+          if (written_.load() == queued_.load() && !stopping_.load())
+            wakeCondition_.wait_for(lock, std::chrono::milliseconds(50));
+          sleeping_.store(false);
+        }
+      }
+
+      /** Wakes the background thread */
+      void wake_()
+      {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        wakeCondition_.notify_one();
+      }
+
+      /** Wakes any threads waiting in flush() */
+      void notifyFlush_()
+      {
+        std::lock_guard<std::mutex> lock(flushMutex_);
+        flushCondition_.notify_all();
+      }
+
+      /** Returns true if called from the background thread */
+      bool isWriterThread_() const
+      {
+        return writerId_.load() == std::this_thread::get_id();
+      }
+
+      MessageQueue queue_;
+      std::thread thread_;
+      std::mutex startStopMutex_;
+      std::mutex wakeMutex_;
+      std::condition_variable wakeCondition_;
+      std::mutex flushMutex_;
+      std::condition_variable flushCondition_;
+      std::atomic<bool> running_;
+      std::atomic<bool> stopping_;
+      std::atomic<bool> sleeping_;
+      std::atomic<unsigned int> submitting_;
+      std::atomic<unsigned int> flushWaiting_;
+      std::atomic<uint64_t> queued_;
+      std::atomic<uint64_t> written_;
+      /// Id of the background thread, set by the thread itself; default id when not running
+      std::atomic<std::thread::id> writerId_;
+    };
+
+    /**
+     * Handler returned by notify() in asynchronous mode.  Each thread has its own instance, so
+     * formatting needs no locks.  Text accumulates until a newline, the next message, or thread
+     * exit, then goes to the writer as one message.
+     */
+    class ThreadNotifyHandler : public NotifyHandler
+    {
+    public:
+      ThreadNotifyHandler()
+        : writer_(NULL)
+      {
+      }
+
+      virtual ~ThreadNotifyHandler()
+      {
+        submit();
+      }
+
+      /** Starts a new message, completing any partial message */
+      void begin(AsyncWriter* writer, NotifySeverity severity, const NotifyHandlerPtr& handler)
+      {
+        submit();
+        writer_ = writer;
+        // Avoid contended reference count updates when the handler is unchanged
+        if (handler_ != handler)
+          handler_ = handler;
+        setSeverity(severity);
+      }
+
+      /** Sends any partial message to the writer */
+      void submit()
+      {
+        if (!buffer_.empty() && writer_ != NULL && handler_ != NULL)
+          writer_->submit(severity(), handler_, buffer_);
+        buffer_.clear();
+      }
+
+      /** Prefix is written by the destination handler when the message is written */
+      virtual void notifyPrefix()
+      {
+      }
+
+      virtual void notify(const std::string &message)
+      {
+        buffer_ += message;
+        if (!buffer_.empty() && buffer_[buffer_.size() - 1] == '\n')
+          submit();
+      }
+
+    private:
+      AsyncWriter* writer_;
+      NotifyHandlerPtr handler_;
+      std::string buffer_;
+    };
+
+    /** Returns the calling thread's handler for asynchronous mode */
+    ThreadNotifyHandler& threadNotifyHandler()
+    {
+      static thread_local ThreadNotifyHandler handler;
+      return handler;
+    }
   }
 
   /**
@@ -63,16 +407,22 @@ namespace simNotify
       initNotifyLevel_();
     }
 
-    /** Retrieves the current severity threshold */
+    /** Retrieves the current severity threshold; a single relaxed load so disabled messages cost little */
     NotifySeverity severityLimit() const
     {
-      return severityLimit_;
+      return static_cast<NotifySeverity>(severityLimit_.load(std::memory_order_relaxed));
     }
 
     /** Changes the severity threshold */
     void setSeverityLimit(NotifySeverity severity)
     {
-      severityLimit_ = severity;
+      severityLimit_.store(severity, std::memory_order_relaxed);
+    }
+
+    /** Retrieves the writer for asynchronous mode */
+    AsyncWriter& asyncWriter()
+    {
+      return asyncWriter_;
     }
 
     /** Retrieves the handler for the given severity, never NULL */
@@ -84,6 +434,12 @@ namespace simNotify
       return handlers_[severity];
     }
 
+    /** Retrieves the handler for the given severity without copying the pointer; severity must be valid */
+    const NotifyHandlerPtr& handlerRef(NotifySeverity severity) const
+    {
+      return handlers_[severity];
+    }
+
     /** Changes the handler for a single severity */
     void setHandler(NotifySeverity severity, NotifyHandlerPtr handler)
     {
@@ -108,10 +464,12 @@ namespace simNotify
     }
 
   private:
-    /// Threshold for severity printing
-    NotifySeverity severityLimit_;
+    /// Threshold for severity printing; atomic so that logging threads may read it while it changes
+    std::atomic<int> severityLimit_;
     /// Handler for each severity level
     std::vector<NotifyHandlerPtr> handlers_;
+    /// Background writer for asynchronous mode
+    AsyncWriter asyncWriter_;
 
     /** Initializes the notify level */
     void initNotifyLevel_()
@@ -125,7 +483,7 @@ namespace simNotify
 
       if (SDKNOTIFYLEVEL)
       {
-        severityLimit_ = stringToSeverity(SDKNOTIFYLEVEL);
+        severityLimit_ = static_cast<int>(stringToSeverity(SDKNOTIFYLEVEL));
       }
 
     }
@@ -193,6 +551,16 @@ namespace simNotify
     assert(severity >= simNotify::NOTIFY_ALWAYS && severity <= simNotify::NOTIFY_DEBUG_FP);
     if (isNotifyEnabled(severity))
     {
+      if (notifyContext_->asyncWriter().isRunning() && severity >= simNotify::NOTIFY_ALWAYS && severity <= simNotify::NOTIFY_DEBUG_FP)
+      {
+        const NotifyHandlerPtr& asyncHandler = notifyContext_->handlerRef(severity);
+        if (asyncHandler != NULL && asyncHandler != nullNotifyHandler_)
+        {
+          ThreadNotifyHandler& threadHandler = threadNotifyHandler();
+          threadHandler.begin(&notifyContext_->asyncWriter(), severity, asyncHandler);
+          return threadHandler;
+        }
+      }
       NotifyHandlerPtr handler = notifyContext_->handler(severity);
       if (handler != NULL)
       {
@@ -206,6 +574,29 @@ namespace simNotify
     return *nullNotifyHandler_;
   }
 
+  void setAsynchronousNotify(bool async)
+  {
+    if (async)
+      notifyContext_->asyncWriter().start();
+    else
+    {
+      // Send this thread's partial message before the writer drains
+      threadNotifyHandler().submit();
+      notifyContext_->asyncWriter().stop();
+    }
+  }
+
+  bool asynchronousNotify()
+  {
+    return notifyContext_->asyncWriter().isRunning();
+  }
+
+  void flushNotify()
+  {
+    threadNotifyHandler().submit();
+    notifyContext_->asyncWriter().flush();
+  }
+
   std::string severityToString(NotifySeverity severity)
   {
     switch (severity)
@@ -230,6 +230,41 @@ namespace simNotify
   */
   inline NotifyHandler &notify() { return notify(simNotify::NOTIFY_INFO); }
 
+  /**
+  * @brief Enable or disable asynchronous notification.
+  *
+  * In asynchronous mode, simNotify::notify() returns a handler that belongs to the calling
+  * thread.  Each thread formats its message into its own buffer, so threads may log
+  * concurrently without external locking.  A message is complete when it ends in a newline,
+  * when the thread starts its next message, or when the thread exits.  Completed messages
+  * are queued without locking and written by a background thread, which is the only thread
+  * that calls the installed notification handlers while asynchronous mode is on.  Because
+  * handlers are called from the background thread, messages appear shortly after they are
+  * logged; call flushNotify() when output must be current.
+  *
+  * Disabling asynchronous mode writes all queued messages before returning.  The default is
+  * synchronous notification.
+  *
+  * @param[in ] async true to enable asynchronous notification, false to disable it.
+  */
+  SDKNOTIFY_EXPORT void setAsynchronousNotify(bool async);
+
+  /**
+  * @brief Retrieve whether asynchronous notification is enabled.
+  *
+  * @return true if asynchronous notification is enabled, false otherwise.
+  * @see setAsynchronousNotify
+  */
+  SDKNOTIFY_EXPORT bool asynchronousNotify();
+
+  /**
+  * @brief Write all pending messages.
+  *
+  * Completes the calling thread's partial message, if any, then blocks until every message
+  * queued before the call has been written.  Has no effect in synchronous mode.
+  */
+  SDKNOTIFY_EXPORT void flushNotify();
+
   /**
    * @brief Representative for notification options (opaque).
    *
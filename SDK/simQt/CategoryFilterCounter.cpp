@@ -19,7 +19,10 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cassert>
 #include <QFutureWatcher>
+#include <QThread>
 #include <QtConcurrent/QtConcurrentRun>
 #include "simData/CategoryData/CategoryFilter.h"
 #include "simData/CategoryData/CategoryNameManager.h"
@@ -28,8 +31,51 @@
 
 namespace simQt {
 
+namespace
+{
+  /** Contribution of an entity that fails the checks of two or more names, and is not counted */
+  static const int COUNT_NONE = -2;
+  /** Contribution of an entity that passes all checks, and is counted in every name */
+  static const int COUNT_ALL = -1;
+  /** Fewest entities worth counting in a separate range */
+  static const size_t MIN_RANGE_SIZE = 4096;
+}
+
+/** Counts for a range [begin,end) of entities, indexed by name and slot */
+struct CategoryFilterCounter::CountRange
+{
+  size_t begin;
+  size_t end;
+  std::vector<std::vector<size_t> > counts;
+};
+
+/** Computes the contribution of each entity in a range, and accumulates the range's counts */
+class CategoryFilterCounter::RangeCounter
+{
+public:
+  explicit RangeCounter(CategoryFilterCounter* counter)
+    : counter_(counter)
+  {
+  }
+
+  void count(CountRange* range) const
+  {
+    // Ranges do not overlap, so each writes to distinct contributions
+    for (size_t k = range->begin; k < range->end; ++k)
+    {
+      const int contribution = counter_->contribution_(k);
+      counter_->contributions_[k] = contribution;
+      counter_->applyContribution_(k, contribution, range->counts, true);
+    }
+  }
+
+private:
+  CategoryFilterCounter* counter_;
+};
+
 CategoryFilterCounter::CategoryFilterCounter(QObject* parent)
   : QObject(parent),
+    countsValid_(false),
     dirtyFlag_(false)
 {
 }
@@ -44,15 +90,18 @@ void CategoryFilterCounter::prepare()
   // Set up initial state
   allEntities_.clear();
   results_.allCategories.clear();
-  if (!filter_)
-    return;
-  const simData::DataStore* ds = filter_->getDataStore();
+  countsValid_ = false;
+  const simData::DataStore* ds = (filter_ ? filter_->getDataStore() : NULL);
   if (!ds)
+  {
+    packAll_();
     return;
+  }
 
   // Make a copy of all the current category data
   std::vector<simData::ObjectId> ids;
   idList_(ids);
+  allEntities_.reserve(ids.size());
   for (auto i = ids.begin(); i != ids.end(); ++i)
   {
     IdAndCategories entry;
@@ -81,6 +130,8 @@ void CategoryFilterCounter::prepare()
     // Save the count map
     results_.allCategories[nameInt] = countMap;
   }
+
+  packAll_();
 }
 
 void CategoryFilterCounter::setFilter(const simData::CategoryFilter& filter)
@@ -107,65 +158,290 @@ void CategoryFilterCounter::testAllCategories()
   // prepare() should turn off the dirty flag
   assert(!dirtyFlag_);
 
-  // Test every category we know about
-  for (auto i = results_.allCategories.begin(); i != results_.allCategories.end(); ++i)
-    testCategory_(i->first, i->second);
+  buildPassTables_();
+
+  // Split the entities into ranges, and count each range in parallel
+  const size_t numEntities = allEntities_.size();
+  const size_t numRanges = std::max<size_t>(1, std::min<size_t>(std::max(1, QThread::idealThreadCount()), numEntities / MIN_RANGE_SIZE));
+  std::vector<CountRange> ranges(numRanges);
+  for (size_t r = 0; r < numRanges; ++r)
+  {
+    ranges[r].begin = numEntities * r / numRanges;
+    ranges[r].end = numEntities * (r + 1) / numRanges;
+    ranges[r].counts.resize(nameInts_.size());
+    for (size_t n = 0; n < nameInts_.size(); ++n)
+      ranges[r].counts[n].assign(slotValues_[n].size(), 0);
+  }
+  contributions_.assign(numEntities, COUNT_NONE);
+  const RangeCounter rangeCounter(this);
+  std::vector<QFuture<void> > futures;
+  for (size_t r = 1; r < numRanges; ++r)
+    futures.push_back(QtConcurrent::run(&rangeCounter, &RangeCounter::count, &ranges[r]));
+  // Count the first range in this thread while the others run in the pool
+  rangeCounter.count(&ranges.front());
+  for (auto i = futures.begin(); i != futures.end(); ++i)
+    i->waitForFinished();
+
+  // Merge the range counts
+  counts_.swap(ranges.front().counts);
+  for (size_t r = 1; r < numRanges; ++r)
+  {
+    for (size_t n = 0; n < counts_.size(); ++n)
+    {
+      for (size_t slot = 0; slot < counts_[n].size(); ++slot)
+        counts_[n][slot] += ranges[r].counts[n][slot];
+    }
+  }
+  countsValid_ = true;
+
+  publishCounts_();
   emit resultsReady(results_);
 }
 
+bool CategoryFilterCounter::updateEntities(const std::vector<simData::ObjectId>& ids)
+{
+  const simData::DataStore* ds = (filter_ ? filter_->getDataStore() : NULL);
+  if (dirtyFlag_ || !countsValid_ || !ds)
+  {
+    dirtyFlag_ = true;
+    return false;
+  }
+
+  const size_t numNames = nameInts_.size();
+  for (auto i = ids.begin(); i != ids.end(); ++i)
+  {
+    auto indexIter = entityIndex_.find(*i);
+    const bool exists = (ds->objectType(*i) != simData::NONE);
+    if (indexIter == entityIndex_.end())
+    {
+      if (!exists)
+        continue;
+      // New entity; append it
+      const size_t index = allEntities_.size();
+      IdAndCategories entry;
+      entry.id = *i;
+      allEntities_.push_back(entry);
+      entityIndex_[*i] = index;
+      packedSlots_.resize(packedSlots_.size() + numNames, 0);
+      contributions_.push_back(COUNT_NONE);
+      if (residualFilter_)
+        residualPasses_.push_back(0);
+      indexIter = entityIndex_.find(*i);
+    }
+
+    // Remove the old contribution
+    const size_t index = indexIter->second;
+    applyContribution_(index, contributions_[index], counts_, false);
+    contributions_[index] = COUNT_NONE;
+
+    if (!exists)
+    {
+      // Removed entity; move the last entity into its place
+      const size_t last = allEntities_.size() - 1;
+      entityIndex_.erase(indexIter);
+      if (index != last)
+      {
+        allEntities_[index] = allEntities_[last];
+        entityIndex_[allEntities_[index].id] = index;
+        std::copy(packedSlots_.begin() + last * numNames, packedSlots_.begin() + (last + 1) * numNames, packedSlots_.begin() + index * numNames);
+        contributions_[index] = contributions_[last];
+        if (residualFilter_)
+          residualPasses_[index] = residualPasses_[last];
+      }
+      allEntities_.pop_back();
+      packedSlots_.resize(last * numNames);
+      contributions_.pop_back();
+      if (residualFilter_)
+        residualPasses_.pop_back();
+      continue;
+    }
+
+    // Re-read the category data; a value without a slot means the pass tables are out of date
+    IdAndCategories& entry = allEntities_[index];
+    simData::CategoryFilter::getCurrentCategoryValues(*ds, entry.id, entry.categories);
+    if (!packEntity_(index))
+    {
+      // Counts are partially updated; the next full count prepares everything again
+      dirtyFlag_ = true;
+      countsValid_ = false;
+      return false;
+    }
+    if (residualFilter_)
+      residualPasses_[index] = (residualFilter_->matchData(entry.categories) ? 1 : 0);
+
+    // Add the new contribution
+    contributions_[index] = contribution_(index);
+    applyContribution_(index, contributions_[index], counts_, true);
+  }
+
+  publishCounts_();
+  emit resultsReady(results_);
+  return true;
+}
+
 const CategoryCountResults& CategoryFilterCounter::results() const
 {
   return results_;
 }
 
-// Inside thread (protected)
-void CategoryFilterCounter::filteredIds_(int ignoreNameInt, std::vector<const IdAndCategories*>& ids) const
+void CategoryFilterCounter::packAll_()
 {
-  simData::CategoryFilter baseFilter(*filter_);
-  baseFilter.removeName(ignoreNameInt);
+  nameInts_.clear();
+  valueSlots_.clear();
+  slotValues_.clear();
+  reportedSlots_.clear();
+  entityIndex_.clear();
+
+  // Values known to results_ are given the first slots, so reported slots are [0,reportedSlots_)
+  for (auto i = results_.allCategories.begin(); i != results_.allCategories.end(); ++i)
+  {
+    nameInts_.push_back(i->first);
+    valueSlots_.push_back(std::map<int, int>());
+    slotValues_.push_back(std::vector<int>());
+    for (auto vi = i->second.begin(); vi != i->second.end(); ++vi)
+      slotFor_(nameInts_.size() - 1, vi->first);
+    reportedSlots_.push_back(static_cast<int>(slotValues_.back().size()));
+  }
 
-  // Find all IDs that match the new filter without the name provided
-  for (auto idIter = allEntities_.begin(); idIter != allEntities_.end(); ++idIter)
+  packedSlots_.assign(allEntities_.size() * nameInts_.size(), 0);
+  for (size_t k = 0; k < allEntities_.size(); ++k)
+  {
+    entityIndex_[allEntities_[k].id] = k;
+    packEntity_(k);
+  }
+}
+
+bool CategoryFilterCounter::packEntity_(size_t index)
+{
+  const size_t numNames = nameInts_.size();
+  const simData::CategoryFilter::CurrentCategoryValues& categories = allEntities_[index].categories;
+  bool allKnown = true;
+  for (size_t n = 0; n < numNames; ++n)
   {
-    if (baseFilter.matchData(idIter->categories))
-      ids.push_back(&(*idIter));
+    auto valueIter = categories.find(nameInts_[n]);
+    const int valueInt = (valueIter == categories.end() ? simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME : valueIter->second);
+    const size_t numSlots = slotValues_[n].size();
+    packedSlots_[index * numNames + n] = slotFor_(n, valueInt);
+    if (slotValues_[n].size() != numSlots)
+      allKnown = false;
   }
+  return allKnown;
+}
+
+int CategoryFilterCounter::slotFor_(size_t nameIndex, int valueInt)
+{
+  std::map<int, int>& slots = valueSlots_[nameIndex];
+  auto slotIter = slots.find(valueInt);
+  if (slotIter != slots.end())
+    return slotIter->second;
+  const int slot = static_cast<int>(slotValues_[nameIndex].size());
+  slots[valueInt] = slot;
+  slotValues_[nameIndex].push_back(valueInt);
+  return slot;
 }
 
 // Inside thread (protected)
-void CategoryFilterCounter::testCategory_(int nameInt, CategoryCountResults::ValueToCountMap& countMap)
+void CategoryFilterCounter::buildPassTables_()
 {
-  // Start out by not testing anything in this filter
-  simData::CategoryFilter baseFilter(*filter_);
-  baseFilter.removeName(nameInt);
+  passes_.clear();
+  residualPasses_.clear();
+  residualFilter_.reset();
+  if (!filter_)
+    return;
+  simData::DataStore* ds = filter_->getDataStore();
+  std::vector<int> filterNames;
+  filter_->getNames(filterNames);
 
-  // Get all IDs that match the filter excluding this name
-  std::vector<const IdAndCategories*> idDataVec;
-  filteredIds_(nameInt, idDataVec);
+  // Evaluate each name's check alone, once per distinct value
+  passes_.resize(nameInts_.size());
+  for (size_t n = 0; n < nameInts_.size(); ++n)
+  {
+    const int nameInt = nameInts_[n];
+    passes_[n].assign(slotValues_[n].size(), 1);
+    if (!filter_->nameContributesToFilter(nameInt))
+      continue;
+
+    // Avoid copy constructor, which could add a listener
+    simData::CategoryFilter nameFilter(ds);
+    nameFilter.assign(*filter_, false);
+    for (auto i = filterNames.begin(); i != filterNames.end(); ++i)
+    {
+      if (*i != nameInt)
+        nameFilter.removeName(*i);
+    }
+    for (size_t slot = 0; slot < slotValues_[n].size(); ++slot)
+    {
+      simData::CategoryFilter::CurrentCategoryValues values;
+      if (slotValues_[n][slot] != simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME)
+        values[nameInt] = slotValues_[n][slot];
+      passes_[n][slot] = (nameFilter.matchData(values) ? 1 : 0);
+    }
+  }
 
-  // Loop through each value in this category.  If the platform matches, add it
-  for (auto vi = countMap.begin(); vi != countMap.end(); ++vi)
+  // Names in the filter that are not in results_ are never counted, but still filter out entities
+  residualFilter_.reset(new simData::CategoryFilter(ds));
+  residualFilter_->assign(*filter_, false);
+  for (auto i = nameInts_.begin(); i != nameInts_.end(); ++i)
+    residualFilter_->removeName(*i);
+  if (residualFilter_->isEmpty())
   {
-    // Test what happens when this filter value is turned on
-    baseFilter.setValue(nameInt, vi->first, true);
-    size_t& numMatches = vi->second;
-    // Assertion failure means the prepare() missed a category value
-    assert(numMatches == 0);
+    residualFilter_.reset();
+    return;
+  }
+  residualPasses_.resize(allEntities_.size());
+  for (size_t k = 0; k < allEntities_.size(); ++k)
+    residualPasses_[k] = (residualFilter_->matchData(allEntities_[k].categories) ? 1 : 0);
+}
 
-    // Loop through each entity of interest
-    for (auto idIter = idDataVec.begin(); idIter != idDataVec.end(); ++idIter)
-    {
-      const IdAndCategories& idData = **idIter;
-      const simData::ObjectId& id = idData.id;
+// Inside thread (protected)
+int CategoryFilterCounter::contribution_(size_t index) const
+{
+  if (residualFilter_ && !residualPasses_[index])
+    return COUNT_NONE;
+
+  // An entity with a single failing name counts only toward that name's values
+  const size_t numNames = nameInts_.size();
+  const int* slots = (numNames == 0 ? NULL : &packedSlots_[index * numNames]);
+  int rv = COUNT_ALL;
+  for (size_t n = 0; n < numNames; ++n)
+  {
+    if (passes_[n][slots[n]])
+      continue;
+    if (rv != COUNT_ALL)
+      return COUNT_NONE;
+    rv = static_cast<int>(n);
+  }
+  return rv;
+}
 
-      // Test the value and increment if it matches
-      const bool matches = baseFilter.matchData(idData.categories);
-      if (matches)
-        ++vi->second;
-    }
+// Inside thread (protected)
+void CategoryFilterCounter::applyContribution_(size_t index, int contribution, std::vector<std::vector<size_t> >& counts, bool add) const
+{
+  if (contribution == COUNT_NONE)
+    return;
+  const size_t numNames = nameInts_.size();
+  const size_t beginName = (contribution == COUNT_ALL ? 0 : static_cast<size_t>(contribution));
+  const size_t endName = (contribution == COUNT_ALL ? numNames : beginName + 1);
+  for (size_t n = beginName; n < endName; ++n)
+  {
+    const int slot = packedSlots_[index * numNames + n];
+    // Values unknown to results_ are not reported
+    if (slot >= reportedSlots_[n])
+      continue;
+    if (add)
+      ++counts[n][slot];
+    else
+      --counts[n][slot];
+  }
+}
 
-    // Turn that value back off.  removeName()
-    baseFilter.setValue(nameInt, vi->first, false);
+void CategoryFilterCounter::publishCounts_()
+{
+  for (size_t n = 0; n < nameInts_.size(); ++n)
+  {
+    CategoryCountResults::ValueToCountMap& countMap = results_.allCategories[nameInts_[n]];
+    for (int slot = 0; slot < reportedSlots_[n]; ++slot)
+      countMap[slotValues_[n][slot]] = counts_[n][slot];
   }
 }
 
@@ -173,13 +449,17 @@ void CategoryFilterCounter::testCategory_(int nameInt, CategoryCountResults::Val
 
 AsyncCategoryCounter::AsyncCategoryCounter(QObject* parent)
   : QObject(parent),
-    counter_(NULL),
+    counter_(new CategoryFilterCounter),
+    counting_(false),
+    counted_(false),
     retestPending_(false)
 {
 }
 
 AsyncCategoryCounter::~AsyncCategoryCounter()
 {
+  // The background thread uses counter_
+  future_.waitForFinished();
 }
 
 void AsyncCategoryCounter::setFilter(const simData::CategoryFilter& filter)
@@ -191,7 +471,7 @@ void AsyncCategoryCounter::setFilter(const simData::CategoryFilter& filter)
 
 void AsyncCategoryCounter::asyncCountEntities()
 {
-  if (counter_ != NULL)
+  if (counting_)
   {
     retestPending_ = true;
     return;
@@ -199,11 +479,14 @@ void AsyncCategoryCounter::asyncCountEntities()
 
   // Turn off the retest flag
   retestPending_ = false;
+  // The full count sees every change made before it starts
+  changedIds_.clear();
+  counting_ = true;
 
   // Create a watcher that will tell us when the task is complete
   QFutureWatcher<void>* watcher = new QFutureWatcher<void>();
 
-  counter_ = new CategoryFilterCounter(watcher);
+  // Setting the filter marks the counter dirty, so prepare() reads all entities again
   if (nextFilter_ != NULL)
     counter_->setFilter(*nextFilter_);
   counter_->prepare();
@@ -213,21 +496,53 @@ void AsyncCategoryCounter::asyncCountEntities()
   // To prevent race conditions use deleteLater() instead of Qt parents to manage lifespan
   connect(watcher, SIGNAL(finished()), watcher, SLOT(deleteLater()));
 
-  watcher->setFuture(QtConcurrent::run(counter_, &CategoryFilterCounter::testAllCategories));
+  future_ = QtConcurrent::run(counter_.get(), &CategoryFilterCounter::testAllCategories);
+  watcher->setFuture(future_);
+}
+
+void AsyncCategoryCounter::updateEntities(const std::vector<simData::ObjectId>& ids)
+{
+  changedIds_.insert(ids.begin(), ids.end());
+  // Changes made during a count are applied when it finishes
+  if (counting_)
+    return;
+  if (!counted_)
+  {
+    asyncCountEntities();
+    return;
+  }
+  applyChangedIds_();
+}
+
+void AsyncCategoryCounter::applyChangedIds_()
+{
+  if (changedIds_.empty())
+    return;
+  const std::vector<simData::ObjectId> ids(changedIds_.begin(), changedIds_.end());
+  changedIds_.clear();
+  // Recounting everything is too slow for this thread, so do it in the background
+  if (!counter_->updateEntities(ids))
+  {
+    asyncCountEntities();
+    return;
+  }
+  lastResults_ = counter_->results();
+  emit resultsReady(lastResults_);
 }
 
 void AsyncCategoryCounter::emitResults_()
 {
   // This call happens in the main thread and is the "join" for the job
+  counting_ = false;
+  counted_ = true;
   lastResults_ = counter_->results();
   emit resultsReady(lastResults_);
 
-  // just set to NULL, the deleteLater() for watcher will do the actual delete
-  counter_ = NULL;
-
   // Retest now that it's safe to do so
   if (retestPending_)
     asyncCountEntities();
+  else
+    applyChangedIds_();
 }
 
 const simQt::CategoryCountResults& AsyncCategoryCounter::lastResults() const
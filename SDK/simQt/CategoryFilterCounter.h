@@ -24,7 +24,9 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
+#include <QFuture>
 #include <QObject>
 #include "simCore/Common/Export.h"
 #include "simData/ObjectId.h"
@@ -49,8 +51,10 @@ struct CategoryCountResults
  * given filter.  This is intended to give a runtime count of the number of entities that will
  * be impacted by clicking a category value line in a category tree widget.
  *
- * Note that this algorithm is O(m * n), scaling both on the number of entities (m) and the
- * total number of category values (n).
+ * Category names combine with Boolean AND, so an entity counts toward a value in category N
+ * exactly when it has that value and fails no category check other than N.  Each name's check
+ * is evaluated once per distinct value into a table, then every entity is visited once, in
+ * parallel across ranges of entities.  The cost is O(m * k) for m entities and k names.
  */
 class SDKQT_EXPORT CategoryFilterCounter : public QObject
 {
@@ -84,6 +88,16 @@ public slots:
    */
   void testAllCategories();
 
+  /**
+   * Recounts after the category data of the given entities changes, or after they are added to or
+   * removed from the data store, without revisiting other entities.  Like prepare(), this must be
+   * called in the data store's thread.  Emits resultsReady() when done.
+   * @return true if the entities were counted; false if a full count is needed instead, because
+   *   the filter changed, there are no counts yet, or an entity has a value not seen before.  In
+   *   that case results() is unchanged and the caller should run testAllCategories().
+   */
+  bool updateEntities(const std::vector<simData::ObjectId>& ids);
+
 signals:
   /** Called when testAllCategories() is completed. */
   void resultsReady(const simQt::CategoryCountResults& results);
@@ -96,19 +110,59 @@ private:
     simData::CategoryFilter::CurrentCategoryValues categories;
   };
 
+  /** Counts for one range of entities; ranges are counted in parallel */
+  struct CountRange;
+  /** Counts ranges, possibly in a thread pool */
+  class RangeCounter;
+
   /**
    * Retrieves the list of IDs out of the data store.  This is called in prepare() and is not thread
    * safe with regards to interactions with the data store.
    */
   void idList_(std::vector<simData::ObjectId>& ids) const;
 
-  /** Returns a list of ID+Categories that matches filter_.  Thread safe. */
-  void filteredIds_(int ignoreNameInt, std::vector<const IdAndCategories*>& ids) const;
-  /** Tests an individual category and sets the counts for that category */
-  void testCategory_(int nameInt, CategoryCountResults::ValueToCountMap& countMap);
+  /** Assigns value slots for all names in results_ and packs every entity */
+  void packAll_();
+  /** Fills in the slots of the entity at the given index; returns false if a new slot was needed */
+  bool packEntity_(size_t index);
+  /** Returns the slot for the value in the given name, adding a slot if needed */
+  int slotFor_(size_t nameIndex, int valueInt);
+  /** Evaluates each name's check for each slot, and the filter's checks on names not in results_ */
+  void buildPassTables_();
+  /** Returns what the entity at the given index contributes: COUNT_NONE, COUNT_ALL, or the only counted name index */
+  int contribution_(size_t index) const;
+  /** Adds (or subtracts) the contribution of the entity at the given index to the counts by name and slot */
+  void applyContribution_(size_t index, int contribution, std::vector<std::vector<size_t> >& counts, bool add) const;
+  /** Copies counts_ into results_ */
+  void publishCounts_();
 
   /** Stores all entity IDs and their current category values. */
   std::vector<IdAndCategories> allEntities_;
+  /** Maps entity ID to index in allEntities_ */
+  std::map<simData::ObjectId, size_t> entityIndex_;
+  /** Name ints in the order of results_ */
+  std::vector<int> nameInts_;
+  /** Per name, maps value int to slot */
+  std::vector<std::map<int, int> > valueSlots_;
+  /** Per name, value int of each slot; slots past the results_ values are not reported */
+  std::vector<std::vector<int> > slotValues_;
+  /** Per name, number of slots reported in results_ */
+  std::vector<int> reportedSlots_;
+  /** Slot of each entity for each name, indexed by entity * nameInts_.size() + name */
+  std::vector<int> packedSlots_;
+  /** Per name and slot, non-zero if that name's check passes */
+  std::vector<std::vector<char> > passes_;
+  /** Per entity, non-zero if the entity passes the filter's checks on names not in results_ */
+  std::vector<char> residualPasses_;
+  /** Filter checks on names not in results_, or NULL if there are none */
+  std::unique_ptr<simData::CategoryFilter> residualFilter_;
+  /** Per entity, the contribution applied to counts_ */
+  std::vector<int> contributions_;
+  /** Per name and slot, the number of entities counted */
+  std::vector<std::vector<size_t> > counts_;
+  /** True when counts_ reflects the current filter and entities */
+  bool countsValid_;
+
   /** Map of category name, to map of category value to count. */
   CategoryCountResults results_;
   /** Current filter supplied by end user. */
@@ -121,7 +175,8 @@ private:
  * Asynchronous implementation of a category counter.  Since CategoryFilterCounter is potentially
  * expensive, it can be advantageous to perform the calculations in the background.  This
  * implementation ensures that the counter only runs one at a time, and additional calls are
- * queued up for execution once the first execution finishes.
+ * queued up for execution once the first execution finishes.  The same counter is kept across
+ * runs, so that changes to a few entities are counted incrementally with updateEntities().
  */
 class SDKQT_EXPORT AsyncCategoryCounter : public QObject
 {
@@ -130,6 +185,7 @@ public:
   /** Default constructor */
   explicit AsyncCategoryCounter(QObject* parent = NULL);
 
+  /** Waits for any count in progress */
   virtual ~AsyncCategoryCounter();
 
   /** Retrieves the last fully executed results. */
@@ -152,18 +208,39 @@ public slots:
    */
   void asyncCountEntities();
 
+  /**
+   * Recounts after the category data of the given entities changes, or after they are added to or
+   * removed from the data store.  Only the given entities are revisited, in the calling thread, and
+   * resultsReady() is emitted before returning.  If a count is ongoing in the background, the
+   * entities are recounted once it finishes.  Before the first full count, or if an entity has a
+   * value not seen before, this starts a background count instead.  Must be called in the data
+   * store's thread.
+   */
+  void updateEntities(const std::vector<simData::ObjectId>& ids);
+
 signals:
   /** Indicates that the asynchronous operation from testAsync() has completed. */
   void resultsReady(const simQt::CategoryCountResults& results);
 
 private slots:
-  /** Captures the results from counter_, clears the future watcher, emits results, and restarts if needed. */
+  /** Captures the results from counter_, emits results, and restarts or applies changed entities if needed. */
   void emitResults_();
 
 private:
+  /** Recounts the entities in changedIds_ with counter_, and emits the results */
+  void applyChangedIds_();
+
   simQt::CategoryCountResults lastResults_;
-  CategoryFilterCounter* counter_;
+  /** Counter kept across runs; only used by the background thread while counting_ is true */
+  std::unique_ptr<CategoryFilterCounter> counter_;
+  /** Background count in progress, if any */
+  QFuture<void> future_;
   std::unique_ptr<simData::CategoryFilter> nextFilter_;
+  /** Entities changed since the last count that started */
+  std::set<simData::ObjectId> changedIds_;
+  bool counting_;
+  /** True once counter_ holds the results of a full count */
+  bool counted_;
   bool retestPending_;
 };
 
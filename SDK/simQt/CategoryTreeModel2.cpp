@@ -1795,19 +1795,28 @@ public:
   virtual void onAddEntity(simData::DataStore *source, simData::ObjectId newId, simData::ObjectType ot)
   {
     parent_.countDirty_ = true;
+    parent_.changedIds_.push_back(newId);
   }
   virtual void onRemoveEntity(simData::DataStore *source, simData::ObjectId newId, simData::ObjectType ot)
   {
     parent_.countDirty_ = true;
+    parent_.changedIds_.push_back(newId);
   }
   virtual void onCategoryDataChange(simData::DataStore *source, simData::ObjectId changedId, simData::ObjectType ot)
   {
     parent_.countDirty_ = true;
+    parent_.changedIds_.push_back(changedId);
+  }
+  virtual void onScenarioDelete(simData::DataStore* source)
+  {
+    // Entities go away without individual removal notices
+    parent_.countDirty_ = true;
+    parent_.recountAll_ = true;
+    parent_.changedIds_.clear();
   }
 
   // Fulfill the interface
   virtual void onNameChange(simData::DataStore *source, simData::ObjectId changeId) {}
-  virtual void onScenarioDelete(simData::DataStore* source) {}
   virtual void onPrefsChange(simData::DataStore *source, simData::ObjectId id) {}
   virtual void onTimeChange(simData::DataStore *source) {}
   virtual void onFlush(simData::DataStore* source, simData::ObjectId id) {}
@@ -1824,7 +1833,8 @@ CategoryFilterWidget2::CategoryFilterWidget2(QWidget* parent)
     showEntityCount_(false),
     counter_(NULL),
     setRegExpAction_(NULL),
-    countDirty_(true)
+    countDirty_(true),
+    recountAll_(true)
 {
   setWindowTitle("Category Data Filter");
   setObjectName("CategoryFilterWidget2");
@@ -2183,9 +2193,17 @@ void CategoryFilterWidget2::recountCategories_()
 {
   if (countDirty_)
   {
+    // Only the changed entities need recounting, unless the whole scenario changed
     if (showEntityCount_ && counter_)
-      counter_->asyncCountEntities();
+    {
+      if (recountAll_)
+        counter_->asyncCountEntities();
+      else
+        counter_->updateEntities(changedIds_);
+    }
+    changedIds_.clear();
     countDirty_ = false;
+    recountAll_ = false;
   }
 }
 
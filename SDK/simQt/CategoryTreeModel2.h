@@ -283,7 +283,7 @@ private slots:
   void toggleLockCategory_();
   /** Expands all unlocked categories */
   void expandUnlockedCategories_();
-  /** Start a recount of the category values if countDirty_ is true */
+  /** Start a recount of the changed entities' category values if countDirty_ is true */
   void recountCategories_();
 
 private:
@@ -311,6 +311,10 @@ private:
   std::shared_ptr<DataStoreListener> dsListener_;
   /** If true then the category counts need to be redone */
   bool countDirty_;
+  /** Entities added, removed, or with changed category data since the last recount */
+  std::vector<simData::ObjectId> changedIds_;
+  /** If true then every entity needs recounting, not just changedIds_ */
+  bool recountAll_;
 };
 
 }
@@ -19,6 +19,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <cassert>
 #include <QDateTime>
 #include <QColor>
@@ -100,6 +101,24 @@ const QString ConsoleDataModel::DEFAULT_TIME_FORMAT = "M/d/yy h:mm:ss.zzz";
 static const int DEFAULT_MAX_LINES_SIZE = 1000;
 static const int PROCESS_PENDING_TIMEOUT = 250; // milliseconds between processing of pending data
 
+/** Matches entries that are less severe than the minimum severity */
+class SeverityExceeds
+{
+public:
+  explicit SeverityExceeds(simNotify::NotifySeverity minSeverity)
+    : minSeverity_(minSeverity)
+  {
+  }
+
+  bool operator()(const ConsoleDataModel::ConsoleEntry& entry) const
+  {
+    return entry.severity > minSeverity_;
+  }
+
+private:
+  simNotify::NotifySeverity minSeverity_;
+};
+
 ConsoleDataModel::ConsoleDataModel(QObject* parent)
   : QAbstractItemModel(parent),
     newestOnTop_(false),
@@ -107,6 +126,8 @@ ConsoleDataModel::ConsoleDataModel(QObject* parent)
     numLines_(DEFAULT_MAX_LINES_SIZE),
     spamFilterTimeout_(5.0),
     minSeverity_(simNotify::NOTIFY_INFO),
+    linesHead_(0),
+    linesCount_(0),
     timeFormatString_(DEFAULT_TIME_FORMAT),
     pendingTimer_(new QTimer)
 {
@@ -119,8 +140,6 @@ ConsoleDataModel::ConsoleDataModel(QObject* parent)
 ConsoleDataModel::~ConsoleDataModel()
 {
   delete pendingTimer_;
-  qDeleteAll(lines_);
-  qDeleteAll(pendingLines_);
   Q_FOREACH(ConsoleChannelPtr ptr, channels_.values())
   {
     ChannelImpl* impl = dynamic_cast<ChannelImpl*>(ptr.get());
@@ -140,12 +159,9 @@ QString ConsoleDataModel::dateTimeString(double timeSince1970)
 
 QVariant ConsoleDataModel::data(const QModelIndex& idx, int role) const
 {
-  if (!idx.isValid() || idx.parent().isValid())
-    return QVariant();
-  LineEntry* line = static_cast<LineEntry*>(idx.internalPointer());
-  assert(line);
-  if (line == NULL)
+  if (!idx.isValid() || idx.parent().isValid() || idx.row() >= linesCount_)
     return QVariant();
+  const ConsoleEntry& line = lineAt_(idx.row());
 
   switch (role)
   {
@@ -154,26 +170,26 @@ QVariant ConsoleDataModel::data(const QModelIndex& idx, int role) const
     {
     case COLUMN_TIME:
     {
-      QDateTime date = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(line->timeStamp() * 1000)).toUTC();
+      QDateTime date = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(line.time * 1000)).toUTC();
       return date.toString(timeFormatString_);
     }
     case COLUMN_SEVERITY:
-      return QString::fromStdString(simNotify::severityToString(line->severity()));
+      return QString::fromStdString(simNotify::severityToString(line.severity));
     case COLUMN_CATEGORY:
-      return line->channel();
+      return line.channel;
     case COLUMN_TEXT:
-      return line->text();
+      return line.text;
     }
     break;
 
   case ConsoleDataModel::SEVERITY_ROLE:
-    return line->severity();
+    return line.severity;
 
   case Qt::ForegroundRole:
     // Colorization is optional
     if (!colorizeText_)
       break;
-    return colorForSeverity_(line->severity());
+    return colorForSeverity_(line.severity);
   }
   return QVariant();
 }
@@ -236,7 +252,7 @@ int ConsoleDataModel::rowCount(const QModelIndex &parent) const
 {
   if (parent.isValid())
     return 0;
-  return lines_.count();
+  return linesCount_;
 }
 
 QModelIndex ConsoleDataModel::parent(const QModelIndex &child) const
@@ -249,13 +265,64 @@ QModelIndex ConsoleDataModel::index(int row, int column, const QModelIndex &pare
   // Error check validity
   if (!hasIndex(row, column, parent))
     return QModelIndex();
+  // Ring buffer slots are reused, so indices only carry the row
+  return createIndex(row, column);
+}
+
+const ConsoleDataModel::ConsoleEntry& ConsoleDataModel::lineAt_(int row) const
+{
+  // Reverse it if newest is on top
+  const int age = (newestOnTop() ? linesCount_ - row - 1 : row);
+  assert(age >= 0 && age < linesCount_);
+  return lines_[(linesHead_ + age) % lines_.size()];
+}
+
+void ConsoleDataModel::pushLine_(const ConsoleEntry& entry)
+{
+  assert(linesCount_ < simCore::sdkMax(1, numLines()));
+  // Grow the storage until it holds numLines(); after that, slots are reused
+  if (linesCount_ == static_cast<int>(lines_.size()))
+  {
+    linearizeLines_();
+    lines_.push_back(entry);
+  }
+  else
+    lines_[(linesHead_ + linesCount_) % lines_.size()] = entry;
+  ++linesCount_;
+}
 
-  // Pull out list entry
-  int indexInLines = row;
-  if (newestOnTop()) // Reverse it if newest is on top
-    indexInLines = lines_.size() - row - 1;
-  LineEntry* entry = lines_[indexInLines];
-  return createIndex(row, column, entry);
+void ConsoleDataModel::removeOldestLines_(int numToRemove)
+{
+  numToRemove = simCore::sdkMin(numToRemove, linesCount_);
+  if (numToRemove <= 0)
+    return;
+
+  // Line removal location is based on what observers see, so if newest is on top (true), remove from bottom
+  if (newestOnTop())
+    beginRemoveRows(QModelIndex(), linesCount_ - numToRemove, linesCount_ - 1);
+  else
+    beginRemoveRows(QModelIndex(), 0, numToRemove - 1);
+  // Release the text of the removed lines; the slots are reused
+  for (int k = 0; k < numToRemove; ++k)
+  {
+    ConsoleEntry& line = lines_[(linesHead_ + k) % lines_.size()];
+    // Lines no longer shown no longer suppress repeats of their text
+    forgetRecentLine_(line);
+    line.channel.clear();
+    line.text.clear();
+  }
+  linesHead_ = (linesHead_ + numToRemove) % lines_.size();
+  linesCount_ -= numToRemove;
+  if (linesCount_ == 0)
+    linesHead_ = 0;
+  endRemoveRows();
+}
+
+void ConsoleDataModel::linearizeLines_()
+{
+  std::rotate(lines_.begin(), lines_.begin() + linesHead_, lines_.end());
+  lines_.resize(linesCount_);
+  linesHead_ = 0;
 }
 
 ConsoleChannelPtr ConsoleDataModel::registerChannel(const QString& name)
@@ -272,13 +339,16 @@ ConsoleChannelPtr ConsoleDataModel::registerChannel(const QString& name)
 
 void ConsoleDataModel::clear()
 {
-  if (lines_.count() <= 0)
+  // Cleared lines no longer suppress repeats of their text
+  recentTimes_.clear();
+  recentEntries_.clear();
+  if (linesCount_ <= 0)
     return;
 
-  beginRemoveRows(QModelIndex(), 0, lines_.count() - 1);
-  Q_FOREACH(LineEntry* line, lines_)
-    delete line;
+  beginRemoveRows(QModelIndex(), 0, linesCount_ - 1);
   lines_.clear();
+  linesHead_ = 0;
+  linesCount_ = 0;
   endRemoveRows();
 }
 
@@ -294,80 +364,104 @@ void ConsoleDataModel::addEntry(simNotify::NotifySeverity severity, const QStrin
   }
 }
 
-bool ConsoleDataModel::isDuplicateEntry_(const QString& channel, const QString& text, double sinceTime) const
+bool ConsoleDataModel::isDuplicateEntry_(const QString& channel, const QString& text, double sinceTime)
 {
-  return isDuplicateEntry_(pendingLines_, channel, text, sinceTime) ||
-    isDuplicateEntry_(lines_, channel, text, sinceTime);
+  // Forget entries that are too old to match
+  while (!recentEntries_.empty() && recentEntries_.front().time < sinceTime)
+    popRecentEntry_();
+
+  auto channelIter = recentTimes_.find(channel);
+  if (channelIter == recentTimes_.end())
+    return false;
+  auto textIter = channelIter->find(text);
+  return textIter != channelIter->end() && *textIter >= sinceTime;
+}
+
+void ConsoleDataModel::addRecentEntry_(const ConsoleEntry& entry)
+{
+  recentTimes_[entry.channel][entry.text] = entry.time;
+  recentEntries_.push_back(entry);
 }
 
-bool ConsoleDataModel::isDuplicateEntry_(const QList<LineEntry*>& whichList, const QString& channel,
-  const QString& text, double sinceTime) const
+void ConsoleDataModel::popRecentEntry_()
 {
-  QListIterator<LineEntry*> iter(whichList);
-  iter.toBack();
-  // Iterate from the back to get proper time sorting
-  while (iter.hasPrevious())
+  const ConsoleEntry& oldest = recentEntries_.front();
+  auto channelIter = recentTimes_.find(oldest.channel);
+  if (channelIter != recentTimes_.end())
   {
-    const LineEntry* line = iter.previous();
-    // Break out if we hit the since-time
-    if (line->timeStamp() < sinceTime)
-      return false;
-    // Break out if we have a match
-    if (line->text() == text && line->channel() == channel)
-      return true;
+    // Only remove the text if no newer entry has the same text
+    auto textIter = channelIter->find(oldest.text);
+    if (textIter != channelIter->end() && *textIter <= oldest.time)
+    {
+      channelIter->erase(textIter);
+      if (channelIter->isEmpty())
+        recentTimes_.erase(channelIter);
+    }
+  }
+  recentEntries_.pop_front();
+}
+
+void ConsoleDataModel::forgetRecentLine_(const ConsoleEntry& line)
+{
+  // Entries are in line order, so anything older than the line belongs to lines already gone
+  while (!recentEntries_.empty() && recentEntries_.front().time < line.time)
+    popRecentEntry_();
+  if (!recentEntries_.empty())
+  {
+    const ConsoleEntry& oldest = recentEntries_.front();
+    if (oldest.time == line.time && oldest.channel == line.channel && oldest.text == line.text)
+      popRecentEntry_();
   }
-  return false;
+}
+
+void ConsoleDataModel::forgetRecentEntries_(simNotify::NotifySeverity minSeverity)
+{
+  auto keep = std::remove_if(recentEntries_.begin(), recentEntries_.end(), SeverityExceeds(minSeverity));
+  if (keep == recentEntries_.end())
+    return;
+  recentEntries_.erase(keep, recentEntries_.end());
+  // Rebuild the lookup from the remaining entries, which are oldest first
+  recentTimes_.clear();
+  for (auto i = recentEntries_.begin(); i != recentEntries_.end(); ++i)
+    recentTimes_[i->channel][i->text] = i->time;
 }
 
 void ConsoleDataModel::addPlainEntry_(simNotify::NotifySeverity severity, const QString& channel, const QString& text)
 {
   // Don't add duplicates
-  const double currentTime = LineEntry::currentTime();
+  const double currentTime = currentTime_();
   if (spamFilterTimeout() > 0 && isDuplicateEntry_(channel, text, currentTime - spamFilterTimeout()))
     return;
 
-  // Process the entry through filters (if filters are defined)
-  LineEntry* newEntry = NULL;
-  if (!entryFilters_.empty())
-  {
-    // Put into a struct for processing
-    ConsoleEntry consoleEntry;
-    consoleEntry.time = currentTime;
-    consoleEntry.severity = severity;
-    consoleEntry.channel = channel;
-    consoleEntry.text = text;
-
-    // Pass through the filters
-    Q_FOREACH(EntryFilterPtr entryFilter, entryFilters_)
-    {
-      // If any filter rejects text, return early
-      if (!entryFilter->acceptEntry(consoleEntry))
-        return;
-    }
+  // Put into a struct for processing
+  ConsoleEntry newEntry;
+  newEntry.time = currentTime;
+  newEntry.severity = severity;
+  newEntry.channel = channel;
+  newEntry.text = text;
 
-    // Allocate the line entry based on modified values
-    newEntry = new LineEntry(consoleEntry.severity, consoleEntry.channel, consoleEntry.text);
-  }
-  else
+  // Process the entry through filters (if filters are defined)
+  Q_FOREACH(EntryFilterPtr entryFilter, entryFilters_)
   {
-    // Allocate the line entry based on non-modified values
-    newEntry = new LineEntry(severity, channel, text);
+    // If any filter rejects text, return early
+    if (!entryFilter->acceptEntry(newEntry))
+      return;
   }
 
   // Save in the pending list, only add items that meet the minimum severity level
   if (severity <= minSeverity_)
+  {
     pendingLines_.push_back(newEntry);
+    if (spamFilterTimeout() > 0)
+      addRecentEntry_(newEntry);
+  }
 
   // Notify users of new data -- this should be instant, even if we are just pending
   // NOTE that this signal is emitted no matter what the severity level is, unlike items in the pendingLines_
-  emit(textAdded(newEntry->severity()));
-  emit(textAdded(newEntry->timeStamp(), newEntry->severity(), newEntry->channel(), newEntry->text()));
+  emit(textAdded(newEntry.severity));
+  emit(textAdded(newEntry.time, newEntry.severity, newEntry.channel, newEntry.text));
   if (severity <= minSeverity_ && !pendingTimer_->isActive())
     pendingTimer_->start();
-
-  // If not pushed onto pending, it needs to be deleted
-  if (severity > minSeverity_)
-    delete newEntry;
 }
 
 void ConsoleDataModel::processPendingAdds_()
@@ -375,22 +469,28 @@ void ConsoleDataModel::processPendingAdds_()
   if (pendingLines_.empty())
     return;
 
+  // Only the newest numLines() of the old and pending lines survive; remove old lines first so the
+  // model never exceeds its limit, then insert all surviving pending lines at once
+  const int linesLimit = simCore::sdkMax(1, numLines());
+  const int numPending = static_cast<int>(pendingLines_.size());
+  const int numToAdd = simCore::sdkMin(numPending, linesLimit);
+  removeOldestLines_(linesCount_ + numToAdd - linesLimit);
+
   // Add the new lines: Pay attention to newest on top flag, which impacts whether
   // people watching us see these at the beginning (true), or end (false)
   // Note that indices are inclusive, so a size of 1 means an offset of 0 (hence the -1)
   if (newestOnTop())
-    beginInsertRows(QModelIndex(), 0, pendingLines_.size() - 1);
+    beginInsertRows(QModelIndex(), 0, numToAdd - 1);
   else
-    beginInsertRows(QModelIndex(), lines_.count(), lines_.count() + pendingLines_.size() - 1);
-  QListIterator<LineEntry*> iter(pendingLines_);
+    beginInsertRows(QModelIndex(), linesCount_, linesCount_ + numToAdd - 1);
+  // Pending lines that do not fit are never shown
+  for (int k = 0; k < numPending - numToAdd; ++k)
+    forgetRecentLine_(pendingLines_[k]);
   // Iterate from the front to get proper time sorting
-  while (iter.hasNext())
-    lines_.push_back(iter.next());
+  for (int k = numPending - numToAdd; k < numPending; ++k)
+    pushLine_(pendingLines_[k]);
   pendingLines_.clear();
   endInsertRows();
-
-  // Limit the internal number of lines saved
-  limitData_();
 }
 
 int ConsoleDataModel::numLines() const
@@ -407,46 +507,43 @@ void ConsoleDataModel::setMinimumSeverity(int severity)
   // if we are changing to a lower severity level, clear out all lines that exceed our minimum severity
   if (newSeverity < minSeverity_)
   {
-    int removeEndIndex = 0;
-    int lineIndex = 0;
-    // iterate through the lines_ list to check and remove lines
-    while (lineIndex < lines_.size())
+    linearizeLines_();
+    // iterate from the newest line to remove blocks of invalid lines without shifting unchecked lines
+    int age = linesCount_ - 1;
+    while (age >= 0)
     {
-      if (lineIndex + removeEndIndex < lines_.size() &&
-        lines_.at(lineIndex + removeEndIndex)->severity() > newSeverity)
+      if (lines_[age].severity <= newSeverity)
       {
-        // found an invalid severity level, update the index of our removal end block
-        removeEndIndex++;
+        --age;
+        continue;
       }
-      // if we have any lines to remove, do it now, since we've reached the end of a block of invalid lines
+      // found an invalid severity level, find the beginning of the block
+      const int blockEnd = age;
+      while (age >= 0 && lines_[age].severity > newSeverity)
+        --age;
+      const int blockBegin = age + 1;
+      const int blockSize = blockEnd - blockBegin + 1;
+      if (newestOnTop())
+        beginRemoveRows(QModelIndex(), linesCount_ - 1 - blockEnd, linesCount_ - 1 - blockBegin);
       else
-      {
-        if (removeEndIndex > 0)
-        {
-          beginRemoveRows(QModelIndex(), lineIndex, lineIndex + removeEndIndex - 1);
-          for (; removeEndIndex > 0; removeEndIndex--)
-          {
-            delete lines_.at(lineIndex);
-            lines_.removeAt(lineIndex);
-          }
-          endRemoveRows();
-        }
-        lineIndex++;
-      }
+        beginRemoveRows(QModelIndex(), blockBegin, blockEnd);
+      lines_.erase(lines_.begin() + blockBegin, lines_.begin() + blockEnd + 1);
+      linesCount_ -= blockSize;
+      endRemoveRows();
     }
 
-    // remove messages with invalid severity from the pendinglines_ list
-    lineIndex = 0;
-    while (lineIndex < pendingLines_.size())
+    // remove messages with invalid severity from the pendingLines_ list
+    auto pendingIter = pendingLines_.begin();
+    while (pendingIter != pendingLines_.end())
     {
-      if (pendingLines_.at(lineIndex)->severity() > newSeverity)
-      {
-        delete pendingLines_.at(lineIndex);
-        pendingLines_.removeAt(lineIndex);
-      }
+      if (pendingIter->severity > newSeverity)
+        pendingIter = pendingLines_.erase(pendingIter);
       else
-        lineIndex++;
+        ++pendingIter;
     }
+
+    // removed messages no longer suppress repeats of their text
+    forgetRecentEntries_(newSeverity);
   }
 
   minSeverity_ = newSeverity;
@@ -456,9 +553,11 @@ void ConsoleDataModel::setNumLines(int numLines)
 {
   if (numLines != numLines_ && numLines > 0)
   {
+    removeOldestLines_(linesCount_ - numLines);
+    // Resize the ring buffer storage
+    linearizeLines_();
     numLines_ = numLines;
     lines_.reserve(numLines_);
-    limitData_();
   }
 }
 
@@ -470,32 +569,10 @@ double ConsoleDataModel::spamFilterTimeout() const
 void ConsoleDataModel::setSpamFilterTimeout(double seconds)
 {
   spamFilterTimeout_ = simCore::sdkMax(0.0, seconds);
-}
-
-void ConsoleDataModel::limitData_()
-{
-  int linesLimit = simCore::sdkMax(1, numLines());
-  if (lines_.size() > linesLimit)
+  if (spamFilterTimeout_ <= 0)
   {
-    // and the pop_front below isn't going to be sufficient to limit data.
-    int numToRemove = lines_.size() - linesLimit;
-
-    // Remove as many rows as needed to get under the numLines(); line removal location
-    // is based on what observers see, so if newest is on top (true), remove from bottom
-    if (newestOnTop())
-      beginRemoveRows(QModelIndex(), lines_.size() - numToRemove - 1, lines_.size() - 1);
-    else
-      beginRemoveRows(QModelIndex(), 0, numToRemove - 1);
-    QList<LineEntry*>::iterator endIter = lines_.begin() + numToRemove;
-    for (QList<LineEntry*>::iterator iter = lines_.begin(); iter != endIter; ++iter)
-    {
-      delete *iter;
-    }
-    lines_.erase(lines_.begin(), endIter);
-    endRemoveRows();
-
-    // Make sure the math is right for arguments to lines_.erase()
-    assert(lines_.size() == linesLimit);
+    recentTimes_.clear();
+    recentEntries_.clear();
   }
 }
 
@@ -567,46 +644,18 @@ void ConsoleDataModel::setTimeFormatString(const QString& formatString)
   // Emit that the data has changed for the time column
   timeFormatString_ = formatString;
   // Return early if we have no data
-  if (lines_.empty())
+  if (linesCount_ == 0)
     return;
-  emit dataChanged(index(0, COLUMN_TIME, QModelIndex()), index(lines_.size() - 1, COLUMN_TIME, QModelIndex()));
+  emit dataChanged(index(0, COLUMN_TIME, QModelIndex()), index(linesCount_ - 1, COLUMN_TIME, QModelIndex()));
 }
 
 ////////////////////////////////////////
 
-ConsoleDataModel::LineEntry::LineEntry(simNotify::NotifySeverity severity, const QString& channel, const QString& text)
-  : time_(ConsoleDataModel::LineEntry::currentTime()),
-    severity_(severity),
-    channel_(channel),
-    text_(text)
-{
-}
-
-double ConsoleDataModel::LineEntry::currentTime()
+double ConsoleDataModel::currentTime_()
 {
   return simCore::getSystemTime();
 }
 
-double ConsoleDataModel::LineEntry::timeStamp() const
-{
-  return time_;
-}
-
-simNotify::NotifySeverity ConsoleDataModel::LineEntry::severity() const
-{
-  return severity_;
-}
-
-QString ConsoleDataModel::LineEntry::channel() const
-{
-  return channel_;
-}
-
-QString ConsoleDataModel::LineEntry::text() const
-{
-  return text_;
-}
-
 /////////////////////////////////////////////////////////////////
 
 SimpleConsoleTextFilter::SimpleConsoleTextFilter()
@@ -22,8 +22,11 @@
 #ifndef SIMQT_CONSOLEDATAMODEL_H
 #define SIMQT_CONSOLEDATAMODEL_H
 
+#include <deque>
 #include <memory>
+#include <vector>
 #include <QSortFilterProxyModel>
+#include <QHash>
 #include <QList>
 #include <QMap>
 #include <QMetaType>
@@ -36,7 +39,10 @@ namespace simQt {
 
 class ConsoleChannel;
 
-/** Maintains a persistent database of console output. */
+/**
+ * Maintains a persistent database of console output.  Lines are stored by value in a ring buffer
+ * of numLines() entries, and new lines reach observers in batches on a timer.
+ */
 class SDKQT_EXPORT ConsoleDataModel : public QAbstractItemModel
 {
   Q_OBJECT;
@@ -164,7 +170,10 @@ signals:
   void newestOnTopChanged(bool newestOnTop);
 
 private slots:
-  /** New entries are kept in a pending list, to be batched up for processing all at once.  This processes the list */
+  /**
+   * New entries are kept in a pending list, to be batched up for processing all at once.  This processes the
+   * list, notifying observers with at most one removal and one insertion.
+   */
   void processPendingAdds_();
 
 private:
@@ -172,31 +181,27 @@ private:
   void addPlainEntry_(simNotify::NotifySeverity severity, const QString& channel, const QString& text);
   /** Returns an appropriate color, given a severity (QVariant() return is possible for default color) */
   QVariant colorForSeverity_(simNotify::NotifySeverity severity) const;
-  /** Applies a data limit to the number of entries in memory based on numLines() */
-  void limitData_();
-  /** Returns true if there is a match to the channel/text, at or after the time supplied */
-  bool isDuplicateEntry_(const QString& channel, const QString& text, double sinceTime) const;
-
-  /** Immutable line entry class holds a single line of data */
-  class LineEntry
-  {
-  public:
-    LineEntry(simNotify::NotifySeverity severity, const QString& channel, const QString& text);
-    static double currentTime();
-    double timeStamp() const;
-    simNotify::NotifySeverity severity() const;
-    QString channel() const;
-    QString text() const;
-
-  private:
-    double time_;
-    simNotify::NotifySeverity severity_;
-    QString channel_;
-    QString text_;
-  };
-
-  /** Returns true if there is a match, but only searching a single QList<> */
-  bool isDuplicateEntry_(const QList<LineEntry*>& whichList, const QString& channel, const QString& text, double sinceTime) const;
+  /** Returns true if there is a recent match to the channel/text, at or after the time supplied; forgets messages before the time */
+  bool isDuplicateEntry_(const QString& channel, const QString& text, double sinceTime);
+  /** Remembers an entry for the spam filter */
+  void addRecentEntry_(const ConsoleEntry& entry);
+  /** Forgets the oldest spam filter entry */
+  void popRecentEntry_();
+  /** Forgets the spam filter entry of a line leaving the model, and any older entries */
+  void forgetRecentLine_(const ConsoleEntry& line);
+  /** Forgets spam filter entries whose severity exceeds the given minimum severity */
+  void forgetRecentEntries_(simNotify::NotifySeverity minSeverity);
+  /** Returns the current time for time stamping entries */
+  static double currentTime_();
+
+  /** Returns the line entry at the given row, accounting for newest on top */
+  const ConsoleEntry& lineAt_(int row) const;
+  /** Appends an entry to the ring buffer; there must be room under numLines() */
+  void pushLine_(const ConsoleEntry& entry);
+  /** Removes the given number of oldest lines, with notifications to observers */
+  void removeOldestLines_(int numToRemove);
+  /** Rotates the ring buffer so the oldest line is first, and drops unused storage */
+  void linearizeLines_();
 
   class ChannelImpl;
   /// Map of channel name to channel pointer
@@ -211,10 +216,19 @@ private:
   double spamFilterTimeout_;
   /// Minimum severity level for messages to keep in the model
   simNotify::NotifySeverity minSeverity_;
-  /// (Automatically) Sorted list of added lines
-  QList<LineEntry*> lines_;
+  /// Ring buffer of added lines, sorted by time starting at linesHead_; grows up to numLines_ entries
+  std::vector<ConsoleEntry> lines_;
+  /// Index of the oldest line in lines_
+  int linesHead_;
+  /// Number of valid lines in lines_
+  int linesCount_;
   /// (Automatically) Sorted list of lines ready to be added, but not yet put into the data model
-  QList<LineEntry*> pendingLines_;
+  std::vector<ConsoleEntry> pendingLines_;
+
+  /// Channel, to text, to time of the most recent entry, for spam filtering
+  QHash<QString, QHash<QString, double> > recentTimes_;
+  /// Entries in recentTimes_, oldest first, so that old entries can be forgotten
+  std::deque<ConsoleEntry> recentEntries_;
 
   /// Contains a list of all entry filters to apply before adding data
   QList<EntryFilterPtr> entryFilters_;
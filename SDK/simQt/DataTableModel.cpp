@@ -19,6 +19,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <limits>
 #include "simCore/Calc/Math.h"
 #include "DataTableModel.h"
@@ -28,8 +29,11 @@ namespace simQt {
 const double DataTableModel::INVALID_TIME = std::numeric_limits<double>::max();
 const QVariant EMPTY_CELL = QVariant("NULL");
 
-// Number of rows to load into the model in increments
-static const int ROWLOADINCREMENT = 50;
+// Number of rows read from the table at once when the view needs cell values
+static const size_t BLOCK_SIZE = 256;
+
+// Maximum number of blocks of cell values kept in memory
+static const size_t MAX_CACHED_BLOCKS = 32;
 
 // Increment for time values
 static const double EPSILON = 1e-7;
@@ -56,51 +60,94 @@ private:
   QList<const simData::TableColumn*> columns_; ///< all the TableColumn ptrs
 };
 
-/**
-* Visits all rows in a table, populates the QList with the row time values, starting at first row visited until
-* it has visited the number of rows specified by numRows
-*/
-class RowValueAccumulator : public simData::DataTable::RowVisitor
+/// Observes the table and passes changes on to the model
+class DataTableModel::TableObserver : public simData::DataTable::TableObserver
+{
+public:
+  /** Constructor */
+  explicit TableObserver(DataTableModel& model)
+    : model_(model)
+  {
+  }
+
+  virtual void onAddColumn(simData::DataTable& table, const simData::TableColumn& column)
+  {
+    model_.addColumn_(column);
+  }
+
+  virtual void onAddRow(simData::DataTable& table, const simData::TableRow& row)
+  {
+    model_.addRowTime_(row.time());
+  }
+
+  virtual void onPreRemoveColumn(simData::DataTable& table, const simData::TableColumn& column)
+  {
+    model_.removeColumn_(column);
+  }
+
+  virtual void onPreRemoveRow(simData::DataTable& table, double rowTime)
+  {
+    model_.queueRowRemoval_(rowTime);
+  }
+
+private:
+  DataTableModel& model_;
+};
+
+/// Clears the model when the manager is about to delete the model's table
+class DataTableModel::TableManagerObserver : public simData::DataTableManager::ManagerObserver
 {
 public:
   /** Constructor */
-  explicit RowValueAccumulator(QList<double>& rows)
-    : rows_(rows)
+  explicit TableManagerObserver(DataTableModel& model)
+    : model_(model)
+  {
+  }
+
+  virtual void onAddTable(simData::DataTable* table)
   {
   }
 
-  virtual VisitReturn visit(const simData::TableRow& row)
+  virtual void onPreRemoveTable(simData::DataTable* table)
   {
-    // add rows in the order they exist in the table, will be time ordered
-    rows_.push_back(row.time());
-    return simData::DataTable::RowVisitor::VISIT_CONTINUE;
+    if (table == model_.dataTable_)
+      model_.setDataTable(NULL);
   }
 
 private:
-  QList<double>& rows_; ///< all the row time values
+  DataTableModel& model_;
 };
 
 //----------------------------------------------------------------------------
 DataTableModel::DataTableModel(QObject *parent, simData::DataTable* dataTable)
 :QAbstractItemModel(parent),
-dataTable_(NULL)
+dataTable_(NULL),
+removedRows_(0),
+removalQueued_(false),
+manager_(NULL)
 {
+  observer_.reset(new TableObserver(*this));
+  managerObserver_.reset(new TableManagerObserver(*this));
   setDataTable(dataTable);
 }
 
 DataTableModel::~DataTableModel()
 {
+  if (manager_)
+    manager_->removeObserver(managerObserver_);
+  if (dataTable_)
+    dataTable_->removeObserver(observer_);
 }
 
 QVariant DataTableModel::data(const QModelIndex &index, int role) const
 {
   if (!index.isValid() || dataTable_ == NULL)
     return QVariant();
-  if (!(columns_.size() > index.column()) || !(rows_.size() > index.row()))
+  if (!(columns_.size() > index.column()) || !(static_cast<int>(rows_.size()) > index.row()))
     return QVariant();
 
   // what time are we looking for
-  const double time = rows_.at(index.row());
+  const double time = rows_[index.row()];
 
   if (role == Qt::DisplayRole)
   {
@@ -112,16 +159,9 @@ QVariant DataTableModel::data(const QModelIndex &index, int role) const
       return QVariant(timeString);
     }
 
-    const simData::TableColumn* col = columns_[index.column()];
-    simData::TableColumn::Iterator cell = col->findAtOrBeforeTime(time);
-    if (!cell.hasNext())
-      return EMPTY_CELL;
-
     // return NULL if we found no data at this time
-    if (cell.peekNext()->time() != time)
-      return EMPTY_CELL;
-
-    return cellDisplayValue_(col->variableType(), cell);
+    const Cell& cell = cell_(index.row(), index.column());
+    return cell.valid ? cell.display : EMPTY_CELL;
   }
 
   if (role == SortRole)
@@ -132,16 +172,9 @@ QVariant DataTableModel::data(const QModelIndex &index, int role) const
       return QVariant(time);
     }
 
-    const simData::TableColumn* col = columns_[index.column()];
-    simData::TableColumn::Iterator cell = col->findAtOrBeforeTime(time);
-    if (!cell.hasNext())
-      return EMPTY_CELL;
-
     // return NULL if we found no data at this time
-    if (cell.peekNext()->time() != time)
-      return EMPTY_CELL;
-
-    return cellSortValue_(col->variableType(), cell);
+    const Cell& cell = cell_(index.row(), index.column());
+    return cell.valid ? cell.sort : EMPTY_CELL;
   }
 
   if (role == Qt::TextAlignmentRole)
@@ -149,14 +182,12 @@ QVariant DataTableModel::data(const QModelIndex &index, int role) const
     // column 0 is time string, left align
     if (index.column() == 0)
       return Qt::AlignLeft;
-    const simData::TableColumn* col = columns_[index.column()];
-    simData::TableColumn::Iterator cell = col->findAtOrBeforeTime(time);
     // this is a NULL block, left align
-    if (cell.next()->time() != time)
+    if (!cell_(index.row(), index.column()).valid)
       return Qt::AlignLeft;
 
     // Strings should be left align
-    if (col->variableType() == simData::VT_STRING)
+    if (columns_[index.column()]->variableType() == simData::VT_STRING)
       return Qt::AlignLeft;
 
     // everything else is right aligned
@@ -210,23 +241,27 @@ int DataTableModel::columnCount(const QModelIndex & parent) const
 
 int DataTableModel::rowCount(const QModelIndex & parent) const
 {
-  return parent == QModelIndex() ? rows_.size() : 0;
+  return parent == QModelIndex() ? static_cast<int>(rows_.size()) : 0;
 }
 
 double DataTableModel::getTime(const QModelIndex& index) const
 {
-  if (rows_.size() > index.row())
-    return rows_.at(index.row());
+  if (index.row() >= 0 && static_cast<int>(rows_.size()) > index.row())
+    return rows_[index.row()];
   return INVALID_TIME;
 }
 
 void DataTableModel::setDataTable(simData::DataTable* dataTable)
 {
-  // clear out our local references to the DataTable
-  // TODO: See SIMSDK-402: This function needs some TLC ASAP
   beginResetModel();
+  // clear out our local references to the DataTable
+  if (dataTable_)
+    dataTable_->removeObserver(observer_);
   columns_.clear();
   rows_.clear();
+  removedRows_ = 0;
+  pendingRemovals_.clear();
+  clearBlocks_();
 
   dataTable_ = dataTable;
 
@@ -237,29 +272,269 @@ void DataTableModel::setDataTable(simData::DataTable* dataTable)
     return;
   }
 
-  // update rows/columns
-
   // fill in columns vector
   // first column is time, no TableColumn ptr
   ColumnTimeValueAccumulator cv;
   dataTable_->accept(cv);
-  // empty table, nothing more to do
-  if (cv.columns().empty())
+  // an empty table still needs observing, so that added columns and rows show up
+  if (!cv.columns().empty())
+  {
+    columns_.push_back(NULL); // time column
+    columns_ += cv.columns();
+    buildRows_();
+  }
+  dataTable_->addObserver(observer_);
+
+  // force an update now
+  endResetModel();
+}
+
+const DataTableModel::Cell& DataTableModel::cell_(int row, int column) const
+{
+  const size_t absoluteRow = static_cast<size_t>(row) + removedRows_;
+  const size_t blockIndex = absoluteRow / BLOCK_SIZE;
+  std::map<size_t, Block>::iterator i = blocks_.find(blockIndex);
+  if (i != blocks_.end())
+  {
+    // mark the block as most recently used
+    blockOrder_.splice(blockOrder_.end(), blockOrder_, i->second.order);
+  }
+  else
+  {
+    // evict the least recently used blocks to keep the cache bounded
+    while (blockOrder_.size() >= MAX_CACHED_BLOCKS)
+    {
+      blocks_.erase(blockOrder_.front());
+      blockOrder_.pop_front();
+    }
+    i = blocks_.insert(std::make_pair(blockIndex, Block())).first;
+    i->second.order = blockOrder_.insert(blockOrder_.end(), blockIndex);
+    fetchBlock_(blockIndex, i->second);
+  }
+  return i->second.cells[(absoluteRow % BLOCK_SIZE) * columns_.size() + column];
+}
+
+void DataTableModel::fetchBlock_(size_t blockIndex, Block& block) const
+{
+  const size_t numColumns = columns_.size();
+  block.cells.assign(BLOCK_SIZE * numColumns, Cell());
+
+  // model rows covered by this block; the front of the block may already have been removed
+  const size_t blockStart = blockIndex * BLOCK_SIZE;
+  const size_t firstRow = (blockStart > removedRows_) ? (blockStart - removedRows_) : 0;
+  const size_t endRow = simCore::sdkMin(blockStart + BLOCK_SIZE - removedRows_, rows_.size());
+  if (firstRow >= endRow)
+    return;
+
+  // walk each column once through the block, in step with the row times
+  for (size_t column = 1; column < numColumns; ++column)
+  {
+    const simData::TableColumn* col = columns_[static_cast<int>(column)];
+    const simData::VariableType type = col->variableType();
+    simData::TableColumn::Iterator iter = col->lower_bound(rows_[firstRow]);
+    for (size_t row = firstRow; row < endRow && iter.hasNext(); ++row)
+    {
+      const double time = rows_[row];
+      while (iter.hasNext() && iter.peekNext()->time() < time)
+        iter.next();
+      if (!iter.hasNext() || iter.peekNext()->time() != time)
+        continue;
+
+      Cell& cell = block.cells[(row + removedRows_ - blockStart) * numColumns + column];
+      simData::TableColumn::Iterator displayIter(iter);
+      cell.display = cellDisplayValue_(type, displayIter);
+      if (type == simData::VT_FLOAT || type == simData::VT_DOUBLE)
+      {
+        simData::TableColumn::Iterator sortIter(iter);
+        cell.sort = cellSortValue_(type, sortIter);
+      }
+      else
+        cell.sort = cell.display;
+      cell.valid = true;
+      iter.next();
+    }
+  }
+}
+
+void DataTableModel::invalidateRow_(int row)
+{
+  const std::map<size_t, Block>::iterator i = blocks_.find((static_cast<size_t>(row) + removedRows_) / BLOCK_SIZE);
+  if (i == blocks_.end())
     return;
+  blockOrder_.erase(i->second.order);
+  blocks_.erase(i);
+}
+
+void DataTableModel::clearBlocks_()
+{
+  blocks_.clear();
+  blockOrder_.clear();
+}
+
+void DataTableModel::buildRows_()
+{
+  // merge the column times into the union of row times, in order
+  std::vector<simData::TableColumn::Iterator> iters;
+  for (int k = 1; k < columns_.size(); ++k)
+    iters.push_back(columns_[k]->begin());
+
+  while (true)
+  {
+    double minTime = INVALID_TIME;
+    for (std::vector<simData::TableColumn::Iterator>::const_iterator i = iters.begin(); i != iters.end(); ++i)
+    {
+      if (i->hasNext() && i->peekNext()->time() < minTime)
+        minTime = i->peekNext()->time();
+    }
+    if (minTime == INVALID_TIME)
+      break;
+
+    rows_.push_back(minTime);
+    for (std::vector<simData::TableColumn::Iterator>::iterator i = iters.begin(); i != iters.end(); ++i)
+    {
+      if (i->hasNext() && i->peekNext()->time() == minTime)
+        i->next();
+    }
+  }
+}
 
-  // use size() instead of size() - 1 because of the time column
-  const int lastColIndex = cv.columns().size();
-  beginInsertColumns(QModelIndex(), 0, lastColIndex);
-  columns_.push_back(NULL); // time column
-  columns_ += cv.columns();
+int DataTableModel::rowForTime_(double time) const
+{
+  const std::deque<double>::const_iterator i = std::lower_bound(rows_.begin(), rows_.end(), time);
+  if (i == rows_.end() || *i != time)
+    return -1;
+  return static_cast<int>(i - rows_.begin());
+}
+
+bool DataTableModel::hasValueAtTime_(double time) const
+{
+  for (int k = 1; k < columns_.size(); ++k)
+  {
+    simData::TableColumn::Iterator cell = columns_[k]->findAtOrBeforeTime(time);
+    if (cell.hasNext() && cell.peekNext()->time() == time)
+      return true;
+  }
+  return false;
+}
+
+void DataTableModel::addColumn_(const simData::TableColumn& column)
+{
+  // the first column of a table brings the time column with it
+  const int first = columns_.size();
+  const int last = columns_.empty() ? 1 : first;
+  beginInsertColumns(QModelIndex(), first, last);
+  if (columns_.empty())
+    columns_.push_back(NULL);
+  columns_.push_back(&column);
+  clearBlocks_();
   endInsertColumns();
+}
 
-  // Add rows
-  RowValueAccumulator rvc(rows_);
-  dataTable_->accept(0, std::numeric_limits<double>::max(), rvc);
+void DataTableModel::removeColumn_(const simData::TableColumn& column)
+{
+  const int index = columns_.indexOf(&column);
+  if (index <= 0)
+    return;
+  beginRemoveColumns(QModelIndex(), index, index);
+  columns_.removeAt(index);
+  clearBlocks_();
+  endRemoveColumns();
+}
 
-  // force an update now
-  endResetModel();
+void DataTableModel::addRowTime_(double time)
+{
+  // new rows almost always come at the end
+  if (rows_.empty() || time > rows_.back())
+  {
+    const int row = static_cast<int>(rows_.size());
+    beginInsertRows(QModelIndex(), row, row);
+    rows_.push_back(time);
+    // a partially filled tail block may be cached
+    invalidateRow_(row);
+    endInsertRows();
+    return;
+  }
+
+  const std::deque<double>::iterator i = std::lower_bound(rows_.begin(), rows_.end(), time);
+  const int row = static_cast<int>(i - rows_.begin());
+  if (*i == time)
+  {
+    // new cells for an existing row
+    invalidateRow_(row);
+    emit dataChanged(index(row, 0, QModelIndex()), index(row, columns_.size() - 1, QModelIndex()));
+    return;
+  }
+
+  // inserting in the middle shifts the rows after it, so no cached block is still valid
+  beginInsertRows(QModelIndex(), row, row);
+  rows_.insert(i, time);
+  clearBlocks_();
+  endInsertRows();
+}
+
+void DataTableModel::queueRowRemoval_(double time)
+{
+  // the table is about to remove the cells; the row is only gone if no other column has a value at this
+  // time, which can only be checked once the removal has finished
+  pendingRemovals_.push_back(time);
+  const int row = rowForTime_(time);
+  if (row >= 0)
+    invalidateRow_(row);
+  if (!removalQueued_)
+  {
+    removalQueued_ = true;
+    QMetaObject::invokeMethod(this, "processPendingRemovals_", Qt::QueuedConnection);
+  }
+}
+
+void DataTableModel::processPendingRemovals_()
+{
+  removalQueued_ = false;
+  std::vector<double> times;
+  times.swap(pendingRemovals_);
+  std::sort(times.begin(), times.end());
+  times.erase(std::unique(times.begin(), times.end()), times.end());
+
+  // find the rows that no longer have any values, in ascending order
+  std::vector<int> removeRows;
+  for (std::vector<double>::const_iterator i = times.begin(); i != times.end(); ++i)
+  {
+    const int row = rowForTime_(*i);
+    if (row < 0)
+      continue;
+    if (!hasValueAtTime_(*i))
+      removeRows.push_back(row);
+    else
+    {
+      // only some of the cells were removed
+      invalidateRow_(row);
+      emit dataChanged(index(row, 0, QModelIndex()), index(row, columns_.size() - 1, QModelIndex()));
+    }
+  }
+
+  // data limiting removes a run of the oldest rows; find it
+  size_t numFront = 0;
+  while (numFront < removeRows.size() && removeRows[numFront] == static_cast<int>(numFront))
+    ++numFront;
+
+  // remove the others last to first, so the indices stay valid
+  for (size_t k = removeRows.size(); k > numFront; --k)
+  {
+    const int row = removeRows[k - 1];
+    beginRemoveRows(QModelIndex(), row, row);
+    rows_.erase(rows_.begin() + row);
+    clearBlocks_();
+    endRemoveRows();
+  }
+
+  // dropping the front run only shifts the absolute offset, so cached blocks stay valid
+  if (numFront > 0)
+  {
+    beginRemoveRows(QModelIndex(), 0, static_cast<int>(numFront) - 1);
+    rows_.erase(rows_.begin(), rows_.begin() + numFront);
+    removedRows_ += numFront;
+    endRemoveRows();
+  }
 }
 
 simData::DataTable* DataTableModel::dataTable() const
@@ -267,6 +542,17 @@ simData::DataTable* DataTableModel::dataTable() const
   return dataTable_;
 }
 
+void DataTableModel::setDataTableManager(simData::DataTableManager* manager)
+{
+  if (manager_ == manager)
+    return;
+  if (manager_)
+    manager_->removeObserver(managerObserver_);
+  manager_ = manager;
+  if (manager_)
+    manager_->addObserver(managerObserver_);
+}
+
 QVariant DataTableModel::cellDisplayValue_(simData::VariableType type, simData::TableColumn::Iterator& cell) const
 {
   if (!cell.hasNext())
@@ -22,13 +22,23 @@
 #ifndef SIMQT_DATATABLE_MODEL_H
 #define SIMQT_DATATABLE_MODEL_H
 
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <vector>
 #include <QList>
 #include <QAbstractItemModel>
 #include "simData/DataTable.h"
 
 namespace simQt {
 
-  /** A data table model based on QAbstractItemModel */
+  /**
+   * A data table model based on QAbstractItemModel.  The model holds only the row times.  Cell values
+   * are read in blocks of rows through one column iterator per column as the view asks for them, and
+   * a limited number of blocks are cached.  The model observes the table and inserts and removes rows
+   * and columns incrementally rather than resetting.
+   */
   class SDKQT_EXPORT DataTableModel : public QAbstractItemModel
   {
     Q_OBJECT
@@ -81,6 +91,18 @@ namespace simQt {
     /** Returns the current data table; can be NULL */
     simData::DataTable* dataTable() const;
 
+    /**
+    * Set the manager that owns the data tables shown by this model.  When the manager deletes the
+    * table this model represents, the model clears itself rather than keeping a dangling pointer.
+    * The manager must outlive this model, or be replaced with NULL before it is deleted.
+    * @param manager  manager of the data tables; can be NULL
+    */
+    void setDataTableManager(simData::DataTableManager* manager);
+
+  private slots:
+    /** Removes the rows deleted from the table since the last call, once the table has finished removing them */
+    void processPendingRemovals_();
+
   protected:
     /** Convert the DataTable cell value to a QVariant; converting float and double into strings with the correct precision */
     QVariant cellDisplayValue_(simData::VariableType type, simData::TableColumn::Iterator& cellIter) const;
@@ -90,7 +112,68 @@ namespace simQt {
 
     simData::DataTable* dataTable_; ///< reference to the data table this model represents
     QList<const simData::TableColumn*> columns_; ///< index in list corresponds to model column index
-    QList<double> rows_; ///< index in list corresponds to model row index
+    std::deque<double> rows_; ///< index in deque corresponds to model row index; sorted by time
+
+  private:
+    class TableObserver;
+    class TableManagerObserver;
+
+    /** Cached values of a single cell */
+    struct Cell
+    {
+      Cell() : valid(false) {}
+      QVariant display; ///< value for Qt::DisplayRole
+      QVariant sort; ///< value for SortRole
+      bool valid; ///< false if the column has no value at the row's time
+    };
+
+    /** Cached cells for a block of rows, stored row-major */
+    struct Block
+    {
+      std::vector<Cell> cells; ///< BLOCK_SIZE rows by columns_.size() columns
+      std::list<size_t>::iterator order; ///< position of this block in blockOrder_
+    };
+
+    /** Returns the cached cell for the row and column, fetching its block if needed; column must be > 0 */
+    const Cell& cell_(int row, int column) const;
+    /** Reads the cells of the block at the given absolute block index from the table */
+    void fetchBlock_(size_t blockIndex, Block& block) const;
+    /** Drops the cached block holding the given model row, if any */
+    void invalidateRow_(int row);
+    /** Drops all cached blocks */
+    void clearBlocks_();
+    /** Fills rows_ with the union of all column times */
+    void buildRows_();
+    /** Returns the model row with the given time, or -1 if there is none */
+    int rowForTime_(double time) const;
+    /** Returns true if any column has a value at exactly the given time */
+    bool hasValueAtTime_(double time) const;
+
+    /** Table observer callbacks */
+    void addColumn_(const simData::TableColumn& column);
+    void removeColumn_(const simData::TableColumn& column);
+    void addRowTime_(double time);
+    void queueRowRemoval_(double time);
+
+    /**
+     * Number of rows dropped from the front of rows_ since the last reset.  Blocks are keyed by absolute
+     * row (model row plus this offset) so that data limiting the oldest rows keeps the cache valid.
+     */
+    size_t removedRows_;
+    /** Cached blocks by absolute block index */
+    mutable std::map<size_t, Block> blocks_;
+    /** Cached block indices, least recently used first, for eviction */
+    mutable std::list<size_t> blockOrder_;
+    /** Times reported removed by the table, waiting on processPendingRemovals_() */
+    std::vector<double> pendingRemovals_;
+    /** True when processPendingRemovals_() has been queued */
+    bool removalQueued_;
+    /** Observer registered with dataTable_ */
+    std::shared_ptr<TableObserver> observer_;
+    /** Manager that owns dataTable_; can be NULL */
+    simData::DataTableManager* manager_;
+    /** Observer registered with manager_, to drop dataTable_ before it is deleted */
+    simData::DataTableManager::ManagerObserverPtr managerObserver_;
   };
 
 }
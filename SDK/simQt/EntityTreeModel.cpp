@@ -19,6 +19,8 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <set>
 #include <QString>
 #include <QTimer>
 
@@ -85,6 +87,7 @@ EntityTreeItem::EntityTreeItem(simData::ObjectId id, EntityTreeItem *parent)
 {
   id_ = id;
   parentItem_ = parent;
+  row_ = 0;
 }
 
 EntityTreeItem::~EntityTreeItem()
@@ -94,13 +97,49 @@ EntityTreeItem::~EntityTreeItem()
 
 void EntityTreeItem::appendChild(EntityTreeItem *item)
 {
+  item->row_ = childItems_.count();
   childItems_.append(item);
 }
 
 void EntityTreeItem::removeChild(EntityTreeItem *item)
 {
-  childItems_.removeOne(item);
-  delete item;
+  // Item must be a child
+  assert(item->parentItem_ == this && childItems_.value(item->row_) == item);
+  removeChildren(item->row_, 1);
+}
+
+void EntityTreeItem::removeChildren(int row, int count)
+{
+  if (row < 0 || count <= 0 || row + count > childItems_.count())
+    return;
+  const QList<EntityTreeItem*>::iterator first = childItems_.begin() + row;
+  for (QList<EntityTreeItem*>::iterator it = first; it != first + count; ++it)
+    delete *it;
+  childItems_.erase(first, first + count);
+  for (int k = row; k < childItems_.count(); ++k)
+    childItems_[k]->row_ = k;
+}
+
+void EntityTreeItem::removeChildren(const std::vector<int>& rows)
+{
+  if (rows.empty())
+    return;
+  // Compact the survivors in a single pass
+  QList<EntityTreeItem*> kept;
+  kept.reserve(childItems_.count());
+  std::vector<int>::const_iterator nextRemoved = rows.begin();
+  for (int k = 0; k < childItems_.count(); ++k)
+  {
+    if (nextRemoved != rows.end() && *nextRemoved == k)
+    {
+      delete childItems_[k];
+      ++nextRemoved;
+      continue;
+    }
+    childItems_[k]->row_ = kept.count();
+    kept.append(childItems_[k]);
+  }
+  childItems_.swap(kept);
 }
 
 EntityTreeItem* EntityTreeItem::child(int row)
@@ -135,7 +174,7 @@ EntityTreeItem* EntityTreeItem::parent()
 int EntityTreeItem::row() const
 {
   if (parentItem_)
-    return parentItem_->childItems_.indexOf(const_cast<EntityTreeItem*>(this));
+    return row_;
 
   return 0;
 }
@@ -216,10 +255,13 @@ void EntityTreeModel::addEntity_(uint64_t entityId)
 
 void EntityTreeModel::commitDelayedEntities_()
 {
+  // Resolve the tree parent of each entity; hosts may be in this same batch, so entities whose
+  // parent is not yet in the tree wait for a later pass
+  std::vector<std::pair<simData::ObjectId, uint64_t> > pending;
   for (std::vector<simData::ObjectId>::const_iterator it = delayedAdds_.begin(); it != delayedAdds_.end(); ++it)
   {
     simData::ObjectType entityType = dataStore_->objectType(*it);
-    if (simData::NONE)
+    if (entityType == simData::NONE)
     {
       // the entity should have been removed from the vector
       assert(false);
@@ -242,10 +284,53 @@ void EntityTreeModel::commitDelayedEntities_()
     assert(!((hostId == 0) && entityTypeNeedsHost));
     if ((hostId > 0 || !entityTypeNeedsHost))
     {
-      addTreeItem_(*it, entityType, hostId);
+      // List view puts everything at the top level
+      pending.push_back(std::make_pair(*it, treeView_ ? hostId : 0));
     }
   }
   delayedAdds_.clear();
+
+  // Each pass appends all ready children of a parent with a single insertion
+  while (!pending.empty())
+  {
+    std::map<EntityTreeItem*, std::vector<simData::ObjectId> > byParent;
+    std::vector<std::pair<simData::ObjectId, uint64_t> > waiting;
+    for (std::vector<std::pair<simData::ObjectId, uint64_t> >::const_iterator it = pending.begin(); it != pending.end(); ++it)
+    {
+      // Skip duplicates
+      if (findItem_(it->first) != NULL)
+        continue;
+      EntityTreeItem* parentItem = (it->second == 0) ? rootItem_ : findItem_(it->second);
+      if (parentItem != NULL)
+        byParent[parentItem].push_back(it->first);
+      else
+        waiting.push_back(*it);
+    }
+    // Hosts that never arrive leave their children out of the tree
+    if (byParent.empty())
+      break;
+    for (std::map<EntityTreeItem*, std::vector<simData::ObjectId> >::const_iterator it = byParent.begin(); it != byParent.end(); ++it)
+      insertTreeItems_(it->first, it->second);
+    pending.swap(waiting);
+  }
+}
+
+void EntityTreeModel::commitDelayedRemoves_()
+{
+  // An item whose ancestor is also removed goes away with the ancestor
+  const std::set<EntityTreeItem*> removing(delayedRemoves_.begin(), delayedRemoves_.end());
+  delayedRemoves_.clear();
+
+  std::vector<EntityTreeItem*> items;
+  for (std::set<EntityTreeItem*>::const_iterator it = removing.begin(); it != removing.end(); ++it)
+  {
+    bool ancestorRemoved = false;
+    for (EntityTreeItem* ancestor = (*it)->parent(); ancestor != NULL && !ancestorRemoved; ancestor = ancestor->parent())
+      ancestorRemoved = (removing.find(ancestor) != removing.end());
+    if (!ancestorRemoved)
+      items.push_back(*it);
+  }
+  removeTreeItems_(items);
 }
 
 void EntityTreeModel::emitEntityDataChanged_(uint64_t entityId)
@@ -299,6 +384,7 @@ void EntityTreeModel::forceRefresh()
     delete rootItem_;
     rootItem_ = new EntityTreeItem(0, NULL); // has no parent
     delayedAdds_.clear();  // clear any delayed entities since building from the data store
+    delayedRemoves_.clear();
     itemsById_.clear();
 
     // Get platform objects from DataStore
@@ -333,41 +419,95 @@ EntityTreeItem* EntityTreeModel::findItem_(uint64_t entityId) const
   return NULL;
 }
 
-void EntityTreeModel::addTreeItem_(uint64_t id, simData::ObjectType type, uint64_t parentId)
+void EntityTreeModel::insertTreeItems_(EntityTreeItem* parent, const std::vector<simData::ObjectId>& ids)
 {
-  EntityTreeItem* found = findItem_(id);
-  // adding a duplicate
-  assert(found == NULL);
-  if (found != NULL)
+  if (ids.empty())
     return;
+  if (parent == NULL)
+    parent = rootItem_;
 
-  EntityTreeItem* parentItem;
-  if (parentId == 0)
-    parentItem = rootItem_;
-  else
-    parentItem = findItem_(parentId);
+  const QModelIndex parentIndex = (parent == rootItem_) ? QModelIndex() : createIndex(parent->row(), 0, parent);
+  const int first = parent->childCount();
+  beginInsertRows(parentIndex, first, first + static_cast<int>(ids.size()) - 1);
+  for (std::vector<simData::ObjectId>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+  {
+    // itemsById_ is out of sync WRT tree
+    assert(itemsById_.find(*it) == itemsById_.end());
+    EntityTreeItem* newItem = new EntityTreeItem(*it, parent);
+    itemsById_[*it] = newItem;
+    parent->appendChild(newItem);
+  }
+  endInsertRows();
+}
 
-  // itemsById_ is out of sync WRT tree
-  assert(itemsById_.find(id) == itemsById_.end());
+void EntityTreeModel::removeTreeItems_(const std::vector<EntityTreeItem*>& items)
+{
+  // Group rows by parent
+  std::map<EntityTreeItem*, std::vector<int> > rowsByParent;
+  for (std::vector<EntityTreeItem*>::const_iterator it = items.begin(); it != items.end(); ++it)
+    rowsByParent[(*it)->parent()].push_back((*it)->row());
 
-  if ((parentItem != rootItem_) && treeView_)
+  // Each removed range renumbers the rows after it, and views update their persistent indices for
+  // every renumbered row.  A reset instead makes views rebuild every row and lose their selection
+  // and expansion state, so it is only worthwhile when the range removals would renumber many
+  // times more rows than the model holds, such as scattered removals from a long list.
+  static const size_t RESET_RENUMBER_RATIO = 8;
+  size_t renumbered = 0;
+  for (std::map<EntityTreeItem*, std::vector<int> >::iterator it = rowsByParent.begin(); it != rowsByParent.end(); ++it)
   {
-    beginInsertRows(createIndex(parentItem->row(), 0, parentItem), parentItem->childCount(), parentItem->childCount());
-    EntityTreeItem* newItem = new EntityTreeItem(id, parentItem);
-    itemsById_[id] = newItem;
-    parentItem->appendChild(newItem);
-    endInsertRows();
+    std::vector<int>& rows = it->second;
+    std::sort(rows.begin(), rows.end());
+    for (size_t k = 0; k < rows.size(); ++k)
+    {
+      if (k == 0 || rows[k - 1] + 1 != rows[k])
+        renumbered += it->first->childCount() - rows[k];
+    }
   }
-  else
+  // Removed items were already dropped from itemsById_, so add them back in for the model size
+  const size_t modelRows = itemsById_.size() + items.size();
+  if (renumbered > RESET_RENUMBER_RATIO * modelRows)
   {
-    beginInsertRows(QModelIndex(), rootItem_->childCount(), rootItem_->childCount());
-    EntityTreeItem* newItem = new EntityTreeItem(id, rootItem_);
-    itemsById_[id] = newItem;
-    rootItem_->appendChild(newItem);
-    endInsertRows();
+    beginResetModel();
+    for (std::map<EntityTreeItem*, std::vector<int> >::const_iterator it = rowsByParent.begin(); it != rowsByParent.end(); ++it)
+      it->first->removeChildren(it->second);
+    endResetModel();
+    return;
+  }
+
+  for (std::map<EntityTreeItem*, std::vector<int> >::iterator it = rowsByParent.begin(); it != rowsByParent.end(); ++it)
+  {
+    EntityTreeItem* parent = it->first;
+    const std::vector<int>& rows = it->second;
+    const QModelIndex parentIndex = (parent == rootItem_) ? QModelIndex() : createIndex(parent->row(), 0, parent);
+
+    // Remove contiguous ranges from the bottom up so that rows of unprocessed ranges stay valid
+    size_t end = rows.size();
+    while (end > 0)
+    {
+      size_t begin = end - 1;
+      while (begin > 0 && rows[begin - 1] + 1 == rows[begin])
+        --begin;
+      const int firstRow = rows[begin];
+      const int lastRow = rows[end - 1];
+
+      // Qt requires we notify it of all the rows to be removed
+      beginRemoveRows(parentIndex, firstRow, lastRow);
+      parent->removeChildren(firstRow, lastRow - firstRow + 1);
+      endRemoveRows();
+      end = begin;
+    }
   }
 }
 
+void EntityTreeModel::forgetItem_(const EntityTreeItem* item)
+{
+  std::vector<uint64_t> ids;
+  item->getChildrenIds(ids);
+  itemsById_.erase(item->id());
+  for (std::vector<uint64_t>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    itemsById_.erase(*it);
+}
+
 void EntityTreeModel::removeEntity_(uint64_t id)
 {
   EntityTreeItem* found = findItem_(id);
@@ -382,31 +522,12 @@ void EntityTreeModel::removeEntity_(uint64_t id)
     return;
   }
 
-  // Qt requires we notify it of all the rows to be removed
-  if (found->parent() != rootItem_)
-  {
-    const QModelIndex parentIndex = createIndex(found->parent()->row(), 0, found->parent());
-    beginRemoveRows(parentIndex, found->row(), found->row());
-  }
-  else
-  {
-    beginRemoveRows(QModelIndex(), found->row(), found->row());
-  }
-
-  // Get any children before deleting
-  std::vector<uint64_t> ids;
-  found->getChildrenIds(ids);
-
-  // tell the found item's parent to remove that item
-  found->parent()->removeChild(found);
-
-  // remove the item
-  itemsById_.erase(id);
-  // now remove any children
-  Q_FOREACH(uint64_t deleteId, ids)
-    itemsById_.erase(deleteId);
-
-  endRemoveRows();
+  // Stop resolving the entity right away; only the row notifications wait, so that all
+  // removals from the same event are committed together by a zero timer
+  forgetItem_(found);
+  if (delayedRemoves_.empty())
+    QTimer::singleShot(0, this, SLOT(commitDelayedRemoves_()));
+  delayedRemoves_.push_back(found);
 }
 
 void EntityTreeModel::removeAllEntities_()
@@ -418,6 +539,7 @@ void EntityTreeModel::removeAllEntities_()
     delete rootItem_;
     rootItem_ = new EntityTreeItem(0, NULL);
     delayedAdds_.clear();
+    delayedRemoves_.clear();
     itemsById_.clear();
 
     endResetModel();
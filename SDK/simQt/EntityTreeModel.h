@@ -47,6 +47,10 @@ public:
    */
   void appendChild(EntityTreeItem *item);
   void removeChild(EntityTreeItem *item);
+  /// Deletes count children starting at row; rows of later children are updated
+  void removeChildren(int row, int count);
+  /// Deletes the children at the given rows, which must be sorted ascending
+  void removeChildren(const std::vector<int>& rows);
   EntityTreeItem *child(int row);
   int childCount() const;
   EntityTreeItem *parent();
@@ -58,6 +62,7 @@ protected:
   simData::ObjectId id_; ///< id of the entity represented
   EntityTreeItem *parentItem_;  ///< parent of the item.  Null if top item
   QList<EntityTreeItem*> childItems_;  ///< Children of item, if any.  If no children, than item is a leaf
+  int row_; ///< Position in the parent's childItems_, kept current by the parent
 };
 
 /// model (data representation) for a tree of Entities (Platforms, Beams, Gates, etc.)
@@ -116,6 +121,8 @@ public slots:
 private slots:
   /** Added any delayed entities */
   void commitDelayedEntities_();
+  /** Removes any delayed entities */
+  void commitDelayedRemoves_();
 
 private:
   class TreeListener;
@@ -125,7 +132,12 @@ private:
   void buildTree_(simData::ObjectType type, const simData::DataStore* dataStore,
     const simData::DataStore::IdList& idList, EntityTreeItem *parent);
   EntityTreeItem* findItem_(uint64_t entityId) const;
-  void addTreeItem_(uint64_t id, simData::ObjectType type, uint64_t parentId);
+  /// Appends the items as children of parent in one insertion; parent of NULL means root
+  void insertTreeItems_(EntityTreeItem* parent, const std::vector<simData::ObjectId>& ids);
+  /// Removes the rows of items already dropped from itemsById_ in contiguous ranges; items must not be ancestors of one another
+  void removeTreeItems_(const std::vector<EntityTreeItem*>& items);
+  /// Removes the item and its descendants from itemsById_
+  void forgetItem_(const EntityTreeItem* item);
 
   /// Removes the entity specified by the id
   void removeEntity_(uint64_t id);
@@ -148,6 +160,12 @@ private:
    * data.
    */
   std::vector<simData::ObjectId> delayedAdds_;
+  /**
+   * Row removals are also delayed so that many removals, such as from data limiting, are processed
+   * as a few contiguous row ranges instead of one row at a time.  The items are dropped from
+   * itemsById_ immediately, so removed IDs no longer resolve while their rows wait.
+   */
+  std::vector<EntityTreeItem*> delayedRemoves_;
 
   /** Icons for entity types */
   QIcon platformIcon_;
@@ -21,10 +21,12 @@
 */
 #include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <limits>
 #include <QHelpEvent>
 #include <QToolTip>
 #include <QPainter>
+#include <QPaintEvent>
 #include <QScrollBar>
 
 #include "GanttChartView.h"
@@ -63,7 +65,16 @@ GanttChartView::GanttChartView(QWidget* parent)
     currentTime_(-std::numeric_limits<double>::max()),
     customStart_(0),
     customEnd_(0),
-    useCustomBounds_(false)
+    useCustomBounds_(false),
+    itemsDirty_(true),
+    numLayers_(0),
+    itemsFirstBegin_(std::numeric_limits<double>::max()),
+    itemsLastEnd_(-std::numeric_limits<double>::max()),
+    chartDirty_(true),
+    chartScroll_(0),
+    chartPixelsPerTime_(0),
+    chartFirstBegin_(0),
+    chartRange_(0)
 {
 }
 
@@ -76,53 +87,23 @@ QModelIndex GanttChartView::indexAt(const QPoint &point) const
   if (!model())
     return QModelIndex();
 
-  int numLayers = 0;
-  if (collapseLevels_)
-    numLayers = model()->rowCount(rootIndex());
-  else
-  {
-    for (int layer = 0; layer < model()->rowCount(rootIndex()); layer++)
-    {
-      numLayers += model()->rowCount(model()->index(layer, 0, rootIndex()));
-    }
-  }
-
-  int itemHeight = (numLayers != 0) ? (viewport()->height() / numLayers) : 0;
-  int itemNum = 0;
-  int layer = 0;
+  updateItems_();
+  const int itemHeight = (numLayers_ != 0) ? (viewport()->height() / numLayers_) : 0;
+  const double pixelsPerTime = scale_ * zoom_;
+  if (itemHeight == 0 || pixelsPerTime <= 0)
+    return QModelIndex();
 
-  for (int parent = 0; parent < model()->rowCount(rootIndex()); parent++)
+  // Only items that span the time under the point can contain it
+  const double time = firstBegin_ + (point.x() + horizontalScrollBar()->value()) / pixelsPerTime;
+  const int layer = point.y() / itemHeight;
+  size_t first = 0;
+  size_t last = 0;
+  itemsInTimeRange_(time, time, first, last);
+  for (size_t k = first; k < last; ++k)
   {
-    QModelIndex layerIndex = model()->index(parent, 0, rootIndex());
-
-    if (collapseLevels_)
-      layer = parent;
-
-    for (int itemInLayer = 0; itemInLayer < model()->rowCount(layerIndex); itemInLayer++)
-    {
-      if (!collapseLevels_)
-      {
-        layer = itemNum;
-        itemNum++;
-      }
-
-      QModelIndex beginIndex = model()->index(itemInLayer, beginTimeColumn_, layerIndex);
-      double begin = model()->data(beginIndex, beginTimeRole_).toDouble(0);
-
-      QModelIndex endIndex = model()->index(itemInLayer, endTimeColumn_, layerIndex);
-      double end = model()->data(endIndex, endTimeRole_).toDouble(0);
-
-      // Handle cases where the beginning is after the end
-      if (begin > end)
-      {
-        std::swap(begin, end);
-      }
-      QRect rect(((begin - firstBegin_) * (scale_ * zoom_)) - horizontalScrollBar()->value(), itemHeight * layer, (end - begin) * (scale_ * zoom_), itemHeight);
-      if (rect.contains(point))
-      {
-        return model()->index(itemInLayer, 0, layerIndex);
-      }
-    }
+    const Item& item = items_[k];
+    if (item.layer == layer && item.end >= time)
+      return model()->index(item.row, 0, model()->index(item.parentRow, 0, rootIndex()));
   }
   return QModelIndex();
 }
@@ -167,7 +148,7 @@ void GanttChartView::setReferenceLineSpacing(double newSpacing)
 
   referenceLineSpacing_ = (newSpacing > 0) ? newSpacing : referenceLineSpacing_;
 
-  viewport()->update();
+  invalidateChart_();
 }
 
 bool GanttChartView::drawReferenceLines() const
@@ -182,7 +163,7 @@ void GanttChartView::setDrawReferenceLines(bool draw)
 
   drawReferenceLines_ = draw;
 
-  viewport()->update();
+  invalidateChart_();
 }
 
 double GanttChartView::iconSize() const
@@ -197,7 +178,7 @@ void GanttChartView::setIconSize(double newSize)
 
   iconSize_ = newSize;
 
-  viewport()->update();
+  invalidateChart_();
 }
 
 Qt::ItemDataRole GanttChartView::beginTimeRole() const
@@ -212,7 +193,7 @@ void GanttChartView::setBeginTimeRole(Qt::ItemDataRole role)
 
   beginTimeRole_ = role;
 
-  viewport()->update();
+  invalidateItems_();
 }
 
 Qt::ItemDataRole GanttChartView::endTimeRole() const
@@ -227,7 +208,7 @@ void GanttChartView::setEndTimeRole(Qt::ItemDataRole role)
 
   endTimeRole_ = role;
 
-  viewport()->update();
+  invalidateItems_();
 }
 
 int GanttChartView::beginTimeColumn() const
@@ -242,7 +223,7 @@ void GanttChartView::setBeginTimeColumn(int col)
 
   beginTimeColumn_ = col;
 
-  viewport()->update();
+  invalidateItems_();
 }
 
 int GanttChartView::endTimeColumn() const
@@ -257,7 +238,7 @@ void GanttChartView::setEndTimeColumn(int col)
 
   endTimeColumn_ = col;
 
-  viewport()->update();
+  invalidateItems_();
 }
 
 bool GanttChartView::collapseLevels() const
@@ -270,7 +251,7 @@ void GanttChartView::setCollapseLevels(bool collapse)
   if (collapseLevels_ == collapse)
     return;
   collapseLevels_ = collapse;
-  viewport()->update();
+  invalidateItems_();
 }
 
 double GanttChartView::currentTime() const
@@ -282,23 +263,46 @@ void GanttChartView::setCurrentTime(double newTime)
 {
   if (currentTime_ == newTime)
     return;
+  // Only the strips under the old and new lines need repainting; the bars come from the cached chart
+  const int oldX = currentTimeX_();
   currentTime_ = newTime;
-  viewport()->update();
+  const int newX = currentTimeX_();
+  viewport()->update(QRect(oldX - 1, 0, 3, viewport()->height()));
+  viewport()->update(QRect(newX - 1, 0, 3, viewport()->height()));
 }
 
 void GanttChartView::dataChanged(const QModelIndex & topLeft, const QModelIndex & bottomRight)
 {
-  viewport()->update();
+  invalidateItems_();
 }
 
 void GanttChartView::rowsInserted(const QModelIndex &parent, int start, int end)
 {
-  viewport()->update();
+  invalidateItems_();
 }
 
 void GanttChartView::rowsAboutToBeRemoved(const QModelIndex &parent, int start, int end)
 {
-  viewport()->update();
+  // Items are rebuilt lazily, after the rows are gone
+  invalidateItems_();
+}
+
+void GanttChartView::reset()
+{
+  QAbstractItemView::reset();
+  invalidateItems_();
+}
+
+void GanttChartView::setRootIndex(const QModelIndex& index)
+{
+  QAbstractItemView::setRootIndex(index);
+  invalidateItems_();
+}
+
+void GanttChartView::doItemsLayout()
+{
+  QAbstractItemView::doItemsLayout();
+  invalidateItems_();
 }
 
 bool GanttChartView::viewportEvent(QEvent *event)
@@ -342,90 +346,199 @@ void GanttChartView::paintEvent(QPaintEvent* event)
 
   updateGeometries_();
 
+  // Bars are only redrawn when the items or the view of them change
+  const int scroll = horizontalScrollBar()->value();
+  const double pixelsPerTime = scale_ * zoom_;
+  const qreal pixelRatio = viewport()->devicePixelRatioF();
+  if (chartDirty_ || chart_.size() != viewport()->size() * pixelRatio || chart_.devicePixelRatioF() != pixelRatio ||
+    chartScroll_ != scroll || chartPixelsPerTime_ != pixelsPerTime || chartFirstBegin_ != firstBegin_ || chartRange_ != range_)
+  {
+    drawChart_();
+    chartDirty_ = false;
+    chartScroll_ = scroll;
+    chartPixelsPerTime_ = pixelsPerTime;
+    chartFirstBegin_ = firstBegin_;
+    chartRange_ = range_;
+  }
+
   QPainter painter(viewport());
+  // Source rectangle is in the pixmap's device pixels
+  const QRectF rect(event->rect());
+  painter.drawPixmap(rect, chart_, QRectF(rect.topLeft() * pixelRatio, rect.size() * pixelRatio));
+
+  // Current time line is drawn over the cached chart
+  const int currTimeLineX = currentTimeX_();
+  painter.setPen(QColor(Qt::black));
+  painter.drawLine(currTimeLineX, 0, currTimeLineX, viewport()->height() - 1);
+}
+
+void GanttChartView::drawChart_()
+{
+  // Draw at device resolution so the chart stays sharp on high DPI screens; painting is still in logical pixels
+  const qreal pixelRatio = viewport()->devicePixelRatioF();
+  chart_ = QPixmap(viewport()->size() * pixelRatio);
+  chart_.setDevicePixelRatio(pixelRatio);
+  chart_.fill(viewport()->palette().color(viewport()->backgroundRole()));
+
+  QPainter painter(&chart_);
   // Move painter's coordinate system relative to the viewport
-  painter.translate(-horizontalScrollBar()->value(), 0);
+  const int scroll = horizontalScrollBar()->value();
+  painter.translate(-scroll, 0);
 
   // Draw reference lines
   painter.setPen(Qt::DashLine);
 
-  const double spacingPixels = (referenceLineSpacing_ * (scale_ * zoom_));
+  const double pixelsPerTime = scale_ * zoom_;
+  const double spacingPixels = (referenceLineSpacing_ * pixelsPerTime);
 
   // If spacingPixels <= 1, the reference lines are drawn on every pixel of the viewport.  This defeats the purpose.
   if (drawReferenceLines_ && spacingPixels > 1)
   {
-    for (double x = 0; x < range_ * (scale_ * zoom_); x += spacingPixels)
+    // Start at the first line inside the viewport
+    const double chartEndX = std::min(range_ * pixelsPerTime, static_cast<double>(scroll + viewport()->width()));
+    for (double x = std::floor(scroll / spacingPixels) * spacingPixels; x < chartEndX; x += spacingPixels)
     {
       painter.drawLine(x, 0, x, viewport()->height() - 1);
     }
   }
 
-  int numLayers = 0;
-  if (collapseLevels_)
-    numLayers = model()->rowCount(rootIndex());
-  else
+  updateItems_();
+  const int itemHeight = (numLayers_ != 0) ? (viewport()->height() / numLayers_) : 0;
+  if (items_.empty() || pixelsPerTime <= 0)
+    return;
+
+  painter.setPen(Qt::SolidLine);
+  const double chartEnd = firstBegin_ + range_;
+  // Visible time range; items ending just before it may still show their icon
+  const double visibleBegin = firstBegin_ + (scroll - ICON_MARGIN - iconSize_) / pixelsPerTime;
+  const double visibleEnd = firstBegin_ + (scroll + viewport()->width()) / pixelsPerTime;
+
+  size_t first = 0;
+  size_t last = 0;
+  itemsInTimeRange_(std::max(visibleBegin, firstBegin_), std::min(visibleEnd, chartEnd), first, last);
+  for (size_t k = first; k < last; ++k)
   {
-    for (int layer = 0; layer < model()->rowCount(rootIndex()); layer++)
+    const Item& item = items_[k];
+    // If the end of the item is before the beginning of the chart or the beginning of the item is after the end of the chart, the entire item is out of bounds and requires special processing
+    if (item.end >= visibleBegin && item.end >= firstBegin_ && item.begin <= chartEnd)
+      drawItem_(item, itemHeight, painter);
+  }
+
+  // Entire item is before beginning of chart.  Draw an arrow at the beginning of the chart pointing towards it
+  if (scroll < itemHeight)
+  {
+    const size_t end = std::lower_bound(begins_.begin(), begins_.end(), firstBegin_) - begins_.begin();
+    for (size_t k = 0; k < end; ++k)
     {
-      numLayers += model()->rowCount(model()->index(layer, 0, rootIndex()));
+      if (items_[k].end < firstBegin_)
+        drawArrowLeft_(items_[k].layer, itemHeight, items_[k].color, painter);
     }
   }
 
-  int itemHeight = (numLayers != 0) ? (viewport()->height() / numLayers) : 0;
-  int itemNum = 0;
-  int layer = 0;
-
-  painter.setPen(Qt::SolidLine);
-  // Each child of the root item
-  for (int parent = 0; parent < model()->rowCount(rootIndex()); parent++)
+  // Entire item is after end of chart.  Draw an arrow at the end of the chart pointing towards it
+  if (range_ * pixelsPerTime - itemHeight <= scroll + viewport()->width())
   {
-    QModelIndex parentIndex = model()->index(parent, 0, rootIndex());
+    const size_t begin = std::upper_bound(begins_.begin(), begins_.end(), chartEnd) - begins_.begin();
+    for (size_t k = begin; k < items_.size(); ++k)
+      drawArrowRight_(items_[k].layer, itemHeight, items_[k].color, painter);
+  }
+}
 
-    if (collapseLevels_)
-      layer = parent;
+int GanttChartView::currentTimeX_() const
+{
+  const double x = (currentTime_ - firstBegin_) * (scale_ * zoom_) - horizontalScrollBar()->value();
+  // Keep positions outside the viewport representable as int
+  return static_cast<int>(std::max(-1.0, std::min(x, viewport()->width() + 1.0)));
+}
 
-    // Each item in the row
-    for (int itemInLayer = 0; itemInLayer < model()->rowCount(parentIndex); itemInLayer++)
-    {
-      if (!collapseLevels_)
-      {
-        layer = itemNum;
-        itemNum++;
-      }
+void GanttChartView::invalidateItems_()
+{
+  itemsDirty_ = true;
+  invalidateChart_();
+}
+
+void GanttChartView::invalidateChart_()
+{
+  chartDirty_ = true;
+  viewport()->update();
+}
+
+bool GanttChartView::itemBeginLess_(const Item& lhs, const Item& rhs)
+{
+  return lhs.begin < rhs.begin;
+}
+
+void GanttChartView::updateItems_() const
+{
+  if (!itemsDirty_)
+    return;
+  itemsDirty_ = false;
+  items_.clear();
+  begins_.clear();
+  maxEnds_.clear();
+  numLayers_ = 0;
+  itemsFirstBegin_ = std::numeric_limits<double>::max();
+  itemsLastEnd_ = -std::numeric_limits<double>::max();
+  if (!model())
+    return;
 
-      QModelIndex itemIndex = model()->index(itemInLayer, 0, parentIndex);
-      QColor color = model()->data(itemIndex, Qt::ForegroundRole).value<QColor>();
-      QIcon icon = model()->data(itemIndex, Qt::DecorationRole).value<QIcon>();
+  // Read every item from the model once
+  int itemNum = 0;
+  const int numParents = model()->rowCount(rootIndex());
+  for (int parent = 0; parent < numParents; parent++)
+  {
+    const QModelIndex parentIndex = model()->index(parent, 0, rootIndex());
+    const int numItems = model()->rowCount(parentIndex);
+    for (int itemInLayer = 0; itemInLayer < numItems; itemInLayer++)
+    {
+      Item item;
+      item.layer = collapseLevels_ ? parent : itemNum;
+      ++itemNum;
+      item.parentRow = parent;
+      item.row = itemInLayer;
 
-      QModelIndex beginIndex = model()->index(itemInLayer, beginTimeColumn_, parentIndex);
-      double begin = model()->data(beginIndex, beginTimeRole_).toDouble(0);
+      const QModelIndex itemIndex = model()->index(itemInLayer, 0, parentIndex);
+      item.color = model()->data(itemIndex, Qt::ForegroundRole).value<QColor>();
+      item.icon = model()->data(itemIndex, Qt::DecorationRole).value<QIcon>();
 
-      QModelIndex endIndex = model()->index(itemInLayer, endTimeColumn_, parentIndex);
-      double end = model()->data(endIndex, endTimeRole_).toDouble(0);
+      const QModelIndex beginIndex = model()->index(itemInLayer, beginTimeColumn_, parentIndex);
+      item.begin = model()->data(beginIndex, beginTimeRole_).toDouble(0);
+      const QModelIndex endIndex = model()->index(itemInLayer, endTimeColumn_, parentIndex);
+      item.end = model()->data(endIndex, endTimeRole_).toDouble(0);
 
       // Handle cases where the beginning is after the end
-      if (begin > end)
+      if (item.begin > item.end)
       {
-        std::swap(begin, end);
+        std::swap(item.begin, item.end);
       }
 
-      // If the end of the item is before the beginning of the chart or the beginning of the item is after the end of the chart, the entire item is out of bounds and requires special processing
-      if (end >= firstBegin_ && begin <= (firstBegin_ + range_))
-        drawItem_(layer, itemHeight, itemInLayer, parentIndex, painter);
-
-      // Entire item is after end of chart.  Draw an arrow at the end of the chart pointing towards it
-      else if (begin > (firstBegin_ + range_))
-        drawArrowRight_(layer, itemHeight, color, painter);
-
-      // Entire item is before beginning of chart.  Draw an arrow at the beginning of the chart pointing towards it
-      else
-        drawArrowLeft_(layer, itemHeight, color, painter);
+      itemsFirstBegin_ = std::min(itemsFirstBegin_, item.begin);
+      itemsLastEnd_ = std::max(itemsLastEnd_, item.end);
+      items_.push_back(item);
     }
   }
+  numLayers_ = collapseLevels_ ? numParents : itemNum;
+
+  // Sort by begin time, with a running maximum of end times; together these find the items overlapping a time range
+  std::stable_sort(items_.begin(), items_.end(), &GanttChartView::itemBeginLess_);
+  begins_.reserve(items_.size());
+  maxEnds_.reserve(items_.size());
+  double maxEnd = -std::numeric_limits<double>::max();
+  for (std::vector<Item>::const_iterator i = items_.begin(); i != items_.end(); ++i)
+  {
+    maxEnd = std::max(maxEnd, i->end);
+    begins_.push_back(i->begin);
+    maxEnds_.push_back(maxEnd);
+  }
+}
 
-  double currTimeLineX = (currentTime_ - firstBegin_) * (scale_ * zoom_);
-  painter.setPen(QColor(Qt::black));
-  painter.drawLine(currTimeLineX, 0, currTimeLineX, viewport()->height() - 1);
+void GanttChartView::itemsInTimeRange_(double beginTime, double endTime, size_t& first, size_t& last) const
+{
+  // No item before the first whose running maximum end reaches beginTime can overlap; none after the last that begins by endTime can either
+  first = std::lower_bound(maxEnds_.begin(), maxEnds_.end(), beginTime) - maxEnds_.begin();
+  last = std::upper_bound(begins_.begin(), begins_.end(), endTime) - begins_.begin();
+  if (last < first)
+    last = first;
 }
 
 void GanttChartView::mouseDoubleClickEvent(QMouseEvent* event)
@@ -552,37 +665,13 @@ void GanttChartView::updateEndpoints_()
 {
   firstBegin_ = std::numeric_limits<double>::max();
   double lastEnd = -std::numeric_limits<double>::max();
-  int numLayers = 0;
-
-  // If model is null, the for loop is skipped and we still get a reasonable default value for scale_
-  if (model())
-    numLayers = model()->rowCount(rootIndex());
 
   if (!useCustomBounds_)
   {
     // Determine the bound of start and end points
-    for (int layer = 0; layer < numLayers; layer++)
-    {
-      QModelIndex layerIndex = model()->index(layer, 0, rootIndex());
-
-      for (int itemInLayer = 0; itemInLayer < model()->rowCount(layerIndex); itemInLayer++)
-      {
-        QModelIndex beginIndex = model()->index(itemInLayer, 1, layerIndex);
-        double begin = model()->data(beginIndex, Qt::DisplayRole).toDouble(0);
-
-        QModelIndex endIndex = model()->index(itemInLayer, 2, layerIndex);
-        double end = model()->data(endIndex, Qt::DisplayRole).toDouble(0);
-
-        // Handle cases where the beginning is after the end
-        if (begin > end)
-        {
-          std::swap(begin, end);
-        }
-
-        firstBegin_ = (firstBegin_ > begin) ? begin : firstBegin_;
-        lastEnd = (lastEnd < end) ? end : lastEnd;
-      }
-    }
+    updateItems_();
+    firstBegin_ = itemsFirstBegin_;
+    lastEnd = itemsLastEnd_;
   }
   else
   {
@@ -623,7 +712,7 @@ double GanttChartView::customStart() const
 void GanttChartView::setCustomStart(double newStart)
 {
   customStart_ = newStart;
-  viewport()->update();
+  invalidateChart_();
 }
 
 double GanttChartView::customEnd() const
@@ -634,7 +723,7 @@ double GanttChartView::customEnd() const
 void GanttChartView::setCustomEnd(double newEnd)
 {
   customEnd_ = newEnd;
-  viewport()->update();
+  invalidateChart_();
 }
 
 bool GanttChartView::usingCustomBounds() const
@@ -645,20 +734,15 @@ bool GanttChartView::usingCustomBounds() const
 void GanttChartView::setUseCustomBounds(bool useCustom)
 {
   useCustomBounds_ = useCustom;
-  viewport()->update();
+  invalidateChart_();
 }
 
-void GanttChartView::drawItem_(int itemLayer, double layerHeight, int indexInLayer, const QModelIndex& parent, QPainter& painter) const
+void GanttChartView::drawItem_(const Item& item, double layerHeight, QPainter& painter) const
 {
-  QModelIndex itemIndex = model()->index(indexInLayer, 0, parent);
-  QColor color = model()->data(itemIndex, Qt::ForegroundRole).value<QColor>();
-  QIcon icon = model()->data(itemIndex, Qt::DecorationRole).value<QIcon>();
-
-  QModelIndex beginIndex = model()->index(indexInLayer, beginTimeColumn_, parent);
-  double begin = model()->data(beginIndex, beginTimeRole_).toDouble(0);
-
-  QModelIndex endIndex = model()->index(indexInLayer, endTimeColumn_, parent);
-  double end = model()->data(endIndex, endTimeRole_).toDouble(0);
+  const int itemLayer = item.layer;
+  const double begin = item.begin;
+  const double end = item.end;
+  const QColor& color = item.color;
 
   painter.fillRect((begin - firstBegin_) * (scale_ * zoom_), layerHeight * itemLayer, (end - begin) * (scale_ * zoom_), layerHeight, color);
 
@@ -674,7 +758,7 @@ void GanttChartView::drawItem_(int itemLayer, double layerHeight, int indexInLay
   // Draw the icon to the right of the item
   double centerY = ((layerHeight * itemLayer) + layerHeight / 2);
 
-  icon.paint(&painter, QRect((end - firstBegin_) * (scale_ * zoom_) + ICON_MARGIN, centerY - (iconSize_ / 2), iconSize_, iconSize_));
+  item.icon.paint(&painter, QRect((end - firstBegin_) * (scale_ * zoom_) + ICON_MARGIN, centerY - (iconSize_ / 2), iconSize_, iconSize_));
 }
 
 void GanttChartView::drawArrowLeft_(int itemLayer, double layerHeight, const QColor& color, QPainter& painter) const
@@ -22,7 +22,11 @@
 #ifndef SIMQT_GANTTCHARTVIEW_H
 #define SIMQT_GANTTCHARTVIEW_H
 
+#include <vector>
 #include <QAbstractItemView>
+#include <QColor>
+#include <QIcon>
+#include <QPixmap>
 #include "simCore/Common/Common.h"
 
 namespace simQt
@@ -39,6 +43,10 @@ namespace simQt
  * and decorationRole of the first column of that item's row.  Column and role of begin and end times
  * can be changed with the set(Begin/End)TimeRole and set(Begin/End)TimeColumn methods, but they must be
  * in the item's row.
+ *
+ * Items are read from the model once per change and kept sorted by begin time, so painting only visits the
+ * items in the visible time range.  Bars are painted into a cached pixmap; the current time line is drawn
+ * over it, so changing the current time does not repaint the bars.
  */
 class SDKQT_EXPORT GanttChartView : public QAbstractItemView
 {
@@ -124,6 +132,14 @@ public:
   /** Set true to use custom start and end times as bounds, false to calculate bounds to fit contents */
   void setUseCustomBounds(bool useCustomBounds);
 
+public slots:
+  /** Rebuild the cached items when the model is reset */
+  virtual void reset();
+  /** Rebuild the cached items when the root changes */
+  virtual void setRootIndex(const QModelIndex& index);
+  /** Rebuild the cached items when the model layout changes */
+  virtual void doItemsLayout();
+
 signals:
   /** Emits value in time of x-coordinate clicked */
   void timeValueAtPositionClicked(double timeValue);
@@ -159,6 +175,18 @@ protected:
   virtual QRegion visualRegionForSelection(const QItemSelection &selection) const;
 
 private:
+  /** Item read from the model */
+  struct Item
+  {
+    double begin; ///< begin time, no greater than end
+    double end; ///< end time
+    int layer; ///< horizontal level the item is drawn on
+    int parentRow; ///< row of the parent under the root index
+    int row; ///< row of the item under its parent
+    QColor color; ///< foreground color
+    QIcon icon; ///< decoration icon
+  };
+
   /** Update the horizontal scroll bar's range */
   void updateGeometries_();
   /** Update range_ and firstBegin_ */
@@ -166,8 +194,23 @@ private:
   /** Check to see if the chart is empty */
   bool isEmpty_() const;
 
+  /** Rereads the items from the model if they have changed */
+  void updateItems_() const;
+  /** Sets [first,last) to the range of items_ to check for overlap with [beginTime,endTime]; items in the range may still end before beginTime */
+  void itemsInTimeRange_(double beginTime, double endTime, size_t& first, size_t& last) const;
+  /** Orders items by begin time */
+  static bool itemBeginLess_(const Item& lhs, const Item& rhs);
+  /** Marks the items as changed and schedules a repaint */
+  void invalidateItems_();
+  /** Marks the cached chart as changed and schedules a repaint */
+  void invalidateChart_();
+  /** Draws the reference lines, items and arrows into chart_ */
+  void drawChart_();
+  /** Viewport x-coordinate of the current time line */
+  int currentTimeX_() const;
+
   /** Draws a single item in the gantt chart */
-  void drawItem_(int itemLayer, double layerHeight, int indexInLayer, const QModelIndex& parent, QPainter& painter) const;
+  void drawItem_(const Item& item, double layerHeight, QPainter& painter) const;
   /** Draws an arrow indicating an item completely out of bounds before valid range of gantt chart */
   void drawArrowLeft_(int itemLayer, double layerHeight, const QColor& color, QPainter& painter) const;
   /** Draws an arrow indicating an item completely out of bounds after valid range of gantt chart */
@@ -207,6 +250,34 @@ private:
   double customEnd_;
   /// Whether bounds should be calculated to fit entries or set explicitly.  False to calculate from entries, true to use explicit bounds
   bool useCustomBounds_;
+
+  /// True if items_ needs to be reread from the model
+  mutable bool itemsDirty_;
+  /// Items from the model, sorted by begin time
+  mutable std::vector<Item> items_;
+  /// Begin time of each entry in items_
+  mutable std::vector<double> begins_;
+  /// Maximum end time of items_ up to and including each entry
+  mutable std::vector<double> maxEnds_;
+  /// Number of horizontal levels
+  mutable int numLayers_;
+  /// Earliest begin time of all items
+  mutable double itemsFirstBegin_;
+  /// Latest end time of all items
+  mutable double itemsLastEnd_;
+
+  /// Reference lines, items and arrows as last drawn, without the current time line
+  QPixmap chart_;
+  /// True if chart_ needs to be redrawn
+  bool chartDirty_;
+  /// Scroll position chart_ was drawn at
+  int chartScroll_;
+  /// Pixels per unit of time chart_ was drawn at
+  double chartPixelsPerTime_;
+  /// First endpoint chart_ was drawn at
+  double chartFirstBegin_;
+  /// Range chart_ was drawn at
+  double chartRange_;
 };
 
 }
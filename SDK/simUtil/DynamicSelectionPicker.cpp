@@ -19,6 +19,8 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include "osg/Viewport"
 #include "simCore/Calc/Math.h"
 #include "simVis/LobGroup.h"
 #include "simVis/Platform.h"
@@ -96,7 +98,11 @@ DynamicSelectionPicker::DynamicSelectionPicker(simVis::ViewManager* viewManager,
     viewManager_(viewManager),
     scenario_(scenarioManager),
     maximumValidRange_(100.0), // pixels
-    pickMask_(simVis::DISPLAY_MASK_PLATFORM|simVis::DISPLAY_MASK_PLATFORM_MODEL)
+    pickMask_(simVis::DISPLAY_MASK_PLATFORM|simVis::DISPLAY_MASK_PLATFORM_MODEL),
+    index_(maximumValidRange_),
+    indexOverhead_(false),
+    indexRevision_(0),
+    indexValid_(false)
 {
   // By default, only platforms are picked.  Gates are feasibly pickable though.
   guiEventHandler_ = new RepickEventHandler(*this);
@@ -119,34 +125,23 @@ DynamicSelectionPicker::~DynamicSelectionPicker()
 
 void DynamicSelectionPicker::pickThisFrame_()
 {
-  // Create a calculator for screen coordinates
-  simUtil::ScreenCoordinateCalculator calc;
-  calc.updateMatrix(*lastMouseView_);
-
-  // Request all entities from the scenario
-  simVis::EntityVector allEntities;
-  scenario_->getAllEntities(allEntities);
+  if (!lastMouseView_.valid() || !scenario_.valid() || updateIndex_(*lastMouseView_) != 0)
+  {
+    setPicked_(0, NULL);
+    return;
+  }
 
-  // We square the range to avoid sqrt() in a tight loop
-  double closestRangePx = osg::square(maximumValidRange_);
+  // Neighbors are sorted by range, so the first pickable one is the closest
+  std::vector<simCore::GridIndex::Neighbor> neighbors;
+  index_.findWithinRadius(mouseXy_.x(), mouseXy_.y(), maximumValidRange_, neighbors);
   simVis::EntityNode* closest = NULL;
-
-  // Loop through all entities
-  for (auto i = allEntities.begin(); i != allEntities.end(); ++i)
+  for (auto i = neighbors.begin(); i != neighbors.end(); ++i)
   {
-    if (!isPickable_(i->get()))
-      continue;
-
-    // Ask the calculator for the range from the mouse position
-    double rangeSquared;
-    if (calculateSquaredRange_(calc, *i->get(), rangeSquared) != 0)
-      continue;
-
-    // Choose the closest object
-    if (rangeSquared < closestRangePx)
+    simVis::EntityNode* entityNode = indexEntities_[i->second].get();
+    if (isPickable_(entityNode))
     {
-      closestRangePx = rangeSquared;
-      closest = i->get();
+      closest = entityNode;
+      break;
     }
   }
 
@@ -157,58 +152,114 @@ void DynamicSelectionPicker::pickThisFrame_()
     setPicked_(0, closest);
 }
 
-bool DynamicSelectionPicker::isPickable_(const simVis::EntityNode* entityNode) const
+void DynamicSelectionPicker::pickBox(simVis::View* view, const osg::Vec2d& corner1, const osg::Vec2d& corner2, simVis::EntityVector& entities)
 {
-  // Avoid NULL and things that don't match the mask
-  if (entityNode == NULL || (entityNode->getNodeMask() & pickMask_) == 0)
-    return false;
-  // Only pick entities with object index tags
-  if (entityNode->objectIndexTag() == 0)
-    return false;
+  entities.clear();
+  if (view == NULL || !scenario_.valid() || updateIndex_(*view) != 0)
+    return;
 
-  // Do not pick inactive or invisible entities
-  return entityNode->isActive() && entityNode->isVisible();
+  // LOBs may be found at several end points; sorting keeps the output in scenario order
+  std::vector<size_t> items;
+  index_.findInBox(corner1.x(), corner1.y(), corner2.x(), corner2.y(), items);
+  std::sort(items.begin(), items.end());
+  items.erase(std::unique(items.begin(), items.end()), items.end());
+  for (auto i = items.begin(); i != items.end(); ++i)
+  {
+    simVis::EntityNode* entityNode = indexEntities_[*i].get();
+    if (isPickable_(entityNode))
+      entities.push_back(entityNode);
+  }
 }
 
-int DynamicSelectionPicker::calculateSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::EntityNode& entityNode, double& rangeSquared) const
+int DynamicSelectionPicker::updateIndex_(simVis::View& view)
 {
-  // Fall back to the LOB case if it's requesting a LOB, since it picks individual points on the lines shown
-  const simVis::LobGroupNode* lobNode = dynamic_cast<const simVis::LobGroupNode*>(&entityNode);
-  if (lobNode)
-    return calculateLobSquaredRange_(calc, *lobNode, rangeSquared);
-
-  const simUtil::ScreenCoordinate& pos = calc.calculate(entityNode);
-  // Ignore objects that are off screen or behind the camera
-  if (pos.isBehindCamera() || pos.isOffScreen() || pos.isOverHorizon())
+  const osg::Camera* camera = view.getCamera();
+  if (camera == NULL || camera->getViewport() == NULL)
     return 1;
-  rangeSquared = (mouseXy_ - pos.position()).length2();
+
+  // Reuse the index until the camera moves or the entities change.  Pick mask, active and
+  // visible state are checked at query time, so they do not invalidate the index.
+  const osg::Matrixd viewProjectionWindow = camera->getViewMatrix() * camera->getProjectionMatrix() * camera->getViewport()->computeWindowMatrix();
+  const unsigned int revision = scenario_->entityRevision();
+  if (indexValid_ && indexView_.get() == &view && indexMatrix_ == viewProjectionWindow &&
+    indexOverhead_ == view.isOverheadEnabled() && indexRevision_ == revision)
+    return 0;
+
+  // Create a calculator for screen coordinates
+  simUtil::ScreenCoordinateCalculator calc;
+  calc.updateMatrix(view);
+
+  // Request all entities from the scenario
+  simVis::EntityVector allEntities;
+  scenario_->getAllEntities(allEntities);
+
+  index_.clear();
+  index_.reserve(allEntities.size());
+  indexEntities_.clear();
+  indexEntities_.reserve(allEntities.size());
+  for (auto i = allEntities.begin(); i != allEntities.end(); ++i)
+  {
+    // Entities without object index tags are never pickable
+    if (i->valid() && (*i)->objectIndexTag() != 0)
+      indexEntity_(calc, *i->get());
+  }
+  index_.build();
+
+  indexView_ = &view;
+  indexMatrix_ = viewProjectionWindow;
+  indexOverhead_ = view.isOverheadEnabled();
+  indexRevision_ = revision;
+  indexValid_ = true;
   return 0;
 }
 
-int DynamicSelectionPicker::calculateLobSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::LobGroupNode& lobNode, double& rangeSquared) const
+void DynamicSelectionPicker::indexEntity_(simUtil::ScreenCoordinateCalculator& calc, simVis::EntityNode& entityNode)
 {
-  rangeSquared = std::numeric_limits<double>::max();
-  // Pull out the vector of all endpoints on the LOB that are visible
-  std::vector<osg::Vec3d> ecefVec;
-  lobNode.getVisibleEndPoints(ecefVec);
-  if (ecefVec.empty())
-    return 1;
+  const size_t item = indexEntities_.size();
+  indexEntities_.push_back(&entityNode);
 
-  for (auto i = ecefVec.begin(); i != ecefVec.end(); ++i)
+  // LOBs pick on the individual points on the lines shown
+  const simVis::LobGroupNode* lobNode = dynamic_cast<const simVis::LobGroupNode*>(&entityNode);
+  if (lobNode)
   {
-    const simUtil::ScreenCoordinate& pos = calc.calculateEcef(simCore::Vec3(i->x(), i->y(), i->z()));
-    // Ignore objects that are off screen or behind the camera
-    if (pos.isBehindCamera() || pos.isOffScreen() || pos.isOverHorizon())
-      continue;
-    rangeSquared = simCore::sdkMin(rangeSquared, (mouseXy_ - pos.position()).length2());
+    // Pull out the vector of all endpoints on the LOB that are visible
+    std::vector<osg::Vec3d> ecefVec;
+    lobNode->getVisibleEndPoints(ecefVec);
+    for (auto i = ecefVec.begin(); i != ecefVec.end(); ++i)
+    {
+      const simUtil::ScreenCoordinate& pos = calc.calculateEcef(simCore::Vec3(i->x(), i->y(), i->z()));
+      // Ignore objects that are off screen or behind the camera
+      if (!pos.isBehindCamera() && !pos.isOffScreen() && !pos.isOverHorizon())
+        index_.insert(pos.position().x(), pos.position().y(), item);
+    }
+    return;
   }
 
-  return (rangeSquared == std::numeric_limits<double>::max()) ? 1 : 0;
+  const simUtil::ScreenCoordinate& pos = calc.calculate(entityNode);
+  // Ignore objects that are off screen or behind the camera
+  if (!pos.isBehindCamera() && !pos.isOffScreen() && !pos.isOverHorizon())
+    index_.insert(pos.position().x(), pos.position().y(), item);
+}
+
+bool DynamicSelectionPicker::isPickable_(const simVis::EntityNode* entityNode) const
+{
+  // Avoid NULL and things that don't match the mask
+  if (entityNode == NULL || (entityNode->getNodeMask() & pickMask_) == 0)
+    return false;
+  // Only pick entities with object index tags
+  if (entityNode->objectIndexTag() == 0)
+    return false;
+
+  // Do not pick inactive or invisible entities
+  return entityNode->isActive() && entityNode->isVisible();
 }
 
 void DynamicSelectionPicker::setRange(double pixelsFromCenter)
 {
   maximumValidRange_ = pixelsFromCenter;
+  // Cells on the order of the pick range keep each pick to a few cells
+  index_.setCellSize(maximumValidRange_);
+  indexValid_ = false;
 }
 
 void DynamicSelectionPicker::setPickMask(osg::Node::NodeMask pickMask)
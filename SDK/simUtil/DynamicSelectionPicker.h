@@ -22,10 +22,12 @@
 #ifndef SIMUTIL_DYNAMICSELECTIONPICKER_H
 #define SIMUTIL_DYNAMICSELECTIONPICKER_H
 
+#include <vector>
+#include "osg/Matrix"
+#include "simCore/Calc/GridIndex.h"
 #include "simCore/Common/Export.h"
 #include "simVis/Picker.h"
-
-namespace simVis { class LobGroupNode; }
+#include "simVis/Types.h"
 
 namespace simUtil
 {
@@ -44,6 +46,10 @@ class ScreenCoordinateCalculator;
  * This picker supports picking of only platforms and gates at this time.  The gate picking is
  * based off gate locator, which is at the centroid node.  Gate picking is disabled by default.
  * Use the setPickMask() method to change this behavior.
+ *
+ * Projected entity positions are kept in a screen-space grid that is reused across mouse
+ * events until the camera or the entities move, so that each pick only examines entities
+ * near the mouse.
  */
 class SDKUTIL_EXPORT DynamicSelectionPicker : public simVis::Picker
 {
@@ -61,6 +67,17 @@ public:
   /** Retrieves the current pick mask. */
   osg::Node::NodeMask pickMask() const;
 
+  /**
+   * Retrieves pickable entities with a screen position inside the box, for box selection.  Corners are
+   * in pixels with the origin at the lower-left, like mouse events.  LOBs are included if any visible end
+   * point is inside the box.
+   * @param view View in which to project entity positions
+   * @param corner1 One corner of the box
+   * @param corner2 Opposite corner of the box
+   * @param entities Filled with the pickable entities inside the box
+   */
+  void pickBox(simVis::View* view, const osg::Vec2d& corner1, const osg::Vec2d& corner2, simVis::EntityVector& entities);
+
 protected:
   /** Derived from osg::Referenced, protect destructor */
   virtual ~DynamicSelectionPicker();
@@ -70,10 +87,10 @@ private:
   void pickThisFrame_();
   /** Returns true if the entity type is pickable. */
   bool isPickable_(const simVis::EntityNode* entityNode) const;
-  /** Calculates the squared range from the mouse for the given entity, returning 0 on success */
-  int calculateSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::EntityNode& entityNode, double& rangeSquared) const;
-  /** Special case calculation for LOBs, called by calculateSquaredRange_() automatically */
-  int calculateLobSquaredRange_(simUtil::ScreenCoordinateCalculator& calc, const simVis::LobGroupNode& lobNode, double& rangeSquared) const;
+  /** Rebuilds the screen-space index if the view, camera, or entities changed since it was built; returns 0 on success */
+  int updateIndex_(simVis::View& view);
+  /** Adds the on-screen positions of the entity to the index; LOBs add each visible end point */
+  void indexEntity_(simUtil::ScreenCoordinateCalculator& calc, simVis::EntityNode& entityNode);
 
   class RepickEventHandler;
 
@@ -96,6 +113,21 @@ private:
   double maximumValidRange_;
   /** Picking mask */
   osg::Node::NodeMask pickMask_;
+
+  /** Screen-space index of projected entity positions; items are offsets into indexEntities_ */
+  simCore::GridIndex index_;
+  /** Entities referenced by the index */
+  std::vector< osg::observer_ptr<simVis::EntityNode> > indexEntities_;
+  /** View for which the index was built */
+  osg::observer_ptr<simVis::View> indexView_;
+  /** View * projection * window matrix at the time the index was built */
+  osg::Matrixd indexMatrix_;
+  /** Overhead mode at the time the index was built */
+  bool indexOverhead_;
+  /** Scenario entity revision at the time the index was built */
+  unsigned int indexRevision_;
+  /** True once the index has been built */
+  bool indexValid_;
 };
 
 }
@@ -59,6 +59,7 @@
 #include "simVis/GlowHighlight.h"
 #include "simVis/GOG/Annotation.h"
 #include "simVis/GOG/Arc.h"
+#include "simVis/GOG/BinaryFormat.h"
 #include "simVis/GOG/Circle.h"
 #include "simVis/GOG/Cylinder.h"
 #include "simVis/GOG/Ellipse.h"
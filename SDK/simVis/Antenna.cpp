@@ -20,8 +20,15 @@
  *
  */
 #include <limits>
+#include <map>
+#include <sstream>
+#include "OpenThreads/Mutex"
+#include "OpenThreads/ScopedLock"
 #include "osg/Geode"
 #include "osg/Geometry"
+#include "osg/observer_ptr"
+#include "osg/OperationThread"
+#include "osgEarth/NodeUtils"
 #include "osgEarthSymbology/MeshConsolidator"
 
 #include "simCore/Calc/Angle.h"
@@ -32,6 +39,7 @@
 #include "simVis/Constants.h"
 #include "simVis/Registry.h"
 #include "simVis/Utils.h"
+#include "simVis/WorkerPool.h"
 #include "simVis/Antenna.h"
 
 // enable this to draw axes at beam origin and at pattern face vertices, for testing only
@@ -77,32 +85,483 @@ namespace {
     vecNorm = normalRot * vecNorm;
     return vecNorm;
   }
+
+  /**
+  * Calculate the gain of the pattern for the given prefs
+  * @param[in] pattern the antenna pattern to evaluate
+  * @param[in] prefs beam prefs that supply the gain parameters
+  * @param[in] polarity polarity for the patterns that support it
+  * @param[in] azim azimuth of the sample, in radians
+  * @param[in] elev elevation of the sample, in radians
+  * @return gain in dB
+  */
+  float patternGain(simCore::AntennaPattern& pattern, const simData::BeamPrefs& prefs, simCore::PolarityType polarity, float azim, float elev)
+  {
+    // convert freq in MHz to Hz (note that freq is not actually used in any supported gain calcs)
+    const double freq = prefs.frequency() * 1e6;
+    switch (pattern.type())
+    {
+    case simCore::ANTENNA_PATTERN_MONOPULSE:
+      return pattern.gain(simCore::AntennaGainParameters(azim, elev, simCore::POLARITY_UNKNOWN, 0, 0, prefs.gain(), 0, 0, freq, false, prefs.channel()));
+    case simCore::ANTENNA_PATTERN_CRUISE:
+      return pattern.gain(simCore::AntennaGainParameters(azim, elev, simCore::POLARITY_UNKNOWN, 0, 0, 0, 0, 0, freq));
+    case simCore::ANTENNA_PATTERN_NSMA:
+    case simCore::ANTENNA_PATTERN_EZNEC:
+    case simCore::ANTENNA_PATTERN_XFDTD:
+      return pattern.gain(simCore::AntennaGainParameters(azim, elev, polarity, 0, 0, prefs.gain()));
+    default:
+      return pattern.gain(simCore::AntennaGainParameters(azim, elev, simCore::POLARITY_UNKNOWN, simCore::angFix2PI(prefs.horizontalwidth()), osg::absolute(simCore::angFixPI(prefs.verticalwidth())), prefs.gain(), -23.2f, -20.0f, freq, prefs.weighting()));
+    }
+    // this point should never be reached; if assert fails, logic in this routine has been changed
+    assert(0);
+    return prefs.gain();
+  }
 }
+
 namespace simVis
 {
+
+/**
+ * Antenna pattern loaded by a node and shared with its mesh builder.  Pattern gain calculations are
+ * not thread safe, so each call locks the pattern.
+ */
+class AntennaNode::SharedPattern : public osg::Referenced
+{
+public:
+  /** Takes ownership of the pattern */
+  explicit SharedPattern(simCore::AntennaPattern* pattern)
+    : pattern_(pattern)
+  {
+  }
+
+  /** Returns the gain in dB for the prefs; safe from any thread */
+  float gain(const simData::BeamPrefs& prefs, simCore::PolarityType polarity, float azim, float elev)
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    return patternGain(*pattern_, prefs, polarity, azim, elev);
+  }
+
+  /** Returns the minimum and maximum gain; safe from any thread */
+  void minMaxGain(float* min, float* max, const simCore::AntennaGainParameters& params)
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    pattern_->minMaxGain(min, max, params);
+  }
+
+protected:
+  virtual ~SharedPattern()
+  {
+    delete pattern_;
+  }
+
+private:
+  simCore::AntennaPattern* pattern_;
+  OpenThreads::Mutex mutex_;
+};
+
+/**
+ * Generates the antenna pattern mesh from a snapshot of the beam prefs, using the pattern loaded
+ * by the node.  Gain is evaluated once per azimuth/elevation grid point; the triangle strips and
+ * the side faces reuse the grid.
+ */
+class AntennaNode::MeshBuilder : public osg::Operation
+{
+public:
+  /** Snapshots the prefs used to generate the mesh */
+  MeshBuilder(const simData::BeamPrefs& prefs, SharedPattern* pattern)
+    : osg::Operation("simVis::AntennaNode::MeshBuilder", false),
+      prefs_(prefs),
+      pattern_(pattern),
+      done_(false),
+      colorUtils_(0.3f),
+      colorScale_(false)
+  {
+  }
+
+  /** Returns a key that is equal for all prefs that generate the same mesh */
+  static std::string key(const simData::BeamPrefs& prefs, const std::string& patternFile)
+  {
+    std::ostringstream os;
+    os.precision(17);
+    os << patternFile << '\n' << prefs.frequency() << ' ' << prefs.polarity() << ' ' << prefs.gain()
+      << ' ' << prefs.channel() << ' ' << prefs.weighting() << ' ' << prefs.horizontalwidth() << ' ' << prefs.verticalwidth()
+      << ' ' << prefs.fieldofview() << ' ' << prefs.detail() << ' ' << prefs.sensitivity() << ' ' << prefs.colorscale();
+    // Color prefs do not matter when coloring by gain
+    if (!prefs.colorscale())
+    {
+      const simData::CommonPrefs& common = prefs.commonprefs();
+      os << ' ' << (common.useoverridecolor() ? common.overridecolor() : common.color());
+    }
+    return os.str();
+  }
+
+  /** Runs on the worker thread */
+  virtual void operator()(osg::Object*)
+  {
+    build();
+  }
+
+  /** Generates the mesh; may be called from any thread */
+  void build()
+  {
+    osg::ref_ptr<osg::Node> mesh;
+    if (pattern_.valid())
+      mesh = createMesh_(*pattern_);
+    // The pattern is no longer needed; release it in case the node has moved on
+    pattern_ = NULL;
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(doneMutex_);
+    mesh_ = mesh;
+    done_ = true;
+  }
+
+  /** Returns true once build() has completed */
+  bool isDone() const
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(doneMutex_);
+    return done_;
+  }
+
+  /** Returns the generated mesh, or NULL if not done or if the prefs do not produce a mesh */
+  osg::Node* mesh() const
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(doneMutex_);
+    return mesh_.get();
+  }
+
+private:
+  /** Creates the pattern geometry, normalized to unit range */
+  osg::Node* createMesh_(SharedPattern& pattern)
+  {
+    const simCore::PolarityType polarity = static_cast<simCore::PolarityType>(prefs_.polarity());
+
+    // expected range for vRange is (0, M_PI]
+    const double vRange = osg::clampBetween(prefs_.fieldofview(), std::numeric_limits<double>::min(), M_PI);
+    // expected range for vRange is (0, M_TWOPI]
+    const double hRange = osg::clampBetween(prefs_.fieldofview(), std::numeric_limits<double>::min(), M_TWOPI);
+
+    // detail is in degrees, determines the step size between az and el points, expected value is [1, 10] degrees
+    const double degDetail = osg::clampBetween(prefs_.detail(), 1.0, 10.0);
+
+    const double endelev = simCore::RAD2DEG * vRange * 0.5;
+    const double startelev = simCore::RAD2DEG * vRange * -0.5;
+    // pre-calculate the elev points we are using
+    std::vector<float> elevPoints;
+    bool elevDone = false;
+    for (double elev = startelev; !elevDone; elev += degDetail)
+    {
+      if (elev >= endelev)
+      {
+        elev = endelev;
+        elevDone = true;
+      }
+      elevPoints.push_back(static_cast<float>(simCore::DEG2RAD * elev));
+    }
+
+    const double endazim = simCore::RAD2DEG * hRange * 0.5;
+    const double startazim = simCore::RAD2DEG * hRange * -0.5;
+    // pre-calculate the azim points we are using
+    std::vector<float> azimPoints;
+    bool azimDone = false;
+    for (double azim = startazim; !azimDone; azim += degDetail)
+    {
+      if (azim >= endazim)
+      {
+        azim = endazim;
+        azimDone = true;
+      }
+      azimPoints.push_back(static_cast<float>(simCore::DEG2RAD * azim));
+    }
+    // algorithms below require azimPoints > 1, so break out if we don't meet that requirement
+    if (azimPoints.size() < 2)
+      return NULL;
+
+    // determine pattern bounds in order to normalize
+    float minGain = HUGE_VAL;
+    float maxGain = -HUGE_VAL;
+    pattern.minMaxGain(&minGain, &maxGain, simCore::AntennaGainParameters(0, 0, polarity, simCore::angFix2PI(prefs_.horizontalwidth()), osg::absolute(simCore::angFixPI(prefs_.verticalwidth())), prefs_.gain(), -23.2f, -20.0f, prefs_.frequency() * 1e6, prefs_.weighting()));
+    // prevent divide by zero error for OMNI case
+    const float scaleFactor = (maxGain == minGain) ? 1.0f/maxGain : 1.0f/(maxGain - minGain);
+
+    // evaluate the pattern once per grid point; grid index is (azimIndex * numElev + elevIndex)
+    const size_t numAzim = azimPoints.size();
+    const size_t numElev = elevPoints.size();
+    std::vector<float> gains(numAzim * numElev);
+    std::vector<osg::Vec3f> points(numAzim * numElev);
+    for (size_t azimIndex = 0; azimIndex < numAzim; ++azimIndex)
+    {
+      const float azim = azimPoints[azimIndex];
+      for (size_t elevIndex = 0; elevIndex < numElev; ++elevIndex)
+      {
+        const float elev = elevPoints[elevIndex];
+        const size_t index = azimIndex * numElev + elevIndex;
+        gains[index] = pattern.gain(prefs_, polarity, azim, elev);
+
+        float radius;
+        if (gains[index] < simCore::SMALL_DB_COMPARE)
+          radius = 0.0;
+        // prevent multiply by zero error when fMin == fMax (OMNI case)
+        else if (minGain == maxGain)
+          radius = ((gains[index] > prefs_.sensitivity()) ? osg::absolute(gains[index]) * scaleFactor : 0.0f);
+        else
+          radius = ((gains[index] > prefs_.sensitivity()) ? osg::absolute(gains[index] - minGain) * scaleFactor : 0.0f);
+
+        // convert azim & elev to a rectangular coordinate
+        points[index].set(radius * cosf(azim) * cosf(elev),
+          radius * sinf(azim) * cosf(elev),
+          radius * sinf(elev));
+      }
+    }
+
+    osg::ref_ptr<osg::Geometry> antGeom = new osg::Geometry();
+    antGeom->setName("simVis::AntennaNode");
+    // the mesh is shared and never changes after generation
+    antGeom->setDataVariance(osg::Object::STATIC);
+    antGeom->setUseVertexBufferObjects(true);
+
+    verts_ = new osg::Vec3Array();
+    antGeom->setVertexArray(verts_.get());
+    norms_ = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
+    antGeom->setNormalArray(norms_.get());
+    colors_ = new osg::Vec4Array(osg::Array::BIND_PER_VERTEX);
+    antGeom->setColorArray(colors_.get());
+
+    colorScale_ = prefs_.colorscale();
+    color_ = (prefs_.commonprefs().useoverridecolor()) ? ColorUtils::RgbaToVec4(prefs_.commonprefs().overridecolor()) : ColorUtils::RgbaToVec4(prefs_.commonprefs().color());
+#ifdef DRAW_AXES
+    // draw axes to represent beam orientation
+    axes_ = new osg::Group;
+    axes_->addChild(new AxisVector());
+#endif
+
+    size_t lastCount = 0;
+    for (size_t azimIndex = 0; azimIndex + 1 < numAzim; ++azimIndex)
+    {
+      for (size_t elevIndex = 0; elevIndex < numElev; ++elevIndex)
+      {
+        // each strip pairs the point with its neighbor in the next azimuth column
+        for (size_t column = azimIndex; column <= azimIndex + 1; ++column)
+        {
+          const size_t index = column * numElev + elevIndex;
+          osg::Vec3f normalVec = points[index];
+          normalVec.normalize();
+          addVertex_(points[index], normalVec, gains[index]);
+        }
+      }
+      antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_STRIP, lastCount, verts_->size() - lastCount));
+      lastCount = verts_->size();
+    }
+
+    // draw top & bottom sides of pattern
+    if (vRange < M_PI)
+    {
+      // draw near face/bottom side of pattern
+      // TODO: for some patterns (gaussian), all bottom side points will be zero, and the entire side can be skipped
+      {
+        const float elev = elevPoints.front();
+        // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around y-axis by (elev + PI/2) radians
+        const osg::Quat& normalRot = osg::Quat(M_PI_2 - elev, osg::Y_AXIS);
+        addOrigin_(normalRot * osg::X_AXIS);
+
+        // reverse iteration to set correct polygon facing
+        for (size_t azimIndex = numAzim; azimIndex-- > 0;)
+        {
+          const size_t index = azimIndex * numElev;
+          addFaceVertex_(points[index], calcNormalXY(points[index]), gains[index], numAzim - 1 - azimIndex);
+        }
+        antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts_->size() - lastCount));
+        lastCount = verts_->size();
+      }
+
+      // draw near face/top side of pattern
+      // TODO: for some patterns (gaussian), all top side points will be zero, and the entire side can be skipped
+      {
+        const float elev = elevPoints.back();
+        // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around y-axis by (-pi/2 - elev) radians
+        const osg::Quat& normalRot = osg::Quat(-M_PI_2 - elev, osg::Y_AXIS);
+        addOrigin_(normalRot * osg::X_AXIS);
+
+        for (size_t azimIndex = 0; azimIndex < numAzim; ++azimIndex)
+        {
+          const size_t index = azimIndex * numElev + numElev - 1;
+          // sign change is required for top side
+          addFaceVertex_(points[index], -calcNormalXY(points[index]), gains[index], azimIndex);
+        }
+        antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts_->size() - lastCount));
+        lastCount = verts_->size();
+      }
+    } // end of (vRange < M_PI)
+
+    // draw right and left sides of pattern
+    if (hRange < M_TWOPI)
+    {
+      // draw right side of pattern
+      // TODO: for some patterns (pedestal), all right side points will be zero, and the entire right side can be skipped
+      {
+        const float azim = azimPoints.front();
+        // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around z-axis by azim - pi/2 radians
+        const osg::Quat& normalRot = osg::Quat(-M_PI_2 + azim, osg::Z_AXIS);
+        addOrigin_(normalRot * osg::X_AXIS);
+
+        for (size_t elevIndex = 0; elevIndex < numElev; ++elevIndex)
+          addFaceVertex_(points[elevIndex], calcNormalXZ(points[elevIndex]), gains[elevIndex], elevIndex);
+        antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts_->size() - lastCount));
+        lastCount = verts_->size();
+      }
+
+      // draw left side of pattern
+      // TODO: for some patterns (pedestal), all left side points will be zero, and the entire left side can be skipped
+      {
+        const float azim = azimPoints.back();
+        // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around z-axis by azim + pi/2 radians
+        const osg::Quat& normalRot = osg::Quat(M_PI_2 + azim, osg::Z_AXIS);
+        addOrigin_(normalRot * osg::X_AXIS);
+
+        // reverse iteration to set correct polygon facing
+        for (size_t elevIndex = numElev; elevIndex-- > 0;)
+        {
+          const size_t index = (numAzim - 1) * numElev + elevIndex;
+          // sign change is required for left side
+          addFaceVertex_(points[index], -calcNormalXZ(points[index]), gains[index], numElev - 1 - elevIndex);
+        }
+        antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts_->size() - lastCount));
+      }
+    } // end of (hRange < T_PI)
+
+    osg::ref_ptr<osg::Geode> geode = new osg::Geode();
+    geode->addDrawable(antGeom);
+
+    // optimize the geode:
+    osgEarth::Symbology::MeshConsolidator::run(*geode);
+#ifdef DRAW_AXES
+    axes_->addChild(geode);
+    return axes_.release();
+#else
+    return geode.release();
+#endif
+  }
+
+  /** Adds a vertex, colored by gain if color scale is on */
+  void addVertex_(const osg::Vec3f& pt, const osg::Vec3f& normalVec, float gain)
+  {
+    verts_->push_back(pt);
+    norms_->push_back(normalVec);
+    if (colorScale_)
+      colors_->push_back(colorUtils_.GainThresholdColor(static_cast<int>(gain)));
+    else
+      colors_->push_back(color_);
+  }
+
+  /** Adds the beam origin that is the center of a side's triangle fan */
+  void addOrigin_(const osg::Vec3f& normalVec)
+  {
+    verts_->push_back(osg::Vec3f(0.0f, 0.0f, 0.0f));
+    norms_->push_back(normalVec);
+    // color that corresponds to minimum gain (-100)
+    colors_->push_back(colorScale_ ? colorUtils_.GainThresholdColor(-100) : color_);
+  }
+
+  /** Adds a vertex of a side's triangle fan; fanIndex is the position in the fan, used for drawing axes */
+  void addFaceVertex_(const osg::Vec3f& pt, const osg::Vec3f& normalVec, float gain, size_t fanIndex)
+  {
+    addVertex_(pt, normalVec, gain);
+#ifdef DRAW_AXES
+    // draw axes to visualize the vertex normals, every 10th point of the triangle fan
+    if (fanIndex % 10 == 0)
+    {
+      AxisVector* axes = new AxisVector();
+      axes->setPositionOrientation(pt, normalVec);
+      axes_->addChild(axes);
+    }
+#endif
+  }
+
+  const simData::BeamPrefs prefs_;
+  /** Pattern used until the mesh is built */
+  osg::ref_ptr<SharedPattern> pattern_;
+  mutable OpenThreads::Mutex doneMutex_;
+  bool done_;
+  osg::ref_ptr<osg::Node> mesh_;
+
+  // Used while generating the mesh
+  ColorUtils colorUtils_;
+  bool colorScale_;
+  osg::Vec4f color_;
+  osg::ref_ptr<osg::Vec3Array> verts_;
+  osg::ref_ptr<osg::Vec3Array> norms_;
+  osg::ref_ptr<osg::Vec4Array> colors_;
+#ifdef DRAW_AXES
+  osg::ref_ptr<osg::Group> axes_;
+#endif
+};
+
+/**
+ * Shares meshes between antenna nodes.  Meshes are held weakly; a mesh is released when no antenna
+ * node uses it.
+ */
+class AntennaNode::MeshCache
+{
+public:
+  /** Returns the cache shared by all antenna nodes */
+  static MeshCache& instance()
+  {
+    static MeshCache s_cache;
+    return s_cache;
+  }
+
+  /**
+   * Returns the mesh for the prefs, queuing its generation on the worker pool if no antenna node
+   * holds a matching mesh.  The pattern must be loaded from the pattern file for the prefs.
+   */
+  osg::ref_ptr<MeshBuilder> get(const simData::BeamPrefs& prefs, const std::string& patternFile, SharedPattern* pattern, WorkerPool& workerPool)
+  {
+    const std::string key = MeshBuilder::key(prefs, patternFile);
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    osg::ref_ptr<MeshBuilder> builder;
+    std::map<std::string, osg::observer_ptr<MeshBuilder> >::const_iterator i = meshes_.find(key);
+    if (i != meshes_.end() && i->second.lock(builder))
+      return builder;
+
+    // Remove meshes that are no longer in use
+    std::map<std::string, osg::observer_ptr<MeshBuilder> >::iterator iter = meshes_.begin();
+    while (iter != meshes_.end())
+    {
+      if (iter->second.valid())
+        ++iter;
+      else
+        meshes_.erase(iter++);
+    }
+
+    builder = new MeshBuilder(prefs, pattern);
+    meshes_[key] = builder.get();
+    workerPool.add(builder.get());
+    return builder;
+  }
+
+private:
+  OpenThreads::Mutex mutex_;
+  std::map<std::string, osg::observer_ptr<MeshBuilder> > meshes_;
+};
+
+//----------------------------------------------------------------------------
+
 // AntennaNode hierarchy:
 //  this (MatrixTransform) - responsible for antenna visual scaling
-//      Geode - contains the antenna geometry
+//      Geode - contains the antenna geometry, shared with other antenna nodes
 //        Geometry - contains the antenna primitives
 
 AntennaNode::AntennaNode(const osg::Quat& rot)
-  : antennaPattern_(NULL),
-    loadedOK_(false),
+  : loadedOK_(false),
     beamRange_(1.0f),
     beamScale_(1.0f),
-    scaleFactor_(-1.0f),
     rot_(rot),
-    min_(HUGE_VAL),
-    max_(-HUGE_VAL)
+    updateTraversalRequested_(false)
 {
-  colorUtils_ = new ColorUtils(0.3);
   setNodeMask(simVis::DISPLAY_MASK_NONE);
 }
 
 AntennaNode::~AntennaNode()
 {
-  delete colorUtils_;
-  delete antennaPattern_;
 }
 
 // antennaPattern's scale is a product of update range (in m) and pref beamScale (no units, 1.0 default)
@@ -166,12 +625,14 @@ bool AntennaNode::setPrefs(const simData::BeamPrefs& prefs)
       }
     }
 
-    // load the new pattern file
-    delete(antennaPattern_);
+    // load the new pattern file; the mesh builder uses this same pattern
+    antennaPattern_ = NULL;
     // Frequency must be > 0, if <= 0 use default value
     const double freq = prefs.frequency() > 0 ? prefs.frequency() : simCore::DEFAULT_FREQUENCY;
-    antennaPattern_ = simCore::loadPatternFile(patternFile_, freq);
-    loadedOK_ = (antennaPattern_ != NULL);
+    simCore::AntennaPattern* pattern = simCore::loadPatternFile(patternFile_, freq);
+    if (pattern != NULL)
+      antennaPattern_ = new SharedPattern(pattern);
+    loadedOK_ = antennaPattern_.valid();
   }
 
   polarity_ = static_cast<simCore::PolarityType>(prefs.polarity());
@@ -193,12 +654,12 @@ bool AntennaNode::setPrefs(const simData::BeamPrefs& prefs)
   if (!drawAntennaPattern)
   {
     removeChildren(0, getNumChildren());
+    mesh_ = NULL;
+    setUpdateTraversal_(false);
     setNodeMask(simVis::DISPLAY_MASK_NONE);
   }
   else if (requiresRedraw)
   {
-    // this needs to be recalc'd if prefs change. reset to -1 to force recalc
-    scaleFactor_ = -1.0f;
     beamScale_ = prefs.beamscale();
     lastPrefs_ = prefs;
     render_();
@@ -254,49 +715,9 @@ float AntennaNode::PatternGain(float azim, float elev, simCore::PolarityType pol
 {
   if (!lastPrefs_.isSet())
     return 0.0f;
-  // convert freq in MHz to Hz (note that freq is not actually used in any supported gain calcs)
-  double freq = lastPrefs_->frequency() * 1e6;
-  if (!antennaPattern_)
+  if (!antennaPattern_.valid())
     return lastPrefs_->gain();
-  switch (antennaPattern_->type())
-  {
-  case simCore::ANTENNA_PATTERN_MONOPULSE:
-    return antennaPattern_->gain(simCore::AntennaGainParameters(azim, elev, simCore::POLARITY_UNKNOWN, 0, 0, lastPrefs_->gain(), 0, 0, freq, false, lastPrefs_->channel()));
-  case simCore::ANTENNA_PATTERN_CRUISE:
-    return antennaPattern_->gain(simCore::AntennaGainParameters(azim, elev, simCore::POLARITY_UNKNOWN, 0, 0, 0, 0, 0, freq));
-  case simCore::ANTENNA_PATTERN_NSMA:
-  case simCore::ANTENNA_PATTERN_EZNEC:
-  case simCore::ANTENNA_PATTERN_XFDTD:
-    return antennaPattern_->gain(simCore::AntennaGainParameters(azim, elev, polarity_, 0, 0, lastPrefs_->gain()));
-  default:
-    return antennaPattern_->gain(simCore::AntennaGainParameters(azim, elev, simCore::POLARITY_UNKNOWN, simCore::angFix2PI(lastPrefs_->horizontalwidth()), osg::absolute(simCore::angFixPI(lastPrefs_->verticalwidth())), lastPrefs_->gain(), -23.2f, -20.0f, freq, lastPrefs_->weighting()));
-  }
-  // this point should never be reached; if assert fails, logic in this routine has been changed
-  assert(0);
-  return lastPrefs_->gain();
-}
-
-float AntennaNode::ComputeRadius_(float azim, float elev, simCore::PolarityType polarity, osg::Vec3f &p) const
-{
-  // values returned from PatternGain are in dB
-  const float gain = PatternGain(azim, elev, polarity);
-  float radius;
-
-  if (gain < simCore::SMALL_DB_COMPARE)
-    radius = 0.0;
-
-  // prevent multiply by zero error when fMin == fMax (OMNI case)
-  else if (min_ == max_)
-    radius = ((gain > lastPrefs_->sensitivity()) ? osg::absolute(gain) * scaleFactor_ : 0.0f);
-  else
-    radius = ((gain > lastPrefs_->sensitivity()) ? osg::absolute(gain - min_) * scaleFactor_ : 0.0f);
-
-  // convert azim & elev to a rectangular coordinate
-  p.set(radius * cosf(azim) * cosf(elev),
-    radius * sinf(azim) * cosf(elev),
-    radius * sinf(elev));
-
-  return gain;
+  return antennaPattern_->gain(*lastPrefs_, polarity_, azim, elev);
 }
 
 // antennaPattern's scale is a product of update range (in m) and beamScale preference (no units, 1.0 default)
@@ -313,13 +734,6 @@ void AntennaNode::applyScale_()
 #endif
 }
 
-void AntennaNode::drawAxes_(const osg::Vec3f& pos, const osg::Vec3f& vec)
-{
-  AxisVector* axes = new AxisVector();
-  axes->setPositionOrientation(pos, vec);
-  addChild(axes);
-}
-
 void AntennaNode::render_()
 {
   // render should never be called unless a valid pattern is set. if assert fails, check logic in setPrefs
@@ -327,313 +741,53 @@ void AntennaNode::render_()
   // lastPrefs_ must be valid before a pattern can be rendered; if assert fails, check for changes in setPrefs
   assert(lastPrefs_.isSet());
 
-  removeChildren(0, getNumChildren());
-
-  osg::ref_ptr<osg::Geometry> antGeom = new osg::Geometry();
-  antGeom->setName("simVis::AntennaNode");
-  antGeom->setDataVariance(osg::Object::DYNAMIC);
-  antGeom->setUseVertexBufferObjects(true);
-
-  osg::Vec3Array* verts = new osg::Vec3Array();
-  antGeom->setVertexArray(verts);
-
-  osg::Vec3Array* norms = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
-  antGeom->setNormalArray(norms);
-
-  osg::Vec4Array* colors = new osg::Vec4Array(osg::Array::BIND_PER_VERTEX);
-  antGeom->setColorArray(colors);
-
-  // expected range for vRange is (0, M_PI]
-  const double vRange = osg::clampBetween(lastPrefs_->fieldofview(), std::numeric_limits<double>::min(), M_PI);
-  // expected range for vRange is (0, M_TWOPI]
-  const double hRange = osg::clampBetween(lastPrefs_->fieldofview(), std::numeric_limits<double>::min(), M_TWOPI);
-
-  // detail is in degrees, determines the step size between az and el points, expected value is [1, 10] degrees
-  const double degDetail = osg::clampBetween(lastPrefs_->detail(), 1.0, 10.0);
-
-  // determine pattern bounds in order to normalize
-  if (scaleFactor_ < 0.0)
-  {
-    antennaPattern_->minMaxGain(&min_, &max_, simCore::AntennaGainParameters(0, 0, polarity_, simCore::angFix2PI(lastPrefs_->horizontalwidth()), osg::absolute(simCore::angFixPI(lastPrefs_->verticalwidth())), lastPrefs_->gain(), -23.2f, -20.0f, lastPrefs_->frequency() * 1e6, lastPrefs_->weighting()));
-
-    // prevent divide by zero error for OMNI case
-    scaleFactor_ = (max_ == min_) ? 1.0f/max_ : 1.0f/(max_ - min_);
-  }
-
-  const double endelev = simCore::RAD2DEG * vRange * 0.5;
-  const double startelev = simCore::RAD2DEG * vRange * -0.5;
-  // pre-calculate the elev points we are using
-  std::vector<float> elevPoints;
-  bool elevDone = false;
-  for (double elev = startelev; !elevDone; elev += degDetail)
-  {
-    if (elev >= endelev)
-    {
-      elev = endelev;
-      elevDone = true;
-    }
-    elevPoints.push_back(static_cast<float>(simCore::DEG2RAD * elev));
-  }
-
-  const double endazim = simCore::RAD2DEG * hRange * 0.5;
-  const double startazim = simCore::RAD2DEG * hRange * -0.5;
-  // pre-calculate the azim points we are using
-  std::vector<float> azimPoints;
-  bool azimDone = false;
-  for (double azim = startazim; !azimDone; azim += degDetail)
-  {
-    if (azim >= endazim)
-    {
-      azim = endazim;
-      azimDone = true;
-    }
-    azimPoints.push_back(static_cast<float>(simCore::DEG2RAD * azim));
-  }
-  // algorithms below require azimPoints > 1, so break out if we don't meet that requirement
-  if (azimPoints.size() < 2)
+  // Prefs changes that do not affect the mesh, or that return to a mesh in use elsewhere, reuse it
+  if (!workerPool_.valid())
+    workerPool_ = WorkerPool::instance();
+  const osg::ref_ptr<MeshBuilder> mesh = MeshCache::instance().get(*lastPrefs_, patternFile_, antennaPattern_.get(), *workerPool_);
+  if (mesh == mesh_)
   {
+    // beam scale may have changed along with the prefs
+    if (getNumChildren() != 0)
+      applyScale_();
     return;
   }
 
-  const osg::Vec3f& zeroPt = osg::Vec3f(0.0f, 0.0f, 0.0f);
-  const bool colorScale = lastPrefs_->colorscale();
-  const osg::Vec4f color = (lastPrefs_->commonprefs().useoverridecolor()) ? ColorUtils::RgbaToVec4(lastPrefs_->commonprefs().overridecolor()) : ColorUtils::RgbaToVec4(lastPrefs_->commonprefs().color());
-  // this is the color that corresponds to minimum gain (-100)
-  const osg::Vec4f scaleAltColor = colorUtils_->GainThresholdColor(-100);
-  int lastCount = 0;
-
-  #ifdef DRAW_AXES
-  // draw axes to represent beam orientation
-  {
-    AxisVector* vec = new AxisVector();
-    addChild(vec);
-  }
-  #endif
+  removeChildren(0, getNumChildren());
+  mesh_ = mesh;
+  // Wait for the worker thread in the update traversal if the mesh is not yet generated
+  setUpdateTraversal_(!installMesh_());
+}
 
-  azimDone = false;
-  // unconventional iteration, due to algorithm needing *iiter and *(iiter+1)
-  for (std::vector<float>::const_iterator iiter = azimPoints.begin(); !azimDone; ++iiter)
+bool AntennaNode::installMesh_()
+{
+  if (!mesh_.valid())
+    return true;
+  if (!mesh_->isDone())
+    return false;
+  // NULL mesh means the prefs do not produce any geometry
+  osg::Node* mesh = mesh_->mesh();
+  if (mesh != NULL)
   {
-    const float azim = *iiter;
-    auto nextIter = iiter + 1;
-    // azimDone condition should break iteration before this can occur
-    assert(nextIter != azimPoints.end());
-    const float azim2 = *nextIter;
-    azimDone = (nextIter + 1 == azimPoints.end());
-
-    for (std::vector<float>::const_iterator jiter = elevPoints.begin(); jiter != elevPoints.end(); ++jiter)
-    {
-      const float elev = *jiter;
-
-      // compute first point in t-strip
-      osg::Vec3f pt;
-      float gain = ComputeRadius_(azim, elev, polarity_, pt);
-      verts->push_back(pt);
-      pt.normalize();
-      norms->push_back(pt);
-      if (colorScale)
-        colors->push_back(colorUtils_->GainThresholdColor(static_cast<int>(gain)));
-      else
-        colors->push_back(color);
-
-      // compute alternate point in t-strip
-      // TODO: this calculated result could potentially be reused in the next azim iteration; consider using an index array.
-      osg::Vec3f ptne;
-      gain = ComputeRadius_(azim2, elev, polarity_, ptne);
-      verts->push_back(ptne);
-      ptne.normalize();
-      norms->push_back(ptne);
-      if (colorScale)
-        colors->push_back(colorUtils_->GainThresholdColor(static_cast<int>(gain)));
-      else
-        colors->push_back(color);
-    }
-
-    antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_STRIP, lastCount, verts->size() - lastCount));
-    lastCount = verts->size();
+    addChild(mesh);
+    applyScale_();
   }
+  return true;
+}
 
-  // draw top & bottom sides of pattern
-  if (vRange < M_PI)
-  {
-    // draw near face/bottom side of pattern
-    // TODO: for some patterns (gaussian), all bottom side points will be zero, and the entire side can be skipped
-    {
-      const float elev = static_cast<float>(simCore::DEG2RAD * startelev);
-      // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around y-axis by (elev + PI/2) radians
-      const osg::Quat& normalRot = osg::Quat(M_PI_2 - elev, osg::Y_AXIS);
-      const osg::Vec3f& zeroNormal = normalRot * osg::X_AXIS;
-
-      verts->push_back(zeroPt);
-      norms->push_back(zeroNormal);
-      if (colorScale)
-        colors->push_back(scaleAltColor);
-      else
-        colors->push_back(color);
-
-      // reverse iteration to set correct polygon facing
-      for (std::vector<float>::const_reverse_iterator iriter = azimPoints.rbegin(); iriter != azimPoints.rend(); ++iriter)
-      {
-        const float azim = *iriter;
-        osg::Vec3f pt;
-        const float gain = ComputeRadius_(azim, elev, polarity_, pt);
-        verts->push_back(pt);
-        const osg::Vec3f& normalVec = calcNormalXY(pt);
-        norms->push_back(normalVec);
-
-        if (colorScale)
-          colors->push_back(colorUtils_->GainThresholdColor(static_cast<int>(gain)));
-        else
-          colors->push_back(color);
-
-#ifdef DRAW_AXES
-        // draw axes to visualize the vertex normals, every 10th point of the triangle fan
-        if (fmod(std::distance(static_cast<std::vector<float>::const_reverse_iterator>(azimPoints.rbegin()), iriter), 10.0) == 0)
-        {
-          drawAxes_(pt, normalVec);
-        }
-#endif
-      }
-      antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts->size() - lastCount));
-      lastCount = verts->size();
-    }
-
-    // draw near face/top side of pattern
-    // TODO: for some patterns (gaussian), all top side points will be zero, and the entire side can be skipped
-    {
-      const float elev = static_cast<float>(simCore::DEG2RAD * endelev);
-
-      // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around y-axis by (-pi/2 - elev) radians
-      const osg::Quat& normalRot = osg::Quat(-M_PI_2 - elev, osg::Y_AXIS);
-      const osg::Vec3f& zeroNormal = normalRot * osg::X_AXIS;
-      verts->push_back(zeroPt);
-      norms->push_back(zeroNormal);
-      if (colorScale)
-        colors->push_back(scaleAltColor);
-      else
-        colors->push_back(color);
-
-      for (std::vector<float>::const_iterator iiter = azimPoints.begin(); iiter != azimPoints.end(); ++iiter)
-      {
-        const float azim = *iiter;
-        osg::Vec3f pt;
-        const float gain = ComputeRadius_(azim, elev, polarity_, pt);
-        verts->push_back(pt);
-        // sign change is required for top side
-        const osg::Vec3f& normalVec = -calcNormalXY(pt);
-        norms->push_back(normalVec);
-
-        if (colorScale)
-          colors->push_back(colorUtils_->GainThresholdColor(static_cast<int>(gain)));
-        else
-          colors->push_back(color);
-
-#ifdef DRAW_AXES
-        // draw axes to visualize the vertex normals, every 10th point of the triangle fan
-        if (fmod(std::distance(static_cast<std::vector<float>::const_iterator>(azimPoints.begin()), iiter), 10.0) == 0)
-        {
-          drawAxes_(pt, normalVec);
-        }
-#endif
-      }
-      antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts->size() - lastCount));
-      lastCount = verts->size();
-    }
-  } // end of (vRange < M_PI)
-
-
-  // draw right and left sides of pattern
-  if (hRange < M_TWOPI)
-  {
-    // draw right side of pattern
-    // TODO: for some patterns (pedestal), all right side points will be zero, and the entire right side can be skipped
-    {
-      const float azim = static_cast<float>(simCore::DEG2RAD * startazim);
-      // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around z-axis by azim - pi/2 radians
-      const osg::Quat& normalRot = osg::Quat(-M_PI_2 + azim, osg::Z_AXIS);
-      const osg::Vec3f& zeroNormal = normalRot * osg::X_AXIS;
-
-      verts->push_back(zeroPt);
-      norms->push_back(zeroNormal);
-      if (colorScale)
-        colors->push_back(scaleAltColor);
-      else
-        colors->push_back(color);
-
-      for (std::vector<float>::const_iterator jiter = elevPoints.begin(); jiter != elevPoints.end(); ++jiter)
-      {
-        const float elev = *jiter;
-        osg::Vec3f pt;
-        const float gain = ComputeRadius_(azim, elev, polarity_, pt);
-        verts->push_back(pt);
-        const osg::Vec3f& normalVec = calcNormalXZ(pt);
-        norms->push_back(normalVec);
-
-        if (colorScale)
-          colors->push_back(colorUtils_->GainThresholdColor(static_cast<int>(gain)));
-        else
-          colors->push_back(color);
-
-#ifdef DRAW_AXES
-        // draw axes to visualize the vertex normals, every 10th point of the triangle fan
-        if (fmod(std::distance(static_cast<std::vector<float>::const_iterator>(elevPoints.begin()), jiter), 10.0) == 0)
-        {
-          drawAxes_(pt, normalVec);
-        }
-#endif
-      }
-      antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts->size() - lastCount));
-      lastCount = verts->size();
-    }
-
-    // draw left side of pattern
-    // TODO: for some patterns (pedestal), all left side points will be zero, and the entire left side can be skipped
-    {
-      const float azim = static_cast<float>(simCore::DEG2RAD * endazim);
-      // determine a normal for the face at the beam origin - rotate the beam unit vector (x-axis) around z-axis by azim + pi/2 radians
-      const osg::Quat& normalRot = osg::Quat(M_PI_2 + azim, osg::Z_AXIS);
-      const osg::Vec3f& zeroNormal = normalRot * osg::X_AXIS;
-      verts->push_back(zeroPt);
-      norms->push_back(zeroNormal);
-      if (colorScale)
-        colors->push_back(scaleAltColor);
-      else
-        colors->push_back(color);
-
-      // reverse iteration to set correct polygon facing
-      for (std::vector<float>::const_reverse_iterator jriter = elevPoints.rbegin(); jriter != elevPoints.rend(); ++jriter)
-      {
-        const float elev = *jriter;
-        osg::Vec3f pt;
-        const float gain = ComputeRadius_(azim, elev, polarity_, pt);
-        verts->push_back(pt);
-        // sign change is required for left side
-        const osg::Vec3f& normalVec = -calcNormalXZ(pt);
-        norms->push_back(normalVec);
-
-        if (colorScale)
-          colors->push_back(colorUtils_->GainThresholdColor(static_cast<int>(gain)));
-        else
-          colors->push_back(color);
-
-#ifdef DRAW_AXES
-        // draw axes to visualize the vertex normals, every 10th point of the triangle fan
-        if (fmod(std::distance(static_cast<std::vector<float>::const_reverse_iterator>(elevPoints.rbegin()), jriter), 10.0) == 0)
-        {
-          drawAxes_(pt, normalVec);
-        }
-#endif
-      }
-      antGeom->addPrimitiveSet(new osg::DrawArrays(osg::PrimitiveSet::TRIANGLE_FAN, lastCount, verts->size() - lastCount));
-    }
-  } // end of (hRange < T_PI)
-
-  osg::ref_ptr<osg::Geode> geode = new osg::Geode();
-  geode->addDrawable(antGeom);
+void AntennaNode::setUpdateTraversal_(bool requested)
+{
+  if (requested == updateTraversalRequested_)
+    return;
+  updateTraversalRequested_ = requested;
+  ADJUST_UPDATE_TRAV_COUNT(this, requested ? 1 : -1);
+}
 
-  // optimize the geode:
-  osgEarth::Symbology::MeshConsolidator::run(*geode);
-  addChild(geode);
-  applyScale_();
+void AntennaNode::traverse(osg::NodeVisitor& nv)
+{
+  if (updateTraversalRequested_ && nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR && installMesh_())
+    setUpdateTraversal_(false);
+  osg::MatrixTransform::traverse(nv);
 }
+
 }
@@ -36,10 +36,12 @@ namespace simCore
 
 namespace simVis
 {
-  struct ColorUtils;
+  class WorkerPool;
 
   /**
-   * Represents an antenna pattern.
+   * Represents an antenna pattern.  The pattern mesh is generated on a worker thread and shared
+   * between all antenna nodes with the same pattern and drawing preferences.  Range and beam
+   * scale are applied through this transform, and do not regenerate the mesh.
    */
   class SDKVIS_EXPORT AntennaNode : public osg::MatrixTransform
   {
@@ -71,6 +73,9 @@ namespace simVis
     /** calculate the antenna gain for given parameters */
     float PatternGain(float azim, float elev, simCore::PolarityType polarity) const;
 
+    /** Installs the pattern mesh once the worker thread generates it */
+    virtual void traverse(osg::NodeVisitor& nv);
+
     /** Return the proper library name */
     virtual const char* libraryName() const { return "simVis"; }
 
@@ -82,6 +87,10 @@ namespace simVis
     virtual ~AntennaNode();
 
   private:
+    class MeshBuilder;
+    class MeshCache;
+    class SharedPattern;
+
     /// apply the lighting pref
     void updateLighting_(bool shaded);
 
@@ -91,31 +100,33 @@ namespace simVis
     // antennaPattern is scaled by the product of update range (in m) and pref beamScale (no units, 1.0 default)
     void applyScale_();
 
-    /**
-    * Draw axes at the specified pt, orienting the x-axis along the specified vector
-    * @param[in] pos the position for the axes origin
-    * @param[in] vec the orientation for the x-axis
-    */
-    void drawAxes_(const osg::Vec3f& pos, const osg::Vec3f& vec);
-
-    float ComputeRadius_(float azim, float elev, simCore::PolarityType polarity, osg::Vec3f &p) const;
+    /// request the shared mesh for the current prefs, installing it immediately if it is already generated
     void render_();
 
+    /// add the mesh as a child if its generation is complete; returns false while generation is pending
+    bool installMesh_();
+
+    /// turn on or off the update traversal used to wait for mesh generation
+    void setUpdateTraversal_(bool requested);
+
   private:
-    simCore::AntennaPattern* antennaPattern_;
+    /// loaded pattern, shared with the mesh builder
+    osg::ref_ptr<SharedPattern> antennaPattern_;
     bool                     loadedOK_;
     std::string              patternFile_;
     simCore::PolarityType    polarity_;
 
     float                    beamRange_;
     float                    beamScale_;
-    float                    scaleFactor_;
     osg::Quat                rot_;
-    float                    min_;
-    float                    max_;
     osgEarth::optional<simData::BeamPrefs>      lastPrefs_;
 
-    ColorUtils*      colorUtils_;
+    /// shared mesh for the current prefs; generation may be pending
+    osg::ref_ptr<MeshBuilder> mesh_;
+    /// true while an update traversal is requested to install a pending mesh
+    bool                     updateTraversalRequested_;
+    /// threads that generate meshes
+    osg::ref_ptr<WorkerPool> workerPool_;
   };
 
 } // namespace simVis
@@ -28,6 +28,7 @@
 #include "simVis/BeamPulse.h"
 #include "simVis/Constants.h"
 #include "simVis/EntityLabel.h"
+#include "simVis/LabelContentCache.h"
 #include "simVis/LabelContentManager.h"
 #include "simVis/LocalGrid.h"
 #include "simVis/Locator.h"
@@ -313,7 +314,7 @@ void BeamNode::updateLabel_(const simData::BeamPrefs& prefs)
 
     std::string text;
     if (prefs.commonprefs().labelprefs().draw())
-      text = labelContentCallback().createString(prefs, lastUpdateFromDS_, prefs.commonprefs().labelprefs().displayfields());
+      text = labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_LABEL, prefs, lastUpdateFromDS_, prefs.commonprefs().labelprefs().displayfields());
 
     if (!text.empty())
     {
@@ -340,7 +341,7 @@ std::string BeamNode::popupText() const
         prefix = getEntityName(EntityNode::ALIAS_NAME);
       prefix += "\n";
     }
-    return prefix + labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hoverdisplayfields());
+    return prefix + labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_HOVER, lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hoverdisplayfields());
   }
 
   return "";
@@ -349,14 +350,14 @@ std::string BeamNode::popupText() const
 std::string BeamNode::hookText() const
 {
   if (hasLastPrefs_ && hasLastUpdate_)
-    return labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hookdisplayfields());
+    return labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_HOOK, lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hookdisplayfields());
   return "";
 }
 
 std::string BeamNode::legendText() const
 {
   if (hasLastPrefs_ && hasLastUpdate_)
-    return labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().legenddisplayfields());
+    return labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_LEGEND, lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().legenddisplayfields());
 
   return "";
 }
@@ -380,6 +381,8 @@ void BeamNode::setPrefs(const simData::BeamPrefs& prefs)
 
 void BeamNode::applyPrefs_(const simData::BeamPrefs& prefs, bool force)
 {
+  // Label content might depend on any pref
+  labelContentCache().invalidate();
   if (prefsOverrides_.size() == 0)
   {
     apply_(NULL, &prefs, force);
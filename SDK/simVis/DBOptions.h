@@ -46,13 +46,25 @@ namespace simVis
     /** Deepest level (in .db depth) for reading data from the .db file. (immutable) */
     const osgEarth::optional<unsigned int>& deepestLevel() const { return _deepestLevel; }
 
+    /** Memory limit in megabytes for decoded tiles cached in memory, shared by layers reading the same file; 0 disables. (mutable) */
+    osgEarth::optional<unsigned int>& tileCacheSize() { return _tileCacheSize; }
+    /** Memory limit in megabytes for decoded tiles cached in memory, shared by layers reading the same file; 0 disables. (immutable) */
+    const osgEarth::optional<unsigned int>& tileCacheSize() const { return _tileCacheSize; }
+
+    /** Whether to read children and neighbors of requested tiles into the tile cache in the background, on a thread per source; off by default. (mutable) */
+    osgEarth::optional<bool>& prefetch() { return _prefetch; }
+    /** Whether to read children and neighbors of requested tiles into the tile cache in the background, on a thread per source; off by default. (immutable) */
+    const osgEarth::optional<bool>& prefetch() const { return _prefetch; }
+
   public:
     /**
     * Construct a new DB options structure
     * @param opt Options data from which to deserialize configuration
     */
     DBOptions(const osgEarth::ConfigOptions &opt = osgEarth::ConfigOptions())
-      : TileSourceOptions(opt)
+      : TileSourceOptions(opt),
+        _tileCacheSize(32),
+        _prefetch(false)
     {
       setDriver("db");
       fromConfig_(_conf);
@@ -70,9 +82,13 @@ namespace simVis
 #if SDK_OSGEARTH_MIN_VERSION_REQUIRED(1,10,0)
       conf.set("url", _url);
       conf.set("deepest_level", _deepestLevel);
+      conf.set("tile_cache_size", _tileCacheSize);
+      conf.set("prefetch", _prefetch);
 #else
       conf.updateIfSet("url", _url);
       conf.updateIfSet("deepest_level", _deepestLevel);
+      conf.updateIfSet("tile_cache_size", _tileCacheSize);
+      conf.updateIfSet("prefetch", _prefetch);
 #endif
       return conf;
     }
@@ -92,14 +108,20 @@ namespace simVis
 #if SDK_OSGEARTH_MIN_VERSION_REQUIRED(1,10,0)
       conf.get("url", _url);
       conf.get("deepest_level", _deepestLevel);
+      conf.get("tile_cache_size", _tileCacheSize);
+      conf.get("prefetch", _prefetch);
 #else
       conf.getIfSet("url", _url);
       conf.getIfSet("deepest_level", _deepestLevel);
+      conf.getIfSet("tile_cache_size", _tileCacheSize);
+      conf.getIfSet("prefetch", _prefetch);
 #endif
     }
 
     osgEarth::optional<osgEarth::URI> _url;
     osgEarth::optional<unsigned int> _deepestLevel;
+    osgEarth::optional<unsigned int> _tileCacheSize;
+    osgEarth::optional<bool> _prefetch;
   };
 }
 
@@ -22,6 +22,7 @@
 #include "osgEarth/Terrain"
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/CoordinateConverter.h"
+#include "simVis/LabelContentCache.h"
 #include "simVis/LabelContentManager.h"
 #include "simVis/Locator.h"
 #include "simVis/LocatorNode.h"
@@ -42,40 +43,53 @@ CoordSurfaceClamping::~CoordSurfaceClamping()
 }
 
 void CoordSurfaceClamping::clampCoordToMapSurface(simCore::Coordinate& coord)
+{
+  clampCoordsToMapSurface(&coord, 1);
+}
+
+void CoordSurfaceClamping::clampCoordsToMapSurface(simCore::Coordinate* coords, size_t count)
 {
   // nothing to do if we don't have a valid map node
-  if (!mapNode_.valid())
+  osg::ref_ptr<const osgEarth::MapNode> mapNode;
+  if (!mapNode_.lock(mapNode))
   {
     assert(0); // called this method without setting the map node
     return;
   }
-  if (coord.coordinateSystem() != simCore::COORD_SYS_LLA && coord.coordinateSystem() != simCore::COORD_SYS_ECEF)
-  {
-    // coordinate type must be LLA to work with osgEarth elevation query
-    assert(0);
-    return;
-  }
+  const osgEarth::Terrain* terrain = mapNode->getTerrain();
+  const osgEarth::SpatialReference* mapSrs = mapNode->getMapSRS();
 
-  // convert from ECEF to LLA if necessary, since osgEarth Terrain getHeight requires LLA
   simCore::Coordinate llaCoord;
-  if (coord.coordinateSystem() == simCore::COORD_SYS_ECEF)
-    simCore::CoordinateConverter::convertEcefToGeodetic(coord, llaCoord);
-  else
-    llaCoord = coord;
-
-  double hamsl = 0.0; // not used
-  double hae = 0.0; // height above ellipsoid, the rough elevation
-
-  if (mapNode_->getTerrain()->getHeight(mapNode_->getMapSRS(), llaCoord.lon()*simCore::RAD2DEG, llaCoord.lat()*simCore::RAD2DEG, &hamsl, &hae))
-    llaCoord.setPositionLLA(llaCoord.lat(), llaCoord.lon(), hae);
-  else
-    llaCoord.setPositionLLA(llaCoord.lat(), llaCoord.lon(), 0.0);  // Assume over the ocean and clamp to zero
+  for (size_t k = 0; k < count; ++k)
+  {
+    simCore::Coordinate& coord = coords[k];
+    if (coord.coordinateSystem() != simCore::COORD_SYS_LLA && coord.coordinateSystem() != simCore::COORD_SYS_ECEF)
+    {
+      // coordinate type must be LLA to work with osgEarth elevation query
+      assert(0);
+      continue;
+    }
 
-  // convert back to ECEF if necessary
-  if (coord.coordinateSystem() == simCore::COORD_SYS_ECEF)
-    simCore::CoordinateConverter::convertGeodeticToEcef(llaCoord, coord);
-  else
-    coord = llaCoord;
+    // convert from ECEF to LLA if necessary, since osgEarth Terrain getHeight requires LLA
+    if (coord.coordinateSystem() == simCore::COORD_SYS_ECEF)
+      simCore::CoordinateConverter::convertEcefToGeodetic(coord, llaCoord);
+    else
+      llaCoord = coord;
+
+    double hamsl = 0.0; // not used
+    double hae = 0.0; // height above ellipsoid, the rough elevation
+
+    if (terrain->getHeight(mapSrs, llaCoord.lon()*simCore::RAD2DEG, llaCoord.lat()*simCore::RAD2DEG, &hamsl, &hae))
+      llaCoord.setPositionLLA(llaCoord.lat(), llaCoord.lon(), hae);
+    else
+      llaCoord.setPositionLLA(llaCoord.lat(), llaCoord.lon(), 0.0);  // Assume over the ocean and clamp to zero
+
+    // convert back to ECEF if necessary
+    if (coord.coordinateSystem() == simCore::COORD_SYS_ECEF)
+      simCore::CoordinateConverter::convertGeodeticToEcef(llaCoord, coord);
+    else
+      coord = llaCoord;
+  }
 }
 
 bool CoordSurfaceClamping::isValid() const
@@ -92,7 +106,8 @@ void CoordSurfaceClamping::setMapNode(const osgEarth::MapNode* map)
 
 EntityNode::EntityNode(simData::ObjectType type, Locator* locator)
   : type_(type),
-    contentCallback_(new NullEntityCallback())
+    contentCallback_(new NullEntityCallback()),
+    contentCache_(new LabelContentCache())
 {
   setNodeMask(0);  // Draw is off until a valid update is received
   setLocator(locator);
@@ -188,6 +203,7 @@ void EntityNode::setLabelContentCallback(LabelContentCallback* cb)
     contentCallback_ = new NullEntityCallback();
   else
     contentCallback_ = cb;
+  contentCache_->invalidate();
 }
 
 LabelContentCallback& EntityNode::labelContentCallback() const
@@ -195,4 +211,9 @@ LabelContentCallback& EntityNode::labelContentCallback() const
   return *contentCallback_;
 }
 
+LabelContentCache& EntityNode::labelContentCache() const
+{
+  return *contentCache_;
+}
+
 }
@@ -42,6 +42,7 @@ namespace simData {
 
 namespace simVis
 {
+  class LabelContentCache;
   class LabelContentCallback;
   class Locator;
 
@@ -72,6 +73,14 @@ namespace simVis
     */
     void clampCoordToMapSurface(simCore::Coordinate& coord);
 
+    /**
+    * Clamps an array of coordinates to the surface, locking the map and terrain once for the whole
+    * array.  Each coordinate must be in LLA or ECEF; others are left unchanged.
+    * @param coords  array of coordinates to clamp to map surface
+    * @param count  number of coordinates in the array
+    */
+    void clampCoordsToMapSurface(simCore::Coordinate* coords, size_t count);
+
     /** Return true if able to apply clamping, false otherwise */
     bool isValid() const;
 
@@ -138,6 +147,8 @@ namespace simVis
     void setLabelContentCallback(LabelContentCallback* callback);
     /// Returns current content callback; guaranteed non-NULL
     LabelContentCallback& labelContentCallback() const;
+    /// Returns the cache of strings from the content callback; guaranteed non-NULL
+    LabelContentCache& labelContentCache() const;
 
     /// Returns the pop up text based on the label content callback, update and preference
     virtual std::string popupText() const = 0;
@@ -266,6 +277,24 @@ namespace simVis
     */
     virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force=false) = 0;
 
+    /**
+    * Optional first phase of updateFromDataStore(), called just before it with the same arguments.
+    * Implementations may precompute values from the update slice into their own members, to be
+    * consumed by updateFromDataStore().  This may run on a worker thread, concurrently with the
+    * preparation of other entities, so it must not touch the scene graph, locators, or any state
+    * shared with other entities.  The default implementation does nothing.
+    * @param updateSlice  Data store update slice (could be NULL)
+    * @param force true if the update will be forced
+    */
+    virtual void prepareUpdateFromDataStore(const simData::DataSliceBase* updateSlice, bool force) {}
+
+    /**
+    * Returns true if the entity requires updateFromDataStore() even though its update slice has not
+    * changed, such as after a preference change that requires the locator to be recomputed.  The
+    * scenario keeps visiting the entity until this returns false.  The default implementation returns false.
+    */
+    virtual bool isUpdateForced() const { return false; }
+
     /**
     * Notify the entity of a clock mode update. The implementation may
     * optionally override this method to respond to a mode change.
@@ -309,6 +338,7 @@ namespace simVis
     simData::ObjectType type_;
     osg::ref_ptr<Locator> locator_;
     osg::ref_ptr<LabelContentCallback> contentCallback_;
+    osg::ref_ptr<LabelContentCache> contentCache_;
   };
 
 } // namespace simVis
@@ -0,0 +1,188 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cstring>
+#include "simVis/GOG/BinaryFormat.h"
+
+namespace simVis { namespace GOG {
+
+namespace
+{
+
+/** Signature at the start of binary GOG data; 0x89 cannot start a line of text GOG */
+static const char BINARY_SIGNATURE[4] = { '\x89', 'G', 'O', 'G' };
+/** Current version of the binary format */
+static const uint32_t BINARY_VERSION = 1;
+/** Highest GogSerializableField value stored in the set fields mask */
+static const int LAST_SERIALIZABLE_FIELD = GOG_LINE_PROJECTION_SET;
+/** Guards against deeply nested or corrupt data */
+static const unsigned int MAX_CONFIG_DEPTH = 32;
+/** Guards against allocating for corrupt string lengths */
+static const uint32_t MAX_STRING_SIZE = 1u << 26;
+
+void writeUint32(std::ostream& output, uint32_t value)
+{
+  const char bytes[4] = {
+    static_cast<char>(value & 0xff),
+    static_cast<char>((value >> 8) & 0xff),
+    static_cast<char>((value >> 16) & 0xff),
+    static_cast<char>((value >> 24) & 0xff)
+  };
+  output.write(bytes, sizeof(bytes));
+}
+
+bool readUint32(std::istream& input, uint32_t& value)
+{
+  unsigned char bytes[4];
+  if (!input.read(reinterpret_cast<char*>(bytes), sizeof(bytes)))
+    return false;
+  value = static_cast<uint32_t>(bytes[0]) |
+    (static_cast<uint32_t>(bytes[1]) << 8) |
+    (static_cast<uint32_t>(bytes[2]) << 16) |
+    (static_cast<uint32_t>(bytes[3]) << 24);
+  return true;
+}
+
+void writeString(std::ostream& output, const std::string& value)
+{
+  writeUint32(output, static_cast<uint32_t>(value.size()));
+  output.write(value.data(), value.size());
+}
+
+bool readString(std::istream& input, std::string& value)
+{
+  uint32_t size = 0;
+  if (!readUint32(input, size) || size > MAX_STRING_SIZE)
+    return false;
+  value.resize(size);
+  return size == 0 || input.read(&value[0], size);
+}
+
+/** Writes the key, value and children of the config, recursively */
+void writeConfig(std::ostream& output, const osgEarth::Config& config)
+{
+  writeString(output, config.key());
+  writeString(output, config.value());
+  const osgEarth::ConfigSet& children = config.children();
+  writeUint32(output, static_cast<uint32_t>(children.size()));
+  for (osgEarth::ConfigSet::const_iterator i = children.begin(); i != children.end(); ++i)
+    writeConfig(output, *i);
+}
+
+bool readConfig(std::istream& input, osgEarth::Config& config, unsigned int depth)
+{
+  if (depth > MAX_CONFIG_DEPTH)
+    return false;
+  std::string key;
+  std::string value;
+  uint32_t numChildren = 0;
+  if (!readString(input, key) || !readString(input, value) || !readUint32(input, numChildren))
+    return false;
+  config = osgEarth::Config(key, value);
+  for (uint32_t k = 0; k < numChildren; ++k)
+  {
+    osgEarth::Config child;
+    if (!readConfig(input, child, depth + 1))
+      return false;
+    config.add(child);
+  }
+  return true;
+}
+
+}
+
+bool BinaryFormat::isBinary(std::istream& input)
+{
+  return input.peek() == static_cast<unsigned char>(BINARY_SIGNATURE[0]);
+}
+
+bool BinaryFormat::write(const osgEarth::Config& config, const std::vector<GogMetaData>& metaData, std::ostream& output)
+{
+  const osgEarth::ConfigSet& shapes = config.children();
+  if (shapes.size() != metaData.size())
+    return false;
+
+  output.write(BINARY_SIGNATURE, sizeof(BINARY_SIGNATURE));
+  writeUint32(output, BINARY_VERSION);
+  writeString(output, config.key());
+  writeUint32(output, static_cast<uint32_t>(shapes.size()));
+
+  std::vector<GogMetaData>::const_iterator meta = metaData.begin();
+  for (osgEarth::ConfigSet::const_iterator i = shapes.begin(); i != shapes.end(); ++i, ++meta)
+  {
+    uint32_t setFields = 0;
+    for (int field = GOG_ALL_DEFAULTS + 1; field <= LAST_SERIALIZABLE_FIELD; ++field)
+    {
+      if (meta->isSetExplicitly(static_cast<GogSerializableField>(field)))
+        setFields |= (1u << field);
+    }
+    writeUint32(output, static_cast<uint32_t>(meta->shape));
+    writeUint32(output, static_cast<uint32_t>(meta->loadFormat));
+    writeUint32(output, setFields);
+    writeString(output, meta->metadata);
+    writeConfig(output, *i);
+  }
+  return output.good();
+}
+
+bool BinaryFormat::read(std::istream& input, osgEarth::Config& config, std::vector<GogMetaData>& metaData)
+{
+  char signature[sizeof(BINARY_SIGNATURE)];
+  if (!input.read(signature, sizeof(signature)) || memcmp(signature, BINARY_SIGNATURE, sizeof(signature)) != 0)
+    return false;
+  uint32_t version = 0;
+  if (!readUint32(input, version) || version > BINARY_VERSION)
+    return false;
+
+  std::string key;
+  uint32_t numShapes = 0;
+  if (!readString(input, key) || !readUint32(input, numShapes))
+    return false;
+  if (!key.empty())
+    config.key() = key;
+
+  for (uint32_t k = 0; k < numShapes; ++k)
+  {
+    uint32_t shape = 0;
+    uint32_t loadFormat = 0;
+    uint32_t setFields = 0;
+    GogMetaData meta;
+    osgEarth::Config shapeConfig;
+    if (!readUint32(input, shape) || !readUint32(input, loadFormat) || !readUint32(input, setFields) ||
+      !readString(input, meta.metadata) || !readConfig(input, shapeConfig, 0))
+      return false;
+    if (shape > GOG_LATLONALTBOX || loadFormat > FORMAT_KML)
+      return false;
+
+    meta.shape = static_cast<GogShape>(shape);
+    meta.loadFormat = static_cast<LoadFormat>(loadFormat);
+    for (int field = GOG_ALL_DEFAULTS + 1; field <= LAST_SERIALIZABLE_FIELD; ++field)
+    {
+      if ((setFields & (1u << field)) != 0)
+        meta.setExplicitly(static_cast<GogSerializableField>(field));
+    }
+    metaData.push_back(meta);
+    config.add(shapeConfig);
+  }
+  return true;
+}
+
+} }
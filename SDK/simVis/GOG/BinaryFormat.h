@@ -0,0 +1,74 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMVIS_GOG_BINARYFORMAT_H
+#define SIMVIS_GOG_BINARYFORMAT_H
+
+#include <iostream>
+#include <vector>
+#include "simCore/Common/Common.h"
+#include "simVis/GOG/GOGNode.h"
+#include "osgEarth/Config"
+
+namespace simVis { namespace GOG
+{
+  /**
+   * Compact binary encoding of parsed GOG data: the Config structure and parallel meta data produced
+   * by Parser::parse().  Loading the binary form skips tokenizing, color parsing and angle parsing of
+   * the text form.  Colors and angles are stored already converted, so colors overridden with
+   * Parser::addOverwriteColor() when writing are fixed in the binary data.
+   *
+   * Data is written in little endian byte order with a leading signature and version, allowing
+   * the format to be detected with isBinary() and rejected if it is from a newer version.
+   */
+  class SDKVIS_EXPORT BinaryFormat
+  {
+  public:
+    /**
+     * Returns true if the stream starts with the binary GOG signature.  Only peeks the first
+     * character, so the stream does not need to support seeking.
+     * @param input Stream to test
+     * @return True if the stream appears to contain binary GOG data
+     */
+    static bool isBinary(std::istream& input);
+
+    /**
+     * Writes parsed GOG data to a stream opened in binary mode.
+     * @param[in ] config   Config structure from Parser::parse()
+     * @param[in ] metaData Meta data from Parser::parse(), parallel to the config children
+     * @param[out] output   Stream receiving the binary data
+     * @return True upon success, false if the inputs are not parallel or the write fails
+     */
+    static bool write(const osgEarth::Config& config, const std::vector<GogMetaData>& metaData, std::ostream& output);
+
+    /**
+     * Reads parsed GOG data from a stream opened in binary mode.  Shapes are appended to the outputs.
+     * @param[in ] input    Stream containing data from write()
+     * @param[out] config   Config structure, equivalent to that from Parser::parse()
+     * @param[out] metaData Meta data, parallel to the config children
+     * @return True upon success, false if the data is not valid binary GOG data
+     */
+    static bool read(std::istream& input, osgEarth::Config& config, std::vector<GogMetaData>& metaData);
+  };
+
+} } // namespace simVis::GOG
+
+#endif // SIMVIS_GOG_BINARYFORMAT_H
@@ -19,9 +19,14 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <deque>
 #include <iomanip>
 #include <set>
 
+#include "OpenThreads/Block"
+#include "OpenThreads/Thread"
+#include "osg/OperationThread"
 #include "osgEarthAnnotation/LocalGeometryNode"
 
 #include "simNotify/Notify.h"
@@ -33,6 +38,7 @@
 #include "simCore/Calc/Angle.h"
 #include "simCore/Calc/CoordinateConverter.h"
 #include "simCore/Calc/Mgrs.h"
+#include "simVis/GOG/BinaryFormat.h"
 #include "simVis/GOG/GOGNode.h"
 #include "simVis/GOG/GogNodeInterface.h"
 #include "simVis/GOG/Parser.h"
@@ -71,13 +77,202 @@ class NotifyErrorHandler : public ErrorHandler
   }
 };
 
+/** Number of lines after which a parse chunk ends at the next start/end block boundary */
+static const size_t CHUNK_LINES = 2048;
+/** Number of chunks queued per load thread; bounds memory use when reading large streams */
+static const size_t CHUNKS_PER_THREAD = 2;
+
+/** Saves errors from a load thread so that they can be reported on the loading thread in input order */
+class DeferredErrorHandler : public ErrorHandler
+{
+public:
+  virtual void printWarning(size_t lineNumber, const std::string& warningText)
+  {
+    messages_.push_back(Message(true, lineNumber, warningText));
+  }
+  virtual void printError(size_t lineNumber, const std::string& errorText)
+  {
+    messages_.push_back(Message(false, lineNumber, errorText));
+  }
+
+  /** Passes all saved messages to the handler */
+  void replay(ErrorHandler& handler) const
+  {
+    for (std::vector<Message>::const_iterator i = messages_.begin(); i != messages_.end(); ++i)
+    {
+      if (i->isWarning)
+        handler.printWarning(i->lineNumber, i->text);
+      else
+        handler.printError(i->lineNumber, i->text);
+    }
+  }
+
+private:
+  struct Message
+  {
+    Message(bool warning, size_t line, const std::string& message)
+      : isWarning(warning), lineNumber(line), text(message)
+    {
+    }
+    bool isWarning;
+    size_t lineNumber;
+    std::string text;
+  };
+  std::vector<Message> messages_;
+};
+
+/**
+ * Follows start/end blocks using the same rules as Parser::parse() to find the lines after which all
+ * parser state is reset.  Input can be split after those lines and the pieces parsed independently.
+ */
+class BlockBoundaryScanner
+{
+public:
+  BlockBoundaryScanner()
+    : inBlock_(false),
+      hasShape_(false)
+  {
+  }
+
+  /** Processes the next line, returning true if it ends a block */
+  bool endsBlock(const std::string& line)
+  {
+    const simCore::StringView view(line);
+    const size_t startPos = view.find_first_not_of(simCore::StringView(" \t"));
+    if (startPos == simCore::StringView::npos)
+      return false;
+    size_t endPos = 0;
+    const std::string first = simCore::lowerCase(simCore::extractWord(view, endPos, startPos).str());
+
+    const bool isStart = (first == "start");
+    const bool isEnd = (first == "end");
+    if (isStart || isEnd)
+    {
+      // Mirrors the error cases in parse(), which do not change the block state
+      if ((inBlock_ && isStart) || (!inBlock_ && isEnd) || (isEnd && !hasShape_))
+        return false;
+      inBlock_ = isStart;
+      hasShape_ = false;
+      return isEnd;
+    }
+
+    // Commands outside a block are ignored by the parser
+    if (!inBlock_)
+      return false;
+    if (Parser::getShapeFromKeyword(first) == GOG_UNKNOWN)
+      return false;
+
+    // Annotations and boxes only take effect with enough arguments, so count tokens the same way
+    if (first == "annotation" || first == "latlonaltbox")
+    {
+      StringVector tokens;
+      StringTokenizer tokenizer;
+      tokenizer.addDelims(" \t");
+      tokenizer.keepEmpties() = false;
+      tokenizer.addQuotes("'\"", true);
+      tokenizer.tokenize(line, tokens);
+      if (tokens.size() < ((first == "annotation") ? 2u : 6u))
+        return false;
+    }
+    hasShape_ = true;
+    return false;
+  }
+
+private:
+  bool inBlock_;
+  bool hasShape_;
+};
+
+/** Collects nodes for the createGOGs() variant that returns them all at once */
+class CollectNodesCallback : public Parser::LoadCallback
+{
+public:
+  CollectNodesCallback(Parser::OverlayNodeVector& output, std::vector<GogFollowData>& followData)
+    : output_(output),
+      followData_(followData)
+  {
+  }
+
+  virtual void addGOGs(const Parser::OverlayNodeVector& nodes, const std::vector<GogFollowData>& followData)
+  {
+    output_.insert(output_.end(), nodes.begin(), nodes.end());
+    followData_.insert(followData_.end(), followData.begin(), followData.end());
+  }
+
+private:
+  Parser::OverlayNodeVector& output_;
+  std::vector<GogFollowData>& followData_;
+};
+
+/** Default number of parse threads, leaving a processor for the loading thread */
+unsigned int defaultLoadThreads()
+{
+  const int processors = OpenThreads::GetNumberOfProcessors();
+  return (processors > 1) ? static_cast<unsigned int>(processors - 1) : 0;
+}
+
 }
 
 //------------------------------------------------------------------------
 
+/** Holds a portion of the input ending on a block boundary, and the results of parsing it */
+class Parser::ParseChunk : public osg::Operation
+{
+public:
+  ParseChunk(const Parser& parser, size_t lineNumberOffset)
+    : osg::Operation("simVis::GOG::Parser::ParseChunk", false),
+      parser_(parser),
+      lineNumberOffset_(lineNumberOffset),
+      numLines_(0)
+  {
+  }
+
+  /** Appends a line of input; only valid before parsing */
+  void addLine(const std::string& line)
+  {
+    text_ += line;
+    text_ += '\n';
+    ++numLines_;
+  }
+
+  /** Parses the input; called on a load thread, or directly */
+  virtual void operator()(osg::Object*)
+  {
+    std::istringstream input(text_);
+    parser_.parse_(input, lineNumberOffset_, errors_, config_, metaData_);
+    std::string().swap(text_);
+    done_.release();
+  }
+
+  /** Blocks until the chunk has been parsed */
+  void wait() { done_.block(); }
+
+  /** Number of input lines in the chunk */
+  size_t numLines() const { return numLines_; }
+  /** Parsed configuration; only valid after parsing */
+  const Config& config() const { return config_; }
+  /** Parsed meta data, parallel to config children; only valid after parsing */
+  const std::vector<GogMetaData>& metaData() const { return metaData_; }
+  /** Errors encountered while parsing; only valid after parsing */
+  const DeferredErrorHandler& errors() const { return errors_; }
+
+private:
+  const Parser& parser_;
+  size_t lineNumberOffset_;
+  size_t numLines_;
+  std::string text_;
+  Config config_;
+  std::vector<GogMetaData> metaData_;
+  DeferredErrorHandler errors_;
+  OpenThreads::Block done_;
+};
+
+//------------------------------------------------------------------------
+
 Parser::Parser(osgEarth::MapNode* mapNode) :
 mapNode_(mapNode),
-registry_(mapNode)
+registry_(mapNode),
+numLoadThreads_(defaultLoadThreads())
 {
   context_.errorHandler_.reset(new NotifyErrorHandler);
   initGogColors_();
@@ -85,7 +280,8 @@ registry_(mapNode)
 
 Parser::Parser(const GOGRegistry& reg) :
 mapNode_(reg.getMapNode()),
-registry_(reg)
+registry_(reg),
+numLoadThreads_(defaultLoadThreads())
 {
   context_.errorHandler_.reset(new NotifyErrorHandler);
   initGogColors_();
@@ -188,6 +384,13 @@ GogNodeInterface* Parser::createGOG(const std::vector<std::string>& lines, const
 }
 
 bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>& metaData) const
+{
+  // Assertion failure means Null Object pattern failed
+  assert(context_.errorHandler_ != NULL);
+  return parse_(input, 0, *context_.errorHandler_, output, metaData);
+}
+
+bool Parser::parse_(std::istream& input, size_t lineNumberOffset, ErrorHandler& errorHandler, Config& output, std::vector<GogMetaData>& metaData) const
 {
   // Set up the modifier state object with default values. The state persists
   // across the parsing of the GOG input, spanning actual objects. (e.g. if the
@@ -219,7 +422,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
   // cache the position lines in case they need to be stored to metadata, for annotations
   std::string positionLines;
   // track line number parsed for error reporting
-  size_t lineNumber = 0;
+  size_t lineNumber = lineNumberOffset;
 
   // parse each line from the stream individually
   while (simCore::getStrippedLine(input, line))
@@ -261,7 +464,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
     {
       std::stringstream errorText;
       errorText << "token \"" << tokens[0] << "\" detected outside of a valid start/end block";
-      printError_(lineNumber, errorText.str());
+      errorHandler.printError(lineNumber, errorText.str());
       // skip command
       continue;
     }
@@ -280,17 +483,17 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
     {
       if (validStartEndBlock && tokens[0] == "start")
       {
-        printError_(lineNumber, "nested start command not allowed");
+        errorHandler.printError(lineNumber, "nested start command not allowed");
         continue;
       }
       if (!validStartEndBlock && tokens[0] == "end")
       {
-        printError_(lineNumber, "end command encountered before start");
+        errorHandler.printError(lineNumber, "end command encountered before start");
         continue;
       }
       if (tokens[0] == "end" && currentMetaData.shape == GOG::GOG_UNKNOWN)
       {
-        printError_(lineNumber, "end command encountered before recognized GOG shape type keyword");
+        errorHandler.printError(lineNumber, "end command encountered before recognized GOG shape type keyword");
         continue;
       }
 
@@ -364,7 +567,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "annotation command requires at least 1 argument");
+        errorHandler.printError(lineNumber, "annotation command requires at least 1 argument");
       }
     }
     // object types
@@ -403,7 +606,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "latlonaltbox command requires at least 5 arguments");
+        errorHandler.printError(lineNumber, "latlonaltbox command requires at least 5 arguments");
       }
     }
     // arguments
@@ -432,7 +635,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "ref/referencepoint command requires at least 2 arguments");
+        errorHandler.printError(lineNumber, "ref/referencepoint command requires at least 2 arguments");
       }
     }
     // geometric data
@@ -457,7 +660,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "xy/xyz command requires at least 2 arguments");
+        errorHandler.printError(lineNumber, "xy/xyz command requires at least 2 arguments");
       }
     }
     else if (tokens[0] == "ll" || tokens[0] == "lla" || tokens[0] == "latlon")
@@ -480,7 +683,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "ll/lla/latlon command requires at least 2 arguments");
+        errorHandler.printError(lineNumber, "ll/lla/latlon command requires at least 2 arguments");
       }
     }
     else if (tokens[0] == "mgrs")
@@ -490,7 +693,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
         double lat;
         double lon;
         if (simCore::Mgrs::convertMgrsToGeodetic(tokens[1], lat, lon) != 0)
-          printError_(lineNumber, "Unable to convert MGRS coordinate to lat/lon");
+          errorHandler.printError(lineNumber, "Unable to convert MGRS coordinate to lat/lon");
         else
         {
           // need to save lla for annotations
@@ -506,7 +709,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "mgrs command requires at least 2 arguments");
+        errorHandler.printError(lineNumber, "mgrs command requires at least 2 arguments");
       }
     }
     else if (tokens[0] == "centerxy" || tokens[0] == "centerxyz")
@@ -527,7 +730,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "centerxy/centerxyz command requires at least 2 arguments");
+        errorHandler.printError(lineNumber, "centerxy/centerxyz command requires at least 2 arguments");
       }
     }
     else if (tokens[0] == "centerll" || tokens[0] == "centerlla" || tokens[0] == "centerlatlon")
@@ -548,7 +751,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "centerll/centerlla/centerlatlon command requires at least 2 arguments");
+        errorHandler.printError(lineNumber, "centerll/centerlla/centerlatlon command requires at least 2 arguments");
       }
     }
     // persistent state modifiers:
@@ -566,7 +769,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "linecolor command requires at least 1 argument");
+        errorHandler.printError(lineNumber, "linecolor command requires at least 1 argument");
       }
     }
     else if (tokens[0] == "fillcolor")
@@ -583,7 +786,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "fillcolor command requires at least 1 argument");
+        errorHandler.printError(lineNumber, "fillcolor command requires at least 1 argument");
       }
     }
     else if (tokens[0] == "linewidth")
@@ -594,7 +797,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
         currentMetaData.setExplicitly(GOG_LINE_WIDTH_SET);
       }
       else
-        printError_(lineNumber, "linewidth command requires 1 argument");
+        errorHandler.printError(lineNumber, "linewidth command requires 1 argument");
      }
     else if (tokens[0] == "pointsize")
     {
@@ -604,7 +807,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
         currentMetaData.setExplicitly(GOG_POINT_SIZE_SET);
       }
       else
-        printError_(lineNumber, "pointsize command requires 1 argument");
+        errorHandler.printError(lineNumber, "pointsize command requires 1 argument");
     }
     else if (tokens[0] == "altitudemode")
     {
@@ -615,7 +818,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "altitudemode command requires 1 argument");
+        errorHandler.printError(lineNumber, "altitudemode command requires 1 argument");
       }
     }
     else if (tokens[0] == "altitudeunits")
@@ -626,7 +829,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "altitudeunits command requires 1 argument");
+        errorHandler.printError(lineNumber, "altitudeunits command requires 1 argument");
       }
     }
     else if (tokens[0] == "rangeunits")
@@ -634,7 +837,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       if (tokens.size() >= 2)
         state.rangeUnits_ = tokens[1];
       else
-        printError_(lineNumber, "rangeunits command requires 1 argument");
+        errorHandler.printError(lineNumber, "rangeunits command requires 1 argument");
     }
     else if (tokens[0] == "timeunits")
     {
@@ -645,7 +848,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "timeunits command requires 1 argument");
+        errorHandler.printError(lineNumber, "timeunits command requires 1 argument");
       }
     }
     else if (tokens[0] == "angleunits")
@@ -657,7 +860,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "angleunits command requires 1 argument");
+        errorHandler.printError(lineNumber, "angleunits command requires 1 argument");
       }
     }
     else if (tokens[0] == "verticaldatum" && tokens.size() >= 2)
@@ -669,7 +872,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "verticaldatum command requires 1 argument");
+        errorHandler.printError(lineNumber, "verticaldatum command requires 1 argument");
       }
     }
     else if (tokens[0] == "priority")
@@ -680,7 +883,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
         state.priority_ = tokens[1];
       }
       else
-        printError_(lineNumber, "priority command requires 1 argument");
+        errorHandler.printError(lineNumber, "priority command requires 1 argument");
     }
     else if (tokens[0] == "filled")
     {
@@ -695,7 +898,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "outline command requires 1 argument");
+        errorHandler.printError(lineNumber, "outline command requires 1 argument");
       }
     }
     else if (startsWith(line, "3d billboard"))
@@ -716,7 +919,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "diameter command requires 1 argument");
+        errorHandler.printError(lineNumber, "diameter command requires 1 argument");
       }
     }
     else if (tokens[0] == "radius")
@@ -728,7 +931,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "radius command requires 1 argument");
+        errorHandler.printError(lineNumber, "radius command requires 1 argument");
       }
     }
     else if (tokens[0] == "anglestart")
@@ -740,7 +943,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "anglestart command requires 1 argument");
+        errorHandler.printError(lineNumber, "anglestart command requires 1 argument");
       }
     }
     else if (tokens[0] == "angleend")
@@ -752,7 +955,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "angleend command requires 1 argument");
+        errorHandler.printError(lineNumber, "angleend command requires 1 argument");
       }
     }
     else if (tokens[0] == "angledeg")
@@ -764,7 +967,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "angledeg command requires 1 argument");
+        errorHandler.printError(lineNumber, "angledeg command requires 1 argument");
       }
    }
     else if (tokens[0] == "majoraxis")
@@ -776,7 +979,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "majoraxis command requires 1 argument");
+        errorHandler.printError(lineNumber, "majoraxis command requires 1 argument");
       }
     }
     else if (tokens[0] == "minoraxis")
@@ -788,7 +991,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "minoraxis command requires 1 argument");
+        errorHandler.printError(lineNumber, "minoraxis command requires 1 argument");
       }
     }
     else if (tokens[0] == "semimajoraxis")
@@ -801,7 +1004,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "semimajoraxis command requires 1 argument");
+        errorHandler.printError(lineNumber, "semimajoraxis command requires 1 argument");
       }
     }
     else if (tokens[0] == "semiminoraxis")
@@ -814,7 +1017,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "semiminoraxis command requires 1 argument");
+        errorHandler.printError(lineNumber, "semiminoraxis command requires 1 argument");
       }
     }
     else if (tokens[0] == "scale")
@@ -828,7 +1031,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "scale command requires 3 arguments");
+        errorHandler.printError(lineNumber, "scale command requires 3 arguments");
       }
     }
     else if (tokens[0] == "orient")
@@ -853,7 +1056,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "orient command requires at least 1 argument");
+        errorHandler.printError(lineNumber, "orient command requires at least 1 argument");
       }
     }
     else if (startsWith(line, "rotate"))
@@ -881,7 +1084,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "3d command requires at least 2 arguments");
+        errorHandler.printError(lineNumber, "3d command requires at least 2 arguments");
       }
     }
     else if (startsWith(line, "extrude"))
@@ -899,7 +1102,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "extrude command requires at least 1 argument");
+        errorHandler.printError(lineNumber, "extrude command requires at least 1 argument");
       }
     }
     else if (tokens[0] == "height")
@@ -911,7 +1114,7 @@ bool Parser::parse(std::istream& input, Config& output, std::vector<GogMetaData>
       }
       else
       {
-        printError_(lineNumber, "height command requires 1 argument");
+        errorHandler.printError(lineNumber, "height command requires 1 argument");
       }
     }
     else if (tokens[0] == "tessellate")
@@ -1037,14 +1240,99 @@ bool Parser::createGOGs_(const Config& conf, const GOGNodeType& nodeType, const
 
 bool Parser::createGOGs(std::istream& input, const GOGNodeType& nodeType, OverlayNodeVector& output, std::vector<GogFollowData>& followData) const
 {
-  // first, parse from GOG into Config
-  Config conf;
-  std::vector<GogMetaData> metaData;
-  if (!parse(input, conf, metaData))
-    return false;
+  CollectNodesCallback callback(output, followData);
+  return createGOGs(input, nodeType, callback);
+}
 
-  // then parse from Config into Annotation.
-  return createGOGs_(conf, nodeType, metaData, output, followData);
+bool Parser::createGOGs(std::istream& input, const GOGNodeType& nodeType, LoadCallback& callback) const
+{
+  // Assertion failure means Null Object pattern failed
+  assert(context_.errorHandler_ != NULL);
+
+  // Load threads share a queue, and are only started once the input spans more than one chunk
+  osg::ref_ptr<osg::OperationQueue> queue;
+  std::vector<osg::ref_ptr<osg::OperationThread> > threads;
+  const size_t maxPending = CHUNKS_PER_THREAD * std::max(numLoadThreads_, 1u);
+  std::deque<osg::ref_ptr<ParseChunk> > pending;
+
+  BlockBoundaryScanner scanner;
+  osg::ref_ptr<ParseChunk> chunk = new ParseChunk(*this, 0);
+  std::string line;
+  size_t linesRead = 0;
+  size_t linesProcessed = 0;
+  bool moreInput = true;
+  bool canceled = false;
+  bool rv = true;
+
+  while (!canceled && (moreInput || !pending.empty()))
+  {
+    // Read ahead, splitting the input into chunks at block boundaries
+    while (moreInput && pending.size() < maxPending)
+    {
+      moreInput = simCore::getStrippedLine(input, line);
+      if (moreInput)
+      {
+        ++linesRead;
+        const bool endsBlock = scanner.endsBlock(line);
+        chunk->addLine(line);
+        if (!endsBlock || chunk->numLines() < CHUNK_LINES)
+          continue;
+      }
+      if (chunk->numLines() == 0)
+        continue;
+
+      if (numLoadThreads_ == 0 || (!moreInput && pending.empty()))
+      {
+        // Not worth starting threads for a single chunk
+        (*chunk)(NULL);
+      }
+      else
+      {
+        if (!queue.valid())
+        {
+          queue = new osg::OperationQueue;
+          for (unsigned int k = 0; k < numLoadThreads_; ++k)
+          {
+            osg::ref_ptr<osg::OperationThread> thread = new osg::OperationThread;
+            thread->setOperationQueue(queue.get());
+            thread->startThread();
+            threads.push_back(thread);
+          }
+        }
+        queue->add(chunk.get());
+      }
+      pending.push_back(chunk);
+      chunk = new ParseChunk(*this, linesRead);
+    }
+
+    if (pending.empty())
+      break;
+
+    // Create the nodes for the oldest chunk on this thread, preserving input order
+    osg::ref_ptr<ParseChunk> next = pending.front();
+    pending.pop_front();
+    next->wait();
+    next->errors().replay(*context_.errorHandler_);
+
+    OverlayNodeVector nodes;
+    std::vector<GogFollowData> followData;
+    if (!createGOGs_(next->config(), nodeType, next->metaData(), nodes, followData))
+      rv = false;
+    linesProcessed += next->numLines();
+
+    if (!nodes.empty())
+      callback.addGOGs(nodes, followData);
+    callback.progress(linesProcessed, linesRead);
+    canceled = callback.isCanceled();
+  }
+
+  // Discard chunks that have not started parsing and wait for the rest
+  if (queue.valid())
+    queue->removeAllOperations();
+  for (std::vector<osg::ref_ptr<osg::OperationThread> >::const_iterator i = threads.begin(); i != threads.end(); ++i)
+    (*i)->cancel();
+
+  return rv && !canceled;
 }
 
 GogShape Parser::getShapeFromKeyword(const std::string& keyword)
@@ -1118,15 +1406,27 @@ std::string Parser::getKeywordFromShape(GogShape shape)
 
 bool Parser::loadGOGs(std::istream& input, const GOGNodeType& nodeType, OverlayNodeVector& output, std::vector<GogFollowData>& followData) const
 {
-  return createGOGs(input, nodeType, output, followData);
+  if (!BinaryFormat::isBinary(input))
+    return createGOGs(input, nodeType, output, followData);
+
+  // Binary data is already parsed into Config, so go straight to creating nodes
+  Config conf;
+  std::vector<GogMetaData> metaData;
+  if (!BinaryFormat::read(input, conf, metaData))
+  {
+    SIM_ERROR << "GOG error: invalid binary GOG data" << std::endl;
+    return false;
+  }
+  return createGOGs_(conf, nodeType, metaData, output, followData);
 }
 
-void Parser::printError_(size_t lineNumber, const std::string& errorText) const
+bool Parser::writeBinaryGOGs(std::istream& input, std::ostream& output) const
 {
-  // Assertion failure means Null Object pattern failed
-  assert(context_.errorHandler_ != NULL);
-  if (context_.errorHandler_)
-    context_.errorHandler_->printError(lineNumber, errorText);
+  Config conf;
+  std::vector<GogMetaData> metaData;
+  if (!parse(input, conf, metaData))
+    return false;
+  return BinaryFormat::write(conf, metaData, output);
 }
 
 void Parser::setErrorHandler(std::shared_ptr<ErrorHandler> errorHandler)
@@ -61,6 +61,34 @@ namespace simVis { namespace GOG
      */
     typedef std::vector<GogNodeInterface*> OverlayNodeVector;
 
+    /**
+     * Receives GOG nodes incrementally from createGOGs() as they are created, for loading large
+     * inputs without waiting for the whole stream.  All methods are called on the loading thread.
+     */
+    class LoadCallback
+    {
+    public:
+      virtual ~LoadCallback() {}
+
+      /**
+       * Receives a batch of new GOG nodes, in input order.  Caller takes ownership of the memory.
+       * @param nodes New GOG nodes
+       * @param followData Follow orientation data for attached GOGs, parallel vector to nodes
+       */
+      virtual void addGOGs(const OverlayNodeVector& nodes, const std::vector<GogFollowData>& followData) = 0;
+
+      /**
+       * Reports loading progress after each batch.  The total number of lines is not known until
+       * the stream is exhausted, so progress is relative to the lines read so far.
+       * @param linesProcessed Number of input lines whose GOGs have been created
+       * @param linesRead Number of input lines read from the stream so far
+       */
+      virtual void progress(size_t linesProcessed, size_t linesRead) {}
+
+      /** Return true to stop loading; GOGs already passed to addGOGs() are unaffected */
+      virtual bool isCanceled() const { return false; }
+    };
+
     /**
      * Constructs a GOG parser.
      * @param mapNode  MapNode that provides the context to GOG objects created by this parser.  Note
@@ -110,6 +138,18 @@ namespace simVis { namespace GOG
      */
     void setStyle(const osgEarth::Symbology::Style& style) { style_ = style; }
 
+    /**
+     * Sets the number of threads used to parse GOG input.  Input is split at start/end block
+     * boundaries and the blocks are parsed concurrently; GOG nodes are always created on the
+     * calling thread, in input order.  Use 0 to parse on the calling thread.  Defaults to one
+     * fewer than the number of processors.
+     * @param numThreads Number of parse threads
+     */
+    void setNumLoadThreads(unsigned int numThreads) { numLoadThreads_ = numThreads; }
+
+    /** Retrieves the number of threads used to parse GOG input */
+    unsigned int numLoadThreads() const { return numLoadThreads_; }
+
   public:
     /**
      * Parses a GOGParams into a GOG node.
@@ -134,6 +174,20 @@ namespace simVis { namespace GOG
       OverlayNodeVector&           output,
       std::vector<GogFollowData>&  followData) const;
 
+    /**
+     * Parses an input stream into GOG nodes, passing them to the callback in batches as they are
+     * created.  The stream is read incrementally, so memory use does not grow with the input size
+     * beyond the nodes themselves.
+     * @param[in ] input      Input stream
+     * @param[in ] nodeType   Read GOGs as this type
+     * @param[in ] callback   Receives the GOG nodes, reports progress, and can cancel the load
+     * @return True upon success, false upon failure or cancellation
+     */
+    bool createGOGs(
+      std::istream&                input,
+      const GOGNodeType&           nodeType,
+      LoadCallback&                callback) const;
+
     /**
     * Converts the GOG file shape keyword to a GogShape. Assumes keyword is all lower, does exact match
     * @param keyword for GOG shape
@@ -149,7 +203,8 @@ namespace simVis { namespace GOG
     static std::string getKeywordFromShape(GogShape shape);
 
     /**
-     * Parses data from an input stream into a collection of GOG nodes.
+     * Parses data from an input stream into a collection of GOG nodes.  The stream may contain
+     * text GOG data, or binary data from writeBinaryGOGs(), which loads without text parsing.
      * @param[in ] input  stream containing the serialized GOG
      * @param[in ] nodeType Read GOGs as this type
      * @param[out] output   Resulting GOG collection
@@ -162,6 +217,18 @@ namespace simVis { namespace GOG
       OverlayNodeVector&           output,
       std::vector<GogFollowData>&  followData) const;
 
+    /**
+     * Parses text GOG data and writes it in the binary format of simVis::GOG::BinaryFormat, which
+     * loadGOGs() reads back without tokenizing or parsing colors and angles.  Open the output stream
+     * in binary mode.
+     * @param[in ] input  Text GOG data
+     * @param[out] output Stream receiving the binary data
+     * @return True upon success, false upon failure
+     */
+    bool writeBinaryGOGs(
+      std::istream&                input,
+      std::ostream&                output) const;
+
     /**
     * Add or overwrite a color key with a new color
     * @param[in ] key   GOG key like color1, color2, red, black,...
@@ -184,6 +251,24 @@ namespace simVis { namespace GOG
       std::vector<GogMetaData>&  metaData) const;
 
   private:
+    /// Parses a portion of the input on a load thread
+    class ParseChunk;
+
+    /**
+     * Implementation of parse(), reporting errors to the given handler instead of the context's
+     * handler so that it can be called from load threads.
+     * @param[in ] input            GOG input data
+     * @param[in ] lineNumberOffset Number of lines preceding the input, for error reporting
+     * @param[in ] errorHandler     Receives parsing errors
+     * @param[out] output           Config structure
+     * @param[out] metaData         Meta data about the GOG that needs to be stored with the resulting osg::Node
+     */
+    bool parse_(
+      std::istream&              input,
+      size_t                     lineNumberOffset,
+      ErrorHandler&              errorHandler,
+      osgEarth::Config&          output,
+      std::vector<GogMetaData>&  metaData) const;
 
     /** Applies all the specified data to the meta data as appropriate  */
     void updateMetaData_(const ModifierState& state, const std::string& refOriginLine, const std::string& positionLines, bool relative, GogMetaData& currentMetaData) const;
@@ -224,13 +309,6 @@ namespace simVis { namespace GOG
       OverlayNodeVector&              output,
       std::vector<GogFollowData>&     followData) const;
 
-    /**
-     * Prints any GOG parsing error to simNotify
-     * @param[in ] lineNumber  Line number of offending error
-     * @param[in ] errorText   Details of error
-     */
-    void printError_(size_t lineNumber, const std::string& errorText) const;
-
   private:
     /// Note that the map node could change; generally though it will not change between when a parser is instantiated and used.
     osg::observer_ptr<osgEarth::MapNode> mapNode_;
@@ -238,6 +316,7 @@ namespace simVis { namespace GOG
     GOGContext                           context_;
     osgEarth::Symbology::Style           style_;
     std::map<std::string, osgEarth::Symbology::Color> colors_; // Key is GOG color like color1, color2
+    unsigned int                         numLoadThreads_;
   };
 
 } } // namespace simVis::GOG
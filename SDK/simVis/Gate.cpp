@@ -31,6 +31,7 @@
 #include "simVis/Beam.h"
 #include "simVis/Constants.h"
 #include "simVis/EntityLabel.h"
+#include "simVis/LabelContentCache.h"
 #include "simVis/LabelContentManager.h"
 #include "simVis/LocalGrid.h"
 #include "simVis/Locator.h"
@@ -396,7 +397,7 @@ void GateNode::updateLabel_(const simData::GatePrefs& prefs)
 
     std::string text;
     if (prefs.commonprefs().labelprefs().draw())
-      text = labelContentCallback().createString(prefs, lastUpdateFromDS_, prefs.commonprefs().labelprefs().displayfields());
+      text = labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_LABEL, prefs, lastUpdateFromDS_, prefs.commonprefs().labelprefs().displayfields());
 
     if (!text.empty())
     {
@@ -423,7 +424,7 @@ std::string GateNode::popupText() const
         prefix = getEntityName(EntityNode::ALIAS_NAME);
       prefix += "\n";
     }
-    return prefix + labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hoverdisplayfields());
+    return prefix + labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_HOVER, lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hoverdisplayfields());
   }
 
   return "";
@@ -432,14 +433,14 @@ std::string GateNode::popupText() const
 std::string GateNode::hookText() const
 {
   if (hasLastPrefs_ && hasLastUpdate_)
-    return labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hookdisplayfields());
+    return labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_HOOK, lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().hookdisplayfields());
   return "";
 }
 
 std::string GateNode::legendText() const
 {
   if (hasLastPrefs_ && hasLastUpdate_)
-    return labelContentCallback().createString(lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().legenddisplayfields());
+    return labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_LEGEND, lastPrefsFromDS_, lastUpdateFromDS_, lastPrefsFromDS_.commonprefs().labelprefs().legenddisplayfields());
   return "";
 }
 
@@ -455,6 +456,8 @@ void GateNode::setPrefs(const simData::GatePrefs& prefs)
 
 void GateNode::applyPrefs_(const simData::GatePrefs& prefs, bool force)
 {
+  // Label content might depend on any pref
+  labelContentCache().invalidate();
   if (prefsOverrides_.size() == 0)
   {
     apply_(NULL, &prefs, force);
@@ -0,0 +1,212 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include "simVis/LabelContentManager.h"
+#include "simVis/LabelContentCache.h"
+
+namespace simVis
+{
+
+namespace
+{
+  /** Bits of the compiled display field mask */
+  enum FieldBits
+  {
+    FIELD_X_LAT = 1 << 0,
+    FIELD_Y_LON = 1 << 1,
+    FIELD_Z_ALT = 1 << 2,
+    FIELD_YAW = 1 << 3,
+    FIELD_PITCH = 1 << 4,
+    FIELD_ROLL = 1 << 5,
+    FIELD_COURSE = 1 << 6,
+    FIELD_FLIGHT_PATH_ELEVATION = 1 << 7,
+    FIELD_VX = 1 << 8,
+    FIELD_VY = 1 << 9,
+    FIELD_VZ = 1 << 10,
+    FIELD_SPEED = 1 << 11,
+    FIELD_MACH = 1 << 12,
+    FIELD_ANGLE_OF_ATTACK = 1 << 13,
+    FIELD_SIDE_SLIP = 1 << 14,
+    FIELD_TOTAL_ANGLE_OF_ATTACK = 1 << 15,
+    FIELD_CATEGORY_DATA = 1 << 16
+  };
+
+  /** Fields whose values a beam or gate can only get from its host */
+  static const uint32_t HOST_FIELDS = FIELD_X_LAT | FIELD_Y_LON | FIELD_Z_ALT | FIELD_COURSE |
+    FIELD_FLIGHT_PATH_ELEVATION | FIELD_VX | FIELD_VY | FIELD_VZ | FIELD_SPEED | FIELD_MACH |
+    FIELD_ANGLE_OF_ATTACK | FIELD_SIDE_SLIP | FIELD_TOTAL_ANGLE_OF_ATTACK;
+
+  /** Statistics shared by all caches; atomic since entities may be updated from several threads */
+  std::atomic<unsigned int> requests_(0);
+  std::atomic<unsigned int> generated_(0);
+}
+
+LabelContentCache::LabelContentCache()
+  : osg::Referenced()
+{
+  invalidate();
+}
+
+LabelContentCache::~LabelContentCache()
+{
+}
+
+void LabelContentCache::invalidate()
+{
+  for (unsigned int k = 0; k < NUM_SLOTS; ++k)
+  {
+    entries_[k].valid = false;
+    entries_[k].fieldMask = 0;
+    entries_[k].numValues = 0;
+    entries_[k].text.clear();
+  }
+}
+
+void LabelContentCache::invalidateCategoryData()
+{
+  for (unsigned int k = 0; k < NUM_SLOTS; ++k)
+  {
+    if ((entries_[k].fieldMask & FIELD_CATEGORY_DATA) != 0)
+      entries_[k].valid = false;
+  }
+}
+
+const std::string& LabelContentCache::createString(LabelContentCallback& callback, Slot slot, const simData::PlatformPrefs& prefs, const simData::PlatformUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+{
+  bool isVolatile = false;
+  const uint32_t fieldMask = compileFields_(fields, false, isVolatile);
+  // Only callbacks that opt in are cached
+  isVolatile = isVolatile || !callback.cacheable();
+  // Every platform field is computed from position, orientation and velocity
+  const double values[] = {
+    lastUpdate.x(), lastUpdate.y(), lastUpdate.z(),
+    lastUpdate.psi(), lastUpdate.theta(), lastUpdate.phi(),
+    lastUpdate.vx(), lastUpdate.vy(), lastUpdate.vz()
+  };
+  Entry* entry = find_(slot, fieldMask, isVolatile, values, (fieldMask == 0 ? 0 : 9));
+  if (entry->valid)
+    return entry->text;
+  entry->text = callback.createString(prefs, lastUpdate, fields);
+  entry->valid = !isVolatile;
+  return entry->text;
+}
+
+const std::string& LabelContentCache::createString(LabelContentCallback& callback, Slot slot, const simData::BeamPrefs& prefs, const simData::BeamUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+{
+  bool isVolatile = false;
+  const uint32_t fieldMask = compileFields_(fields, true, isVolatile);
+  // Only callbacks that opt in are cached
+  isVolatile = isVolatile || !callback.cacheable();
+  const double values[] = { lastUpdate.azimuth(), lastUpdate.elevation(), lastUpdate.range() };
+  Entry* entry = find_(slot, fieldMask, isVolatile, values, (fieldMask == 0 ? 0 : 3));
+  if (entry->valid)
+    return entry->text;
+  entry->text = callback.createString(prefs, lastUpdate, fields);
+  entry->valid = !isVolatile;
+  return entry->text;
+}
+
+const std::string& LabelContentCache::createString(LabelContentCallback& callback, Slot slot, const simData::GatePrefs& prefs, const simData::GateUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+{
+  bool isVolatile = false;
+  const uint32_t fieldMask = compileFields_(fields, true, isVolatile);
+  // Only callbacks that opt in are cached
+  isVolatile = isVolatile || !callback.cacheable();
+  const double values[] = {
+    lastUpdate.azimuth(), lastUpdate.elevation(), lastUpdate.width(), lastUpdate.height(),
+    lastUpdate.minrange(), lastUpdate.maxrange(), lastUpdate.centroid()
+  };
+  Entry* entry = find_(slot, fieldMask, isVolatile, values, (fieldMask == 0 ? 0 : 7));
+  if (entry->valid)
+    return entry->text;
+  entry->text = callback.createString(prefs, lastUpdate, fields);
+  entry->valid = !isVolatile;
+  return entry->text;
+}
+
+LabelContentCache::Statistics LabelContentCache::statistics()
+{
+  Statistics rv;
+  rv.requests = requests_.load(std::memory_order_relaxed);
+  rv.generated = generated_.load(std::memory_order_relaxed);
+  return rv;
+}
+
+void LabelContentCache::resetStatistics()
+{
+  requests_.store(0, std::memory_order_relaxed);
+  generated_.store(0, std::memory_order_relaxed);
+}
+
+uint32_t LabelContentCache::compileFields_(const simData::LabelPrefs_DisplayFields& fields, bool ownUpdateOnly, bool& isVolatile)
+{
+  // Category data is cached until invalidateCategoryData()
+  isVolatile = fields.genericdata() || fields.late() ||
+    fields.solarazimuth() || fields.solarelevation() || fields.solarilluminance() ||
+    fields.lunarazimuth() || fields.lunarelevation() || fields.lunarilluminance() ||
+    fields.uselabelcode();
+
+  uint32_t rv = 0;
+  if (fields.xlat()) rv |= FIELD_X_LAT;
+  if (fields.ylon()) rv |= FIELD_Y_LON;
+  if (fields.zalt()) rv |= FIELD_Z_ALT;
+  if (fields.yaw()) rv |= FIELD_YAW;
+  if (fields.pitch()) rv |= FIELD_PITCH;
+  if (fields.roll()) rv |= FIELD_ROLL;
+  if (fields.course()) rv |= FIELD_COURSE;
+  if (fields.flightpathelevation()) rv |= FIELD_FLIGHT_PATH_ELEVATION;
+  if (fields.displayvx()) rv |= FIELD_VX;
+  if (fields.displayvy()) rv |= FIELD_VY;
+  if (fields.displayvz()) rv |= FIELD_VZ;
+  if (fields.speed()) rv |= FIELD_SPEED;
+  if (fields.mach()) rv |= FIELD_MACH;
+  if (fields.angleofattack()) rv |= FIELD_ANGLE_OF_ATTACK;
+  if (fields.sideslip()) rv |= FIELD_SIDE_SLIP;
+  if (fields.totalangleofattack()) rv |= FIELD_TOTAL_ANGLE_OF_ATTACK;
+  if (fields.categorydata()) rv |= FIELD_CATEGORY_DATA;
+
+  if (ownUpdateOnly && (rv & HOST_FIELDS) != 0)
+    isVolatile = true;
+  return rv;
+}
+
+LabelContentCache::Entry* LabelContentCache::find_(Slot slot, uint32_t fieldMask, bool isVolatile, const double* values, unsigned int numValues)
+{
+  assert(slot >= 0 && slot < NUM_SLOTS && numValues <= MAX_VALUES);
+  requests_.fetch_add(1, std::memory_order_relaxed);
+  Entry& entry = entries_[slot];
+  if (!isVolatile && entry.valid && entry.fieldMask == fieldMask && entry.numValues == numValues &&
+    std::equal(values, values + numValues, entry.values))
+    return &entry;
+
+  // Save the new inputs; the caller fills in the text
+  generated_.fetch_add(1, std::memory_order_relaxed);
+  entry.valid = false;
+  entry.fieldMask = fieldMask;
+  entry.numValues = numValues;
+  std::copy(values, values + numValues, entry.values);
+  return &entry;
+}
+
+}
@@ -0,0 +1,120 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#ifndef SIMVIS_LABEL_CONTENT_CACHE_H
+#define SIMVIS_LABEL_CONTENT_CACHE_H
+
+#include <string>
+#include "osg/Referenced"
+#include "simCore/Common/Common.h"
+#include "simData/DataTypes.h"
+
+namespace simVis
+{
+class LabelContentCallback;
+
+/**
+ * Caches the label content strings of one entity, so that the LabelContentCallback is called only
+ * when the inputs of the displayed fields change.  The display fields are compiled into a mask, and
+ * the update values those fields read are saved with the string.  A later request with the same
+ * mask and values returns the saved string.
+ *
+ * Only callbacks whose cacheable() returns true are cached.  Strings that show category data are
+ * cached until invalidateCategoryData().  Other fields that depend on more than the entity's own
+ * prefs and update, such as generic data, late time, sun and moon values, and label code, are
+ * regenerated on every request.  The owner must call invalidate() whenever the prefs, name, or
+ * content callback change, and invalidateCategoryData() whenever the category data changes.
+ */
+class SDKVIS_EXPORT LabelContentCache : public osg::Referenced
+{
+public:
+  /** Each string an entity creates is cached separately */
+  enum Slot
+  {
+    SLOT_LABEL = 0,
+    SLOT_HOVER,
+    SLOT_HOOK,
+    SLOT_LEGEND,
+    NUM_SLOTS
+  };
+
+  /** Counts of requests and of strings actually generated, across all caches */
+  struct Statistics
+  {
+    /** Number of strings requested */
+    unsigned int requests;
+    /** Number of strings generated by a content callback */
+    unsigned int generated;
+  };
+
+  LabelContentCache();
+
+  /** Discards all cached strings; call when prefs, name, or the content callback change */
+  void invalidate();
+  /** Discards the cached strings that show category data; call when the entity's category data changes */
+  void invalidateCategoryData();
+
+  /** Returns the platform label content, calling the callback only if the inputs changed */
+  const std::string& createString(LabelContentCallback& callback, Slot slot, const simData::PlatformPrefs& prefs, const simData::PlatformUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields);
+  /** Returns the beam label content, calling the callback only if the inputs changed */
+  const std::string& createString(LabelContentCallback& callback, Slot slot, const simData::BeamPrefs& prefs, const simData::BeamUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields);
+  /** Returns the gate label content, calling the callback only if the inputs changed */
+  const std::string& createString(LabelContentCallback& callback, Slot slot, const simData::GatePrefs& prefs, const simData::GateUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields);
+
+  /** Returns the statistics for all caches since the last resetStatistics(); safe from any thread */
+  static Statistics statistics();
+  /** Resets the statistics; e.g. call once per frame to count labels generated per frame */
+  static void resetStatistics();
+
+protected:
+  virtual ~LabelContentCache();
+
+private:
+  /** Most values saved for any entity type */
+  static const unsigned int MAX_VALUES = 9;
+
+  /** Saved string and the inputs that produced it */
+  struct Entry
+  {
+    bool valid;
+    uint32_t fieldMask;
+    unsigned int numValues;
+    double values[MAX_VALUES];
+    std::string text;
+  };
+
+  /**
+   * Compiles the display fields into a mask of enabled fields.  Sets isVolatile if any enabled field
+   * depends on data other than the entity's prefs and update.  If ownUpdateOnly is true, fields that
+   * describe a platform's position and motion are also volatile, since beams and gates get those
+   * values from the host.
+   */
+  static uint32_t compileFields_(const simData::LabelPrefs_DisplayFields& fields, bool ownUpdateOnly, bool& isVolatile);
+
+  /** Returns the entry for the slot if it matches the inputs; else returns NULL and saves the inputs in the entry */
+  Entry* find_(Slot slot, uint32_t fieldMask, bool isVolatile, const double* values, unsigned int numValues);
+
+  Entry entries_[NUM_SLOTS];
+};
+
+}
+
+#endif /* SIMVIS_LABEL_CONTENT_CACHE_H */
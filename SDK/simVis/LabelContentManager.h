@@ -97,6 +97,19 @@ namespace simVis
     */
     virtual std::string createString(simData::ObjectId id, const simData::CustomRenderingPrefs& prefs, const simData::LabelPrefs_DisplayFields& fields) = 0;
 
+    /**
+    * Returns true if the strings depend only on the prefs, update and display fields passed to
+    * createString(), so that a string may be reused while those are unchanged.  The entity's own
+    * category data may also be read when the category data field is displayed, since cached strings
+    * showing it are discarded when it changes.  Callbacks that read other data, such as generic data
+    * from the data store, must return false.  Default returns false.
+    * @return True if strings may be cached by LabelContentCache
+    */
+    virtual bool cacheable() const
+    {
+      return false;
+    }
+
   protected:
     virtual ~LabelContentCallback() {}
   };
@@ -154,6 +167,11 @@ namespace simVis
       return "";
     }
 
+    virtual bool cacheable() const
+    {
+      return true;
+    }
+
   protected:
     virtual ~NullEntityCallback() {}
   };
@@ -19,6 +19,8 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <deque>
 #include "osgEarth/GeoData"
 #include "osgEarth/Horizon"
 #include "osgEarth/ObjectIndex"
@@ -71,107 +73,181 @@ bool prefsRequiresRebuild(const simData::LobGroupPrefs* a, const simData::LobGro
 namespace simVis
 {
 
-/// maps time to one or more animated lines
+/**
+ * Time-ordered columnar cache of the lines drawn.  Entry k of each column describes child k of the
+ * lines group, and the entries are sorted by time.  Points are processed in time order, so new lines
+ * are appended to the end, and lines that fall out of the data window are trimmed from either end by
+ * index.  An update only needs to convert the points that are newer than the processed window.
+ */
 class LobGroupNode::Cache
 {
 public:
   /** Constructor */
   Cache()
+    : lines_(new osg::Group),
+      hasProcessed_(false),
+      processedFirst_(0.0),
+      processedLast_(0.0)
   {
+    lines_->setName("LobGroup Lines");
   }
 
   ~Cache()
   {
   }
 
+  /** Group that holds the animated lines, in the same order as the columns */
+  osg::Group* group() const
+  {
+    return lines_.get();
+  }
+
   /** Retrieves the number of animated lines in the cache */
   int numLines() const
   {
-    return static_cast<int>(entries_.size());
+    return static_cast<int>(times_.size());
   }
 
-  /** Removes all animated lines from the cache under the parent */
-  void clearCache(osg::Group* parent)
+  /** Removes all animated lines from the cache */
+  void clearCache()
   {
-    // removes all LOB draw nodes
-    for (LineCache::const_iterator iter = entries_.begin(); iter != entries_.end(); ++iter)
-    {
-      parent->removeChild(iter->second);
-    }
-    // clear out cache
-    entries_.clear();
+    if (lines_->getNumChildren() > 0)
+      lines_->removeChildren(0, lines_->getNumChildren());
+    times_.clear();
+    starts_.clear();
+    ends_.clear();
+    unresolved_.clear();
+    hasProcessed_ = false;
   }
 
   /** Removes items from the cache that are outside [firstTime,lastTime] */
-  void pruneCache(osg::Group* parent, double firstTime, double lastTime)
+  void pruneCache(double firstTime, double lastTime)
   {
-    // since the ordered multimap keys are ordered by time, remove all entries < firstTime time
-    const LineCache::iterator newStart = entries_.find(firstTime);
-    for (LineCache::const_iterator iter = entries_.begin(); iter != newStart; ++iter)
+    // Trim the tail first so that the head indices remain valid
+    const size_t end = std::upper_bound(times_.begin(), times_.end(), lastTime) - times_.begin();
+    if (end < times_.size())
+      erase_(end, times_.size());
+    const size_t begin = std::lower_bound(times_.begin(), times_.end(), firstTime) - times_.begin();
+    if (begin > 0)
+      erase_(0, begin);
+
+    // Unresolved times are sorted too
+    unresolved_.erase(std::upper_bound(unresolved_.begin(), unresolved_.end(), lastTime), unresolved_.end());
+    unresolved_.erase(unresolved_.begin(), std::lower_bound(unresolved_.begin(), unresolved_.end(), firstTime));
+
+    if (hasProcessed_)
     {
-      parent->removeChild(iter->second);
+      processedFirst_ = simCore::sdkMax(processedFirst_, firstTime);
+      processedLast_ = simCore::sdkMin(processedLast_, lastTime);
+      hasProcessed_ = (processedFirst_ <= processedLast_);
     }
-    if (newStart != entries_.begin())
-      entries_.erase(entries_.begin(), newStart);
+  }
 
-    // since the ordered multimap keys are ordered by time, remove all entries > lastTime time
-    const LineCache::iterator newEnd = entries_.upper_bound(lastTime);
-    for (LineCache::const_iterator iter = newEnd; iter != entries_.end(); ++iter)
-    {
-      parent->removeChild(iter->second);
-    }
-    if (newEnd != entries_.end())
-      entries_.erase(newEnd, entries_.end());
+  /** Returns true if points have been processed, filling in the time window of the processed points */
+  bool processedWindow(double& firstTime, double& lastTime) const
+  {
+    firstTime = processedFirst_;
+    lastTime = processedLast_;
+    return hasProcessed_;
+  }
+
+  /** Marks all points in [firstTime,lastTime] as processed */
+  void setProcessedWindow(double firstTime, double lastTime)
+  {
+    processedFirst_ = firstTime;
+    processedLast_ = lastTime;
+    hasProcessed_ = true;
   }
 
   /// update all lines to have the prefs in 'p'
   void setAllLineProperties(const simData::LobGroupPrefs &p)
   {
     // TODO body offset
-    for (LineCache::const_iterator i = entries_.begin(); i != entries_.end(); ++i)
+    const unsigned int numChildren = lines_->getNumChildren();
+    for (unsigned int k = 0; k < numChildren; ++k)
     {
+      AnimatedLineNode* line = static_cast<AnimatedLineNode*>(lines_->getChild(k));
       // only changeable pref is color override (maxdatapoints and maxdataseconds are handled in refresh())
       if (p.commonprefs().useoverridecolor())
-        i->second->setColorOverride(simVis::ColorUtils::RgbaToVec4(p.commonprefs().overridecolor()));
+        line->setColorOverride(simVis::ColorUtils::RgbaToVec4(p.commonprefs().overridecolor()));
       else
-        i->second->clearColorOverride();
+        line->clearColorOverride();
+    }
+  }
+
+  /// add animated line 'a' at time 't', with ECEF end points 'start' and 'end'
+  void addLineAtTime(double t, AnimatedLineNode *a, const osg::Vec3d& start, const osg::Vec3d& end)
+  {
+    // Almost always an append; only a time resolved late is inserted into the middle
+    const size_t index = std::upper_bound(times_.begin(), times_.end(), t) - times_.begin();
+    if (index == times_.size())
+    {
+      times_.push_back(t);
+      starts_.push_back(start);
+      ends_.push_back(end);
+      lines_->addChild(a);
+      return;
     }
+    times_.insert(times_.begin() + index, t);
+    starts_.insert(starts_.begin() + index, start);
+    ends_.insert(ends_.begin() + index, end);
+    lines_->insertChild(static_cast<unsigned int>(index), a);
   }
 
-  /// return true if there are any lines for time 't'
-  bool hasTime(double t) const
+  /// remember a time whose lines could not be created yet because the host had no position
+  void addUnresolvedTime(double t)
   {
-    return (entries_.find(t) != entries_.end());
+    unresolved_.insert(std::upper_bound(unresolved_.begin(), unresolved_.end(), t), t);
   }
 
-  /// add animated line 'a' at time 't'
-  void addLineAtTime(double t, AnimatedLineNode *a)
+  /// moves the unresolved times into 'times'; caller is expected to retry them
+  void takeUnresolvedTimes(std::vector<double>& times)
   {
-    entries_.insert(std::make_pair(t, osg::ref_ptr<AnimatedLineNode>(a)));
+    times.clear();
+    times.swap(unresolved_);
   }
 
   /// Gets the endpoints of all lines in the cache
   void getVisibleEndpoints(std::vector<osg::Vec3d>& ecefVec) const
   {
-    simCore::MultiFrameCoordinate first;
-    simCore::MultiFrameCoordinate second;
-    for (LineCache::const_iterator iter = entries_.begin(); iter != entries_.end(); ++iter)
+    ecefVec.reserve(ecefVec.size() + 2 * times_.size());
+    for (size_t k = 0; k < times_.size(); ++k)
     {
       // Only save points of lines that are visible
-      if (iter->second->getNodeMask() != 0 && iter->second->getEndPoints(first, second) == 0)
+      if (lines_->getChild(static_cast<unsigned int>(k))->getNodeMask() != 0)
       {
-        const simCore::Vec3 firstPos = first.ecefCoordinate().position();
-        const simCore::Vec3 secondPos = second.ecefCoordinate().position();
-        ecefVec.push_back(osg::Vec3d(firstPos.x(), firstPos.y(), firstPos.z()));
-        ecefVec.push_back(osg::Vec3d(secondPos.x(), secondPos.y(), secondPos.z()));
+        ecefVec.push_back(starts_[k]);
+        ecefVec.push_back(ends_[k]);
       }
     }
   }
 
-protected:
-  typedef std::multimap<double, osg::ref_ptr<AnimatedLineNode> > LineCache;
-  /** Multimap of scenario time to the animated lines at that time */
-  LineCache entries_;
+private:
+  /** Removes the entries in [begin,end) from all columns and from the lines group */
+  void erase_(size_t begin, size_t end)
+  {
+    lines_->removeChildren(static_cast<unsigned int>(begin), static_cast<unsigned int>(end - begin));
+    times_.erase(times_.begin() + begin, times_.begin() + end);
+    starts_.erase(starts_.begin() + begin, starts_.begin() + end);
+    ends_.erase(ends_.begin() + begin, ends_.begin() + end);
+  }
+
+  /** Animated lines, one child per column entry */
+  osg::ref_ptr<osg::Group> lines_;
+  /** Scenario time of each line, sorted; deques since pruning removes the oldest lines from the front */
+  std::deque<double> times_;
+  /** ECEF start point of each line */
+  std::deque<osg::Vec3d> starts_;
+  /** ECEF end point of each line */
+  std::deque<osg::Vec3d> ends_;
+  /** Sorted times of points that had no host position when processed */
+  std::vector<double> unresolved_;
+  /** True if processedFirst_ and processedLast_ are valid */
+  bool hasProcessed_;
+  /** First time of the points already processed */
+  double processedFirst_;
+  /** Last time of the points already processed */
+  double processedLast_;
 };
 
 LobGroupNode::LobGroupNode(const simData::LobGroupProperties &props, EntityNode* host, CoordSurfaceClamping* surfaceClamping, simData::DataStore &ds)
@@ -189,6 +265,8 @@ LobGroupNode::LobGroupNode(const simData::LobGroupProperties &props, EntityNode*
   objectIndexTag_(0)
 {
   setName("LobGroup");
+  addChild(lineCache_->group());
+
   localGrid_ = new LocalGridNode(getLocator(), host, ds.referenceYear());
   addChild(localGrid_);
 
@@ -217,7 +295,7 @@ LobGroupNode::~LobGroupNode()
 
   delete coordConverter_;
   coordConverter_ = NULL;
-  lineCache_->clearCache(this);
+  lineCache_->clearCache();
   delete lineCache_;
   lineCache_ = NULL;
 }
@@ -311,7 +389,7 @@ void LobGroupNode::setPrefs(const simData::LobGroupPrefs &prefs)
       PB_FIELD_CHANGED(&lastPrefs_, &prefs, lobuseclampalt))
   {
     // rebuild all lines
-    lineCache_->clearCache(this);
+    lineCache_->clearCache();
     const simData::LobGroupUpdateSlice *updateSlice = ds_.lobGroupUpdateSlice(lastProps_.id());
     if (updateSlice)
     {
@@ -328,18 +406,14 @@ void LobGroupNode::setPrefs(const simData::LobGroupPrefs &prefs)
   updateLabel_(prefs);
 }
 
-void LobGroupNode::setLineDrawStyle_(double time, simVis::AnimatedLineNode& line, const simData::LobGroupPrefs& defaultValues)
+void LobGroupNode::getLineDrawStyle_(double time, const simData::LobGroupPrefs& defaultValues, simData::LobGroupPrefs& prefs) const
 {
-  simData::DataTable* table = ds_.dataTableManager().findTable(getId(), simData::INTERNAL_LOB_DRAWSTYLE_TABLE);
+  // initialize to the current pref values
+  prefs.CopyFrom(defaultValues);
+  const simData::DataTable* table = ds_.dataTableManager().findTable(getId(), simData::INTERNAL_LOB_DRAWSTYLE_TABLE);
   if (table == NULL)
-  {
-    setLineValueFromPrefs_(line, defaultValues);
     return;
-  }
 
-  simData::LobGroupPrefs prefs;
-  // initialize to the current pref values
-  prefs.CopyFrom(defaultValues);
   uint32_t color1;
   uint32_t color2;
   uint16_t stipple1;
@@ -356,8 +430,6 @@ void LobGroupNode::setLineDrawStyle_(double time, simVis::AnimatedLineNode& line
     prefs.set_stipple2(stipple2);
   if (getColumnValue_(simData::INTERNAL_LOB_LINEWIDTH_COLUMN, *table, time, lineWidth) == 0)
     prefs.set_lobwidth(lineWidth);
-
-  setLineValueFromPrefs_(line, prefs);
 }
 
 void LobGroupNode::setLineValueFromPrefs_(AnimatedLineNode& line, const simData::LobGroupPrefs& prefs) const
@@ -399,128 +471,186 @@ void LobGroupNode::updateCache_(const simData::LobGroupUpdate &update, const sim
   if ((numLines <= 0) || (platformData == NULL))
   {
     // no lines, clear out cache and remove all draw nodes
-    lineCache_->clearCache(this);
+    lineCache_->clearCache();
     return;
   }
 
-  // prune the cache, since the data max values may adjust how much data is shown
   const double firstTime = update.datapoints(0).time();
   const double lastTime = update.datapoints(numLines-1).time();
-  lineCache_->pruneCache(this, firstTime, lastTime);
+  double processedFirst = 0.0;
+  double processedLast = 0.0;
+  if (lineCache_->processedWindow(processedFirst, processedLast) && firstTime < processedFirst)
+  {
+    // points earlier than the processed window cannot be appended (e.g. time moved backwards); start over
+    lineCache_->clearCache();
+  }
+  else
+  {
+    // prune the cache, since the data max values may adjust how much data is shown
+    lineCache_->pruneCache(firstTime, lastTime);
+  }
 
-  simData::Interpolator* li = ds_.interpolator();
-  for (int index = 0; index < numLines;) // Incremented in the for loop below
+  // retry the times that had no host position when last processed; host data may have arrived since
+  std::vector<double> unresolved;
+  lineCache_->takeUnresolvedTimes(unresolved);
+  for (std::vector<double>::const_iterator i = unresolved.begin(); i != unresolved.end(); ++i)
   {
-    // handle all lines with this time (if time is not already in the cache)
-    const double time = update.datapoints(index).time();
-    if (lineCache_->hasTime(time))
-    {
-      ++index;
-      continue;
-    }
+    const int index = lowerBoundIndex_(update, *i);
+    if (index < numLines && update.datapoints(index).time() == *i)
+      addLinesAtTime_(update, index, prefs, *platformData);
+  }
 
-    // prepare to add this line to the cache - process the host platform position once for all endpoints
-    const simData::PlatformUpdateSlice::Iterator platformIter = platformData->upper_bound(time);
-    if (!platformIter.hasPrevious())
-    {
-      // cannot process this LOB since there is no platform position at or before lob time; possibly the platform point was removed by data limiting.
+  // only the points after the processed window are new
+  int index = 0;
+  if (lineCache_->processedWindow(processedFirst, processedLast))
+  {
+    index = lowerBoundIndex_(update, processedLast);
+    while (index < numLines && update.datapoints(index).time() == processedLast)
       ++index;
-      continue;
-      // note that this will create the condition that numLines != lineCache_->numLines()
-    }
-    // last update at or before t:
-    const simData::PlatformUpdate* platformUpdate = platformIter.peekPrevious();
+  }
+  lineCache_->setProcessedWindow(firstTime, lastTime);
+  while (index < numLines)
+    index = addLinesAtTime_(update, index, prefs, *platformData);
+}
 
-    // interpolation may be required for LOBs on a moving platform
-    simData::PlatformUpdate interpolatedPlatformUpdate;
-    if (platformUpdate->time() != time && li != NULL && platformIter.hasNext())
+int LobGroupNode::lowerBoundIndex_(const simData::LobGroupUpdate& update, double time) const
+{
+  // datapoints are sorted by time
+  int first = 0;
+  int count = update.datapoints_size();
+  while (count > 0)
+  {
+    const int step = count / 2;
+    if (update.datapoints(first + step).time() < time)
     {
-      // defn of upper_bound previous()
-      assert(platformUpdate->time() < time);
-      // defn of upper_bound next()
-      assert(platformIter.peekNext()->time() > time);
-      li->interpolate(time, *platformUpdate, *(platformIter.peekNext()), &interpolatedPlatformUpdate);
-      platformUpdate = &interpolatedPlatformUpdate;
+      first += step + 1;
+      count -= step + 1;
     }
+    else
+      count = step;
+  }
+  return first;
+}
 
-    // construct the starting coordinate, we may clamp this
-    simCore::Coordinate platformCoordPosOnly(simCore::COORD_SYS_ECEF, simCore::Vec3(platformUpdate->x(), platformUpdate->y(), platformUpdate->z()));
-    simCore::Coordinate llaCoord;
-    if (lastProps_.azelrelativetohostori())
-    {
-      // calculate host orientation in LLA, used for determining a relative LOB's true angle
-      const simCore::Coordinate ecefCoord(simCore::COORD_SYS_ECEF, simCore::Vec3(platformUpdate->x(), platformUpdate->y(), platformUpdate->z()),
-                                          simCore::Vec3(platformUpdate->psi(), platformUpdate->theta(), platformUpdate->phi()));
-      simCore::CoordinateConverter::convertEcefToGeodetic(ecefCoord, llaCoord);
-    }
+int LobGroupNode::addLinesAtTime_(const simData::LobGroupUpdate& update, int index, const simData::LobGroupPrefs& prefs, const simData::PlatformUpdateSlice& platformData)
+{
+  const int numLines = update.datapoints_size();
+  const double time = update.datapoints(index).time();
+  int endIndex = index + 1;
+  while (endIndex < numLines && update.datapoints(endIndex).time() == time)
+    ++endIndex;
+
+  // process the host platform position once for all endpoints
+  const simData::PlatformUpdateSlice::Iterator platformIter = platformData.upper_bound(time);
+  if (!platformIter.hasPrevious())
+  {
+    // cannot process this LOB since there is no platform position at or before lob time; possibly the platform point was removed by data limiting.
+    // note that this will create the condition that numLines != lineCache_->numLines()
+    lineCache_->addUnresolvedTime(time);
+    return endIndex;
+  }
+  // last update at or before t:
+  const simData::PlatformUpdate* platformUpdate = platformIter.peekPrevious();
 
-    // calculate the clamped host platform coord only once, for all lines at this same time
-    if (prefs.lobuseclampalt())
-    {
-      // we provide only ecef
-      assert(platformCoordPosOnly.coordinateSystem() == simCore::COORD_SYS_ECEF);
-      applyPlatformCoordClamping_(platformCoordPosOnly);
-      // and are returned only ecef
-      assert(platformCoordPosOnly.coordinateSystem() == simCore::COORD_SYS_ECEF);
-    }
+  // interpolation may be required for LOBs on a moving platform
+  simData::Interpolator* li = ds_.interpolator();
+  simData::PlatformUpdate interpolatedPlatformUpdate;
+  if (platformUpdate->time() != time && li != NULL && platformIter.hasNext())
+  {
+    // defn of upper_bound previous()
+    assert(platformUpdate->time() < time);
+    // defn of upper_bound next()
+    assert(platformIter.peekNext()->time() > time);
+    li->interpolate(time, *platformUpdate, *(platformIter.peekNext()), &interpolatedPlatformUpdate);
+    platformUpdate = &interpolatedPlatformUpdate;
+  }
 
-    // process endpoints for all lines at same time; all share same host platform position just calc'd
-    for (; index < update.datapoints_size() && update.datapoints(index).time() == time; ++index)
-    {
-      // calculate end point based on update point RAE
-      const simData::LobGroupUpdatePoint &curP = update.datapoints(index);
+  // construct the starting coordinate, we may clamp this
+  simCore::Coordinate platformCoordPosOnly(simCore::COORD_SYS_ECEF, simCore::Vec3(platformUpdate->x(), platformUpdate->y(), platformUpdate->z()));
+  simCore::Coordinate llaCoord;
+  if (lastProps_.azelrelativetohostori())
+  {
+    // calculate host orientation in LLA, used for determining a relative LOB's true angle
+    const simCore::Coordinate ecefCoord(simCore::COORD_SYS_ECEF, simCore::Vec3(platformUpdate->x(), platformUpdate->y(), platformUpdate->z()),
+                                        simCore::Vec3(platformUpdate->psi(), platformUpdate->theta(), platformUpdate->phi()));
+    simCore::CoordinateConverter::convertEcefToGeodetic(ecefCoord, llaCoord);
+  }
+
+  // calculate the clamped host platform coord only once, for all lines at this same time
+  const bool clamp = prefs.lobuseclampalt() && surfaceClamping_ != NULL;
+  if (clamp)
+  {
+    // we provide only ecef
+    assert(platformCoordPosOnly.coordinateSystem() == simCore::COORD_SYS_ECEF);
+    applyPlatformCoordClamping_(platformCoordPosOnly);
+    // and are returned only ecef
+    assert(platformCoordPosOnly.coordinateSystem() == simCore::COORD_SYS_ECEF);
+  }
 
-      // find the point relative to the start
-      simCore::Vec3 endPoint;
+  // compute the endpoints for all lines at same time in the host's XEAST frame
+  std::vector<simCore::Vec3> endPoints;
+  endPoints.reserve(endIndex - index);
+  for (int k = index; k < endIndex; ++k)
+  {
+    // calculate end point based on update point RAE
+    const simData::LobGroupUpdatePoint &curP = update.datapoints(k);
 
-      simCore::Vec3 lobAngles(curP.azimuth(), curP.elevation(), 0.0);
-      if (lastProps_.azelrelativetohostori())
-      {
-        // Offset the host orientation angles via the LOB relative orientation for body-relative mode
-        lobAngles = simCore::rotateEulerAngle(llaCoord.orientation(), lobAngles);
-      }
+    simCore::Vec3 lobAngles(curP.azimuth(), curP.elevation(), 0.0);
+    if (lastProps_.azelrelativetohostori())
+    {
+      // Offset the host orientation angles via the LOB relative orientation for body-relative mode
+      lobAngles = simCore::rotateEulerAngle(llaCoord.orientation(), lobAngles);
+    }
 
-      // check for minimum range
-      const double range = prefs.userangeoverride() ? prefs.rangeoverridevalue() : curP.range();
-      simCore::v3SphtoRec(range, lobAngles.yaw(), lobAngles.pitch(), endPoint);
-      simCore::Coordinate endCoord(simCore::COORD_SYS_XEAST, endPoint);
+    // check for minimum range
+    const double range = prefs.userangeoverride() ? prefs.rangeoverridevalue() : curP.range();
+    simCore::Vec3 endPoint;
+    simCore::v3SphtoRec(range, lobAngles.yaw(), lobAngles.pitch(), endPoint);
+    endPoints.push_back(endPoint);
+  }
 
-      if (prefs.lobuseclampalt())
-        applyEndpointCoordClamping_(endCoord);
+  // convert them all to ECEF against the shared host position
+  convertEndpoints_(platformCoordPosOnly, clamp, endPoints);
 
-      //--- construct the line
-      AnimatedLineNode *line = new AnimatedLineNode;
-      line->setShiftsPerSecond(0);
+  // all lines at this time share the same draw style
+  simData::LobGroupPrefs stylePrefs;
+  getLineDrawStyle_(time, prefs, stylePrefs);
 
-      // set starting prefs
-      setLineDrawStyle_(time, *line, prefs);
+  const osg::Vec3d start(platformCoordPosOnly.x(), platformCoordPosOnly.y(), platformCoordPosOnly.z());
+  for (std::vector<simCore::Vec3>::const_iterator i = endPoints.begin(); i != endPoints.end(); ++i)
+  {
+    //--- construct the line
+    AnimatedLineNode *line = new AnimatedLineNode;
+    line->setShiftsPerSecond(0);
 
-      // set coordinates
-      line->setEndPoints(platformCoordPosOnly, endCoord);
+    // set starting prefs
+    setLineValueFromPrefs_(*line, stylePrefs);
 
-      // insert into cache
-      lineCache_->addLineAtTime(time, line);
-      addChild(line);
-    }
+    // set coordinates
+    line->setEndPoints(platformCoordPosOnly, simCore::Coordinate(simCore::COORD_SYS_ECEF, *i));
 
-    // set the local grid for platform's position and az/el of the last of the lobs
-    if (index == numLines)
-    {
-      const simData::LobGroupUpdatePoint &curP = update.datapoints(update.datapoints_size()-1);
-      simCore::Vec3 lobAngles(curP.azimuth(), curP.elevation(), 0.0);
-      if (lastProps_.azelrelativetohostori())
-      {
-        // Offset the host orientation angles via the LOB relative orientation for body-relative mode
-        lobAngles = simCore::rotateEulerAngle(llaCoord.orientation(), lobAngles);
-      }
+    // insert into cache
+    lineCache_->addLineAtTime(time, line, start, osg::Vec3d(i->x(), i->y(), i->z()));
+  }
 
-      // suppress locator notification until we're done with locator updates
-      getLocator()->setLocalOffsets(simCore::Vec3(), lobAngles, time, false);
-      // Use position only, otherwise rendering will be adversely affected; locator notification is true now
-      // note that if lob is clamped, localgrid will also be clamped
-      getLocator()->setCoordinate(platformCoordPosOnly, time);
+  // set the local grid for platform's position and az/el of the last of the lobs
+  if (endIndex == numLines)
+  {
+    const simData::LobGroupUpdatePoint &curP = update.datapoints(numLines-1);
+    simCore::Vec3 lobAngles(curP.azimuth(), curP.elevation(), 0.0);
+    if (lastProps_.azelrelativetohostori())
+    {
+      // Offset the host orientation angles via the LOB relative orientation for body-relative mode
+      lobAngles = simCore::rotateEulerAngle(llaCoord.orientation(), lobAngles);
     }
+
+    // suppress locator notification until we're done with locator updates
+    getLocator()->setLocalOffsets(simCore::Vec3(), lobAngles, time, false);
+    // Use position only, otherwise rendering will be adversely affected; locator notification is true now
+    // note that if lob is clamped, localgrid will also be clamped
+    getLocator()->setCoordinate(platformCoordPosOnly, time);
   }
+  return endIndex;
 }
 
 bool LobGroupNode::isActive() const
@@ -603,7 +733,7 @@ bool LobGroupNode::updateFromDataStore(const simData::DataSliceBase *updateSlice
 
 void LobGroupNode::flush()
 {
-  lineCache_->clearCache(this);
+  lineCache_->clearCache();
   setNodeMask(DISPLAY_MASK_NONE);
   hasLastUpdate_ = false;
 }
@@ -635,23 +765,36 @@ void LobGroupNode::applyPlatformCoordClamping_(simCore::Coordinate& platformCoor
   // clamp in ecef means: convert to lla, clamp, convert back to ecef; clamp in lla involves no coord conversion
   surfaceClamping_->clampCoordToMapSurface(platLla);
 
-  // platform position is always our coordinate converter reference origin, in LLA (required for applyEndpointCoordClamping_)
-  coordConverter_->setReferenceOrigin(platLla.position());
-
   // now convert to ecef since that is what the caller requires
   simCore::CoordinateConverter::convertGeodeticToEcef(platLla, platformCoord);
 }
 
-void LobGroupNode::applyEndpointCoordClamping_(simCore::Coordinate& endpointCoord)
+void LobGroupNode::convertEndpoints_(const simCore::Coordinate& platformCoord, bool clamp, std::vector<simCore::Vec3>& endPoints)
 {
-  if (!surfaceClamping_)
+  if (endPoints.empty())
     return;
 
-  // convert to lla for surface clamping call
+  // platform position is the reference origin for all endpoints; set it once for the batch
+  simCore::Coordinate platLla;
+  simCore::CoordinateConverter::convertEcefToGeodetic(platformCoord, platLla);
+  coordConverter_->setReferenceOrigin(platLla.position());
+
   simCore::Coordinate endLla;
-  coordConverter_->convert(endpointCoord, endLla, simCore::COORD_SYS_LLA);
-  surfaceClamping_->clampCoordToMapSurface(endLla);
-  coordConverter_->convert(endLla, endpointCoord, simCore::COORD_SYS_XEAST);
+  simCore::Coordinate endEcef;
+  for (std::vector<simCore::Vec3>::iterator i = endPoints.begin(); i != endPoints.end(); ++i)
+  {
+    const simCore::Coordinate endCoord(simCore::COORD_SYS_XEAST, *i);
+    if (clamp)
+    {
+      // clamping is done in lla
+      coordConverter_->convert(endCoord, endLla, simCore::COORD_SYS_LLA);
+      surfaceClamping_->clampCoordToMapSurface(endLla);
+      simCore::CoordinateConverter::convertGeodeticToEcef(endLla, endEcef);
+    }
+    else
+      coordConverter_->convert(endCoord, endEcef, simCore::COORD_SYS_ECEF);
+    *i = endEcef.position();
+  }
 }
 
 void LobGroupNode::getVisibleEndPoints(std::vector<osg::Vec3d>& ecefVec) const
@@ -22,6 +22,7 @@
 #ifndef SIMVIS_LOB_GROUP_H
 #define SIMVIS_LOB_GROUP_H
 
+#include "simData/DataSlice.h"
 #include "simData/DataTypes.h"
 #include "simVis/Entity.h"
 #include "simVis/Constants.h"
@@ -164,21 +165,25 @@ private: // methods
   /// osg::Referenced-derived
   virtual ~LobGroupNode();
 
-  /// apply clamping to this platform coordinate. Assumes coord is ECEF. Will update the coordinate converter ref lla
+  /// apply clamping to this platform coordinate. Assumes coord is ECEF
   void applyPlatformCoordClamping_(simCore::Coordinate& platformCoord);
-  /// apply clamping to this endpoint coordinate. Assumes coord is XEAST
-  void applyEndpointCoordClamping_(simCore::Coordinate& endpointCoord);
+  /// convert XEAST endpoints relative to the ECEF platform coordinate into ECEF in one batch, optionally clamping. Will update the coordinate converter ref lla
+  void convertEndpoints_(const simCore::Coordinate& platformCoord, bool clamp, std::vector<simCore::Vec3>& endPoints);
 
   /// get the value for the specified colume from the specified data table, at the specified time. Returns 0 on success, non-zero on failure
   template <class T>
   int getColumnValue_(const std::string& columnName, const simData::DataTable& table, double time, T& value) const;
-  /// set the line's LOB draw style at the specified time, using default values if not found in the internal data table
-  void setLineDrawStyle_(double time, AnimatedLineNode& line, const simData::LobGroupPrefs& defaultValues);
+  /// get the LOB draw style at the specified time, using default values if not found in the internal data table
+  void getLineDrawStyle_(double time, const simData::LobGroupPrefs& defaultValues, simData::LobGroupPrefs& prefs) const;
   /// set the line LOB draw style values from the specified prefs
   void setLineValueFromPrefs_(AnimatedLineNode& line, const simData::LobGroupPrefs& prefs) const;
 
-  /// update the cache so it has lines for every point in 'u'
+  /// update the cache so it has lines for every point in 'u'; only points newer than the cache are converted
   void updateCache_(const simData::LobGroupUpdate &u, const simData::LobGroupPrefs& prefs);
+  /// returns the index of the first point in 'u' at or after 'time', or the number of points if none
+  int lowerBoundIndex_(const simData::LobGroupUpdate& u, double time) const;
+  /// adds lines for all points in 'u' that share the time of point 'index'; returns the index of the first point after them
+  int addLinesAtTime_(const simData::LobGroupUpdate& u, int index, const simData::LobGroupPrefs& prefs, const simData::PlatformUpdateSlice& platformData);
 
   /// updates the label with the given preferences
   void updateLabel_(const simData::LobGroupPrefs& prefs);
@@ -203,7 +208,7 @@ private: // data
   /// Host platform ID
   simData::ObjectId hostId_;
 
-  /// Cache of lines drawn
+  /// Time-ordered cache of lines drawn; owns the group holding the lines
   Cache *lineCache_;
   /// the localgrid node for this lobgroup
   osg::ref_ptr<LocalGridNode> localGrid_;
@@ -19,11 +19,16 @@
  * disclose, or release this software.
  *
  */
+#include <cmath>
 #include <iomanip>
+#include <map>
+#include <sstream>
 
 #include "osg/Notify"
 #include "osg/Geode"
 #include "osg/Geometry"
+#include "osg/MatrixTransform"
+#include "osg/observer_ptr"
 #include "osgText/Text"
 
 #include "osgEarth/Registry"
@@ -390,7 +395,7 @@ public:
     (*colorArray)[0] = color;
   }
 
-  void update(const simData::LocalGridPrefs& prefs, double sizeM)
+  void update(unsigned int numRings, double sizeM)
   {
     osg::ref_ptr<osg::Vec3Array> vertexArray = dynamic_cast<osg::Vec3Array*>(getVertexArray());
     if (!vertexArray)
@@ -404,9 +409,7 @@ public:
       drawArray_->setCount(0);
       return;
     }
-    const unsigned int numDivisions = prefs.gridsettings().numdivisions();
-    const unsigned int numSubDivisions = prefs.gridsettings().numsubdivisions();
-    const unsigned int numRings = osg::maximum(1u, (numDivisions + 1) * (numSubDivisions + 1));
+    numRings = osg::maximum(1u, numRings);
     const float spacingM = sizeM / numRings;
     const float radiusM = spacingM * (ring_ + 1);
     const double circum = 2.0 * M_PI * radiusM;
@@ -431,11 +434,205 @@ private:
   osg::ref_ptr<osg::DrawArrays> drawArray_;
   unsigned int ring_;
 };
+
+/// Returns true if the grid type draws rings, whose number of segments depends on the ring size
+bool hasRings(simData::LocalGridPrefs_Type gridType)
+{
+  return gridType == simData::LocalGridPrefs_Type_POLAR ||
+    gridType == simData::LocalGridPrefs_Type_RANGE_RINGS ||
+    gridType == simData::LocalGridPrefs_Type_SPEED_RINGS;
+}
+
+/// Returns a string identifying the grid lines for the prefs, apart from the size
+std::string graphicsParameters(const simData::LocalGridPrefs& prefs)
+{
+  // Speed rings draw the same lines as a polar grid
+  const simData::LocalGridPrefs_Type gridType = (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_RINGS) ?
+    simData::LocalGridPrefs_Type_POLAR : prefs.gridtype();
+  std::ostringstream os;
+  os << gridType << ' ' << prefs.gridcolor() << ' ' << prefs.gridsettings().numdivisions() << ' ' << prefs.gridsettings().numsubdivisions();
+  if (gridType == simData::LocalGridPrefs_Type_POLAR)
+    os << ' ' << prefs.gridsettings().sectorangle();
+  return os.str();
+}
+
+/// Returns the size at which to generate rings for the given size: the next power of two in meters
+double ringReferenceSize(double sizeM)
+{
+  return simCore::sdkMin(MAX_RING_SIZE_M, pow(2.0, ceil(log(sizeM) / log(2.0))));
+}
+
+/// Creates Cartesian grid lines with a half-width of 1
+void createCartesianGraphics(const simData::LocalGridPrefs& prefs, osg::Geode* geomGroup)
+{
+  const int numDivisions    = prefs.gridsettings().numdivisions();
+  const int numSubDivisions = prefs.gridsettings().numsubdivisions();
+  const int numDivLines = (numDivisions * 2) + 3;
+  const int numSubLines = (numDivLines-1) * (numSubDivisions + 1);
+
+  const float span = 2.f;
+  const float divSpacing = span / (numDivLines-1);
+  const float subSpacing = span / (numSubLines);
+  const float x0 = -0.5f * span;
+  const float y0 = -0.5f * span;
+
+  const osg::Vec4f& color = osgEarth::Symbology::Color(prefs.gridcolor(), osgEarth::Symbology::Color::RGBA);
+  const osg::Vec4f& subColor = osgEarth::Symbology::Color(color * 0.5f, 1.0f);
+
+  // first draw the subdivision lines
+  for (int s = 0; s < numSubLines; ++s)
+  {
+    // skip sub lines that are coincident with main division lines
+    if (s % (numSubDivisions+1) == 0)
+      continue;
+
+    {
+      const float x = x0 + subSpacing * s;
+      LineStrip* sub1 = new LineStrip();
+      sub1->update(osg::Vec3(x, y0, 0.f), osg::Vec3(x, y0 + span, 0.f));
+      sub1->setName("simVis::LocalGridNode::GridSubDivision1");
+      sub1->setColor(subColor);
+      geomGroup->addDrawable(sub1);
+    }
+    {
+      const float y = y0 + subSpacing * s;
+      LineStrip* sub2 = new LineStrip();
+      sub2->update(osg::Vec3(x0, y, 0.f), osg::Vec3(x0 + span, y, 0.f));
+      sub2->setName("simVis::LocalGridNode::GridSubDivision2");
+      sub2->setColor(subColor);
+      geomGroup->addDrawable(sub2);
+    }
+  }
+
+  // second draw the main division lines
+  for (int p=0; p < numDivLines; ++p)
+  {
+    const float x = x0 + divSpacing * p;
+    LineStrip* div1 = new LineStrip();
+    div1->update(osg::Vec3(x, y0, 0.f), osg::Vec3(x, y0 + span, 0.f));
+    div1->setName("simVis::LocalGridNode::GridDivision1");
+    div1->setColor(color);
+    geomGroup->addDrawable(div1);
+
+    const float y = y0 + divSpacing * p;
+    LineStrip* div2 = new LineStrip();
+    div2->update(osg::Vec3(x0, y, 0.f), osg::Vec3(x0 + span, y, 0.f));
+    div2->setName("simVis::LocalGridNode::GridDivision2");
+    div2->setColor(color);
+    geomGroup->addDrawable(div2);
+  }
+}
+
+/// Creates rings with optional polar radials, sized to the radius in meters
+void createRingGraphics(const simData::LocalGridPrefs& prefs, double sizeM, bool includePolarRadials, osg::Geode* geomGroup)
+{
+  const unsigned int numDivisions = prefs.gridsettings().numdivisions();
+  const unsigned int numSubDivisions = prefs.gridsettings().numsubdivisions();
+  const unsigned int numRings = (numDivisions + 1) * (numSubDivisions + 1);
+
+  const osg::Vec4f& color = osgEarth::Symbology::Color(prefs.gridcolor(), osgEarth::Symbology::Color::RGBA);
+  const osg::Vec4f& subColor = osgEarth::Symbology::Color(color * 0.5f, 1.0f);
+
+  for (unsigned int i = 0; i < numRings; ++i)
+  {
+    const bool isMajorRing = ((i + 1) % (numSubDivisions + 1)) == 0;
+    RangeRing* rangeRing = new RangeRing(i);
+    rangeRing->setColor(isMajorRing ? color : subColor);
+    geomGroup->addDrawable(rangeRing);
+    rangeRing->update(numRings, sizeM);
+  }
+
+  // Cross-hair lines don't get drawn for Range Rings, but do for Polar and Speed Rings
+  if (includePolarRadials)
+  {
+    Axis* majorAxis = new Axis(true);
+    majorAxis->setColor(color);
+    geomGroup->addDrawable(majorAxis);
+    majorAxis->update(sizeM);
+
+    Axis* minorAxis = new Axis(false);
+    minorAxis->setColor(color);
+    geomGroup->addDrawable(minorAxis);
+    minorAxis->update(sizeM);
+
+    const float sectorAngle = prefs.gridsettings().sectorangle();
+    if (sectorAngle > 0.0f)
+    {
+      RadialPoints* points = new RadialPoints(subColor, sectorAngle, numRings);
+      geomGroup->addDrawable(points);
+      points->update(sizeM);
+    }
+  }
+}
+
+/// Creates the grid lines for the prefs; rings are sized to the reference size, other lines have a size of 1
+osg::Geode* createGraphics(const simData::LocalGridPrefs& prefs, double referenceSizeM)
+{
+  osg::Geode* geode = new osg::Geode();
+  geode->setName("simVis::LocalGridNode::GraphicsGeode");
+  PointSize::setValues(geode->getOrCreateStateSet(), 1.5f, osg::StateAttribute::ON);
+
+  switch (prefs.gridtype())
+  {
+  case simData::LocalGridPrefs_Type_CARTESIAN:
+    createCartesianGraphics(prefs, geode);
+    break;
+  case simData::LocalGridPrefs_Type_POLAR:
+  case simData::LocalGridPrefs_Type_SPEED_RINGS:
+    createRingGraphics(prefs, referenceSizeM, true, geode);
+    break;
+  case simData::LocalGridPrefs_Type_RANGE_RINGS:
+    createRingGraphics(prefs, referenceSizeM, false, geode);
+    break;
+  case simData::LocalGridPrefs_Type_SPEED_LINE:
+  {
+    SpeedLine* speedLine = new SpeedLine();
+    speedLine->setColor(osgEarth::Symbology::Color(prefs.gridcolor(), osgEarth::Symbology::Color::RGBA));
+    geode->addDrawable(speedLine);
+    speedLine->update(1.0);
+    break;
+  }
+  }
+  return geode;
+}
+
+/// Grid lines shared between local grids; lines are released when no grid displays them
+typedef std::map<std::string, osg::observer_ptr<osg::Geode> > GraphicsCache;
+
+/// Returns the grid lines for the parameters and reference size, creating them if no grid displays them
+osg::ref_ptr<osg::Geode> sharedGraphics(const std::string& parameters, const simData::LocalGridPrefs& prefs, double referenceSizeM)
+{
+  static GraphicsCache s_cache;
+  std::ostringstream os;
+  os.precision(17);
+  os << parameters << '|' << referenceSizeM;
+  const std::string key = os.str();
+
+  osg::ref_ptr<osg::Geode> graphics;
+  GraphicsCache::const_iterator i = s_cache.find(key);
+  if (i != s_cache.end() && i->second.lock(graphics))
+    return graphics;
+
+  // Remove lines that are no longer displayed
+  GraphicsCache::iterator iter = s_cache.begin();
+  while (iter != s_cache.end())
+  {
+    if (iter->second.valid())
+      ++iter;
+    else
+      s_cache.erase(iter++);
+  }
+
+  graphics = createGraphics(prefs, referenceSizeM);
+  s_cache[key] = graphics.get();
+  return graphics;
+}
 }
 
 // --------------------------------------------------------------------------
 LocalGridNode::LocalGridNode(Locator* hostLocator, const EntityNode* host, int referenceYear)
   : LocatorNode(new Locator(hostLocator, Locator::COMP_POSITION | Locator::COMP_HEADING)),
+    graphicsSizeM_(0.0),
     forceRebuild_(true),
     hostSpeedMS_(0.0),
     hostTimeS_(0.0),
@@ -455,13 +652,11 @@ void LocalGridNode::rebuild_(const simData::LocalGridPrefs& prefs)
   // set up the default state set and render bins:
   getOrCreateStateSet()->setRenderBinDetails(BIN_LOCAL_GRID, BIN_GLOBAL_SIMSDK);
 
-  if (!graphicsGroup_)
+  if (!graphicsTransform_)
   {
-    graphicsGroup_ = new osg::Geode();
-    graphicsGroup_->setName("simVis::LocalGridNode::GraphicsGeode");
-    osg::StateSet* ss = graphicsGroup_->getOrCreateStateSet();
-    PointSize::setValues(ss, 1.5f, osg::StateAttribute::ON);
-    addChild(graphicsGroup_.get());
+    graphicsTransform_ = new osg::MatrixTransform();
+    graphicsTransform_->setName("simVis::LocalGridNode::GraphicsTransform");
+    addChild(graphicsTransform_.get());
   }
 
   if (!labelGroup_)
@@ -473,36 +668,58 @@ void LocalGridNode::rebuild_(const simData::LocalGridPrefs& prefs)
 
   // LocalGrid is constructed with 2 children; they are not removed
   assert(getNumChildren() == 2);
-  graphicsGroup_->removeChildren(0, graphicsGroup_->getNumChildren());
   labelGroup_->removeChildren(0, labelGroup_->getNumChildren());
 
+  const Units sizeUnits = simVis::convertUnitsToOsgEarth(prefs.sizeunits());
+  // Note that size is halved; it's provided in diameter, and we need it as radius
+  const double sizeM = sizeUnits.convertTo(Units::METERS, prefs.size()) * 0.5;
+
   // build for the appropriate grid type:
   switch (prefs.gridtype())
   {
   case simData::LocalGridPrefs_Type_CARTESIAN:
-    createCartesian_(prefs, graphicsGroup_.get(), labelGroup_.get());
+    applyGraphics_(prefs, sizeM);
+    createCartesianLabels_(prefs, sizeM, labelGroup_.get());
     break;
 
   case simData::LocalGridPrefs_Type_POLAR:
-    createRangeRings_(prefs, graphicsGroup_.get(), labelGroup_.get(), true);
-    break;
-
   case simData::LocalGridPrefs_Type_RANGE_RINGS:
-    createRangeRings_(prefs, graphicsGroup_.get(), labelGroup_.get(), false);
+  {
+    // if size exceeds this number there is an excessive UI responsiveness penalty
+    const bool tooLarge = (sizeM > MAX_RING_SIZE_M);
+    if (tooLarge)
+      SIM_ERROR << "Range Rings radius exceeds maximum ring size." << std::endl;
+    if (tooLarge || simCore::areEqual(sizeM, 0.0))
+    {
+      applyGraphics_(prefs, 0.0);
+      break;
+    }
+    applyGraphics_(prefs, sizeM);
+    createRingLabels_(prefs, labelGroup_.get(), true);
+    const unsigned int numLabels = labelGroup_->getNumChildren();
+    for (unsigned int i = 0; i < numLabels; ++i)
+    {
+      RingLabel* label = dynamic_cast<RingLabel*>(labelGroup_->getChild(i));
+      if (label)
+        label->update(prefs, sizeM);
+    }
     break;
+  }
 
   case simData::LocalGridPrefs_Type_SPEED_RINGS:
   case simData::LocalGridPrefs_Type_SPEED_LINE:
   {
     // determine if we can validly display speedrings/speedline
-    double sizeM;
+    double speedSizeM;
     double timeRadiusSeconds;
-    const int status = processSpeedParams_(prefs, sizeM, timeRadiusSeconds);
+    const int status = processSpeedParams_(prefs, speedSizeM, timeRadiusSeconds);
     if (status >= 0)
     {
-      createSpeedRings_(prefs, graphicsGroup_.get(), labelGroup_.get(), (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_LINE));
-      updateSpeedRings_(prefs, sizeM, timeRadiusSeconds);
+      createRingLabels_(prefs, labelGroup_.get(), (prefs.gridtype() == simData::LocalGridPrefs_Type_SPEED_RINGS));
+      updateSpeedRings_(prefs, speedSizeM, timeRadiusSeconds);
     }
+    else
+      applyGraphics_(prefs, 0.0);
     break;
   }
   }
@@ -511,6 +728,37 @@ void LocalGridNode::rebuild_(const simData::LocalGridPrefs& prefs)
     osgEarth::Registry::shaderGenerator().run(labelGroup_.get());
 };
 
+void LocalGridNode::applyGraphics_(const simData::LocalGridPrefs& prefs, double sizeM)
+{
+  if (sizeM <= 0.0)
+  {
+    graphicsTransform_->removeChildren(0, graphicsTransform_->getNumChildren());
+    graphicsParameters_.clear();
+    return;
+  }
+
+  const std::string parameters = graphicsParameters(prefs);
+  const bool rings = hasRings(prefs.gridtype());
+  // Cartesian lines and the speed line scale exactly; rings keep enough segments for any radius up to the reference size
+  double referenceSizeM = rings ? ringReferenceSize(sizeM) : 1.0;
+  const bool current = (graphicsTransform_->getNumChildren() != 0 && parameters == graphicsParameters_);
+  // Keep current rings while they have no more than four times the segments needed, to avoid swapping lines back and forth
+  if (current && rings && graphicsSizeM_ >= sizeM && graphicsSizeM_ <= 4.0 * sizeM)
+    referenceSizeM = graphicsSizeM_;
+
+  if (!current || referenceSizeM != graphicsSizeM_)
+  {
+    const osg::ref_ptr<osg::Geode> graphics = sharedGraphics(parameters, prefs, referenceSizeM);
+    graphicsTransform_->removeChildren(0, graphicsTransform_->getNumChildren());
+    graphicsTransform_->addChild(graphics.get());
+    graphicsParameters_ = parameters;
+    graphicsSizeM_ = referenceSizeM;
+  }
+
+  const double scale = sizeM / referenceSizeM;
+  graphicsTransform_->setMatrix(osg::Matrix::scale(scale, scale, scale));
+}
+
 void LocalGridNode::validatePrefs(const simData::LocalGridPrefs& prefs)
 {
   // because fixed time validation provides feedback to user, it needs to be processed when interaction occurs, not just when grid is turned on
@@ -670,81 +918,33 @@ void LocalGridNode::syncWithLocator()
   }
 }
 
-// creates a Cartesian grid.
-void LocalGridNode::createCartesian_(const simData::LocalGridPrefs& prefs, osg::Geode* geomGroup, osg::Geode* labelGroup) const
+// creates the labels for a Cartesian grid.
+void LocalGridNode::createCartesianLabels_(const simData::LocalGridPrefs& prefs, double sizeM, osg::Geode* labelGroup) const
 {
-  const Units sizeUnits = simVis::convertUnitsToOsgEarth(prefs.sizeunits());
-  // Note that size is halved; it's provided in diameter, and we need it as radius
-  const float size = sizeUnits.convertTo(Units::METERS, prefs.size()) * 0.5f;
-  const int numDivisions    = prefs.gridsettings().numdivisions();
-  const int numSubDivisions = prefs.gridsettings().numsubdivisions();
-  const int numDivLines = (numDivisions * 2) + 3;
-  const int numSubLines = (numDivLines-1) * (numSubDivisions + 1);
+  if (!prefs.gridlabeldraw())
+    return;
 
-  const float span = 2.f * size;
+  const int numDivisions = prefs.gridsettings().numdivisions();
+  const int numDivLines = (numDivisions * 2) + 3;
+  const float span = 2.f * static_cast<float>(sizeM);
   const float divSpacing = span / (numDivLines-1);
-  const float subSpacing = span / (numSubLines);
   const float x0 = -0.5f * span;
   const float y0 = -0.5f * span;
 
-  const osg::Vec4f& color = osgEarth::Symbology::Color(prefs.gridcolor(), osgEarth::Symbology::Color::RGBA);
-  const osg::Vec4f& subColor = osgEarth::Symbology::Color(color * 0.5f, 1.0f);
-
-  // first draw the subdivision lines
-  for (int s = 0; s < numSubLines; ++s)
-  {
-    // skip sub lines that are coincident with main division lines
-    if (s % (numSubDivisions+1) == 0)
-      continue;
-
-    {
-      const float x = x0 + subSpacing * s;
-      LineStrip* sub1 = new LineStrip();
-      sub1->update(osg::Vec3(x, y0, 0.f), osg::Vec3(x, y0 + span, 0.f));
-      sub1->setName("simVis::LocalGridNode::GridSubDivision1");
-      sub1->setColor(subColor);
-      geomGroup->addDrawable(sub1);
-    }
-    {
-      const float y = y0 + subSpacing * s;
-      LineStrip* sub2 = new LineStrip();
-      sub2->update(osg::Vec3(x0, y, 0.f), osg::Vec3(x0 + span, y, 0.f));
-      sub2->setName("simVis::LocalGridNode::GridSubDivision2");
-      sub2->setColor(subColor);
-      geomGroup->addDrawable(sub2);
-    }
-  }
-
-  // second draw the main division lines and the text labels
-  const std::string abbrev = sizeUnits.getAbbr();
   for (int p=0; p < numDivLines; ++p)
   {
-    const float x = x0 + divSpacing * p;
-    {
-      LineStrip* div1 = new LineStrip();
-      div1->update(osg::Vec3(x, y0, 0.f), osg::Vec3(x, y0 + span, 0.f));
-      div1->setName("simVis::LocalGridNode::GridDivision1");
-      div1->setColor(color);
-      geomGroup->addDrawable(div1);
-    }
     // x-label:
-    if (x < 0 && prefs.gridlabeldraw())
+    const float x = x0 + divSpacing * p;
+    if (x < 0)
     {
       CartesianGridLabel* label = new CartesianGridLabel(prefs, -x);
       label->setPosition(osg::Vec3(-x, 0.f, 0.f));
       labelGroup->addDrawable(label);
     }
 
-    const float y = y0 + divSpacing * p;
-    {
-      LineStrip* div2 = new LineStrip();
-      div2->update(osg::Vec3(x0, y, 0.f), osg::Vec3(x0 + span, y, 0.f));
-      div2->setName("simVis::LocalGridNode::GridDivision2");
-      div2->setColor(color);
-      geomGroup->addDrawable(div2);
-    }
     // y-label
-    if (y > 0 && prefs.gridlabeldraw())
+    const float y = y0 + divSpacing * p;
+    if (y > 0)
     {
       CartesianGridLabel* label = new CartesianGridLabel(prefs, y);
       label->setPosition(osg::Vec3(0.f, y, 0.f));
@@ -753,134 +953,28 @@ void LocalGridNode::createCartesian_(const simData::LocalGridPrefs& prefs, osg::
   }
 }
 
-// creates a range-rings local grid with optional polar radials.
-void LocalGridNode::createRangeRings_(const simData::LocalGridPrefs& prefs, osg::Geode* geomGroup, osg::Geode* labelGroup, bool includePolarRadials) const
+// creates the labels on the major rings; text and position are set when the labels are updated.
+void LocalGridNode::createRingLabels_(const simData::LocalGridPrefs& prefs, osg::Geode* labelGroup, bool includeMinorAxisLabels) const
 {
-  const Units sizeUnits = simVis::convertUnitsToOsgEarth(prefs.sizeunits());
-  // Note that size is halved; it's provided in diameter, and we need it as radius
-  const float sizeM = sizeUnits.convertTo(Units::METERS, prefs.size()) * 0.5f;
-
-  if (simCore::areEqual(sizeM, 0.0))
+  if (!prefs.gridlabeldraw())
     return;
 
-  // if size exceeds this number there is an excessive UI responsiveness penalty
-  if (sizeM > MAX_RING_SIZE_M)
-  {
-    SIM_ERROR << "Range Rings radius exceeds maximum ring size." << std::endl;
-    return;
-  }
-
-  const int   numDivisions    = prefs.gridsettings().numdivisions();
-  const int   numSubDivisions = prefs.gridsettings().numsubdivisions();
-  const int numRings          = (numDivisions + 1) * (numSubDivisions + 1);
-
-  const osg::Vec4f& color = osgEarth::Symbology::Color(prefs.gridcolor(), osgEarth::Symbology::Color::RGBA);
-  const osg::Vec4f& subColor = osgEarth::Symbology::Color(color * 0.5f, 1.0f);
-
-  // rings:
-  for (int i = 0; i < numRings; ++i)
-  {
-    const bool isMajorRing = ((i + 1) % (numSubDivisions + 1)) == 0;
-
-    RangeRing* rangeRing = new RangeRing(i);
-    rangeRing->setColor(isMajorRing ? color : subColor);
-    geomGroup->addDrawable(rangeRing);
-    rangeRing->update(prefs, sizeM);
-
-    // label:
-    if (isMajorRing && prefs.gridlabeldraw())
-    {
-      RingLabel* label = new RingLabel(prefs, i, true);
-      labelGroup->addDrawable(label);
-      label->update(prefs, sizeM);
-
-      // add minor axis label as clone
-      RingLabel* label2 = new RingLabel(*label, false);
-      labelGroup->addChild(label2);
-      label2->update(prefs, sizeM);
-    }
-  }
-
-  // Cross-hair lines don't get drawn for Range Rings, but do for Polar
-  if (includePolarRadials)
-  {
-    Axis* majorAxis = new Axis(true);
-    majorAxis->setColor(color);
-    geomGroup->addDrawable(majorAxis);
-    majorAxis->update(sizeM);
-
-    Axis* minorAxis = new Axis(false);
-    minorAxis->setColor(color);
-    geomGroup->addDrawable(minorAxis);
-    minorAxis->update(sizeM);
-
-    const float sectorAngle = prefs.gridsettings().sectorangle();
-    if (sectorAngle > 0.0f)
-    {
-      RadialPoints* points = new RadialPoints(subColor, sectorAngle, numRings);
-      geomGroup->addDrawable(points);
-      points->update(sizeM);
-    }
-  }
-}
-
-// creates a speed-rings local grid with optional polar radials.
-void LocalGridNode::createSpeedRings_(const simData::LocalGridPrefs& prefs, osg::Geode* graphicsGroup, osg::Geode* labelGroup, bool drawSpeedLine) const
-{
-  const osg::Vec4f& color = osgEarth::Symbology::Color(prefs.gridcolor(), osgEarth::Symbology::Color::RGBA);
-  const osg::Vec4f& subColor = osgEarth::Symbology::Color(color * 0.5f, 1.0f);
   const unsigned int numDivisions = prefs.gridsettings().numdivisions();
   const unsigned int numSubDivisions = prefs.gridsettings().numsubdivisions();
   const unsigned int numRings = (numDivisions + 1) * (numSubDivisions + 1);
-
-  if (drawSpeedLine)
-  {
-    SpeedLine* speedLine = new SpeedLine();
-    speedLine->setColor(color);
-    graphicsGroup->addDrawable(speedLine);
-
-    if (!prefs.gridlabeldraw())
-      return;
-  }
-  else
-  {
-    Axis* majorAxis = new Axis(true);
-    majorAxis->setColor(color);
-    graphicsGroup->addDrawable(majorAxis);
-    Axis* minorAxis = new Axis(false);
-    minorAxis->setColor(color);
-    graphicsGroup->addDrawable(minorAxis);
-
-    const float sectorAngle = prefs.gridsettings().sectorangle();
-    // draw polar radials for speed rings
-    if (sectorAngle > 0.0f)
-    {
-      RadialPoints* points = new RadialPoints(subColor, sectorAngle, numRings);
-      graphicsGroup->addDrawable(points);
-    }
-  }
-
   for (unsigned int i = 0; i < numRings; ++i)
   {
-    const bool isMajorRing = ((i + 1) % (numSubDivisions + 1)) == 0;
-    if (!drawSpeedLine)
-    {
-      RangeRing* speedRing = new RangeRing(i);
-      speedRing->setColor(isMajorRing ? color : subColor);
-      graphicsGroup->addDrawable(speedRing);
-    }
     // labels are only added to major rings
-    if (isMajorRing && prefs.gridlabeldraw())
-    {
-      RingLabel* label = new RingLabel(prefs, i, true);
-      labelGroup->addDrawable(label);
+    if (((i + 1) % (numSubDivisions + 1)) != 0)
+      continue;
+    RingLabel* label = new RingLabel(prefs, i, true);
+    labelGroup->addDrawable(label);
 
-      if (!drawSpeedLine)
-      {
-        // add minor axis label as clone
-        RingLabel* label2 = new RingLabel(*label, false);
-        labelGroup->addChild(label2);
-      }
+    if (includeMinorAxisLabels)
+    {
+      // add minor axis label as clone
+      RingLabel* label2 = new RingLabel(*label, false);
+      labelGroup->addChild(label2);
     }
   }
 }
@@ -892,6 +986,8 @@ void LocalGridNode::updateSpeedRings_(const simData::LocalGridPrefs& prefs, doub
     assert(0);
     return;
   }
+  // lines are rescaled; only the label text and positions change
+  applyGraphics_(prefs, sizeM);
   const unsigned int numLabels = labelGroup_->getNumChildren();
   for (unsigned int i = 0; i < numLabels; i++)
   {
@@ -900,35 +996,6 @@ void LocalGridNode::updateSpeedRings_(const simData::LocalGridPrefs& prefs, doub
     if (label)
       label->update(prefs, sizeM, timeRadiusSeconds);
   }
-  const unsigned int numGraphics = graphicsGroup_->getNumChildren();
-  for (unsigned int i = 0; i < numGraphics; i++)
-  {
-    osg::Node* child = graphicsGroup_->getChild(i);
-    RangeRing* ring = dynamic_cast<RangeRing*>(child);
-    if (ring)
-    {
-      ring->update(prefs, sizeM);
-      continue;
-    }
-    SpeedLine* line = dynamic_cast<SpeedLine*>(child);
-    if (line)
-    {
-      line->update(sizeM);
-      continue;
-    }
-    Axis* axis = dynamic_cast<Axis*>(child);
-    if (axis)
-    {
-      axis->update(sizeM);
-      continue;
-    }
-    RadialPoints* pts = dynamic_cast<RadialPoints*>(child);
-    if (pts)
-    {
-      pts->update(sizeM);
-      continue;
-    }
-  }
 }
 
 int LocalGridNode::processSpeedParams_(const simData::LocalGridPrefs& prefs, double& sizeM, double& timeRadiusSeconds)
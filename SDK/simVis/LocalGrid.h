@@ -22,20 +22,25 @@
 #ifndef SIMVIS_LOCAL_GRID_H
 #define SIMVIS_LOCAL_GRID_H
 
+#include <string>
 #include "osg/observer_ptr"
 #include "osg/ref_ptr"
 #include "simCore/Common/Common.h"
 #include "simData/DataTypes.h"
 #include "simVis/LocatorNode.h"
 
-namespace osg { class Geode; }
+namespace osg { class Geode; class MatrixTransform; }
 namespace osgText { class Text; }
 
 namespace simVis
 {
   class EntityNode;
 
-  /// Attachment node for a local coordinate grid display.
+  /**
+  * Attachment node for a local coordinate grid display.  Grid lines are shared between all local grids
+  * with the same type, color and divisions, and are sized with a scale transform.  Changes in speed or
+  * time rescale the speed ring lines and update the label text, without regenerating any geometry.
+  */
   class SDKVIS_EXPORT LocalGridNode : public simVis::LocatorNode
   {
   public:
@@ -88,14 +93,14 @@ namespace simVis
     /// update the locator settings
     void configureLocator_(const simData::LocalGridPrefs& prefs);
 
-    /// create Cartesian grid display
-    void createCartesian_(const simData::LocalGridPrefs& prefs, osg::Geode* geomGroup, osg::Geode* labelGroup) const;
+    /// show the shared grid lines for the prefs, scaled to the radius in meters; a radius of 0 hides the lines
+    void applyGraphics_(const simData::LocalGridPrefs& prefs, double sizeM);
 
-    /// create polar ring or range ring display
-    void createRangeRings_(const simData::LocalGridPrefs& prefs, osg::Geode* geomGroup, osg::Geode* labelGroup, bool includePolarRadials) const;
+    /// create Cartesian grid labels
+    void createCartesianLabels_(const simData::LocalGridPrefs& prefs, double sizeM, osg::Geode* labelGroup) const;
 
-    /// create speed ring or speed line display
-    void createSpeedRings_(const simData::LocalGridPrefs& prefs, osg::Geode* geomGroup, osg::Geode* labelGroup, bool drawSpeedLine) const;
+    /// create labels for the major rings of polar, range ring, speed ring or speed line displays
+    void createRingLabels_(const simData::LocalGridPrefs& prefs, osg::Geode* labelGroup, bool includeMinorAxisLabels) const;
 
     /// update the speed ring/line display for current data
     void updateSpeedRings_(const simData::LocalGridPrefs& prefs, double sizeM, double timeRadiusSeconds);
@@ -110,8 +115,12 @@ namespace simVis
     int processSpeedParams_(const simData::LocalGridPrefs& prefs, double& sizeM, double& timeRadiusSeconds);
 
   private: // data
-    osg::ref_ptr<osg::Geode> graphicsGroup_;
+    osg::ref_ptr<osg::MatrixTransform> graphicsTransform_;
     osg::ref_ptr<osg::Geode> labelGroup_;
+    /// parameters, other than size, of the shared grid lines under graphicsTransform_
+    std::string             graphicsParameters_;
+    /// size in meters at which the shared grid lines were generated
+    double                  graphicsSizeM_;
 
     simData::LocalGridPrefs lastPrefs_;
     bool                    forceRebuild_;
@@ -37,7 +37,8 @@ Locator::Locator(const osgEarth::SpatialReference* mapSRS) :
   ecefCoordIsSet_(false),
   offsetsAreSet_(false),
   timestamp_(std::numeric_limits<double>::max()),
-  eciRefTime_(0.0)
+  eciRefTime_(0.0),
+  matricesDirty_(true)
 {
   if (!mapSRS_.valid())
     osg::notify(osg::WARN) << "simVis::Locator: illegal, cannot create a Locator with a NULL map SRS." << std::endl;
@@ -51,7 +52,8 @@ Locator::Locator(Locator* parentLoc, unsigned int inheritMask) :
   ecefCoordIsSet_(false),
   offsetsAreSet_(false),
   timestamp_(std::numeric_limits<double>::max()),
-  eciRefTime_(0.0)
+  eciRefTime_(0.0),
+  matricesDirty_(true)
 {
   setParentLocator(parentLoc, inheritMask);
   ecefCoord_.setCoordinateSystem(simCore::COORD_SYS_ECEF);
@@ -62,6 +64,7 @@ void Locator::setMapSRS(const osgEarth::SpatialReference* mapSRS)
   if (mapSRS && mapSRS != mapSRS_.get())
   {
     mapSRS_ = mapSRS;
+    dirtyMatrices_();
     if (!isEmpty_)
       notifyListeners_();
   }
@@ -91,6 +94,7 @@ void Locator::setParentLocator(Locator* newParent, unsigned int inheritMask, boo
 
   parentLoc_ = newParent;
   componentsToInherit_ = inheritMask;
+  dirtyMatrices_();
 
   if (newParent)
   {
@@ -109,6 +113,7 @@ void Locator::setParentLocator(Locator* newParent, unsigned int inheritMask, boo
 void Locator::setComponentsToInherit(unsigned int value, bool notify)
 {
   componentsToInherit_ = value;
+  dirtyMatrices_();
 
   if (notify)
     notifyListeners_();
@@ -131,6 +136,7 @@ void Locator::setCoordinate(const simCore::Coordinate& coord, bool notify)
   isEmpty_ = false;
 
   ecefCoordIsSet_ = true;
+  dirtyMatrices_();
 
   if (notify)
     notifyListeners_();
@@ -159,6 +165,7 @@ void Locator::setCoordinate(const simCore::Coordinate& coord, double timestamp,
   isEmpty_ = false;
 
   ecefCoordIsSet_ = true;
+  dirtyMatrices_();
 
   if (notify)
     notifyListeners_();
@@ -179,6 +186,7 @@ void Locator::setLocalOffsets(const simCore::Vec3& pos, const simCore::Vec3& ori
   }
   else if (offsetsAreSet_)
     isEmpty_ = false;
+  dirtyMatrices_();
 
   if (notify)
     notifyListeners_();
@@ -257,7 +265,11 @@ void Locator::endUpdate()
 void Locator::setTime(double stamp, bool notify)
 {
   timestamp_ = stamp;
-  isEmpty_ = false;
+  if (isEmpty_)
+  {
+    isEmpty_ = false;
+    dirtyMatrices_();
+  }
 }
 
 bool Locator::setEciRefTime(double eciRefTime)
@@ -425,6 +437,17 @@ void Locator::applyLocalOffsets_(osg::Matrixd& output, unsigned int comps) const
 }
 
 bool Locator::getLocatorMatrix(osg::Matrixd& output, unsigned int comps) const
+{
+  if (!matricesDirty_ && locatorMatrices_.get(comps, output))
+    return true;
+
+  computeLocatorMatrix_(output, comps);
+  cleanMatrices_();
+  locatorMatrices_.set(comps, output);
+  return true;
+}
+
+void Locator::computeLocatorMatrix_(osg::Matrixd& output, unsigned int comps) const
 {
   osg::Vec3d pos;
   const bool posFound = getPosition_(pos, comps);
@@ -441,7 +464,6 @@ bool Locator::getLocatorMatrix(osg::Matrixd& output, unsigned int comps) const
   }
 
   applyOffsets_(output, comps);
-  return true;
 }
 
 bool Locator::getPosition_(osg::Vec3d& pos, unsigned int comps) const
@@ -477,11 +499,18 @@ bool Locator::getOrientation_(osg::Matrixd& rot, unsigned int comps) const
   }
   else if (ecefCoord_.hasOrientation())
   {
+    // Every inheriting locator asks for the same base orientation; compute it once per change
+    const unsigned int oriComps = comps & COMP_ORIENTATION;
+    if (!matricesDirty_ && orientations_.get(oriComps, rot))
+      return true;
+
     // find the base orientation, then apply offsets
     if ((comps & COMP_ORIENTATION) == COMP_ORIENTATION)
     {
       // easy, use all orientation components
       simVis::Math::ecefEulerToEnuRotMatrix(ecefCoord_.orientation(), rot);
+      cleanMatrices_();
+      orientations_.set(oriComps, rot);
       return true;
     }
     else
@@ -503,6 +532,8 @@ bool Locator::getOrientation_(osg::Matrixd& rot, unsigned int comps) const
       simCore::Coordinate ecef;
       conv.convert(lla, ecef, simCore::COORD_SYS_ECEF);
       simVis::Math::ecefEulerToEnuRotMatrix(ecef.orientation(), rot);
+      cleanMatrices_();
+      orientations_.set(oriComps, rot);
       return true;
     }
   }
@@ -541,10 +572,47 @@ void Locator::removeCallback(LocatorCallback* callback)
   }
 }
 
+void Locator::dirtyMatrices_()
+{
+  // A dirty locator's children are already dirty; see cleanMatrices_()
+  if (matricesDirty_)
+    return;
+  matricesDirty_ = true;
+  locatorMatrices_.clear();
+  orientations_.clear();
+
+  for (std::set< osg::observer_ptr<Locator> >::const_iterator i = children_.begin(); i != children_.end(); ++i)
+  {
+    Locator* child = i->get();
+    if (child)
+      child->dirtyMatrices_();
+  }
+}
+
+void Locator::cleanMatrices_() const
+{
+  // Stop at the first clean parent, since its own parents are clean too
+  for (const Locator* loc = this; loc != NULL && loc->matricesDirty_; loc = loc->parentLoc_.get())
+  {
+    loc->matricesDirty_ = false;
+    loc->locatorMatrices_.clear();
+    loc->orientations_.clear();
+  }
+}
+
 void Locator::notifyListeners_()
 {
   dirty();
+  notifyCallbacks_();
+}
 
+bool Locator::resolvesToOwnCoordinate_() const
+{
+  return ecefCoordIsSet_ && !isEmpty_ && !parentLoc_.valid() && !offsetsAreSet_ && componentsToInherit_ == COMP_ALL;
+}
+
+void Locator::notifyCallbacks_()
+{
   for (std::vector< osg::ref_ptr<LocatorCallback> >::iterator i = callbacks_.begin(); i != callbacks_.end();)
   {
     LocatorCallback* cb = i->get();
@@ -577,6 +645,42 @@ void Locator::notifyListeners_()
 
 //---------------------------------------------------------------------------
 
+Locator::MatrixCache::MatrixCache()
+  : size_(0),
+    next_(0)
+{
+}
+
+void Locator::MatrixCache::clear()
+{
+  size_ = 0;
+  next_ = 0;
+}
+
+bool Locator::MatrixCache::get(unsigned int comps, osg::Matrixd& matrix) const
+{
+  for (unsigned int k = 0; k < size_; ++k)
+  {
+    if (comps_[k] == comps)
+    {
+      matrix = matrices_[k];
+      return true;
+    }
+  }
+  return false;
+}
+
+void Locator::MatrixCache::set(unsigned int comps, const osg::Matrixd& matrix)
+{
+  comps_[next_] = comps;
+  matrices_[next_] = matrix;
+  next_ = (next_ + 1) % MAX_ENTRIES;
+  if (size_ < MAX_ENTRIES)
+    ++size_;
+}
+
+//---------------------------------------------------------------------------
+
 CachingLocator::CachingLocator(const osgEarth::SpatialReference* mapSRS)
   : Locator(mapSRS)
 {}
@@ -636,6 +740,38 @@ bool CachingLocator::getLocatorPositionOrientation(simCore::Vec3* out_position,
   return false;
 }
 
+void CachingLocator::setCoordinate(const simCore::Coordinate& coord, const simCore::Vec3& llaPosition, const simCore::Vec3& llaOrientation,
+  double timestamp, double eciRefTime)
+{
+  Locator::setCoordinate(coord, timestamp, eciRefTime, false);
+  // Bump the revision ahead of the callbacks, so that they see the seeded cache as current
+  dirty();
+  if (coord.coordinateSystem() == simCore::COORD_SYS_ECEF && coord.hasOrientation() && resolvesToOwnCoordinate_())
+  {
+    llaPositionCache_ = llaPosition;
+    llaOrientationCache_ = llaOrientation;
+    sync(llaPositionCacheRevision_);
+    sync(llaOrientationCacheRevision_);
+  }
+  notifyCallbacks_();
+}
+
+void CachingLocator::computeLlaPositionOrientation(const simCore::Coordinate& ecefCoord, simCore::Vec3& llaPosition, simCore::Vec3& llaOrientation)
+{
+  // Mirror Locator::getLocatorPositionOrientation(), including the round trip through the
+  // rotation matrix, so the results are identical to the ones computed on demand
+  osg::Matrixd rot;
+  simVis::Math::ecefEulerToEnuRotMatrix(ecefCoord.orientation(), rot);
+  simCore::Vec3 ecefOri;
+  simVis::Math::enuRotMatrixToEcefEuler(rot, ecefOri);
+
+  const simCore::Coordinate in(simCore::COORD_SYS_ECEF, ecefCoord.position(), ecefOri);
+  simCore::Coordinate out;
+  simCore::CoordinateConverter::convertEcefToGeodetic(in, out);
+  llaPosition = out.position();
+  llaOrientation = out.orientation();
+}
+
 //---------------------------------------------------------------------------
 
 ResolvedPositionOrientationLocator::ResolvedPositionOrientationLocator(const osgEarth::SpatialReference* mapSRS)
@@ -198,7 +198,8 @@ public:
 
   /**
   * Gets a positioning matrix that combines aggregate position, local orientation, and
-  * offset position.
+  * offset position.  Results are cached per components mask until this locator or one
+  * of its parents changes, so repeated queries within a frame do not walk the parent chain.
   */
   bool getLocatorMatrix(osg::Matrixd& output_mat, unsigned int components = COMP_ALL) const;
 
@@ -377,11 +378,57 @@ protected:
   */
   void applyLocalOffsets_(osg::Matrixd& output, unsigned int comps) const;
 
+  /**
+  * Invalidates cached matrices of this locator and all locators inheriting from it. Must be
+  * called by any change that affects the locator matrix, whether or not listeners are notified.
+  */
+  void dirtyMatrices_();
+
+  /**
+  * Returns true if the locator matrix is exactly the coordinate set on this locator, i.e. there is
+  * no parent, no local offset, and nothing is filtered by the inheritance mask
+  */
+  bool resolvesToOwnCoordinate_() const;
+
+  /** Calls the callbacks and notifies the children, without bumping the revision; see notifyListeners_() */
+  void notifyCallbacks_();
+
 private: // methods
   void notifyListeners_();
 
   bool inherits_(unsigned int mask) const;
 
+  /** Computes the locator matrix without consulting the matrix cache */
+  void computeLocatorMatrix_(osg::Matrixd& output, unsigned int comps) const;
+
+  /**
+  * Marks this locator and its dirty parents clean before a result is cached.  Parents are always
+  * cleaned with their children, so a dirty locator implies a dirty subtree, which lets
+  * dirtyMatrices_() stop at the first locator that is already dirty.
+  */
+  void cleanMatrices_() const;
+
+  /** Small most-recently-used cache of matrices keyed by components mask */
+  class MatrixCache
+  {
+  public:
+    MatrixCache();
+    /** Empties the cache */
+    void clear();
+    /** Returns true and fills in the output if comps is cached */
+    bool get(unsigned int comps, osg::Matrixd& matrix) const;
+    /** Adds an entry, replacing the least recently added one if full */
+    void set(unsigned int comps, const osg::Matrixd& matrix);
+
+  private:
+    /** Few distinct masks are requested of any one locator, typically COMP_ALL and one partial mask */
+    static const unsigned int MAX_ENTRIES = 3;
+    unsigned int comps_[MAX_ENTRIES];
+    osg::Matrixd matrices_[MAX_ENTRIES];
+    unsigned int size_;
+    unsigned int next_;
+  };
+
 private: // data
   osg::ref_ptr<const osgEarth::SpatialReference> mapSRS_;
   osg::ref_ptr<Locator> parentLoc_;
@@ -400,6 +447,13 @@ private: // data
 
   double timestamp_;
   double eciRefTime_;
+
+  /** True if cached results may be stale; see cleanMatrices_() */
+  mutable bool matricesDirty_;
+  /** Results of getLocatorMatrix() */
+  mutable MatrixCache locatorMatrices_;
+  /** Results of getOrientation_() from this locator's own coordinate, shared by all inheriting locators */
+  mutable MatrixCache orientations_;
 };
 
 /**
@@ -438,6 +492,31 @@ public:
   virtual bool getLocatorPositionOrientation(simCore::Vec3* out_position, simCore::Vec3* out_orientation,
     const simCore::CoordinateSystem& coordsys = simCore::COORD_SYS_ECEF) const;
 
+  using Locator::setCoordinate;
+
+  /**
+  * Sets the ECEF coordinate like setCoordinate(), and seeds the LLA cache with values computed ahead
+  * of time by computeLlaPositionOrientation(), sparing the conversion on the next request.  The seed
+  * is ignored if the locator has a parent, offsets, or an inheritance mask, since the LLA values then
+  * differ from the coordinate's.  Always notifies listeners.
+  * @param coord ECEF coordinate with orientation
+  * @param llaPosition LLA position computed from coord
+  * @param llaOrientation LLA orientation computed from coord
+  * @param timestamp Time of the coordinate
+  * @param eciRefTime ECI reference time
+  */
+  void setCoordinate(const simCore::Coordinate& coord, const simCore::Vec3& llaPosition, const simCore::Vec3& llaOrientation,
+    double timestamp, double eciRefTime);
+
+  /**
+  * Computes the LLA position and orientation that getLocatorPositionOrientation() returns for a
+  * locator whose matrix is the given ECEF coordinate.  Safe to call from any thread.
+  * @param ecefCoord ECEF coordinate with orientation
+  * @param llaPosition LLA position output
+  * @param llaOrientation LLA orientation output
+  */
+  static void computeLlaPositionOrientation(const simCore::Coordinate& ecefCoord, simCore::Vec3& llaPosition, simCore::Vec3& llaOrientation);
+
 private:
   // cache frequently used LLA position and orientation
   mutable simCore::Vec3 llaPositionCache_;
@@ -19,8 +19,11 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <cassert>
 #include <limits>
+#include <set>
+#include "osg/Geometry"
 #include "osg/LightModel"
 #include "osg/LOD"
 #include "osg/Node"
@@ -30,7 +33,11 @@
 #include "osg/ShadeModel"
 #include "osg/ShapeDrawable"
 #include "osg/TexEnv"
+#include "osg/Texture"
+#include "osg/Timer"
 #include "osg/ValueObject"
+#include "OpenThreads/Mutex"
+#include "OpenThreads/ScopedLock"
 #include "osgSim/DOFTransform"
 #include "osgSim/LightPointNode"
 #include "osgSim/MultiSwitch"
@@ -135,6 +142,81 @@ public:
 
 ////////////////////////////////////////////////////////////////////////////
 
+/** Visitor that sums the sizes of vertex data, primitive indices, and texture images; shared data is counted once */
+class ByteSizeVisitor : public osg::NodeVisitor
+{
+public:
+  ByteSizeVisitor()
+    : NodeVisitor(TRAVERSE_ALL_CHILDREN),
+      bytes_(0)
+  {
+  }
+
+  /** Returns the total bytes counted */
+  size_t bytes() const
+  {
+    return bytes_;
+  }
+
+  virtual void apply(osg::Node& node)
+  {
+    addStateSet_(node.getStateSet());
+    traverse(node);
+  }
+
+  virtual void apply(osg::Geometry& geom)
+  {
+    addStateSet_(geom.getStateSet());
+    addArray_(geom.getVertexArray());
+    addArray_(geom.getNormalArray());
+    addArray_(geom.getColorArray());
+    addArray_(geom.getSecondaryColorArray());
+    for (unsigned int k = 0; k < geom.getNumTexCoordArrays(); ++k)
+      addArray_(geom.getTexCoordArray(k));
+    for (unsigned int k = 0; k < geom.getNumVertexAttribArrays(); ++k)
+      addArray_(geom.getVertexAttribArray(k));
+    for (unsigned int k = 0; k < geom.getNumPrimitiveSets(); ++k)
+    {
+      const osg::PrimitiveSet* primSet = geom.getPrimitiveSet(k);
+      if (primSet && seen_.insert(primSet).second)
+        bytes_ += primSet->getTotalDataSize();
+    }
+  }
+
+private:
+  /** Counts the array if not already counted */
+  void addArray_(const osg::Array* array)
+  {
+    if (array && seen_.insert(array).second)
+      bytes_ += array->getTotalDataSize();
+  }
+
+  /** Counts the images of all textures in the state set */
+  void addStateSet_(const osg::StateSet* stateSet)
+  {
+    if (!stateSet || !seen_.insert(stateSet).second)
+      return;
+    const unsigned int numUnits = static_cast<unsigned int>(stateSet->getTextureAttributeList().size());
+    for (unsigned int unit = 0; unit < numUnits; ++unit)
+    {
+      const osg::Texture* texture = dynamic_cast<const osg::Texture*>(stateSet->getTextureAttribute(unit, osg::StateAttribute::TEXTURE));
+      if (!texture)
+        continue;
+      for (unsigned int k = 0; k < texture->getNumImages(); ++k)
+      {
+        const osg::Image* image = texture->getImage(k);
+        if (image && seen_.insert(image).second)
+          bytes_ += image->getTotalSizeInBytes();
+      }
+    }
+  }
+
+  size_t bytes_;
+  std::set<const osg::Referenced*> seen_;
+};
+
+////////////////////////////////////////////////////////////////////////////
+
 /** Options class that holds onto the Clock and SequenceTimeUpdater from the Model Cache. */
 class ModelCacheLoaderOptions : public osgDB::ReaderWriter::Options
 {
@@ -404,6 +486,10 @@ REGISTER_OSGPLUGIN(simvis_modelcache, ModelCacheLoader)
  * osg::ProxyNode relies on the cull traversal's database pager to load the model.  ProxyNode will
  * only traverse if it's in the scene.  Thus, this parent must be in the scene too, else the model
  * will never load.
+ *
+ * Requests for a URI that is already waiting or loading join the existing request.  Only a limited
+ * number of proxy nodes are active at once; the pager assigns all proxy nodes the same priority, so
+ * ordering is controlled here by starting the highest priority waiting URI whenever a load completes.
  */
 class ModelCache::LoaderNode : public osg::Group
 {
@@ -412,7 +498,8 @@ public:
 
   /** Initializes the Loader Node */
   LoaderNode()
-    : cache_(NULL)
+    : cache_(NULL),
+      maxActive_(4)
   {
   }
 
@@ -428,10 +515,24 @@ public:
     cache_ = cache;
   }
 
+  /** Changes the number of loads permitted at once */
+  void setMaxActive(unsigned int maxActive)
+  {
+    maxActive_ = std::max(1u, maxActive);
+    startLoads_();
+  }
+
+  /** Retrieves the number of loads permitted at once */
+  unsigned int maxActive() const
+  {
+    return maxActive_;
+  }
+
   /** Clears out all requests */
   void clear()
   {
     requests_.clear();
+    active_.clear();
     const unsigned int numChildren = getNumChildren();
     if (numChildren)
       removeChildren(0, numChildren);
@@ -451,33 +552,53 @@ public:
     // Create a new request record
     CallbackVector& callbacks = requests_[uri];
     callbacks.push_back(callback);
-    // Return early if there's already another active request
+    // Return early if there's already another request waiting or in progress
     if (callbacks.size() != 1)
+    {
+      if (cache_)
+        ++cache_->stats_.coalesced;
       return;
+    }
+    startLoads_();
+  }
 
-    // Set up an options struct for the pseudo loader
-    osg::ref_ptr<ModelCacheLoaderOptions> opts = new ModelCacheLoaderOptions;
-    opts->clock = cache_->clock_;
-    opts->addLodNode = cache_->addLodNode_;
-    opts->sequenceTimeUpdater = cache_->sequenceTimeUpdater_.get();
-    // Need to return something or proxy never succeeds and keeps issuing searches
-    opts->boxWhenNotFound = true;
-
-    // Create a proxy node to load the model
-    osg::ref_ptr<osg::ProxyNode> proxy = new osg::ProxyNode;
-    proxy->setFileName(0, uri + "." + MODEL_LOADER_EXT);
-    proxy->setDatabaseOptions(opts.get());
-    proxy->setUserValue("uri", uri);
-    // Culling needs to be off for the traverse() to hit
-    proxy->setCullingActive(false);
-    addChild(proxy);
+  /**
+   * Delivers a node for a URI that was loaded outside of the loader, e.g. synchronously.  Any waiting
+   * or in-progress request for the URI is completed with the node.
+   */
+  void fulfill(const std::string& uri, osg::Node* node)
+  {
+    if (requests_.find(uri) == requests_.end())
+      return;
+    if (active_.erase(uri) != 0)
+    {
+      for (unsigned int childIndex = 0; childIndex < getNumChildren(); ++childIndex)
+      {
+        std::string childUri;
+        if (getChild(childIndex)->getUserValue("uri", childUri) && childUri == uri)
+        {
+          removeChild(childIndex, 1);
+          break;
+        }
+      }
+    }
+    fireLoadFinished_(uri, node);
+    startLoads_();
   }
 
   virtual void traverse(osg::NodeVisitor& nv)
   {
+    // Remember the eye for prioritizing loads; cull may run in a different thread than the load requests
+    if (nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR)
+    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(eyeMutex_);
+      eye_ = nv.getEyePoint();
+    }
+
     osg::Group::traverse(nv);
 
     // Check for proxy node children with children -- they just finished loading.
+    bool completed = false;
     unsigned int childIndex = 0;
     while (childIndex < getNumChildren())
     {
@@ -503,6 +624,15 @@ public:
           assert(0);
         }
 
+        // Record the time from start of load to delivery
+        auto activeIter = active_.find(uri);
+        if (activeIter != active_.end())
+        {
+          if (cache_)
+            cache_->recordLoad_(osg::Timer::instance()->delta_s(activeIter->second, osg::Timer::instance()->tick()), true);
+          active_.erase(activeIter);
+        }
+
         // Run the shader generator on the newly loaded node (in main thread)
         osg::ref_ptr<osgEarth::StateSetCache> stateCache = new osgEarth::StateSetCache();
         osgEarth::Registry::shaderGenerator().run(loaded.get(), stateCache.get());
@@ -512,9 +642,15 @@ public:
 
         // Remove the proxy so it doesn't show up in the scene
         removeChild(childIndex, 1);
+        completed = true;
+        continue;
       }
       ++childIndex;
     }
+
+    // Start the next waiting loads; new proxies begin paging on the next traversal
+    if (completed)
+      startLoads_();
   }
 
   /** Return the proper library name */
@@ -523,6 +659,74 @@ public:
   virtual const char* className() const { return "ModelCache::LoaderNode"; }
 
 private:
+  /** Starts the highest priority waiting requests until the active limit is reached */
+  void startLoads_()
+  {
+    // Prioritize every pending request against the same snapshot of the eye
+    osg::Vec3d eye;
+    {
+      OpenThreads::ScopedLock<OpenThreads::Mutex> lock(eyeMutex_);
+      eye = eye_;
+    }
+    while (active_.size() < maxActive_ && active_.size() < requests_.size())
+    {
+      auto best = requests_.end();
+      double bestPriority = 0.0;
+      for (auto i = requests_.begin(); i != requests_.end(); ++i)
+      {
+        if (active_.find(i->first) != active_.end())
+          continue;
+        const double priority = priority_(i->second, eye);
+        if (best == requests_.end() || priority > bestPriority)
+        {
+          best = i;
+          bestPriority = priority;
+        }
+      }
+      if (best == requests_.end())
+        return;
+      startLoad_(best->first);
+    }
+  }
+
+  /** Returns the highest priority of all callbacks waiting on a request, relative to the given eye position */
+  double priority_(const CallbackVector& callbacks, const osg::Vec3d& eye) const
+  {
+    double rv = -std::numeric_limits<double>::max();
+    for (auto i = callbacks.begin(); i != callbacks.end(); ++i)
+    {
+      // NULL callbacks are preloads, and take the default priority
+      const double priority = (i->valid() ? (*i)->loadPriority(eye) : 0.0);
+      rv = std::max(rv, priority);
+    }
+    return rv;
+  }
+
+  /** Creates the proxy node that loads the URI */
+  void startLoad_(const std::string& uri)
+  {
+    // Set up an options struct for the pseudo loader
+    osg::ref_ptr<ModelCacheLoaderOptions> opts = new ModelCacheLoaderOptions;
+    if (cache_)
+    {
+      opts->clock = cache_->clock_;
+      opts->addLodNode = cache_->addLodNode_;
+      opts->sequenceTimeUpdater = cache_->sequenceTimeUpdater_.get();
+    }
+    // Need to return something or proxy never succeeds and keeps issuing searches
+    opts->boxWhenNotFound = true;
+
+    // Create a proxy node to load the model
+    osg::ref_ptr<osg::ProxyNode> proxy = new osg::ProxyNode;
+    proxy->setFileName(0, uri + "." + MODEL_LOADER_EXT);
+    proxy->setDatabaseOptions(opts.get());
+    proxy->setUserValue("uri", uri);
+    // Culling needs to be off for the traverse() to hit
+    proxy->setCullingActive(false);
+    addChild(proxy);
+    active_[uri] = osg::Timer::instance()->tick();
+  }
+
   /** Loading on a URI completed.  Alert everyone who cares. */
   void fireLoadFinished_(const std::string& uri, const osg::ref_ptr<osg::Node>& node)
   {
@@ -547,14 +751,18 @@ private:
     const bool isArticulated = ModelCache::isArticulated(node.get());
 
     // Respect the cache hint
-    if (cacheIt)
+    if (cacheIt && cache_)
       cache_->saveToCache_(uri, node.get(), isArticulated, isImage);
+    const bool shareArticulated = (cache_ && cache_->getShareArticulatedIconModels());
 
     // Pass the new node to everyone who is listening
     for (auto i = callbacks.begin(); i != callbacks.end(); ++i)
     {
+      // NULL callbacks are preloads that only want the model in the cache
+      if (!i->valid())
+        continue;
       // Articulated models need to clone
-      if (isArticulated && !cache_->getShareArticulatedIconModels())
+      if (isArticulated && !shareArticulated)
       {
         osg::ref_ptr<osg::Node> copy = osg::clone(node.get(), osg::CopyOp::DEEP_COPY_NODES);
         (*i)->loadFinished(copy, isImage, uri);
@@ -566,8 +774,16 @@ private:
 
   /** Pointer back to our parent cache */
   simVis::ModelCache* cache_;
-  /** Maps the URI to the vector of callbacks to use when the request is ready */
+  /** Maps the URI to the vector of callbacks to use when the request is ready; includes waiting and active requests */
   std::map<std::string, CallbackVector> requests_;
+  /** Maps the URI of each active request to its start time */
+  std::map<std::string, osg::Timer_t> active_;
+  /** Maximum number of active requests */
+  unsigned int maxActive_;
+  /** Eye position from the most recent cull traversal; protected by eyeMutex_ */
+  osg::Vec3d eye_;
+  /** Protects eye_, which is written during cull and read when starting loads */
+  OpenThreads::Mutex eyeMutex_;
 };
 
 ////////////////////////////////////////////////////////////////////////////
@@ -576,7 +792,9 @@ ModelCache::ModelCache()
   : shareArticulatedModels_(false),
     addLodNode_(true),
     clock_(NULL),
-    cache_(false, 30), // No need for thread safety, max of 30 elements
+    maxEntries_(30),
+    maxBytes_(256 * 1024 * 1024),
+    cachedBytes_(0),
     asyncLoader_(new LoaderNode)
 {
   asyncLoader_->setCache(this);
@@ -606,11 +824,11 @@ ModelCache::~ModelCache()
 osg::Node* ModelCache::getOrCreateIconModel(const std::string& uri, bool* pIsImage)
 {
   // first check the cache.
-  Cache::Record record;
-  if (cache_.get(uri, record))
+  const Entry* cached = find_(uri);
+  if (cached)
   {
-    assert(record.valid()); // Guaranteed by get()
-    const Entry& entry = record.value();
+    ++stats_.hits;
+    const Entry& entry = *cached;
     if (pIsImage)
       *pIsImage = entry.isImage_;
 
@@ -630,7 +848,10 @@ osg::Node* ModelCache::getOrCreateIconModel(const std::string& uri, bool* pIsIma
   opts->addLodNode = addLodNode_;
   opts->sequenceTimeUpdater = sequenceTimeUpdater_.get();
   // Farm off to the pseudo-loader
+  ++stats_.misses;
+  const osg::Timer_t startTick = osg::Timer::instance()->tick();
   osg::ref_ptr<osg::Node> result = osgDB::readRefNodeFile(uri + "." + MODEL_LOADER_EXT, opts.get());
+  recordLoad_(osg::Timer::instance()->delta_s(startTick, osg::Timer::instance()->tick()), false);
   if (!result)
     return NULL;
 
@@ -650,16 +871,66 @@ osg::Node* ModelCache::getOrCreateIconModel(const std::string& uri, bool* pIsIma
   if (cacheIt)
     saveToCache_(uri, result.get(), ModelCache::isArticulated(result.get()), isImage);
 
+  // Complete any asynchronous request for the same URI with this result instead of loading it twice
+  asyncLoader_->fulfill(uri, result.get());
+
   return result.release();
 }
 
 void ModelCache::saveToCache_(const std::string& uri, osg::Node* node, bool isArticulated, bool isImage)
 {
-  Entry newEntry;
+  // Refresh the entry if this node is already cached, e.g. from a synchronous load completing asynchronous requests
+  auto existing = cache_.find(uri);
+  if (existing != cache_.end() && existing->second.node_.get() == node)
+  {
+    find_(uri);
+    return;
+  }
+  // Replace any previous entry for the URI
+  erase(uri);
+
+  Entry& newEntry = cache_[uri];
   newEntry.node_ = node;
   newEntry.isImage_ = isImage;
   newEntry.isArticulated_ = isArticulated;
-  cache_.insert(uri, newEntry);
+  newEntry.bytes_ = estimateByteSize(node);
+  lru_.push_front(uri);
+  newEntry.lru_ = lru_.begin();
+  cachedBytes_ += newEntry.bytes_;
+  evict_();
+}
+
+const ModelCache::Entry* ModelCache::find_(const std::string& uri)
+{
+  auto i = cache_.find(uri);
+  if (i == cache_.end())
+    return NULL;
+  // Move to the front of the recency list
+  lru_.splice(lru_.begin(), lru_, i->second.lru_);
+  return &i->second;
+}
+
+void ModelCache::evict_()
+{
+  while (cache_.size() > 1 && (cache_.size() > maxEntries_ || cachedBytes_ > maxBytes_))
+  {
+    auto i = cache_.find(lru_.back());
+    assert(i != cache_.end());
+    cachedBytes_ -= i->second.bytes_;
+    cache_.erase(i);
+    lru_.pop_back();
+    ++stats_.evictions;
+  }
+}
+
+void ModelCache::recordLoad_(double seconds, bool async)
+{
+  if (async)
+    ++stats_.asyncLoads;
+  else
+    ++stats_.syncLoads;
+  stats_.totalLoadSeconds += seconds;
+  stats_.maxLoadSeconds = std::max(stats_.maxLoadSeconds, seconds);
 }
 
 void ModelCache::asyncLoad(const std::string& uri, ModelReadyCallback* callback)
@@ -674,29 +945,26 @@ void ModelCache::asyncLoad(const std::string& uri, ModelReadyCallback* callback)
   // Check that the async loader is going to work.  If it's not configured, then load synchronously.
   if (!threadSafe || !asyncLoader_->isConfigured())
   {
-    // Not configured: synchronous load
+    // Not configured: synchronous load, which has already run the shader generator
     bool isImage = false;
     osg::ref_ptr<osg::Node> node = getOrCreateIconModel(uri, &isImage);
-    // Run the shader generator on the newly loaded node (in main thread)
-    osg::ref_ptr<osgEarth::StateSetCache> stateCache = new osgEarth::StateSetCache();
-    osgEarth::Registry::shaderGenerator().run(node.get(), stateCache.get());
     if (refCallback.valid())
       refCallback->loadFinished(node, isImage, uri);
     return;
   }
 
   // first check the cache
-  Cache::Record record;
-  if (cache_.get(uri, record))
+  const Entry* cached = find_(uri);
+  if (cached)
   {
-    assert(record.valid()); // Guaranteed by get()
+    ++stats_.hits;
 
     // If the callback is valid, then pass the model back immediately.  It's possible the
     // callback might not be valid in cases where someone is attempting to preload icons
     // for the sake of performance.  In that case we just return early because it's loaded.
     if (refCallback.valid())
     {
-      const Entry& entry = record.value();
+      const Entry& entry = *cached;
       osg::ref_ptr<osg::Node> node = entry.node_.get();
       // clone articulated nodes so we get independent articulations
       if (entry.isArticulated_ && !shareArticulatedModels_)
@@ -708,6 +976,7 @@ void ModelCache::asyncLoad(const std::string& uri, ModelReadyCallback* callback)
   }
 
   // Queue up the request with the async loader
+  ++stats_.misses;
   asyncLoader_->addRequest(uri, callback);
 }
 
@@ -750,6 +1019,68 @@ void ModelCache::clear()
 {
   asyncLoader_->clear();
   cache_.clear();
+  lru_.clear();
+  cachedBytes_ = 0;
+}
+
+void ModelCache::setMaxCacheEntries(unsigned int maxEntries)
+{
+  maxEntries_ = maxEntries;
+  evict_();
+}
+
+unsigned int ModelCache::maxCacheEntries() const
+{
+  return maxEntries_;
+}
+
+void ModelCache::setMaxCacheBytes(size_t maxBytes)
+{
+  maxBytes_ = maxBytes;
+  evict_();
+}
+
+size_t ModelCache::maxCacheBytes() const
+{
+  return maxBytes_;
+}
+
+void ModelCache::setMaxConcurrentLoads(unsigned int maxLoads)
+{
+  asyncLoader_->setMaxActive(maxLoads);
+}
+
+unsigned int ModelCache::maxConcurrentLoads() const
+{
+  return asyncLoader_->maxActive();
+}
+
+ModelCache::Statistics ModelCache::statistics() const
+{
+  Statistics rv = stats_;
+  rv.cachedEntries = static_cast<unsigned int>(cache_.size());
+  rv.cachedBytes = cachedBytes_;
+  return rv;
+}
+
+void ModelCache::resetStatistics()
+{
+  stats_ = Statistics();
+}
+
+size_t ModelCache::estimateByteSize(osg::Node* node)
+{
+  if (!node)
+    return 0;
+  ByteSizeVisitor sizeVisitor;
+  node->accept(sizeVisitor);
+  return sizeVisitor.bytes();
+}
+
+double ModelCache::loadPriority(bool visible, double distance)
+{
+  // Visibility dominates, since the distance term is at most 1; a double keeps ECEF-scale distances distinct
+  return (visible ? 2.0 : 0.0) + 1.0 / (1.0 + std::max(0.0, distance));
 }
 
 bool ModelCache::isArticulated(osg::Node* node)
@@ -775,7 +1106,34 @@ osg::Node* ModelCache::boxNode() const
 
 void ModelCache::erase(const std::string& uri)
 {
-  cache_.erase(uri);
+  auto i = cache_.find(uri);
+  if (i == cache_.end())
+    return;
+  cachedBytes_ -= i->second.bytes_;
+  lru_.erase(i->second.lru_);
+  cache_.erase(i);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+ModelCache::Statistics::Statistics()
+  : hits(0),
+    misses(0),
+    coalesced(0),
+    syncLoads(0),
+    asyncLoads(0),
+    evictions(0),
+    totalLoadSeconds(0.0),
+    maxLoadSeconds(0.0),
+    cachedEntries(0),
+    cachedBytes(0)
+{
+}
+
+double ModelCache::Statistics::hitRate() const
+{
+  const unsigned int requests = hits + misses;
+  return (requests == 0) ? 0.0 : static_cast<double>(hits) / requests;
 }
 
 ////////////////////////////////////////////////////////////////////////////
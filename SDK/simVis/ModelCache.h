@@ -22,11 +22,12 @@
 #ifndef SIMVIS_MODELCACHE_H
 #define SIMVIS_MODELCACHE_H
 
+#include <list>
 #include <map>
 #include <string>
 #include "osg/observer_ptr"
 #include "osg/ref_ptr"
-#include "osgEarth/Containers"
+#include "osg/Vec3d"
 #include "simCore/Common/Export.h"
 
 namespace osg {
@@ -96,6 +97,66 @@ public:
   /** Erases a single element from the cache. */
   void erase(const std::string& uri);
 
+  /** Changes the maximum number of models in the cache.  Default: 30. */
+  void setMaxCacheEntries(unsigned int maxEntries);
+  /** Retrieves the maximum number of models in the cache. */
+  unsigned int maxCacheEntries() const;
+
+  /**
+   * Changes the maximum estimated size of the cached models, in bytes.  Least recently used models are
+   * evicted when either limit is exceeded.  A single model larger than the limit is still cached.
+   * Default: 256 MB.
+   */
+  void setMaxCacheBytes(size_t maxBytes);
+  /** Retrieves the maximum estimated size of the cached models, in bytes. */
+  size_t maxCacheBytes() const;
+
+  /**
+   * Changes the maximum number of asynchronous loads in progress at once.  Further requests wait, and
+   * the highest priority waiting request starts when a load completes.  Default: 4.
+   */
+  void setMaxConcurrentLoads(unsigned int maxLoads);
+  /** Retrieves the maximum number of asynchronous loads in progress at once. */
+  unsigned int maxConcurrentLoads() const;
+
+  /** Counters describing cache effectiveness and load times */
+  struct SDKVIS_EXPORT Statistics
+  {
+    Statistics();
+
+    /** Requests satisfied from the cache */
+    unsigned int hits;
+    /** Requests that required a load */
+    unsigned int misses;
+    /** Asynchronous requests that joined a load already in progress for the same URI */
+    unsigned int coalesced;
+    /** Models loaded synchronously */
+    unsigned int syncLoads;
+    /** Models loaded asynchronously */
+    unsigned int asyncLoads;
+    /** Models evicted to honor the entry or byte limits */
+    unsigned int evictions;
+    /** Total seconds spent in loads; asynchronous loads count from start to delivery */
+    double totalLoadSeconds;
+    /** Longest single load, in seconds */
+    double maxLoadSeconds;
+    /** Models currently in the cache */
+    unsigned int cachedEntries;
+    /** Estimated size of the models currently in the cache, in bytes */
+    size_t cachedBytes;
+
+    /** Fraction of requests satisfied from the cache, or 0 with no requests */
+    double hitRate() const;
+  };
+
+  /** Retrieves the current statistics */
+  Statistics statistics() const;
+  /** Resets the request and load counters; cache occupancy is unaffected */
+  void resetStatistics();
+
+  /** Estimates the memory used by a model's geometry and images, in bytes */
+  static size_t estimateByteSize(osg::Node* node);
+
   /**
    * Retrieves the asynchronous loader node.  This node must be added to the scene graph for
    * asynchronous loading to work correctly.  The Registry's default model cache is registered with
@@ -110,6 +171,15 @@ public:
   public:
     /** Called when the model is ready for display in the scene. */
     virtual void loadFinished(const osg::ref_ptr<osg::Node>& model, bool isImage, const std::string& uri) = 0;
+
+    /**
+     * Returns the priority of the load; waiting loads with the highest priority start first.  Called
+     * from the scene traversal whenever a load can start.  Default implementation returns 0.
+     * See ModelCache::loadPriority() for a helper based on visibility and distance.
+     * @param eye Most recent camera eye position, in world coordinates
+     */
+    virtual double loadPriority(const osg::Vec3d& eye) const { return 0.0; }
+
   protected:
     /** Protected destructor due to Referenced derived class. */
     virtual ~ModelReadyCallback() {}
@@ -125,6 +195,15 @@ public:
    */
   void asyncLoad(const std::string& uri, ModelReadyCallback* callback);
 
+  /**
+   * Helper to compute a load priority.  Visible models load before hidden ones, and nearer models
+   * load before farther ones.
+   * @param visible True if the model will be displayed when loaded
+   * @param distance Distance from the eye to the model, in meters
+   * @return Priority suitable for ModelReadyCallback::loadPriority()
+   */
+  static double loadPriority(bool visible, double distance);
+
   /** Helper method that returns true if an articulation node is present under the provided node. */
   static bool isArticulated(osg::Node* node);
 
@@ -136,6 +215,10 @@ private:
 
   /// Saves the given URI into the cache
   void saveToCache_(const std::string& uri, osg::Node* node, bool isArticulated, bool isImage);
+  /// Records the duration of a load, in seconds
+  void recordLoad_(double seconds, bool async);
+  /// Evicts least recently used entries until both limits are met; always keeps the newest entry
+  void evict_();
 
   /// Entry in the cache
   struct Entry
@@ -146,7 +229,13 @@ private:
     bool isArticulated_;
     /// Set true when node_ represents an image icon
     bool isImage_;
+    /// Estimated size of node_ in bytes
+    size_t bytes_;
+    /// Position in the recency list
+    std::list<std::string>::iterator lru_;
   };
+  /// Returns the cached entry for the URI and marks it most recently used, or NULL if not cached
+  const Entry* find_(const std::string& uri);
   /// osg::Node that is responsible for loading nodes in the background using osg::ProxyNode
   class LoaderNode;
 
@@ -159,10 +248,18 @@ private:
   /// Sequence updater is associated with nodes with osg::Sequence, to fix backwards time problems.  See simVis::Registry::sequenceTimeUpdater_
   osg::observer_ptr<SequenceTimeUpdater> sequenceTimeUpdater_;
 
-  /// Typedef for Cache class instance
-  typedef osgEarth::LRUCache<std::string, Entry> Cache;
   /// Maps string name to cache entry
-  Cache cache_;
+  std::map<std::string, Entry> cache_;
+  /// URIs in the cache, most recently used first
+  std::list<std::string> lru_;
+  /// Maximum number of entries in the cache
+  unsigned int maxEntries_;
+  /// Maximum estimated size of the cache in bytes
+  size_t maxBytes_;
+  /// Statistics; occupancy fields are filled on request
+  Statistics stats_;
+  /// Estimated size of the cache in bytes
+  size_t cachedBytes_;
 
   /// Node that is used for when platforms do not exist as a placeholder object
   osg::ref_ptr<osg::Node> boxNode_;
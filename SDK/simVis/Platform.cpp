@@ -29,6 +29,7 @@
 #include "simVis/AxisVector.h"
 #include "simVis/EntityLabel.h"
 #include "simVis/EphemerisVector.h"
+#include "simVis/LabelContentCache.h"
 #include "simVis/LabelContentManager.h"
 #include "simVis/LocalGrid.h"
 #include "simVis/Locator.h"
@@ -176,6 +177,7 @@ lastPrefsValid_(false),
 forceUpdateFromDataStore_(false),
 queuedInvalidate_(false)
 {
+  prepared_.valid = false;
   model_ = new PlatformModelNode(new Locator(locator));
   addChild(model_);
   model_->addCallback(new BoundsUpdater(this));
@@ -240,6 +242,8 @@ void PlatformNode::setRcsPrefs_(const simData::PlatformPrefs& prefs)
 
 void PlatformNode::setPrefs(const simData::PlatformPrefs& prefs)
 {
+  // Label content might depend on any pref
+  labelContentCache().invalidate();
   const bool prefsDraw = prefs.commonprefs().datadraw() && prefs.commonprefs().draw();
   // if the platform is valid, update if this platform should be drawn
   if (valid_)
@@ -379,7 +383,13 @@ void PlatformNode::updateLocator_(const simData::PlatformUpdate& u)
         simCore::Vec3(u.psi(), u.theta(), u.phi()),
         simCore::Vec3(u.vx(), u.vy(), u.vz()));
 
-  getLocator()->setCoordinate(coord, u.time(), lastProps_.coordinateframe().ecireferencetime());
+  // use the LLA values from prepareUpdateFromDataStore() if they match the (possibly filtered) update
+  CachingLocator* cachingLocator = dynamic_cast<CachingLocator*>(getLocator());
+  if (cachingLocator && prepared_.valid && prepared_.ecefPosition == coord.position() && prepared_.ecefOrientation == coord.orientation())
+    cachingLocator->setCoordinate(coord, prepared_.llaPosition, prepared_.llaOrientation, u.time(), lastProps_.coordinateframe().ecireferencetime());
+  else
+    getLocator()->setCoordinate(coord, u.time(), lastProps_.coordinateframe().ecireferencetime());
+  prepared_.valid = false;
 
   if (lastPrefsValid_)
   {
@@ -397,6 +407,28 @@ simData::ObjectId PlatformNode::getId() const
   return lastProps_.id();
 }
 
+void PlatformNode::prepareUpdateFromDataStore(const simData::DataSliceBase* updateSliceBase, bool force)
+{
+  prepared_.valid = false;
+  const simData::PlatformUpdateSlice* updateSlice = static_cast<const simData::PlatformUpdateSlice*>(updateSliceBase);
+  if (!updateSlice || (!updateSlice->hasChanged() && !force && !forceUpdateFromDataStore_))
+    return;
+  const simData::PlatformUpdate* current = updateSlice->current();
+  if (!current)
+    return;
+
+  prepared_.ecefPosition.set(current->x(), current->y(), current->z());
+  prepared_.ecefOrientation.set(current->psi(), current->theta(), current->phi());
+  CachingLocator::computeLlaPositionOrientation(simCore::Coordinate(simCore::COORD_SYS_ECEF, prepared_.ecefPosition, prepared_.ecefOrientation),
+    prepared_.llaPosition, prepared_.llaOrientation);
+  prepared_.valid = true;
+}
+
+bool PlatformNode::isUpdateForced() const
+{
+  return forceUpdateFromDataStore_;
+}
+
 bool PlatformNode::updateFromDataStore(const simData::DataSliceBase* updateSliceBase, bool force)
 {
   // if assert fails, check whether prefs are initialized correctly when platform is created
@@ -632,7 +664,7 @@ void PlatformNode::updateLabel_(const simData::PlatformPrefs& prefs)
 
   std::string text;
   if (prefs.commonprefs().labelprefs().draw())
-    text = labelContentCallback().createString(prefs, lastUpdate_, prefs.commonprefs().labelprefs().displayfields());
+    text = labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_LABEL, prefs, lastUpdate_, prefs.commonprefs().labelprefs().displayfields());
 
   if (!text.empty())
   {
@@ -661,7 +693,7 @@ std::string PlatformNode::popupText() const
         prefix = getEntityName(EntityNode::ALIAS_NAME);
       prefix += "\n";
     }
-    return prefix + labelContentCallback().createString(lastPrefs_, lastUpdate_, lastPrefs_.commonprefs().labelprefs().hoverdisplayfields());
+    return prefix + labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_HOVER, lastPrefs_, lastUpdate_, lastPrefs_.commonprefs().labelprefs().hoverdisplayfields());
   }
 
   return "";
@@ -673,7 +705,7 @@ std::string PlatformNode::hookText() const
   {
     // a valid_ platform should never have an update that does not have a time
     assert(lastUpdate_.has_time());
-    return labelContentCallback().createString(lastPrefs_, lastUpdate_, lastPrefs_.commonprefs().labelprefs().hookdisplayfields());
+    return labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_HOOK, lastPrefs_, lastUpdate_, lastPrefs_.commonprefs().labelprefs().hookdisplayfields());
   }
 
   return "";
@@ -685,7 +717,7 @@ std::string PlatformNode::legendText() const
   {
     // a valid_ platform should never have an update that does not have a time
     assert(lastUpdate_.has_time());
-    return labelContentCallback().createString(lastPrefs_, lastUpdate_, lastPrefs_.commonprefs().labelprefs().legenddisplayfields());
+    return labelContentCache().createString(labelContentCallback(), LabelContentCache::SLOT_LEGEND, lastPrefs_, lastUpdate_, lastPrefs_.commonprefs().labelprefs().legenddisplayfields());
   }
 
   return "";
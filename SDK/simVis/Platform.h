@@ -24,6 +24,7 @@
 
 #include "osg/ref_ptr"
 #include "simCore/Calc/CoordinateSystem.h"
+#include "simCore/Calc/Vec3.h"
 #include "simCore/EM/RadarCrossSection.h"
 #include "simData/DataTypes.h"
 #include "simVis/Constants.h"
@@ -176,6 +177,20 @@ public: // EntityNode interface
   */
   virtual bool updateFromDataStore(const simData::DataSliceBase* updateSlice, bool force = false);
 
+  /**
+  * Converts the current update slice position to LLA ahead of updateFromDataStore(); thread safe
+  * with respect to other entities.
+  * @param updateSlice  Data store update slice (could be NULL)
+  * @param force true if the update will be forced
+  */
+  virtual void prepareUpdateFromDataStore(const simData::DataSliceBase* updateSlice, bool force);
+
+  /**
+  * Returns true if a preference change requires the platform to update even though its update slice has not changed.
+  * override from EntityNode.
+  */
+  virtual bool isUpdateForced() const;
+
   /**
   * Notifies the platform of a clock mode update.
   * override from EntityNode.
@@ -317,6 +332,17 @@ private:
   bool                            forceUpdateFromDataStore_;
   /// queue up the invalidate to apply on the next data store update
   bool                            queuedInvalidate_;
+
+  /// LLA values computed by prepareUpdateFromDataStore() for the ECEF position and orientation they came from
+  struct PreparedLocation
+  {
+    bool valid;
+    simCore::Vec3 ecefPosition;
+    simCore::Vec3 ecefOrientation;
+    simCore::Vec3 llaPosition;
+    simCore::Vec3 llaOrientation;
+  };
+  PreparedLocation                prepared_;
 };
 
 } // namespace simVis
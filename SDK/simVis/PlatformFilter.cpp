@@ -51,10 +51,27 @@ public:
 
   virtual PlatformTspiFilterManager::FilterResponse filter(simCore::Coordinate& llaCoord, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props)
   {
-    PlatformTspiFilterManager::FilterResponse modified = PlatformTspiFilterManager::POINT_UNCHANGED;
+    if (!prefs.useclampalt())
+      return PlatformTspiFilterManager::POINT_UNCHANGED;
+    return clamp_(llaCoord, prefs);
+  }
 
+  virtual void filterBatch(simCore::Coordinate* llaCoords, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformTspiFilterManager::FilterResponse* responses)
+  {
     if (!prefs.useclampalt())
-      return modified;
+      return;
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (responses[k] != PlatformTspiFilterManager::POINT_DROPPED && clamp_(llaCoords[k], prefs) == PlatformTspiFilterManager::POINT_CHANGED)
+        responses[k] = PlatformTspiFilterManager::POINT_CHANGED;
+    }
+  }
+
+private:
+  /// Clamps the altitude to the min/max prefs
+  PlatformTspiFilterManager::FilterResponse clamp_(simCore::Coordinate& llaCoord, const simData::PlatformPrefs& prefs) const
+  {
+    PlatformTspiFilterManager::FilterResponse modified = PlatformTspiFilterManager::POINT_UNCHANGED;
 
     if (prefs.clampvalaltmax() < llaCoord.alt())
     {
@@ -93,6 +110,22 @@ public:
   }
 
   virtual PlatformTspiFilterManager::FilterResponse filter(simCore::Coordinate& llaCoord, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props)
+  {
+    return clamp_(llaCoord, prefs);
+  }
+
+  virtual void filterBatch(simCore::Coordinate* llaCoords, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformTspiFilterManager::FilterResponse* responses)
+  {
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (responses[k] != PlatformTspiFilterManager::POINT_DROPPED && clamp_(llaCoords[k], prefs) == PlatformTspiFilterManager::POINT_CHANGED)
+        responses[k] = PlatformTspiFilterManager::POINT_CHANGED;
+    }
+  }
+
+private:
+  /// Clamps the orientation to the prefs values
+  PlatformTspiFilterManager::FilterResponse clamp_(simCore::Coordinate& llaCoord, const simData::PlatformPrefs& prefs) const
   {
     bool autoClamp = false;
     if (prefs.clamporientationatlowvelocity())
@@ -158,6 +191,21 @@ void PlatformTspiFilterManager::removeFilter(PlatformTspiFilter* filter)
 }
 
 PlatformTspiFilterManager::FilterResponse PlatformTspiFilterManager::filter(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props)
+{
+  // A single update is a batch of one
+  PlatformTspiFilterManager::FilterResponse modified = PlatformTspiFilterManager::POINT_UNCHANGED;
+  filter_(&update, 1, prefs, props, &modified);
+  return modified;
+}
+
+void PlatformTspiFilterManager::filter(std::vector<simData::PlatformUpdate>& updates, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, std::vector<FilterResponse>& responses)
+{
+  responses.assign(updates.size(), PlatformTspiFilterManager::POINT_UNCHANGED);
+  if (!updates.empty())
+    filter_(&updates[0], updates.size(), prefs, props, &responses[0]);
+}
+
+void PlatformTspiFilterManager::filter_(simData::PlatformUpdate* updates, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, FilterResponse* responses)
 {
   // See if a filter possibly applies before converting from ECEF to LLA
   std::vector<PlatformTspiFilter*> possibleFilters;
@@ -169,32 +217,25 @@ PlatformTspiFilterManager::FilterResponse PlatformTspiFilterManager::filter(simD
 
   // No filter wants to look at the data
   if (possibleFilters.empty())
-  {
-    return PlatformTspiFilterManager::POINT_UNCHANGED;
-  }
+    return;
 
-  simCore::Coordinate ecefCoord(toCoordinate_(update));
-  simCore::Coordinate llaCoord;
-  simCore::CoordinateConverter::convertEcefToGeodetic(ecefCoord, llaCoord);
+  std::vector<simCore::Coordinate> llaCoords(count);
+  for (size_t k = 0; k < count; ++k)
+    simCore::CoordinateConverter::convertEcefToGeodetic(toCoordinate_(updates[k]), llaCoords[k]);
 
-  PlatformTspiFilterManager::FilterResponse modified = PlatformTspiFilterManager::POINT_UNCHANGED;
-  for (std::vector<PlatformTspiFilter*>::const_iterator it = platformFilters_.begin(); it != platformFilters_.end(); ++it)
-  {
-    PlatformTspiFilterManager::FilterResponse rv = (*it)->filter(llaCoord, prefs, props);
-    if (rv == PlatformTspiFilterManager::POINT_DROPPED)
-      return rv;
-
-    if (rv == PlatformTspiFilterManager::POINT_CHANGED)
-      modified = rv;
-  }
+  // Each filter sees the whole batch, including the modifications of previous filters
+  for (std::vector<PlatformTspiFilter*>::const_iterator it = possibleFilters.begin(); it != possibleFilters.end(); ++it)
+    (*it)->filterBatch(&llaCoords[0], count, prefs, props, responses);
 
-  if (modified == PlatformTspiFilterManager::POINT_CHANGED)
+  simCore::Coordinate ecefCoord;
+  for (size_t k = 0; k < count; ++k)
   {
-    simCore::CoordinateConverter::convertGeodeticToEcef(llaCoord, ecefCoord);
-    toPlatformUpdate_(ecefCoord, update);
+    if (responses[k] == PlatformTspiFilterManager::POINT_CHANGED)
+    {
+      simCore::CoordinateConverter::convertGeodeticToEcef(llaCoords[k], ecefCoord);
+      toPlatformUpdate_(ecefCoord, updates[k]);
+    }
   }
-
-  return modified;
 }
 
 simCore::Coordinate PlatformTspiFilterManager::toCoordinate_(const simData::PlatformUpdate& update) const
@@ -220,6 +261,20 @@ void PlatformTspiFilterManager::toPlatformUpdate_(const simCore::Coordinate& coo
 }
 
 
+//-----------------------------------------------------------------------------------------------------------------------------
+
+void PlatformTspiFilter::filterBatch(simCore::Coordinate* llaCoords, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformTspiFilterManager::FilterResponse* responses)
+{
+  for (size_t k = 0; k < count; ++k)
+  {
+    if (responses[k] == PlatformTspiFilterManager::POINT_DROPPED)
+      continue;
+    const PlatformTspiFilterManager::FilterResponse rv = filter(llaCoords[k], prefs, props);
+    if (rv != PlatformTspiFilterManager::POINT_UNCHANGED)
+      responses[k] = rv;
+  }
+}
+
 }
 
 
@@ -23,6 +23,7 @@
 #ifndef SIMVIS_MEMORYDATASTORE_PLATFORMFILTER_H
 #define SIMVIS_MEMORYDATASTORE_PLATFORMFILTER_H
 
+#include <vector>
 #include "simData/DataTypes.h"
 #include "simData/ObjectId.h"
 
@@ -38,6 +39,9 @@ class PlatformTspiFilter;
  * processing stops and POINT_DROPPED is returned.  A filter sees the modifications to update of any previous filters.
  *
  * Filters are used to implement features like Altitude Clamping.  See AltitudeMinMaxClamping as an example.
+ *
+ * Updates may also be filtered in batches that share prefs and properties, such as a track history backfill.
+ * Each filter then sees the whole batch at once, and filtering a single update is a batch of one.
  */
 class PlatformTspiFilterManager
 {
@@ -63,7 +67,19 @@ public:
   /// Filters the given platform state
   virtual FilterResponse filter(simData::PlatformUpdate& update, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props);
 
+  /**
+   * Filters a batch of platform states of a single platform
+   * @param updates Platform states to filter in place
+   * @param prefs Prefs of the platform
+   * @param props Properties of the platform
+   * @param responses Filled with the response for each update
+   */
+  virtual void filter(std::vector<simData::PlatformUpdate>& updates, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, std::vector<FilterResponse>& responses);
+
 private:
+  /// Filters the count platform states in updates, writing their responses; responses must be initialized to POINT_UNCHANGED
+  void filter_(simData::PlatformUpdate* updates, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, FilterResponse* responses);
+
   /// Returns simCore::Coordinate based off of update
   simCore::Coordinate toCoordinate_(const simData::PlatformUpdate& update) const;
 
@@ -86,6 +102,19 @@ public:
 
   /// Filters the given platform state
   virtual PlatformTspiFilterManager::FilterResponse filter(simCore::Coordinate& llaCoord, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props) = 0;
+
+  /**
+   * Filters an array of platform states that share prefs and properties.  Entries already at POINT_DROPPED
+   * are ignored by the caller, and a filter may skip them.  A filter only changes a response when it changes
+   * or drops the entry.  The default implementation calls filter() on each entry; override to process the
+   * whole array at once.
+   * @param llaCoords Array of count LLA coordinates to filter in place
+   * @param count Number of coordinates
+   * @param prefs Prefs of the platform
+   * @param props Properties of the platform
+   * @param responses Array of count responses to update
+   */
+  virtual void filterBatch(simCore::Coordinate* llaCoords, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformTspiFilterManager::FilterResponse* responses);
 };
 
 }
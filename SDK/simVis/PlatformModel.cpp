@@ -19,6 +19,7 @@
  * disclose, or release this software.
  *
  */
+#include <limits>
 #include "osg/AutoTransform"
 #include "osg/ComputeBoundsVisitor"
 #include "osg/CullFace"
@@ -85,6 +86,19 @@ public:
       refPlatform->setModel(model.get(), isImage);
   }
 
+  /** Loads visible platforms near the eye first */
+  virtual double loadPriority(const osg::Vec3d& eye) const
+  {
+    osg::ref_ptr<PlatformModelNode> refPlatform;
+    if (!platform_.lock(refPlatform) || ignoreResult_)
+      return -1.0;
+    simCore::Vec3 ecef;
+    if (refPlatform->getPosition(&ecef) != 0)
+      return ModelCache::loadPriority(false, std::numeric_limits<double>::max());
+    const bool visible = (refPlatform->getNodeMask() != 0 && refPlatform->getNumParents() > 0 && refPlatform->getParent(0)->getNodeMask() != 0);
+    return ModelCache::loadPriority(visible, (osg::Vec3d(ecef.x(), ecef.y(), ecef.z()) - eye).length());
+  }
+
   void ignoreResult()
   {
     ignoreResult_ = true;
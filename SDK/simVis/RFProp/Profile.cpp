@@ -19,7 +19,11 @@
  * disclose, or release this software.
  *
  */
+#include <utility>
+#include <vector>
+#include "OpenThreads/ScopedLock"
 #include "osg/MatrixTransform"
+#include "osg/OperationThread"
 #include "osg/Texture2D"
 #include "osgEarth/ImageUtils"
 #include "osgEarth/NodeUtils"
@@ -29,25 +33,266 @@
 #include "simVis/Constants.h"
 #include "simVis/PointSize.h"
 #include "simVis/Utils.h"
+#include "simVis/WorkerPool.h"
 #include "simVis/RFProp/Profile.h"
 
 using namespace simRF;
 using namespace simCore;
 
+namespace
+{
+
+/** Profiles closer than this many bounding radii from the eye are drawn at full resolution */
+static const double LOD_DISTANCE_FACTOR = 4.0;
+/** Largest sample stride applied by the level of detail */
+static const unsigned int MAX_LOD_STRIDE = 8;
+
+/** Returns the indices from first to last inclusive, stepping by stride; last is always included */
+std::vector<unsigned int> sampleIndices(unsigned int first, unsigned int last, unsigned int stride)
+{
+  std::vector<unsigned int> indices;
+  if (last < first)
+    return indices;
+  stride = simCore::sdkMax(1u, stride);
+  indices.reserve((last - first) / stride + 2);
+  for (unsigned int i = first; i < last; i += stride)
+    indices.push_back(i);
+  indices.push_back(last);
+  return indices;
+}
+
+}
+
+/**
+ * Generates the geometry for a Profile from a snapshot of its settings.  The snapshot copies the data
+ * provider so that changes to the Profile, such as changing the active threshold type, do not affect
+ * a build in progress.  Member names mirror those in Profile so that generation code reads the same.
+ */
+class Profile::GeometryBuilder : public osg::Operation
+{
+public:
+  /** Snapshots the settings of the profile */
+  GeometryBuilder(const Profile& profile, unsigned int generation, unsigned int lodStride)
+    : osg::Operation("simRF::Profile::GeometryBuilder", false),
+      generation_(generation),
+      lodStride_(lodStride),
+      done_(false),
+      displayThickness_(profile.displayThickness_),
+      height_(profile.height_),
+      halfBeamWidth_(profile.halfBeamWidth_),
+      terrainHeights_(profile.terrainHeights_),
+      data_(profile.data_.valid() ? new CompositeProfileProvider(*profile.data_) : NULL),
+      agl_(profile.agl_),
+      mode_(profile.mode_),
+      refCoord_(profile.refCoord_),
+      sphericalEarth_(profile.sphericalEarth_),
+      elevAngle_(profile.elevAngle_),
+      texture_(profile.texture_),
+      numRanges_(0),
+      minRange_(0.),
+      rangeStep_(0.),
+      numHeights_(0),
+      minHeight_(0.),
+      heightStep_(0.)
+  {
+    if (data_.valid())
+    {
+      numRanges_ = data_->getNumRanges();
+      minRange_ = data_->getMinRange();
+      rangeStep_ = data_->getRangeStep();
+      numHeights_ = data_->getNumHeights();
+      minHeight_ = data_->getMinHeight();
+      heightStep_ = data_->getHeightStep();
+    }
+  }
+
+  /** Runs on the worker thread */
+  virtual void operator()(osg::Object*)
+  {
+    build();
+  }
+
+  /** Generates the geometry; may be called from any thread */
+  void build()
+  {
+    verts_ = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
+    values_ = new osg::FloatArray(osg::Array::BIND_PER_VERTEX);
+    values_->setNormalize(false);
+    valueIndices_.clear();
+    geode_ = NULL;
+
+    // ensure that our provider is valid
+    if (data_.valid() && data_->getActiveProvider() != NULL)
+    {
+      geode_ = new osg::Geode;
+      switch (mode_)
+      {
+        case DRAWMODE_2D_HORIZONTAL:
+          init2DHoriz_();
+          break;
+        case DRAWMODE_2D_VERTICAL:
+          init2DVert_();
+          break;
+        case DRAWMODE_2D_TEE:
+          init2DHoriz_();
+          init2DVert_();
+          break;
+        case DRAWMODE_3D:
+          init3D_();
+          break;
+        case DRAWMODE_3D_TEXTURE:
+          init3DTexture_();
+          break;
+        case DRAWMODE_3D_POINTS:
+          init3DPoints_();
+          break;
+        case DRAWMODE_RAE:
+          initRAE_();
+          break;
+        default:
+          // if assert fails, a new type has been added, but this switch has not been updated
+          assert(0);
+      }
+    }
+
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(doneMutex_);
+    done_ = true;
+  }
+
+  /** Returns true once build() has completed */
+  bool isDone() const
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(doneMutex_);
+    return done_;
+  }
+
+  /** Returns true if the range and height samples of the provider match the ones used to generate the geometry */
+  bool matchesGrid(const CompositeProfileProvider& data) const
+  {
+    return data.getNumRanges() == numRanges_ && data.getMinRange() == minRange_ && data.getRangeStep() == rangeStep_ &&
+      data.getNumHeights() == numHeights_ && data.getMinHeight() == minHeight_ && data.getHeightStep() == heightStep_;
+  }
 
+  /** Creates an image representing the loss values */
+  static osg::Image* createImage(const CompositeProfileProvider& data)
+  {
+    assert(data.getActiveProvider() != NULL);
+    const unsigned int numRanges = data.getNumRanges();
+    const unsigned int numHeights = data.getNumHeights();
+
+    osg::Image* image = new osg::Image();
+    image->allocateImage(numRanges, numHeights, 1, GL_LUMINANCE, GL_FLOAT);
+    image->setInternalTextureFormat(GL_LUMINANCE32F_ARB);
+
+    for (unsigned int r = 0; r < numRanges; r++)
+    {
+      for (unsigned int h = 0; h < numHeights; h++)
+      {
+        const double value = data.getValueByIndex(h, r);
+        *(float*)image->data(r, h) = (float)value;
+      }
+    }
+    return image;
+  }
+
+  /** Identifies the request that created this builder */
+  unsigned int generation() const { return generation_; }
+  /** Draw mode of the generated geometry */
+  DrawMode mode() const { return mode_; }
+  /** Sample stride of the generated geometry */
+  unsigned int lodStride() const { return lodStride_; }
+  /** Generated vertices */
+  osg::Vec3Array* verts() const { return verts_.get(); }
+  /** Generated loss values */
+  osg::FloatArray* values() const { return values_.get(); }
+  /** Generated geode; NULL if the provider was not valid */
+  osg::Geode* geode() const { return geode_.get(); }
+  /** Texture used by DRAWMODE_3D_TEXTURE */
+  osg::Texture* texture() const { return texture_.get(); }
+  /** Height and range index of the sample for each entry in values() */
+  const std::vector<std::pair<unsigned int, unsigned int> >& valueIndices() const { return valueIndices_; }
+
+protected:
+  /// osg::Referenced-derived
+  virtual ~GeometryBuilder() {}
+
+private:
+  /** Initializes as a 2D horizontal */
+  void init2DHoriz_();
+  /** Initializes as a 2D Vertical */
+  void init2DVert_();
+  /** Initializes as a 3D */
+  void init3D_();
+  /** Initializes as a 3D texture */
+  void init3DTexture_();
+  /** Initializes as a 3D points */
+  void init3DPoints_();
+  /** Initializes as RAE */
+  void initRAE_();
+
+  /** Creates a voxel (volume pixel) at the given location, spanning rangeSpan range samples */
+  void buildVoxel_(const double* lla, const simCore::Vec3* tpSphereXYZ, unsigned int heightIndex, unsigned int rangeIndex, unsigned int rangeSpan, osg::Geometry* geometry);
+  /** Tesselate the 2D Vertical with triangle strips */
+  void tesselate2DVert_(unsigned int numRanges, unsigned int numHeights, unsigned int startIndex, osg::Geometry* geometry);
+  /** Adjusts based on spherical XYZ */
+  void adjustSpherical_(osg::Vec3& v, const double *lla, const simCore::Vec3 *tpSphereXYZ) const;
+  /** Retrieves the profile height at the given ground range in meters */
+  float getTerrainHgt_(float gndRng) const;
+  /** Appends the value of the given sample, recording its indices for later recoloring */
+  void pushValue_(unsigned int heightIndex, unsigned int rangeIndex);
+
+  unsigned int generation_;
+  unsigned int lodStride_;
+  mutable OpenThreads::Mutex doneMutex_;
+  bool done_;
+
+  float displayThickness_;
+  double height_;
+  double halfBeamWidth_;
+  std::map<float, float> terrainHeights_;
+  osg::ref_ptr<CompositeProfileProvider> data_;
+  bool agl_;
+  DrawMode mode_;
+  osg::Vec3d refCoord_;
+  bool sphericalEarth_;
+  double elevAngle_;
+  osg::ref_ptr<osg::Texture> texture_;
+
+  unsigned int numRanges_;
+  double minRange_;
+  double rangeStep_;
+  unsigned int numHeights_;
+  double minHeight_;
+  double heightStep_;
+
+  osg::ref_ptr<osg::Vec3Array> verts_;
+  osg::ref_ptr<osg::FloatArray> values_;
+  osg::ref_ptr<osg::Geode> geode_;
+  std::vector<std::pair<unsigned int, unsigned int> > valueIndices_;
+};
+
+//----------------------------------------------------------------------------
 Profile::Profile(CompositeProfileProvider* data)
  : bearing_(0),
    displayThickness_(1000.0f),
    height_(0.0),
    halfBeamWidth_(osg::DegreesToRadians(5.0)),
    data_(data),
-   dirty_(true),
+   dirty_(false),
    alpha_(1.0),
    agl_(false),
    mode_(DRAWMODE_2D_HORIZONTAL),
    refCoord_(0, 0, 0),
    sphericalEarth_(true),
-   elevAngle_(0.0)
+   elevAngle_(0.0),
+   valuesDirty_(false),
+   updateTraversalRequested_(false),
+   lodEnabled_(true),
+   asyncGeneration_(true),
+   lodStride_(1),
+   generation_(0),
+   requestedLodStride_(1),
+   lodFrame_(0)
 {
   alphaUniform_ = getOrCreateStateSet()->getOrCreateUniform("alpha", osg::Uniform::FLOAT);
   alphaUniform_->set(alpha_);
@@ -56,7 +301,12 @@ Profile::Profile(CompositeProfileProvider* data)
   addChild(transform_);
   updateOrientation_();
 
-  init_();
+  // Geometry is generated on the first update traversal, after the owner has applied its settings
+  dirty();
+}
+
+Profile::~Profile()
+{
 }
 
 void Profile::addProvider(ProfileDataProvider* provider)
@@ -106,11 +356,43 @@ void Profile::setMode(DrawMode mode)
 
 void Profile::dirty()
 {
-  if (!dirty_)
+  dirty_ = true;
+  setUpdateTraversal_(true);
+}
+
+void Profile::dirtyValues_()
+{
+  valuesDirty_ = true;
+  setUpdateTraversal_(true);
+}
+
+bool Profile::getLodEnabled() const
+{
+  return lodEnabled_;
+}
+
+void Profile::setLodEnabled(bool lodEnabled)
+{
+  if (lodEnabled_ == lodEnabled)
+    return;
+  lodEnabled_ = lodEnabled;
+  // Return to full resolution when disabled
+  if (!lodEnabled_ && lodStride_ != 1)
   {
-    ADJUST_UPDATE_TRAV_COUNT(this, 1);
+    lodStride_ = 1;
+    dirty();
   }
-  dirty_ = true;
+  setUpdateTraversal_(needsUpdate_());
+}
+
+bool Profile::getAsyncGeneration() const
+{
+  return asyncGeneration_;
+}
+
+void Profile::setAsyncGeneration(bool async)
+{
+  asyncGeneration_ = async;
 }
 
 double Profile::getBearing() const
@@ -264,23 +546,6 @@ void Profile::setHalfBeamWidth(double halfBeamWidth)
   }
 }
 
-void Profile::adjustSpherical_(osg::Vec3& v, const double *lla, const simCore::Vec3 *tpSphereXYZ)
-{
-  double pos[3] = { v[0], v[1], v[2] };
-  simCore::Vec3 sphereXYZ;
-  simCore::tangentPlane2Sphere(Vec3(lla), Vec3(pos), sphereXYZ, tpSphereXYZ);
-  double alt = v3Length(sphereXYZ) - simCore::EARTH_RADIUS;
-  v.z() = v.z() - (alt - v.z()) + refCoord_.z();
-}
-
-float Profile::getTerrainHgt_(float gndRng) const
-{
-  // initialize terrain hgt to default value in case interpolation fails
-  float value = 0.f;
-  simCore::linearInterpolate(terrainHeights_, gndRng, value);
-  return value;
-}
-
 ProfileDataProvider::ThresholdType Profile::getThresholdType() const
 {
   const CompositeProfileProvider* provider = getDataProvider();
@@ -293,80 +558,207 @@ void Profile::setThresholdType(ProfileDataProvider::ThresholdType type)
   if (provider)
   {
     provider->setActiveProvider(type);
-    // if providers change, null the texture to force it to recreate (if necessary)
-    texture_ = NULL;
-    dirty();
+    // Geometry depends only on the range and height samples, so only the values need to change
+    dirtyValues_();
   }
 }
 
-void Profile::init_()
+void Profile::updateOrientation_()
 {
-  // Remove all existing nodes
-  transform_->removeChildren(0, transform_->getNumChildren());
+  if (transform_)
+  {
+    // TODO:  Z axis is flipped in order to correctly display RF prop data (SIMSDK-365)
+    transform_->setMatrix(osg::Matrixd::rotate(bearing_, osg::Vec3d(0, 0, -1)));
+  }
+}
 
-  // Clear out the original values
-  verts_ = new osg::Vec3Array(osg::Array::BIND_PER_VERTEX);
-  values_ = new osg::FloatArray(osg::Array::BIND_PER_VERTEX);
-  values_->setNormalize(false);
-  geode_ = NULL;
+void Profile::startBuild_()
+{
   if (mode_ != DRAWMODE_3D_TEXTURE)
   {
     // if assert fails, check that setMode nulls texture on mode change
     assert(texture_ == NULL);
   }
 
-  // ensure that our provider is valid
-  if (data_.valid() && data_->getActiveProvider() != NULL)
+  osg::ref_ptr<GeometryBuilder> builder = new GeometryBuilder(*this, ++generation_, lodStride_);
+  dirty_ = false;
+  // Any pending value refresh is satisfied by the snapshot of the current provider
+  valuesDirty_ = false;
+  if (!asyncGeneration_)
   {
-    geode_ = new osg::Geode;
-    switch (mode_)
-    {
-      case DRAWMODE_2D_HORIZONTAL:
-        init2DHoriz_();
-        break;
-      case DRAWMODE_2D_VERTICAL:
-        init2DVert_();
-        break;
-      case DRAWMODE_2D_TEE:
-        init2DHoriz_();
-        init2DVert_();
-        break;
-      case DRAWMODE_3D:
-        init3D_();
-        break;
-      case DRAWMODE_3D_TEXTURE:
-        init3DTexture_();
-        break;
-      case DRAWMODE_3D_POINTS:
-        init3DPoints_();
-        break;
-      case DRAWMODE_RAE:
-        initRAE_();
-        break;
-      default:
-        // if assert fails, a new type has been added, but this switch has not been updated
-        assert(0);
-    }
-    transform_->addChild(geode_);
+    builder->build();
+    applyBuilder_(builder.get());
+    return;
   }
-  dirty_ = false;
+  pending_ = builder;
+  if (!workerPool_.valid())
+    workerPool_ = simVis::WorkerPool::instance();
+  workerPool_->add(builder.get());
 }
 
-void Profile::updateOrientation_()
+void Profile::applyBuilder_(GeometryBuilder* builder)
 {
-  if (transform_)
+  // Remove all existing nodes
+  transform_->removeChildren(0, transform_->getNumChildren());
+
+  verts_ = builder->verts();
+  values_ = builder->values();
+  geode_ = builder->geode();
+  if (mode_ == DRAWMODE_3D_TEXTURE)
+    texture_ = builder->texture();
+  if (geode_.valid())
+    transform_->addChild(geode_.get());
+  built_ = builder;
+}
+
+bool Profile::refreshValues_()
+{
+  if (!built_.valid() || built_->mode() != mode_ || built_->geode() == NULL)
+    return false;
+  if (!data_.valid() || data_->getActiveProvider() == NULL || !built_->matchesGrid(*data_))
+    return false;
+
+  if (mode_ == DRAWMODE_3D_TEXTURE)
   {
-    // TODO:  Z axis is flipped in order to correctly display RF prop data (SIMSDK-365)
-    transform_->setMatrix(osg::Matrixd::rotate(bearing_, osg::Vec3d(0, 0, -1)));
+    if (!texture_.valid())
+      return false;
+    texture_->setImage(0, GeometryBuilder::createImage(*data_));
+    return true;
+  }
+
+  const std::vector<std::pair<unsigned int, unsigned int> >& indices = built_->valueIndices();
+  if (!values_.valid() || values_->size() != indices.size())
+    return false;
+  for (size_t k = 0; k < indices.size(); ++k)
+    (*values_)[k] = static_cast<float>(data_->getValueByIndex(indices[k].first, indices[k].second));
+  values_->dirty();
+  return true;
+}
+
+bool Profile::needsUpdate_() const
+{
+  // With level of detail, the update traversal applies the stride requested by the cull traversals; see traverse()
+  return dirty_ || valuesDirty_ || pending_.valid() || (lodEnabled_ && mode_ != DRAWMODE_3D_TEXTURE);
+}
+
+void Profile::setUpdateTraversal_(bool requested)
+{
+  if (requested == updateTraversalRequested_)
+    return;
+  updateTraversalRequested_ = requested;
+  ADJUST_UPDATE_TRAV_COUNT(this, requested ? 1 : -1);
+}
+
+unsigned int Profile::computeLodStride_(double distanceToEye) const
+{
+  const osg::BoundingSphere& bound = getBound();
+  if (!bound.valid() || bound.radius() <= 0.f)
+    return 1;
+  unsigned int stride = 1;
+  double threshold = LOD_DISTANCE_FACTOR * bound.radius();
+  while (distanceToEye > threshold && stride < MAX_LOD_STRIDE)
+  {
+    stride *= 2;
+    threshold *= 2.0;
+  }
+  return stride;
+}
+
+void Profile::traverse(osg::NodeVisitor& nv)
+{
+  if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
+  {
+    // Swap in completed geometry; output for an old mode is discarded since it cannot be recolored
+    if (pending_.valid() && pending_->isDone())
+    {
+      if (pending_->mode() == mode_)
+        applyBuilder_(pending_.get());
+      pending_ = NULL;
+    }
+
+    // Pick up level of detail changes from the cull traversals
+    if (lodEnabled_ && mode_ != DRAWMODE_3D_TEXTURE)
+    {
+      unsigned int requestedStride = 1;
+      {
+        OpenThreads::ScopedLock<OpenThreads::Mutex> lock(lodMutex_);
+        requestedStride = requestedLodStride_;
+      }
+      if (requestedStride != lodStride_)
+      {
+        lodStride_ = requestedStride;
+        dirty_ = true;
+      }
+    }
+
+    // Only one build is outstanding at a time; a newer request waits for the pending one
+    if (!pending_.valid())
+    {
+      if (dirty_)
+        startBuild_();
+      else if (valuesDirty_)
+      {
+        valuesDirty_ = false;
+        if (!refreshValues_())
+        {
+          // Sample layout changed; regenerate everything, including the texture image
+          texture_ = NULL;
+          startBuild_();
+        }
+      }
+    }
+    setUpdateTraversal_(needsUpdate_());
+  }
+  else if (lodEnabled_ && mode_ != DRAWMODE_3D_TEXTURE && nv.getVisitorType() == osg::NodeVisitor::CULL_VISITOR && nv.getFrameStamp())
+  {
+    // Use the finest level requested by any view in this frame
+    const unsigned int stride = computeLodStride_(nv.getDistanceToViewPoint(getBound().center(), true));
+    const unsigned int frame = nv.getFrameStamp()->getFrameNumber();
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(lodMutex_);
+    if (frame != lodFrame_)
+    {
+      lodFrame_ = frame;
+      requestedLodStride_ = stride;
+    }
+    else
+      requestedLodStride_ = simCore::sdkMin(requestedLodStride_, stride);
+    // The update traversal picks up the request; the scene graph is not changed from cull
   }
+  osg::Group::traverse(nv);
 }
 
-void Profile::init2DHoriz_()
+//----------------------------------------------------------------------------
+void Profile::GeometryBuilder::adjustSpherical_(osg::Vec3& v, const double *lla, const simCore::Vec3 *tpSphereXYZ) const
+{
+  double pos[3] = { v[0], v[1], v[2] };
+  simCore::Vec3 sphereXYZ;
+  simCore::tangentPlane2Sphere(Vec3(lla), Vec3(pos), sphereXYZ, tpSphereXYZ);
+  double alt = v3Length(sphereXYZ) - simCore::EARTH_RADIUS;
+  v.z() = v.z() - (alt - v.z()) + refCoord_.z();
+}
+
+float Profile::GeometryBuilder::getTerrainHgt_(float gndRng) const
+{
+  // initialize terrain hgt to default value in case interpolation fails
+  float value = 0.f;
+  simCore::linearInterpolate(terrainHeights_, gndRng, value);
+  return value;
+}
+
+void Profile::GeometryBuilder::pushValue_(unsigned int heightIndex, unsigned int rangeIndex)
+{
+  values_->push_back(data_->getValueByIndex(heightIndex, rangeIndex));
+  valueIndices_.push_back(std::make_pair(heightIndex, rangeIndex));
+}
+
+void Profile::GeometryBuilder::init2DHoriz_()
 {
   assert(data_.valid() && data_->getActiveProvider() != NULL);
   const double minRange = data_->getMinRange();
   const double rangeStep = data_->getRangeStep();
-  const double numRanges = data_->getNumRanges();
+  const unsigned int numRanges = data_->getNumRanges();
+  if (numRanges == 0)
+    return;
 
   const double dt0 = -halfBeamWidth_ + M_PI_2;
   const double dt1 = halfBeamWidth_ + M_PI_2;
@@ -390,8 +782,12 @@ void Profile::init2DHoriz_()
     return;
   }
 
-  for (unsigned int i = 0; i < numRanges; i++)
+  const std::vector<unsigned int> ranges = sampleIndices(0, numRanges - 1, lodStride_);
+  verts_->reserve(startIndex + 2 * ranges.size());
+  values_->reserve(startIndex + 2 * ranges.size());
+  for (std::vector<unsigned int>::const_iterator iter = ranges.begin(); iter != ranges.end(); ++iter)
   {
+    const unsigned int i = *iter;
     const double range = minRange + rangeStep * i;
     double height = height_;
     if (agl_ && !terrainHeights_.empty())
@@ -422,9 +818,8 @@ void Profile::init2DHoriz_()
     verts_->push_back(v0);
 
     heightIndex = osg::clampBetween(heightIndex, 0u, data_->getNumHeights() - 1);
-    const double value = data_->getValueByIndex(heightIndex, i);
-    values_->push_back(value);
-    values_->push_back(value);
+    pushValue_(heightIndex, i);
+    pushValue_(heightIndex, i);
   }
 
   osg::Geometry* geometry = new osg::Geometry();
@@ -444,7 +839,7 @@ void Profile::init2DHoriz_()
 }
 
 // Used to tesselate the 2D Vertical with triangle strip
-const void Profile::tesselate2DVert_(unsigned int numRanges, unsigned int numHeights, unsigned int startIndex, osg::ref_ptr<osg::FloatArray> values, osg::Geometry* geometry)
+void Profile::GeometryBuilder::tesselate2DVert_(unsigned int numRanges, unsigned int numHeights, unsigned int startIndex, osg::Geometry* geometry)
 {
   for (unsigned int h = 0; h < numHeights - 1; ++h)
   {
@@ -465,7 +860,7 @@ const void Profile::tesselate2DVert_(unsigned int numRanges, unsigned int numHei
   }
 }
 
-void Profile::init2DVert_()
+void Profile::GeometryBuilder::init2DVert_()
 {
   assert(data_.valid() && data_->getActiveProvider() != NULL);
   const double minRange = data_->getMinRange();
@@ -479,20 +874,27 @@ void Profile::init2DVert_()
   const unsigned int numHeights = data_->getNumHeights();
   // if assert fails, check that init_ ensures that we have a valid provider
   assert(numHeights > 0);
+  if (numRanges == 0 || numHeights == 0)
+    return;
 
   simCore::Vec3 tpSphereXYZ;
   simCore::geodeticToSpherical(refCoord_.y(), refCoord_.x(), refCoord_.z(), tpSphereXYZ);
   const double lla[3] = { refCoord_.y(), refCoord_.x(), refCoord_.z() };
 
+  const std::vector<unsigned int> ranges = sampleIndices(0, numRanges - 1, lodStride_);
+  const std::vector<unsigned int> heights = sampleIndices(0, numHeights - 1, lodStride_);
+
   const unsigned int startIndex = verts_->size();
-  for (unsigned int r = 0; r < numRanges; r++)
+  verts_->reserve(startIndex + ranges.size() * heights.size());
+  values_->reserve(startIndex + ranges.size() * heights.size());
+  for (std::vector<unsigned int>::const_iterator rIter = ranges.begin(); rIter != ranges.end(); ++rIter)
   {
     const double x = 0;
-    const double y = minRange + rangeStep * r;
+    const double y = minRange + rangeStep * (*rIter);
 
-    for (unsigned int h = 0; h < numHeights; h++)
+    for (std::vector<unsigned int>::const_iterator hIter = heights.begin(); hIter != heights.end(); ++hIter)
     {
-      const double height = minHeight + heightStep * h;
+      const double height = minHeight + heightStep * (*hIter);
       osg::Vec3 v(x, y, height);
 
       if (sphericalEarth_)
@@ -501,9 +903,7 @@ void Profile::init2DVert_()
       }
 
       verts_->push_back(v);
-
-      const float value = data_->getValueByIndex(h, r);
-      values_->push_back(value);
+      pushValue_(*hIter, *rIter);
     }
   }
 
@@ -516,12 +916,12 @@ void Profile::init2DVert_()
   geometry->getOrCreateStateSet()->setMode(GL_CULL_FACE, osg::StateAttribute::OFF);
 
   // Call to tesselate the 2D Vertical
-  tesselate2DVert_(numRanges, numHeights, startIndex, values_, geometry);
+  tesselate2DVert_(ranges.size(), heights.size(), startIndex, geometry);
 
   geode_->addDrawable(geometry);
 }
 
-void Profile::init3D_()
+void Profile::GeometryBuilder::init3D_()
 {
   assert(data_.valid() && data_->getActiveProvider() != NULL);
   const double minRange = data_->getMinRange();
@@ -535,7 +935,7 @@ void Profile::init3D_()
   const unsigned int numHeights = data_->getNumHeights();
   // if assert fails, check that init_ ensures that we have a valid provider
   assert(numHeights > 0);
-  if (numHeights == 0)
+  if (numHeights == 0 || numRanges == 0)
     return;
 
   //Build a 3D voxel representation of the profile.  The minimum height is specified by the height_ setting and the maximum height is the height_ + the display thickness
@@ -578,12 +978,15 @@ void Profile::init3D_()
     return;
   }
 
-  const unsigned int heightIndexCount = maxHeightIndex - minHeightIndex + 1;
-  const unsigned int numVerts = 2 * heightIndexCount * numRanges;
-  //osg::Vec3Array* verts = new osg::Vec3Array();
-  verts_->reserve(numVerts);
+  const std::vector<unsigned int> ranges = sampleIndices(0, numRanges - 1, lodStride_);
+  const std::vector<unsigned int> heights = sampleIndices(minHeightIndex, maxHeightIndex, lodStride_);
+  const unsigned int rangeCount = ranges.size();
+  const unsigned int heightIndexCount = heights.size();
+  const unsigned int numVerts = 2 * heightIndexCount * rangeCount;
 
   const unsigned int startIndex = verts_->size();
+  verts_->reserve(startIndex + numVerts);
+  values_->reserve(startIndex + numVerts);
 
   const double dt0 = -halfBeamWidth_ + M_PI_2;
   const double dt1 = halfBeamWidth_ + M_PI_2;
@@ -593,17 +996,17 @@ void Profile::init3D_()
   const double cosTheta1 = cos(dt1);
   const double sinTheta1 = sin(dt1);
 
-  for (unsigned int r = 0; r < numRanges; r++)
+  for (unsigned int r = 0; r < rangeCount; r++)
   {
-    const double range = minRange + rangeStep * r;
+    const double range = minRange + rangeStep * ranges[r];
     const double x0 = range * cosTheta0;
     const double y0 = range * sinTheta0;
     const double x1 = range * cosTheta1;
     const double y1 = range * sinTheta1;
 
-    for (unsigned int h = minHeightIndex; h <= maxHeightIndex; h++)
+    for (unsigned int h = 0; h < heightIndexCount; h++)
     {
-      const double height = minHeight + heightStep * h;
+      const double height = minHeight + heightStep * heights[h];
       //Left vert
       osg::Vec3 v0(x0, y0, height);
       //Right vert
@@ -618,27 +1021,26 @@ void Profile::init3D_()
       verts_->push_back(v0);
       verts_->push_back(v1);
 
-      double value = data_->getValueByIndex(h, r);
-      values_->push_back(value);
-      values_->push_back(value);
+      pushValue_(heights[h], ranges[r]);
+      pushValue_(heights[h], ranges[r]);
     }
   }
 
   osg::Geometry* geometry = new osg::Geometry();
 
   //Now build the indices that will actually be rendered
-  for (unsigned int r = 0; r < numRanges - 1; r++)
+  for (unsigned int r = 0; r + 1 < rangeCount; r++)
   {
     const unsigned int nextR = r + 1;
-    for (unsigned int h = minHeightIndex; h < maxHeightIndex; h++)
+    for (unsigned int h = 0; h + 1 < heightIndexCount; h++)
     {
       //Compute the indices of the 8 corners of the cube
-      const unsigned int v0 = startIndex + r * heightIndexCount * 2 + (h - minHeightIndex) * 2;  // front LR
+      const unsigned int v0 = startIndex + r * heightIndexCount * 2 + h * 2;  // front LR
       const unsigned int v1 = v0 + 1; // front LL
       const unsigned int v2 = v1 + 1; // front UR
       const unsigned int v3 = v2 + 1; // front UL
 
-      const unsigned int v4 = startIndex + nextR * heightIndexCount * 2 + (h - minHeightIndex) * 2; // back LR
+      const unsigned int v4 = startIndex + nextR * heightIndexCount * 2 + h * 2; // back LR
       const unsigned int v5 = v4 + 1; // back LL
       const unsigned int v6 = v5 + 1; // back UR
       const unsigned int v7 = v6 + 1; // back UL
@@ -681,7 +1083,7 @@ void Profile::init3D_()
   geode_->addDrawable(geometry);
 }
 
-void Profile::init3DTexture_()
+void Profile::GeometryBuilder::init3DTexture_()
 {
   assert(data_.valid() && data_->getActiveProvider() != NULL);
   const double maxRange = data_->getMaxRange();
@@ -908,7 +1310,7 @@ void Profile::init3DTexture_()
   // Only create the texture if it doesn't already exist, otherwise you can just reuse it
   if (texture_ == NULL)
   {
-    texture_ = new osg::Texture2D(createImage_());
+    texture_ = new osg::Texture2D(createImage(*data_));
     texture_->setResizeNonPowerOfTwoHint(false);
     texture_->setWrap(osg::Texture::WRAP_S, osg::Texture::CLAMP_TO_EDGE);
     texture_->setWrap(osg::Texture::WRAP_T, osg::Texture::CLAMP_TO_EDGE);
@@ -917,7 +1319,8 @@ void Profile::init3DTexture_()
   geode_->getOrCreateStateSet()->setTextureAttributeAndModes(0, texture_);
 }
 
-void Profile::init3DPoints_()
+
+void Profile::GeometryBuilder::init3DPoints_()
 {
   assert(data_.valid() && data_->getActiveProvider() != NULL);
   const double minRange = data_->getMinRange();
@@ -929,6 +1332,8 @@ void Profile::init3DPoints_()
   const unsigned int numHeights = data_->getNumHeights();
   // if assert fails, check that init_ ensures that we have a valid provider
   assert(numHeights > 0);
+  if (numHeights == 0 || numRanges == 0)
+    return;
 
   //Build a 3D voxel representation of the profile.  The minimum height is specified by the height_ setting and the maximum height is the height_ + the display thickness
   unsigned int minHeightIndex = data_->getHeightIndex(height_);
@@ -970,24 +1375,26 @@ void Profile::init3DPoints_()
     return;
   }
 
-  const unsigned int numVerts = (maxHeightIndex - minHeightIndex + 1) * numRanges;
+  const std::vector<unsigned int> ranges = sampleIndices(0, numRanges - 1, lodStride_);
+  const std::vector<unsigned int> heights = sampleIndices(minHeightIndex, maxHeightIndex, lodStride_);
+  const unsigned int numVerts = heights.size() * ranges.size();
   verts_->reserve(numVerts);
+  values_->reserve(numVerts);
 
-  for (unsigned int r = 0; r < numRanges; r++)
+  for (std::vector<unsigned int>::const_iterator rIter = ranges.begin(); rIter != ranges.end(); ++rIter)
   {
-    const double range = minRange + rangeStep * r;
+    const double range = minRange + rangeStep * (*rIter);
 
-    for (unsigned int h = minHeightIndex; h <= maxHeightIndex; h++)
+    for (std::vector<unsigned int>::const_iterator hIter = heights.begin(); hIter != heights.end(); ++hIter)
     {
-      const double height = minHeight + heightStep * h;
+      const double height = minHeight + heightStep * (*hIter);
       osg::Vec3 v(0, range, height);
       if (sphericalEarth_)
       {
         adjustSpherical_(v, lla, &tpSphereXYZ);
       }
       verts_->push_back(v);
-      const double value = data_->getValueByIndex(h, r);
-      values_->push_back(value);
+      pushValue_(*hIter, *rIter);
     }
   }
 
@@ -1003,27 +1410,7 @@ void Profile::init3DPoints_()
   simVis::PointSize::setValues(geode_->getOrCreateStateSet(), 3.f, osg::StateAttribute::ON);
 }
 
-osg::Image* Profile::createImage_()
-{
-  assert(data_.valid() && data_->getActiveProvider() != NULL);
-  const unsigned int numRanges = data_->getNumRanges();
-  const unsigned int numHeights = data_->getNumHeights();
-
-  osg::Image* image = new osg::Image();
-  image->allocateImage(numRanges, numHeights, 1, GL_LUMINANCE, GL_FLOAT);
-  image->setInternalTextureFormat(GL_LUMINANCE32F_ARB);
-
-  for (unsigned int r = 0; r < numRanges; r++)
-  {
-    for (unsigned int h = 0; h < numHeights; h++)
-    {
-      const double value = data_->getValueByIndex(h, r);
-      *(float*)image->data(r, h) = (float)value;
-    }
-  }
-  return image;
-}
-const void Profile::buildVoxel_(const double *lla, const simCore::Vec3 *tpSphereXYZ, unsigned int heightIndex, unsigned int rangeIndex, osg::Geometry* geometry)
+void Profile::GeometryBuilder::buildVoxel_(const double *lla, const simCore::Vec3 *tpSphereXYZ, unsigned int heightIndex, unsigned int rangeIndex, unsigned int rangeSpan, osg::Geometry* geometry)
 {
   assert(data_.valid() && data_->getActiveProvider() != NULL);
   const double minRange = data_->getMinRange();
@@ -1072,7 +1459,7 @@ const void Profile::buildVoxel_(const double *lla, const simCore::Vec3 *tpSphere
   const double h1 = h0 + heightStep;
 
   unsigned int minRangeIndex = rangeIndex;
-  unsigned int maxRangeIndex = minRangeIndex + 1;
+  unsigned int maxRangeIndex = minRangeIndex + simCore::sdkMax(1u, rangeSpan);
 
   minRangeIndex = osg::clampBetween(minRangeIndex, 0u, numRanges - 1);
   maxRangeIndex = osg::clampBetween(maxRangeIndex, 0u, numRanges - 1);
@@ -1097,7 +1484,7 @@ const void Profile::buildVoxel_(const double *lla, const simCore::Vec3 *tpSphere
   }
 
   const double r0 = minRange + rangeStep * minRangeIndex;
-  const double r1 = r0 + rangeStep;
+  const double r1 = minRange + rangeStep * maxRangeIndex;
 
   const double dt0 = -halfBeamWidth_ + M_PI_2;
   const double dt1 = halfBeamWidth_ + M_PI_2;
@@ -1151,24 +1538,20 @@ const void Profile::buildVoxel_(const double *lla, const simCore::Vec3 *tpSphere
   verts_->push_back(v7);
 
   //v0, v1
-  double value = data_->getValueByIndex(minHeightIndex, minRangeIndex);
-  values_->push_back(value);
-  values_->push_back(value);
+  pushValue_(minHeightIndex, minRangeIndex);
+  pushValue_(minHeightIndex, minRangeIndex);
 
   //v2, v3
-  value = data_->getValueByIndex(minHeightIndex, maxRangeIndex);
-  values_->push_back(value);
-  values_->push_back(value);
+  pushValue_(minHeightIndex, maxRangeIndex);
+  pushValue_(minHeightIndex, maxRangeIndex);
 
   //v4, v5
-  value = data_->getValueByIndex(maxHeightIndex, minRangeIndex);
-  values_->push_back(value);
-  values_->push_back(value);
+  pushValue_(maxHeightIndex, minRangeIndex);
+  pushValue_(maxHeightIndex, minRangeIndex);
 
   //v6, v7
-  value = data_->getValueByIndex(maxHeightIndex, maxRangeIndex);
-  values_->push_back(value);
-  values_->push_back(value);
+  pushValue_(maxHeightIndex, maxRangeIndex);
+  pushValue_(maxHeightIndex, maxRangeIndex);
 
   // Create a triangle strip set to wrap the voxel
   osg::DrawElementsUInt* idx = new osg::DrawElementsUInt(GL_TRIANGLE_STRIP);
@@ -1197,12 +1580,14 @@ const void Profile::buildVoxel_(const double *lla, const simCore::Vec3 *tpSphere
   geometry->addPrimitiveSet(idx);
 }
 
-void Profile::initRAE_()
+void Profile::GeometryBuilder::initRAE_()
 {
   assert(data_.valid() && data_->getActiveProvider() != NULL);
   const unsigned int numRanges = data_->getNumRanges();
   // if assert fails, check that init_ ensures that we have a valid provider
   assert(numRanges > 0);
+  if (numRanges == 0)
+    return;
 
   const double rangeStep = data_->getRangeStep();
 
@@ -1211,7 +1596,11 @@ void Profile::initRAE_()
   const double lla[3] = { refCoord_.y(), refCoord_.x(), refCoord_.z() };
   const double sinElevAngle = sin(elevAngle_);
   simCore::geodeticToSpherical(refCoord_.y(), refCoord_.x(), refCoord_.z(), tpSphereXYZ);
-  for (unsigned int i = 0; i < numRanges - 1; ++i)
+  const unsigned int stride = simCore::sdkMax(1u, lodStride_);
+  // Each voxel has 8 vertices
+  verts_->reserve(8 * ((numRanges - 1) / stride + 1));
+  values_->reserve(verts_->capacity());
+  for (unsigned int i = 0; i + 1 < numRanges; i += stride)
   {
     const double height = height_ + (i * rangeStep * sinElevAngle);
     const unsigned int heightIndex = data_->getHeightIndex(height);
@@ -1222,7 +1611,7 @@ void Profile::initRAE_()
       assert(0);
       return;
     }
-    buildVoxel_(lla, &tpSphereXYZ, heightIndex, i, geometry);
+    buildVoxel_(lla, &tpSphereXYZ, heightIndex, i, simCore::sdkMin(stride, numRanges - 1 - i), geometry);
   }
 
   geometry->setUseVertexBufferObjects(true);
@@ -1233,16 +1622,3 @@ void Profile::initRAE_()
 
   geode_->addDrawable(geometry);
 }
-
-void Profile::traverse(osg::NodeVisitor& nv)
-{
-  if (nv.getVisitorType() == osg::NodeVisitor::UPDATE_VISITOR)
-  {
-    if (dirty_)
-    {
-      init_();
-    }
-    ADJUST_UPDATE_TRAV_COUNT(this, -1);
-  }
-  osg::Group::traverse(nv);
-}
@@ -23,8 +23,10 @@
 #define SIMVIS_RFPROP_PROFILE_H
 
 #include <map>
+#include "OpenThreads/Mutex"
 #include "osg/Group"
 #include "osg/Geode"
+#include "osg/ref_ptr"
 #include "simCore/Common/Common.h"
 #include "simCore/Calc/Vec3.h"
 #include "simCore/Calc/Math.h"
@@ -36,10 +38,17 @@ namespace osg {
   class DrawElementsUInt;
 }
 
+namespace simVis { class WorkerPool; }
+
 namespace simRF
 {
 
-/** Responsible for rendering a single profile of data. */
+/**
+ * Responsible for rendering a single profile of data.  Geometry is generated from a snapshot of the
+ * profile settings, optionally on the shared simVis::WorkerPool, and swapped in during the update
+ * traversal once complete.  Changes that only affect the loss values (such as the threshold type)
+ * recompute the value attribute in place without regenerating vertices or primitives.
+ */
 class SDKVIS_EXPORT Profile : public osg::Group
 {
 public:
@@ -165,7 +174,28 @@ public:
   /** Set threshold type, selects a data provider of that type, if one exists */
   void setThresholdType(ProfileDataProvider::ThresholdType type);
 
-  /** On update visitor, re-initialize when dirty */
+  /** Gets whether distance-based level of detail is enabled */
+  bool getLodEnabled() const;
+
+  /**
+   * Sets whether distance-based level of detail is enabled.  When enabled, profiles that are far from
+   * the eye decimate their range and height samples, regenerating geometry when the level changes.
+   * While enabled, the profile takes part in every update traversal, which applies the level requested
+   * by the cull traversals.  Does not apply to DRAWMODE_3D_TEXTURE.  Defaults to true.
+   */
+  void setLodEnabled(bool lodEnabled);
+
+  /** Gets whether geometry is generated on a background thread */
+  bool getAsyncGeneration() const;
+
+  /**
+   * Sets whether geometry is generated on a background thread.  When true, the previous geometry remains
+   * displayed until the new geometry is complete.  When false, geometry is generated in the update traversal.
+   * Defaults to true.
+   */
+  void setAsyncGeneration(bool async);
+
+  /** On update visitor, re-initialize when dirty; on cull visitor, selects the level of detail */
   virtual void traverse(osg::NodeVisitor& nv);
 
   /** Dirty this Profile causing it to be redrawn. */
@@ -180,42 +210,14 @@ public:
 protected:
 
   /// osg::Referenced-derived
-  virtual ~Profile() {}
-
-  /** Performs initialization at construction time */
-  void init_();
-
-  /** Initializes as a 2D horizontal */
-  void init2DHoriz_();
-  /** Initializes as a 2D Vertical */
-  void init2DVert_();
-  /** Initializes as a 3D */
-  void init3D_();
-  /** Initializes as a 3D texture */
-  void init3DTexture_();
-  /** Initializes as a 3D points */
-  void init3DPoints_();
-  /** Initializes as RAE */
-  void initRAE_();
+  virtual ~Profile();
 
   /** Gets the DataProvider for this Profile, non-const version */
   CompositeProfileProvider* getDataProvider_();
 
-  /** Creates an image representing the loss values */
-  osg::Image* createImage_();
-
-  /** Creates a voxel (volume pixel) at the given location */
-  const void buildVoxel_(const double* lla, const simCore::Vec3* tpSphereXYZ, unsigned int heightIndex, unsigned int rangeIndex, osg::Geometry* geometry);
-
   /** Fixes the orientation of the profile */
   void updateOrientation_();
 
-  /** Adjusts based on spherical XYZ */
-  void adjustSpherical_(osg::Vec3& v, const double *lla, const simCore::Vec3 *tpSphereXYZ);
-
-  /** Retrieves the profile height at the given ground range in meters */
-  float getTerrainHgt_(float gndRng) const;
-
   /** Bearing of the profile in radians */
   double bearing_;
 
@@ -262,8 +264,48 @@ protected:
   osg::ref_ptr<osg::Uniform> alphaUniform_;
 
 private:
-    /** Tesselate the 2D Vertical with tringle strip */
-  const void tesselate2DVert_(unsigned int numRanges, unsigned int numHeights, unsigned int startIndex, osg::ref_ptr<osg::FloatArray> values, osg::Geometry* geometry);
+  class GeometryBuilder;
+
+  /** Flags the loss values as needing recomputation, without regenerating geometry */
+  void dirtyValues_();
+  /** Starts generation of new geometry from the current settings */
+  void startBuild_();
+  /** Replaces the displayed geometry with the output of a completed builder */
+  void applyBuilder_(GeometryBuilder* builder);
+  /** Recomputes loss values in place; returns false if the displayed geometry is incompatible with the active provider */
+  bool refreshValues_();
+  /** Returns true if there is outstanding work requiring update traversals */
+  bool needsUpdate_() const;
+  /** Requests or releases update traversals, keeping the traversal count balanced */
+  void setUpdateTraversal_(bool requested);
+  /** Returns the sample stride to use for the given distance from the eye */
+  unsigned int computeLodStride_(double distanceToEye) const;
+
+  /** Indicates loss values need recomputation */
+  bool valuesDirty_;
+  /** Indicates that this node has requested update traversals */
+  bool updateTraversalRequested_;
+  /** Distance-based level of detail enabled */
+  bool lodEnabled_;
+  /** Generate geometry on the background thread */
+  bool asyncGeneration_;
+  /** Sample stride used to generate the current geometry */
+  unsigned int lodStride_;
+  /** Incremented on each build request, to identify builder output */
+  unsigned int generation_;
+  /** Builder currently generating geometry, if any */
+  osg::ref_ptr<GeometryBuilder> pending_;
+  /** Builder that produced the displayed geometry; records the sample indices for each value */
+  osg::ref_ptr<GeometryBuilder> built_;
+  /** Threads that run asynchronous builds; held while this profile exists, once it first builds asynchronously */
+  osg::ref_ptr<simVis::WorkerPool> workerPool_;
+
+  /** Protects the level of detail requested by the cull traversals */
+  OpenThreads::Mutex lodMutex_;
+  /** Smallest stride requested by any cull traversal in lodFrame_; applied by the update traversal */
+  unsigned int requestedLodStride_;
+  /** Frame number of the most recent level of detail request */
+  unsigned int lodFrame_;
 };
 }
 
@@ -19,14 +19,21 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
+#include <cmath>
 #include <limits>
+#include "OpenThreads/ScopedLock"
+#include "simVis/osgEarthVersion.h"
 #include "simVis/RadialLOS.h"
 #include "simVis/Utils.h"
+#include "simVis/WorkerPool.h"
 #include "simCore/Calc/Calculations.h"
 #include "simCore/Calc/CoordinateConverter.h"
 #include "simNotify/Notify.h"
 #include "simCore/Calc/Math.h"
+#include "osgEarth/ElevationLayer"
 #include "osgEarth/GeoData"
+#include "osgEarth/Map"
 #include "osgEarth/Terrain"
 #include <cassert>
 
@@ -34,6 +41,513 @@
 
 using namespace simVis;
 
+namespace
+{
+
+/** Fewest terrain samples worth handing to the worker pool; smaller computations run serially */
+static const size_t MIN_PARALLEL_SAMPLES = 1024;
+/** Cache cells per range resolution step; keeps the error from sampling cell centers small */
+static const double CACHE_CELLS_PER_RANGE_STEP = 8.0;
+/** Approximate meters per degree, to size cache cells in geographic maps */
+static const double METERS_PER_DEGREE = 111319.49;
+
+/**
+ * Default height sampler, which intersects the map node's terrain.  Terrain::getHeight() is not
+ * documented as thread-safe, so computations through this sampler run on the calling thread.
+ */
+class TerrainHeightSampler : public RadialLOS::HeightSampler
+{
+public:
+  explicit TerrainHeightSampler(osgEarth::MapNode* mapNode)
+    : mapNode_(mapNode)
+  {
+  }
+
+  virtual bool getHeight(osg::Node* patch, const osgEarth::GeoPoint& point, double& hamsl, double& hae) const
+  {
+    if (patch)
+      return mapNode_->getTerrain()->getHeight(patch, point.getSRS(), point.x(), point.y(), &hamsl, &hae);
+    return mapNode_->getTerrain()->getHeight(point.getSRS(), point.x(), point.y(), &hamsl, &hae);
+  }
+
+private:
+  osgEarth::MapNode* mapNode_;
+};
+
+/** State shared by all radials of one computation; read-only while the radials are sampled */
+struct RadialContext
+{
+  const RadialLOS::HeightSampler* sampler;
+  ElevationSampleCache* cache;
+  double cellSize;
+  osg::Node* patch;
+  const osgEarth::SpatialReference* mapSRS;
+  osg::Matrix local2world;
+  simCore::Vec3 originLla;
+  simCore::CoordinateConverter cc;
+  double rangeMax;
+  double rangeResolution;
+};
+
+/** Converts an absolute map point to an LLA coordinate; returns true on success */
+bool toLlaCoordinate(const osgEarth::GeoPoint& point, simCore::Coordinate& out)
+{
+  osgEarth::GeoPoint geoPoint = point;
+  if (!geoPoint.getSRS()->isGeographic())
+  {
+    if (!geoPoint.transform(geoPoint.getSRS()->getGeographicSRS(), geoPoint))
+      return false;
+  }
+  out = simCore::Coordinate(simCore::COORD_SYS_LLA, simCore::Vec3(geoPoint.y() * simCore::DEG2RAD, geoPoint.x() * simCore::DEG2RAD, geoPoint.alt()));
+  return true;
+}
+
+/** Calculates the elevation angle from the LOS origin to the point */
+double elevationTo(const RadialContext& context, const osgEarth::GeoPoint& point)
+{
+  simCore::Coordinate destCoord;
+  toLlaCoordinate(point, destCoord);
+  double elev;
+  simCore::calculateAbsAzEl(context.originLla, destCoord.position(), NULL, &elev, NULL, simCore::FLAT_EARTH, &context.cc);
+  return elev;
+}
+
+/** Samples the terrain height at the point, through the cache if there is one */
+bool sampleHeight(const RadialContext& context, const osgEarth::GeoPoint& point, double& hamsl, double& hae)
+{
+  if (context.cache == NULL)
+    return context.sampler->getHeight(context.patch, point, hamsl, hae);
+
+  // A patch is newer than anything cached, so it always samples
+  const ElevationSampleCache::Key key = ElevationSampleCache::makeKey(point.x(), point.y(), context.cellSize);
+  if (context.patch == NULL && context.cache->get(key, hamsl, hae))
+    return true;
+
+  // Sample the center of the cell so the cached heights are exact for the key
+  const osg::Vec2d center = ElevationSampleCache::cellCenter(key);
+  const osgEarth::GeoPoint cellPoint(point.getSRS(), center.x(), center.y(), 0.0, osgEarth::ALTMODE_ABSOLUTE);
+  if (!context.sampler->getHeight(context.patch, cellPoint, hamsl, hae))
+    return false;
+  context.cache->put(key, hamsl, hae);
+  return true;
+}
+
+/** Samples one radial; returns true if it has at least two consecutive valid samples */
+bool computeRadial(const RadialContext& context, RadialLOS::Radial& radial)
+{
+  double x = sin(radial.azim_rad_);
+  double y = cos(radial.azim_rad_);
+
+  // Track the bounds of the sample points, so updates can skip radials outside a changed extent
+  double xMin = std::numeric_limits<double>::max();
+  double yMin = std::numeric_limits<double>::max();
+  double xMax = -std::numeric_limits<double>::max();
+  double yMax = -std::numeric_limits<double>::max();
+  bool pointsValid = true;
+
+  // Track the highest elevation along this azimuth to check for visibility
+  double maxElev = -2 * M_PI;
+  bool validLos = false;
+  // step through the distance range:
+  bool rangeDone = false;
+  bool lastSampleValid = false;
+  for (double range_m = context.rangeResolution; !rangeDone; range_m += context.rangeResolution)
+  {
+    if (range_m >= context.rangeMax)
+    {
+      range_m = context.rangeMax;
+      rangeDone = true;
+    }
+
+    // calculate the world point:
+    osg::Vec3d sampleWorld = osg::Vec3d(x*range_m, y*range_m, 0.0) * context.local2world;
+
+    // convert to a map point
+    osgEarth::GeoPoint mapPoint;
+    mapPoint.fromWorld(context.mapSRS, sampleWorld);
+    if (mapPoint.isValid())
+    {
+      xMin = std::min(xMin, mapPoint.x());
+      yMin = std::min(yMin, mapPoint.y());
+      xMax = std::max(xMax, mapPoint.x());
+      yMax = std::max(yMax, mapPoint.y());
+    }
+    else
+      pointsValid = false;
+
+    // sample the terrain at that point
+    double hamsl = 0.0, hae = 0.0;
+    if (sampleHeight(context, mapPoint, hamsl, hae))
+    {
+      // see if the point is unobstructed.
+      mapPoint.z() = hae;
+      const double elev = elevationTo(context, mapPoint);
+
+      bool visible = false;
+      if (elev >= maxElev)
+      {
+        maxElev = elev;
+        visible = true;
+      }
+
+      radial.samples_.push_back(RadialLOS::Sample(range_m, mapPoint, hamsl, hae, elev, visible));
+      if (!validLos)
+      {
+        // To be valid there needs to be at least two consecutive points on the same azimuth
+        if (lastSampleValid)
+          validLos = true;
+        lastSampleValid = true;
+      }
+    }
+    else
+    {
+      // record an "invalid" sample
+      radial.samples_.push_back(RadialLOS::Sample(range_m, mapPoint));
+      lastSampleValid = false;
+    }
+  }
+
+  if (pointsValid && !radial.samples_.empty())
+    radial.extent_ = osgEarth::GeoExtent(context.mapSRS, xMin, yMin, xMax, yMax);
+  else
+    radial.extent_ = osgEarth::GeoExtent();
+  return validLos;
+}
+
+/** Re-samples the points of the radial inside the extent, and recalculates visibility beyond the first new sample */
+void updateRadial(const RadialContext& context, const osgEarth::GeoExtent& extent, RadialLOS::Radial& radial)
+{
+  unsigned int firstNewSampleIndex = ~0;
+
+  for (unsigned int sampleIndex = 0; sampleIndex < radial.samples_.size(); ++sampleIndex)
+  {
+    RadialLOS::Sample& sample = radial.samples_[sampleIndex];
+
+    if (!sample.point_.isValid() || extent.contains(sample.point_))
+    {
+      bool ok = sampleHeight(context, sample.point_, sample.hamsl_m_, sample.hae_m_);
+
+      if (ok && firstNewSampleIndex == ~(0u))
+      {
+        firstNewSampleIndex = sampleIndex;
+      }
+    }
+  }
+
+  // if we re-sampled anything, start with the first new sample and recalculate
+  // visibility from there on out.
+  if (firstNewSampleIndex == ~(0u))
+    return;
+
+  double maxElev = -2 * M_PI;
+  for (unsigned int sampleIndex = 0; sampleIndex < radial.samples_.size(); ++sampleIndex)
+  {
+    RadialLOS::Sample& sample = radial.samples_[sampleIndex];
+
+    // recalculate the elevation for all the new samples only.
+    if (sampleIndex >= firstNewSampleIndex)
+    {
+      // see if the point is unobstructed.
+      sample.point_.z() = sample.hae_m_;
+      sample.elev_rad_ = elevationTo(context, sample.point_);
+    }
+
+    if (sample.elev_rad_ >= maxElev)
+    {
+      maxElev = sample.elev_rad_;
+      sample.visible_ = true;
+    }
+    else
+    {
+      sample.visible_ = false;
+    }
+  }
+}
+
+/** Computes a radial by index */
+class ComputeRadialTask : public WorkerPool::Task
+{
+public:
+  ComputeRadialTask(const RadialContext& context, RadialLOS::RadialVector& radials, std::vector<char>& valid)
+    : context_(context),
+      radials_(radials),
+      valid_(valid)
+  {
+  }
+
+  virtual void run(size_t index)
+  {
+    valid_[index] = computeRadial(context_, radials_[index]) ? 1 : 0;
+  }
+
+private:
+  const RadialContext& context_;
+  RadialLOS::RadialVector& radials_;
+  std::vector<char>& valid_;
+};
+
+/** Updates a radial by index into a list of radials to update */
+class UpdateRadialTask : public WorkerPool::Task
+{
+public:
+  UpdateRadialTask(const RadialContext& context, const osgEarth::GeoExtent& extent, RadialLOS::RadialVector& radials, const std::vector<size_t>& indices)
+    : context_(context),
+      extent_(extent),
+      radials_(radials),
+      indices_(indices)
+  {
+  }
+
+  virtual void run(size_t index)
+  {
+    updateRadial(context_, extent_, radials_[indices_[index]]);
+  }
+
+private:
+  const RadialContext& context_;
+  const osgEarth::GeoExtent& extent_;
+  RadialLOS::RadialVector& radials_;
+  const std::vector<size_t>& indices_;
+};
+
+/** Registry of caches shared per map */
+OpenThreads::Mutex s_sharedCachesMutex;
+std::map<osgEarth::UID, osg::observer_ptr<ElevationSampleCache> > s_sharedCaches;
+
+}
+
+//----------------------------------------------------------------------------
+
+#if SDK_OSGEARTH_MIN_VERSION_REQUIRED(1,6,0)
+/** Clears the cache when elevation layers are added, removed, moved, or change visibility */
+class ElevationSampleCache::MapListener : public osgEarth::MapCallback
+{
+public:
+  explicit MapListener(ElevationSampleCache& cache)
+    : cache_(cache),
+      layerListener_(new LayerListener(cache))
+  {
+  }
+
+  /** Starts watching the visibility of the layer, if it is an elevation layer */
+  void watchLayer(osgEarth::Layer* layer)
+  {
+    osgEarth::ElevationLayer* elevationLayer = dynamic_cast<osgEarth::ElevationLayer*>(layer);
+    if (elevationLayer)
+      elevationLayer->addCallback(layerListener_.get());
+  }
+
+  /** Stops watching the layer */
+  void unwatchLayer(osgEarth::Layer* layer)
+  {
+    osgEarth::ElevationLayer* elevationLayer = dynamic_cast<osgEarth::ElevationLayer*>(layer);
+    if (elevationLayer)
+      elevationLayer->removeCallback(layerListener_.get());
+  }
+
+  virtual void onLayerAdded(osgEarth::Layer* layer, unsigned int index)
+  {
+    if (dynamic_cast<osgEarth::ElevationLayer*>(layer) == NULL)
+      return;
+    watchLayer(layer);
+    cache_.clear();
+  }
+
+  virtual void onLayerRemoved(osgEarth::Layer* layer, unsigned int index)
+  {
+    if (dynamic_cast<osgEarth::ElevationLayer*>(layer) == NULL)
+      return;
+    unwatchLayer(layer);
+    cache_.clear();
+  }
+
+  virtual void onLayerMoved(osgEarth::Layer* layer, unsigned int oldIndex, unsigned int newIndex)
+  {
+    // Elevation layer order decides which layer provides the heights
+    if (dynamic_cast<osgEarth::ElevationLayer*>(layer) != NULL)
+      cache_.clear();
+  }
+
+private:
+  /** Clears the cache when an elevation layer is shown or hidden */
+  class LayerListener : public osgEarth::ElevationLayerCallback
+  {
+  public:
+    explicit LayerListener(ElevationSampleCache& cache)
+      : cache_(cache)
+    {
+    }
+
+    virtual void onVisibleChanged(osgEarth::VisibleLayer* layer)
+    {
+      cache_.clear();
+    }
+
+  private:
+    ElevationSampleCache& cache_;
+  };
+
+  ElevationSampleCache& cache_;
+  osg::ref_ptr<LayerListener> layerListener_;
+};
+#else
+/** Layer change notifications are not available; the cache relies on terrain tile updates alone */
+class ElevationSampleCache::MapListener : public osg::Referenced
+{
+};
+#endif
+
+//----------------------------------------------------------------------------
+
+bool ElevationSampleCache::Key::operator<(const Key& rhs) const
+{
+  if (level != rhs.level)
+    return level < rhs.level;
+  if (x != rhs.x)
+    return x < rhs.x;
+  return y < rhs.y;
+}
+
+ElevationSampleCache::ElevationSampleCache(size_t maxSamples)
+  : maxSamples_(maxSamples)
+{
+}
+
+ElevationSampleCache::~ElevationSampleCache()
+{
+#if SDK_OSGEARTH_MIN_VERSION_REQUIRED(1,6,0)
+  osg::ref_ptr<osgEarth::Map> map;
+  if (mapListener_.valid() && map_.lock(map))
+  {
+    map->removeMapCallback(mapListener_.get());
+    osgEarth::ElevationLayerVector layers;
+    map->getLayers(layers);
+    for (osgEarth::ElevationLayerVector::const_iterator i = layers.begin(); i != layers.end(); ++i)
+      mapListener_->unwatchLayer(i->get());
+  }
+#endif
+}
+
+void ElevationSampleCache::watchMap_(osgEarth::Map* map)
+{
+#if SDK_OSGEARTH_MIN_VERSION_REQUIRED(1,6,0)
+  map_ = map;
+  mapListener_ = new MapListener(*this);
+  osgEarth::ElevationLayerVector layers;
+  map->getLayers(layers);
+  for (osgEarth::ElevationLayerVector::const_iterator i = layers.begin(); i != layers.end(); ++i)
+    mapListener_->watchLayer(i->get());
+  map->addMapCallback(mapListener_.get());
+#endif
+}
+
+ElevationSampleCache::Key ElevationSampleCache::makeKey(double x, double y, double cellSize)
+{
+  Key key;
+  key.level = static_cast<int>(ceil(-log2(cellSize > 0.0 ? cellSize : 1.0)));
+  const double width = ldexp(1.0, -key.level);
+  key.x = static_cast<int>(floor(x / width));
+  key.y = static_cast<int>(floor(y / width));
+  return key;
+}
+
+osg::Vec2d ElevationSampleCache::cellCenter(const Key& key)
+{
+  const double width = ldexp(1.0, -key.level);
+  return osg::Vec2d((key.x + 0.5) * width, (key.y + 0.5) * width);
+}
+
+bool ElevationSampleCache::get(const Key& key, double& hamsl, double& hae) const
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  std::map<Key, Heights>::const_iterator i = samples_.find(key);
+  if (i == samples_.end())
+    return false;
+  hamsl = i->second.first;
+  hae = i->second.second;
+  return true;
+}
+
+void ElevationSampleCache::put(const Key& key, double hamsl, double hae)
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  // Flushing is cheaper to track than recency, and a full cache is refilled within a few computations
+  if (samples_.size() >= maxSamples_)
+  {
+    samples_.clear();
+    levels_.clear();
+  }
+  samples_[key] = Heights(hamsl, hae);
+  levels_.insert(key.level);
+}
+
+void ElevationSampleCache::invalidate(const osgEarth::GeoExtent& extent)
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  if (!extent.isValid() || extent.crossesAntimeridian())
+  {
+    samples_.clear();
+    levels_.clear();
+    return;
+  }
+
+  // Keys sort by level, column, then row, so each column of each level is a range search
+  for (std::set<int>::const_iterator level = levels_.begin(); level != levels_.end(); ++level)
+  {
+    const double width = ldexp(1.0, -*level);
+    Key first;
+    first.level = *level;
+    const int xFirst = static_cast<int>(floor(extent.xMin() / width - 0.5));
+    const int xLast = static_cast<int>(ceil(extent.xMax() / width - 0.5));
+    const int yFirst = static_cast<int>(floor(extent.yMin() / width - 0.5));
+    const int yLast = static_cast<int>(ceil(extent.yMax() / width - 0.5));
+    for (int x = xFirst; x <= xLast; ++x)
+    {
+      first.x = x;
+      first.y = yFirst;
+      std::map<Key, Heights>::iterator i = samples_.lower_bound(first);
+      while (i != samples_.end() && i->first.level == *level && i->first.x == x && i->first.y <= yLast)
+      {
+        const osg::Vec2d center = cellCenter(i->first);
+        if (extent.contains(center.x(), center.y()))
+          samples_.erase(i++);
+        else
+          ++i;
+      }
+    }
+  }
+}
+
+void ElevationSampleCache::clear()
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  samples_.clear();
+  levels_.clear();
+}
+
+size_t ElevationSampleCache::size() const
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+  return samples_.size();
+}
+
+osg::ref_ptr<ElevationSampleCache> ElevationSampleCache::forMap(osgEarth::Map* map)
+{
+  if (map == NULL)
+    return new ElevationSampleCache();
+
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(s_sharedCachesMutex);
+  osg::ref_ptr<ElevationSampleCache> cache;
+  osg::observer_ptr<ElevationSampleCache>& shared = s_sharedCaches[map->getUID()];
+  if (!shared.lock(cache))
+  {
+    cache = new ElevationSampleCache();
+    cache->watchMap_(map);
+    shared = cache.get();
+  }
+  return cache;
+}
+
 //----------------------------------------------------------------------------
 
 RadialLOS::Sample::Sample(double range_m, const osgEarth::GeoPoint& point)
@@ -89,7 +603,10 @@ RadialLOS::RadialLOS(const RadialLOS& rhs)
     range_resolution_(rhs.range_resolution_),
     azim_center_(rhs.azim_center_),
     fov_(rhs.fov_),
-    azim_resolution_(rhs.azim_resolution_)
+    azim_resolution_(rhs.azim_resolution_),
+    srs_(rhs.srs_),
+    cache_(rhs.cache_),
+    workerPool_(rhs.workerPool_)
 {
   //nop
 }
@@ -139,15 +656,32 @@ void RadialLOS::setAzimuthalResolution(const Angle& value)
   }
 }
 
+void RadialLOS::setElevationCache(ElevationSampleCache* cache)
+{
+  cache_ = cache;
+}
+
 bool RadialLOS::compute(osgEarth::MapNode* mapNode, const simCore::Coordinate& originCoord)
 {
   assert(mapNode != NULL);
+  const TerrainHeightSampler sampler(mapNode);
+  return compute_(mapNode->getMapSRS(), sampler, false, originCoord);
+}
+
+bool RadialLOS::compute(const osgEarth::SpatialReference* mapSRS, const HeightSampler& sampler, const simCore::Coordinate& originCoord)
+{
+  return compute_(mapSRS, sampler, true, originCoord);
+}
+
+bool RadialLOS::compute_(const osgEarth::SpatialReference* mapSRS, const HeightSampler& sampler, bool parallel, const simCore::Coordinate& originCoord)
+{
+  assert(mapSRS != NULL);
 
   // clear out existing data
   radials_.clear();
 
   // set up the localizer transforms:
-  if (!convertCoordToGeoPoint(originCoord, originMap_, mapNode->getMapSRS()))
+  if (!convertCoordToGeoPoint(originCoord, originMap_, mapSRS))
     return false;
 
   osg::Matrix local2world;
@@ -190,84 +724,33 @@ bool RadialLOS::compute(osgEarth::MapNode* mapNode, const simCore::Coordinate& o
     azimuths.push_back(azim_max_rad);
   }
 
-  simCore::CoordinateConverter cc;
+  RadialContext context;
+  context.sampler = &sampler;
+  context.cache = cache_.get();
+  context.cellSize = range_res_m / CACHE_CELLS_PER_RANGE_STEP;
+  if (mapSRS->isGeographic())
+    context.cellSize /= METERS_PER_DEGREE;
+  context.patch = NULL;
+  context.mapSRS = mapSRS;
+  context.local2world = local2world;
   simCore::Coordinate originLlaCoord;
-  cc.convert(originCoord, originLlaCoord, simCore::COORD_SYS_LLA);
-  cc.setReferenceOrigin(originLlaCoord.position());
-
-  bool validLos = false;
-  // step through the azimuthal range:
-  for (std::vector<double>::iterator i = azimuths.begin(); i != azimuths.end(); ++i)
-  {
-    double azim_rad = *i;
-    double x = sin(azim_rad);
-    double y = cos(azim_rad);
-
-    radials_.push_back(Radial(azim_rad));
-    Radial& radial = radials_.back();
-
-    // Track the highest elevation along this azimuth to check for visibility
-    double maxElev = -2 * M_PI;
-    // step through the distance range:
-    bool rangeDone = false;
-    bool lastSampleValid = false;
-    for (double range_m = range_res_m; !rangeDone; range_m += range_res_m)
-    {
-      if (range_m >= range_max_m)
-      {
-        range_m = range_max_m;
-        rangeDone = true;
-      }
+  context.cc.convert(originCoord, originLlaCoord, simCore::COORD_SYS_LLA);
+  context.cc.setReferenceOrigin(originLlaCoord.position());
+  context.originLla = originLlaCoord.position();
+  context.rangeMax = range_max_m;
+  context.rangeResolution = range_res_m;
 
-      // calculate the world point:
-      osg::Vec3d sampleWorld = osg::Vec3d(x*range_m, y*range_m, 0.0) * local2world;
+  for (std::vector<double>::const_iterator i = azimuths.begin(); i != azimuths.end(); ++i)
+    radials_.push_back(Radial(*i));
 
-      // convert to a map point
-      osgEarth::GeoPoint mapPoint;
-      mapPoint.fromWorld(mapNode->getMapSRS(), sampleWorld);
+  // Radials are independent, so sample them in parallel when the sampler allows it
+  std::vector<char> valid(radials_.size(), 0);
+  ComputeRadialTask task(context, radials_, valid);
+  const size_t samplesPerRadial = (range_res_m > 0.0) ? static_cast<size_t>(range_max_m / range_res_m) + 1 : 1;
+  runRadials_(task, radials_.size(), samplesPerRadial, parallel);
+  const bool validLos = std::find(valid.begin(), valid.end(), 1) != valid.end();
 
-      // sample the terrain at that point
-      double hamsl = 0.0, hae = 0.0;
-
-      bool ok = mapNode->getTerrain()->getHeight(mapPoint.getSRS(), mapPoint.x(), mapPoint.y(), &hamsl, &hae);
-
-      if (ok)
-      {
-        // see if the point is unobstructed.
-        mapPoint.z() = hae;
-
-        simCore::Coordinate destCoord;
-        convertGeoPointToCoord(mapPoint, destCoord, mapNode);
-
-        double elev;
-        simCore::calculateAbsAzEl(originLlaCoord.position(), destCoord.position(), NULL, &elev, NULL, simCore::FLAT_EARTH, &cc);
-
-        bool visible = false;
-        if (elev >= maxElev)
-        {
-          maxElev = elev;
-          visible = true;
-        }
-
-        radial.samples_.push_back(Sample(range_m, mapPoint, hamsl, hae, elev, visible));
-        if (!validLos)
-        {
-          // To be valid there needs to be at least two consecutive points on the same azimuth
-          if (lastSampleValid)
-            validLos = true;
-          lastSampleValid = true;
-        }
-      }
-      else
-      {
-        // record an "invalid" sample
-        radial.samples_.push_back(Sample(range_m, mapPoint));
-        lastSampleValid = false;
-      }
-    }
-  }
-
-  srs_ = mapNode->getMapSRS();
+  srs_ = mapSRS;
 
   dirty_ = false;
   return validLos;
@@ -275,83 +758,69 @@ bool RadialLOS::compute(osgEarth::MapNode* mapNode, const simCore::Coordinate& o
 
 bool RadialLOS::update(osgEarth::MapNode* mapNode, const osgEarth::GeoExtent& extent, osg::Node* patch)
 {
-  osg::Vec3d originWorld;
-  originMap_.toWorld(originWorld);
+  assert(mapNode != NULL);
+  const TerrainHeightSampler sampler(mapNode);
+  return update_(sampler, false, extent, patch);
+}
+
+bool RadialLOS::update(const HeightSampler& sampler, const osgEarth::GeoExtent& extent, osg::Node* patch)
+{
+  return update_(sampler, true, extent, patch);
+}
+
+bool RadialLOS::update_(const HeightSampler& sampler, bool parallel, const osgEarth::GeoExtent& extent, osg::Node* patch)
+{
+  // Terrain in the extent changed, so heights cached there are stale for every user of the cache
+  if (cache_.valid())
+    cache_->invalidate(extent);
 
   // NOTE:
   // if any point in the radial falls within the extent, we will have to
   // recalculate the visibility of the entire radial.
-  for (unsigned int radialIndex = 0; radialIndex < radials_.size(); ++radialIndex)
+  std::vector<size_t> indices;
+  for (size_t radialIndex = 0; radialIndex < radials_.size(); ++radialIndex)
   {
-    Radial& radial = radials_[radialIndex];
-    unsigned int firstNewSampleIndex = ~0;
-
-    for (unsigned int sampleIndex = 0; sampleIndex < radial.samples_.size(); ++sampleIndex)
-    {
-      Sample& sample = radial.samples_[sampleIndex];
-
-      if (!sample.point_.isValid() || extent.contains(sample.point_))
-      {
-        bool ok = mapNode->getTerrain()->getHeight(patch, sample.point_.getSRS(), sample.point_.x(), sample.point_.y(), &sample.hamsl_m_, &sample.hae_m_);
-
-        if (ok && firstNewSampleIndex == ~(0u))
-        {
-          firstNewSampleIndex = sampleIndex;
-        }
-      }
-    }
-
-    // if we re-sampled anything, start with the first new sample and recalculate
-    // visibility from there on out.
-    if (firstNewSampleIndex != ~(0u))
-    {
-      osg::Matrix local2world;
-      originMap_.createLocalToWorld(local2world);
-
-      osg::Vec3d originUpWorld = osg::Vec3d(0, 0, 1) * local2world;
-      originUpWorld.normalize();
-
-      double maxElev = -2 * M_PI;
-      for (unsigned int sampleIndex = 0; sampleIndex < radial.samples_.size(); ++sampleIndex)
-      {
-        Sample& sample = radial.samples_[sampleIndex];
-
-        // recalculate the elevation for all the new samples only.
-        if (sampleIndex >= firstNewSampleIndex)
-        {
-          // see if the point is unobstructed.
-          sample.point_.z() = sample.hae_m_;
-
-          simCore::Coordinate destCoord;
-          convertGeoPointToCoord(sample.point_, destCoord, mapNode);
-          simCore::Coordinate originCoord;
-          convertGeoPointToCoord(originMap_, originCoord, mapNode);
-
-          simCore::CoordinateConverter cc;
-          simCore::Coordinate originLlaCoord;
-          cc.convert(originCoord, originLlaCoord, simCore::COORD_SYS_LLA);
-          cc.setReferenceOrigin(originLlaCoord.lat(), originLlaCoord.lon(), originLlaCoord.alt());
-
-          double elev;
-          simCore::calculateAbsAzEl(originLlaCoord.position(), destCoord.position(), NULL, &elev, NULL, simCore::FLAT_EARTH, &cc);
-          sample.elev_rad_ = elev;
-        }
-
-        if (sample.elev_rad_ >= maxElev)
-        {
-          maxElev = sample.elev_rad_;
-          sample.visible_ = true;
-        }
-        else
-        {
-          sample.visible_ = false;
-        }
-      }
-    }
+    const osgEarth::GeoExtent& radialExtent = radials_[radialIndex].extent_;
+    if (!radialExtent.isValid() || radialExtent.intersects(extent))
+      indices.push_back(radialIndex);
   }
+  if (indices.empty() || !srs_.valid())
+    return true;
+
+  RadialContext context;
+  context.sampler = &sampler;
+  context.cache = cache_.get();
+  context.cellSize = range_resolution_.as(Units::METERS) / CACHE_CELLS_PER_RANGE_STEP;
+  if (srs_->isGeographic())
+    context.cellSize /= METERS_PER_DEGREE;
+  context.patch = patch;
+  context.mapSRS = srs_.get();
+  originMap_.createLocalToWorld(context.local2world);
+  simCore::Coordinate originCoord;
+  toLlaCoordinate(originMap_, originCoord);
+  context.cc.setReferenceOrigin(originCoord.lat(), originCoord.lon(), originCoord.alt());
+  context.originLla = originCoord.position();
+  context.rangeMax = range_max_.as(Units::METERS);
+  context.rangeResolution = range_resolution_.as(Units::METERS);
+
+  UpdateRadialTask task(context, extent, radials_, indices);
+  runRadials_(task, indices.size(), getNumSamplesPerRadial(), parallel);
   return true;
 }
 
+void RadialLOS::runRadials_(WorkerPool::Task& task, size_t count, size_t samplesPerRadial, bool parallel)
+{
+  if (!parallel || count < 2 || count * samplesPerRadial < MIN_PARALLEL_SAMPLES)
+  {
+    for (size_t k = 0; k < count; ++k)
+      task.run(k);
+    return;
+  }
+  if (!workerPool_.valid())
+    workerPool_ = WorkerPool::instance();
+  workerPool_->parallelFor(task, count);
+}
+
 bool RadialLOS::getMinMaxHeight(const Angle& azimuth, Distance& out_minHeight, Distance& out_maxHeight) const
 {
   // ensure the test is within the computed range
@@ -22,17 +22,95 @@
 #ifndef SIMVIS_RADIAL_LOS_H
 #define SIMVIS_RADIAL_LOS_H
 
+#include <map>
+#include <set>
+#include "OpenThreads/Mutex"
 #include "simCore/Common/Common.h"
 #include "simCore/Calc/Coordinate.h"
 #include "simVis/Types.h"
+#include "simVis/WorkerPool.h"
 #include "osgEarth/MapNode"
 #include "osgEarth/GeoData"
 #include "osgEarth/SpatialReference"
 #include "osg/Node"
+#include "osg/observer_ptr"
+#include "osg/Vec2d"
 
 namespace simVis
 {
 
+/**
+ * Thread-safe cache of terrain heights that can be shared between RadialLOS computations.
+ * Heights are stored per cell of a power-of-two grid in map coordinates, keyed by the
+ * resolution level and cell, so that computations at similar range resolutions share
+ * samples and an origin that moves slightly reuses most of its samples.  Heights are
+ * those at the cell centers, so cached results approximate exact sampling.
+ */
+class SDKVIS_EXPORT ElevationSampleCache : public osg::Referenced
+{
+public:
+  /** Cell of the sample grid at a resolution level; cells at level L are 2^-L map units wide */
+  struct SDKVIS_EXPORT Key
+  {
+    /** Resolution level */
+    int level;
+    /** Column of the cell */
+    int x;
+    /** Row of the cell */
+    int y;
+    /** Sorts by level, then column, then row */
+    bool operator<(const Key& rhs) const;
+  };
+
+  /** Constructs a cache that holds up to the given number of samples before it is flushed */
+  explicit ElevationSampleCache(size_t maxSamples = 1000000);
+
+  /** Returns the key of the cell containing (x,y) at the coarsest level no wider than cellSize */
+  static Key makeKey(double x, double y, double cellSize);
+  /** Returns the center of the cell in map coordinates */
+  static osg::Vec2d cellCenter(const Key& key);
+
+  /** Retrieves the heights cached for the cell; returns true if found */
+  bool get(const Key& key, double& hamsl, double& hae) const;
+  /** Stores the heights for the cell, flushing the cache first if it is full */
+  void put(const Key& key, double hamsl, double hae);
+  /** Discards cached cells with centers inside the extent, e.g. when a terrain tile changes */
+  void invalidate(const osgEarth::GeoExtent& extent);
+  /** Discards all cached cells */
+  void clear();
+  /** Number of cached cells */
+  size_t size() const;
+
+  /**
+   * Returns the cache shared by all users of the map.  The shared cache is cleared when an elevation
+   * layer is added to, removed from, or moved in the map, or when its visibility changes.
+   */
+  static osg::ref_ptr<ElevationSampleCache> forMap(osgEarth::Map* map);
+
+protected:
+  /** osg::Referenced-derived */
+  virtual ~ElevationSampleCache();
+
+private:
+  class MapListener;
+
+  /** Clears the cache when the elevation layers of the map change */
+  void watchMap_(osgEarth::Map* map);
+
+  /** Height above mean sea level and height above ellipsoid */
+  typedef std::pair<double, double> Heights;
+
+  mutable OpenThreads::Mutex mutex_;
+  std::map<Key, Heights> samples_;
+  /** Levels with cells in samples_, to bound invalidate() to a range search per level */
+  std::set<int> levels_;
+  size_t maxSamples_;
+  /** Map whose elevation layers are watched, if any */
+  osg::observer_ptr<osgEarth::Map> map_;
+  /** Listens for elevation layer changes in map_ */
+  osg::ref_ptr<MapListener> mapListener_;
+};
+
 /**
  * Samples the terrain in a radial pattern around an origin point.
  */
@@ -72,6 +150,27 @@ public:
     osgEarth::GeoPoint point_;
   };
 
+  /**
+   * Source of terrain heights for the computation.  Implementations are called from several
+   * threads at once and must be thread-safe.  Computations through the map node's terrain, which
+   * is not thread-safe, run on the calling thread instead.
+   */
+  class SDKVIS_EXPORT HeightSampler
+  {
+  public:
+    virtual ~HeightSampler() {}
+
+    /**
+     * Samples the terrain height at a map point
+     * @param[in ] patch Terrain tile to sample, or NULL to sample the whole terrain
+     * @param[in ] point Map point to sample; only X and Y are used
+     * @param[out] hamsl Height above mean sea level, in meters
+     * @param[out] hae Height above ellipsoid, in meters
+     * @return True upon success
+     */
+    virtual bool getHeight(osg::Node* patch, const osgEarth::GeoPoint& point, double& hamsl, double& hae) const = 0;
+  };
+
   /** Vector of Samples */
   typedef std::vector<Sample> SampleVector;
 
@@ -152,6 +251,18 @@ public:
    */
   const Angle& getAzimuthalResolution() const { return azim_resolution_; }
 
+  /**
+   * Sets the cache through which terrain heights are sampled, or NULL to sample every point exactly.
+   * With a cache, heights are sampled at the centers of cache cells an eighth of the range resolution wide.
+   * @param[in ] cache Elevation cache, which may be shared with other computations
+   */
+  void setElevationCache(ElevationSampleCache* cache);
+
+  /**
+   * Gets the elevation cache
+   * @return Elevation cache, possibly NULL
+   */
+  ElevationSampleCache* getElevationCache() const { return cache_.get(); }
 
 public:
 
@@ -163,6 +274,16 @@ public:
    */
   bool compute(osgEarth::MapNode* mapNode, const simCore::Coordinate& origin);
 
+  /**
+   * Compute the entire set of terrain samples using the current settings and a custom height source.
+   * Radials are sampled in parallel on the shared simVis::WorkerPool.
+   * @param[in ] mapSRS  Spatial reference of the map
+   * @param[in ] sampler Source of terrain heights
+   * @param[in ] origin  Origin point for the LOS computation
+   * @return True upon success
+   */
+  bool compute(const osgEarth::SpatialReference* mapSRS, const HeightSampler& sampler, const simCore::Coordinate& origin);
+
   /**
    * Re-samples the terrain for all sample points that fall within the specified extent.
    * @param[in ] mapNode Map interface to use for sampling
@@ -172,6 +293,16 @@ public:
    */
   bool update(osgEarth::MapNode* mapNode, const osgEarth::GeoExtent& extent, osg::Node* patch = NULL);
 
+  /**
+   * Re-samples the terrain from a custom height source for all sample points that fall within the specified
+   * extent.  Only radials that intersect the extent are recomputed, in parallel on the shared simVis::WorkerPool.
+   * @param[in ] sampler Source of terrain heights
+   * @param[in ] extent  Geospatial extent within which to update the samples
+   * @param patch Patch node, possibly NULL
+   * @return True upon success
+   */
+  bool update(const HeightSampler& sampler, const osgEarth::GeoExtent& extent, osg::Node* patch = NULL);
+
   /**
    * Gets the number of samples in each radial
    * @return Sample count
@@ -211,6 +342,8 @@ public:
     double       azim_rad_;
     /** Samples along the radial */
     SampleVector samples_;
+    /** Map extent of the sample points; invalid if unknown */
+    osgEarth::GeoExtent extent_;
   };
 
   /** Vector of Radial */
@@ -231,6 +364,15 @@ private:
   Angle               fov_;
   Angle               azim_resolution_;
   osg::ref_ptr<const osgEarth::SpatialReference> srs_;
+  osg::ref_ptr<ElevationSampleCache> cache_;
+  osg::ref_ptr<WorkerPool> workerPool_;
+
+  /** Implements compute(), sampling radials on the worker pool if parallel is true */
+  bool compute_(const osgEarth::SpatialReference* mapSRS, const HeightSampler& sampler, bool parallel, const simCore::Coordinate& origin);
+  /** Implements update(), sampling radials on the worker pool if parallel is true */
+  bool update_(const HeightSampler& sampler, bool parallel, const osgEarth::GeoExtent& extent, osg::Node* patch);
+  /** Runs the task for each of count radials, on the worker pool if parallel is true and there are enough samples */
+  void runRadials_(WorkerPool::Task& task, size_t count, size_t samplesPerRadial, bool parallel);
 
   bool getBoundingRadials_(double azim_rad, const Radial*& out_r0, const Radial*& out_r1, double& out_mix) const;
 
@@ -41,7 +41,8 @@ RadialLOSNode::RadialLOSNode(osgEarth::MapNode* mapNode)
     obstructedColor_(1.0f, 0.0f, 0.0f, 0.5f),
     active_(false),
     isValid_(true),
-    requireUpdateLOS_(true)
+    requireUpdateLOS_(true),
+    elevationCacheEnabled_(true)
 {
   callbackHook_ = new TerrainCallbackHook(this);
 
@@ -84,6 +85,8 @@ void RadialLOSNode::setMapNode(osgEarth::MapNode* mapNode)
   drapeable_->setMapNode(mapNode);
 #endif
 
+  applyElevationCache_();
+
   // re-apply the position
   setCoordinate(coord_);
 }
@@ -119,6 +122,7 @@ void RadialLOSNode::setDataModel(const RadialLOS& los)
     return;
 
   RadialLOS newLOS = los;
+  newLOS.setElevationCache(los_.getElevationCache());
   if (newLOS.compute(getMapNode(), coord_))
   {
     los_ = newLOS;
@@ -231,6 +235,27 @@ void RadialLOSNode::setActive(bool active)
   }
 }
 
+void RadialLOSNode::setElevationCacheEnabled(bool enabled)
+{
+  if (enabled == elevationCacheEnabled_)
+    return;
+  elevationCacheEnabled_ = enabled;
+  applyElevationCache_();
+  // Recompute, since cached heights differ slightly from exact samples
+  if (getMapNode() && updateLOS_(getMapNode(), coord_))
+    refreshGeometry_();
+}
+
+void RadialLOSNode::applyElevationCache_()
+{
+  // share terrain samples with the other LOS nodes on the same map
+  osgEarth::MapNode* mapNode = getMapNode();
+  if (elevationCacheEnabled_ && mapNode)
+    los_.setElevationCache(ElevationSampleCache::forMap(mapNode->getMap()).get());
+  else
+    los_.setElevationCache(NULL);
+}
+
 void RadialLOSNode::refreshGeometry_()
 {
   this->dirtyBound();
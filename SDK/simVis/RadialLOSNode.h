@@ -120,6 +120,18 @@ public:
   /** Returns active state of node */
   bool getActive() const { return active_; }
 
+  /**
+   * Sets whether terrain heights are shared with the other LOS nodes on the same map through an
+   * ElevationSampleCache.  On by default, so that recomputing after a small origin move reuses most
+   * samples.  The cache samples heights at the centers of cells an eighth of the range resolution
+   * wide rather than at each sample point, so results can differ slightly from uncached sampling.
+   * @param[in ] enabled True to share terrain heights, false to sample every point exactly
+   */
+  void setElevationCacheEnabled(bool enabled);
+
+  /** Returns true if terrain heights are shared through an elevation cache */
+  bool getElevationCacheEnabled() const { return elevationCacheEnabled_; }
+
 public: // GeoPositionNode
 
   /** Return the proper library name */
@@ -181,10 +193,14 @@ private:
   bool active_;
   bool isValid_;
   bool requireUpdateLOS_;
+  bool elevationCacheEnabled_;
 
   /** Rebuilds the geometry if needed when parameters change. */
   void refreshGeometry_();
 
+  /** Applies the shared elevation cache for the current map, if enabled */
+  void applyElevationCache_();
+
   // called by the terrain callback when a new tile enters the graph
   void onTileAdded_(const osgEarth::TileKey& key, osg::Node* tile);
 };
@@ -57,6 +57,7 @@
 #include "simVis/TrackHistory.h"
 #include "simVis/Utils.h"
 #include "simVis/View.h"
+#include "simVis/WorkerPool.h"
 #include "simVis/Scenario.h"
 
 #define LC "[Scenario] "
@@ -112,6 +113,10 @@ private:
   osg::observer_ptr<simVis::ScenarioManager> scenarioManager_;
 };
 
+
+/** Fewest records worth handing to a preparation thread */
+const size_t MIN_RECORDS_PER_PREPARE_BATCH = 64;
+
 }
 
 
@@ -155,6 +160,12 @@ bool ScenarioManager::EntityRecord::dataStoreMatches(const simData::DataStore* d
   return dataStore == dataStore_;
 }
 
+void ScenarioManager::EntityRecord::prepareUpdateFromDataStore(bool force) const
+{
+  if (node_.valid())
+    node_->prepareUpdateFromDataStore(updateSlice_, force);
+}
+
 bool ScenarioManager::EntityRecord::updateFromDataStore(bool force) const
 {
   return (node_.valid() && node_->updateFromDataStore(updateSlice_, force));
@@ -290,12 +301,24 @@ public:
   /** Applies coordinate surface clamping to the LLA coordinate */
   virtual PlatformTspiFilterManager::FilterResponse filter(simCore::Coordinate& llaCoord, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props)
   {
-    if (!prefs.surfaceclamping() || !coordSurfaceClamping_.isValid())
-      return PlatformTspiFilterManager::POINT_UNCHANGED;
+    PlatformTspiFilterManager::FilterResponse rv = PlatformTspiFilterManager::POINT_UNCHANGED;
+    filterBatch(&llaCoord, 1, prefs, props, &rv);
+    return rv;
+  }
 
-    coordSurfaceClamping_.clampCoordToMapSurface(llaCoord);
+  /** Applies coordinate surface clamping to all the LLA coordinates with a single map lookup */
+  virtual void filterBatch(simCore::Coordinate* llaCoords, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformTspiFilterManager::FilterResponse* responses)
+  {
+    if (!prefs.surfaceclamping() || !coordSurfaceClamping_.isValid())
+      return;
 
-    return PlatformTspiFilterManager::POINT_CHANGED;
+    // Dropped entries are clamped too; the caller ignores them
+    coordSurfaceClamping_.clampCoordsToMapSurface(llaCoords, count);
+    for (size_t k = 0; k < count; ++k)
+    {
+      if (responses[k] != PlatformTspiFilterManager::POINT_DROPPED)
+        responses[k] = PlatformTspiFilterManager::POINT_CHANGED;
+    }
   }
 
   /** Sets the map pointer, required for proper clamping */
@@ -332,20 +355,35 @@ public:
   /** Applies coordinate surface clamping to the LLA coordinate */
   virtual PlatformTspiFilterManager::FilterResponse filter(simCore::Coordinate& llaCoord, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props)
   {
-    if (!prefs.abovesurfaceclamping() || !mapNode_.valid())
-      return PlatformTspiFilterManager::POINT_UNCHANGED;
+    PlatformTspiFilterManager::FilterResponse rv = PlatformTspiFilterManager::POINT_UNCHANGED;
+    filterBatch(&llaCoord, 1, prefs, props, &rv);
+    return rv;
+  }
+
+  /** Applies coordinate surface clamping to all the LLA coordinates with a single map lookup */
+  virtual void filterBatch(simCore::Coordinate* llaCoords, size_t count, const simData::PlatformPrefs& prefs, const simData::PlatformProperties& props, PlatformTspiFilterManager::FilterResponse* responses)
+  {
+    osg::ref_ptr<const osgEarth::MapNode> mapNode;
+    if (!prefs.abovesurfaceclamping() || !mapNode_.lock(mapNode))
+      return;
 
-    double hamsl;  // Not used
-    double terrainHeightHae = 0.0; // height above ellipsoid, the rough elevation
-    mapNode_->getTerrain()->getHeight(mapNode_->getMapSRS(), llaCoord.lon()*simCore::RAD2DEG, llaCoord.lat()*simCore::RAD2DEG, &hamsl, &terrainHeightHae);
-    // If getHeight() fails, terrainHeightHae will have 0.0 (our intended fallback)
-    if (llaCoord.alt() < terrainHeightHae)
+    const osgEarth::Terrain* terrain = mapNode->getTerrain();
+    const osgEarth::SpatialReference* mapSrs = mapNode->getMapSRS();
+    for (size_t k = 0; k < count; ++k)
     {
-      llaCoord.setPositionLLA(llaCoord.lat(), llaCoord.lon(), terrainHeightHae);
-      return PlatformTspiFilterManager::POINT_CHANGED;
+      if (responses[k] == PlatformTspiFilterManager::POINT_DROPPED)
+        continue;
+      simCore::Coordinate& llaCoord = llaCoords[k];
+      double hamsl;  // Not used
+      double terrainHeightHae = 0.0; // height above ellipsoid, the rough elevation
+      terrain->getHeight(mapSrs, llaCoord.lon()*simCore::RAD2DEG, llaCoord.lat()*simCore::RAD2DEG, &hamsl, &terrainHeightHae);
+      // If getHeight() fails, terrainHeightHae will have 0.0 (our intended fallback)
+      if (llaCoord.alt() < terrainHeightHae)
+      {
+        llaCoord.setPositionLLA(llaCoord.lat(), llaCoord.lon(), terrainHeightHae);
+        responses[k] = PlatformTspiFilterManager::POINT_CHANGED;
+      }
     }
-
-    return PlatformTspiFilterManager::POINT_UNCHANGED;
   }
 
   /** Sets the map pointer, required for proper clamping */
@@ -360,6 +398,34 @@ private:
 
 // -----------------------------------------------------------------------
 
+/** Runs the preparation phase of the update, one contiguous batch of records per item */
+class ScenarioManager::PrepareUpdateTask : public WorkerPool::Task
+{
+public:
+  PrepareUpdateTask(const std::vector<EntityRecord*>& records, size_t numBatches, bool force)
+    : records_(records),
+      numBatches_(numBatches),
+      force_(force)
+  {
+  }
+
+  /** Prepares one batch of records; called on a pool thread, or on the update thread */
+  virtual void run(size_t index)
+  {
+    const size_t begin = records_.size() * index / numBatches_;
+    const size_t end = records_.size() * (index + 1) / numBatches_;
+    for (size_t k = begin; k < end; ++k)
+      records_[k]->prepareUpdateFromDataStore(force_);
+  }
+
+private:
+  const std::vector<EntityRecord*>& records_;
+  size_t numBatches_;
+  bool force_;
+};
+
+// -----------------------------------------------------------------------
+
 class ScenarioManager::ScenarioLosCreator : public LosCreator
 {
 public:
@@ -389,6 +455,45 @@ private:
 
 // -----------------------------------------------------------------------
 
+/** Bumps the entity revision when an entity's locator changes, including changes inherited from a host */
+class ScenarioManager::EntityRevisionCallback : public LocatorCallback
+{
+public:
+  EntityRevisionCallback(ScenarioManager* scenario, Locator* locator)
+    : scenario_(scenario),
+      locator_(locator)
+  {
+    if (locator)
+      locator->addCallback(this);
+  }
+
+  /** Removes the callback from the locator; the scenario is no longer notified */
+  void detach()
+  {
+    scenario_ = NULL;
+    osg::ref_ptr<Locator> locator;
+    if (locator_.lock(locator))
+      locator->removeCallback(this);
+  }
+
+  virtual void operator()(const Locator* locator)
+  {
+    if (scenario_)
+      ++scenario_->entityRevision_;
+  }
+
+protected:
+  virtual ~EntityRevisionCallback()
+  {
+  }
+
+private:
+  ScenarioManager* scenario_;
+  osg::observer_ptr<Locator> locator_;
+};
+
+// -----------------------------------------------------------------------
+
 ScenarioManager::ScenarioManager(LocatorFactory* factory, ProjectorManager* projMan)
   : locatorFactory_(factory),
   platformTspiFilterManager_(new PlatformTspiFilterManager()),
@@ -400,7 +505,11 @@ ScenarioManager::ScenarioManager(LocatorFactory* factory, ProjectorManager* proj
   projectorManager_(projMan),
   labelContentManager_(new NullLabelContentManager()),
   rfManager_(new simRF::NullRFPropagationManager()),
-  losCreator_(new ScenarioLosCreator())
+  losCreator_(new ScenarioLosCreator()),
+  pendingFullUpdate_(true),
+  lastUpdateVisitCount_(0),
+  lastUpdateChangeCount_(0),
+  entityRevision_(0)
 {
   root_->setName("root");
   root_->addChild(entityGraph_->node());
@@ -458,6 +567,10 @@ ScenarioManager::~ScenarioManager()
   losCreator_ = NULL;
   // guarantee that ScenarioTools receive OnUninstall() calls
   removeAllTools_();
+
+  for (std::map<simData::ObjectId, osg::ref_ptr<EntityRevisionCallback> >::const_iterator i = revisionCallbacks_.begin(); i != revisionCallbacks_.end(); ++i)
+    i->second->detach();
+  revisionCallbacks_.clear();
 }
 
 void ScenarioManager::bind(simData::DataStore* dataStore)
@@ -506,6 +619,7 @@ void ScenarioManager::flush(simData::ObjectId flushedId)
   // if id 0, flush entire scenario
   if (flushedId == 0)
   {
+    pendingFullUpdate_ = true;
     for (EntityRepo::const_iterator i = entities_.begin(); i != entities_.end(); ++i)
     {
       const EntityRecord* record = i->second.get();
@@ -517,6 +631,9 @@ void ScenarioManager::flush(simData::ObjectId flushedId)
     EntityNode* entity = find(flushedId);
     if (entity)
       entity->flush();
+    // flushed entities apply their changes on the next update, as do hosted entities that may see the host go inactive
+    pendingIds_.insert(flushedId);
+    addHostedIds_(flushedId, pendingIds_);
   }
   SAFETRYEND("flushing scenario entities");
 }
@@ -542,8 +659,12 @@ void ScenarioManager::clearEntities(simData::DataStore* dataStore)
           // remove it from the scene graph:
           entityGraph_->removeEntity(record);
 
+          pendingIds_.erase(i->first);
+          alwaysUpdateIds_.erase(i->first);
+          unwatchEntity_(i->first);
           // remove it from the entities list (works because EntityRepo is a map, will not work for vector)
           entities_.erase(i++);
+          ++entityRevision_;
         }
         else
         {
@@ -558,7 +679,13 @@ void ScenarioManager::clearEntities(simData::DataStore* dataStore)
     // just remove everything.
     entityGraph_->clear();
     entities_.clear();
+    pendingIds_.clear();
+    alwaysUpdateIds_.clear();
+    for (std::map<simData::ObjectId, osg::ref_ptr<EntityRevisionCallback> >::const_iterator i = revisionCallbacks_.begin(); i != revisionCallbacks_.end(); ++i)
+      i->second->detach();
+    revisionCallbacks_.clear();
     projectorManager_->clear();
+    ++entityRevision_;
   }
   SAFETRYEND("clearing scenario entities");
 }
@@ -583,6 +710,10 @@ void ScenarioManager::removeEntity(simData::ObjectId id)
 
     // remove it from the entities list
     entities_.erase(i);
+    pendingIds_.erase(id);
+    alwaysUpdateIds_.erase(id);
+    unwatchEntity_(id);
+    ++entityRevision_;
   }
   SAFETRYEND("removing entity from scenario");
 }
@@ -643,9 +774,11 @@ PlatformNode* ScenarioManager::addPlatform(const simData::PlatformProperties& pr
     node,
     dataStore.platformUpdateSlice(node->getId()),
     &dataStore);
+  pendingIds_.insert(node->getId());
 
   node->setLosCreator(losCreator_);
 
+  watchEntity_(node);
   notifyToolsOfAdd_(node);
 
   node->setLabelContentCallback(labelContentManager_->createLabelContentCallback(node->getId()));
@@ -673,6 +806,7 @@ BeamNode* ScenarioManager::addBeam(const simData::BeamProperties& props, simData
     node,
     dataStore.beamUpdateSlice(node->getId()),
     &dataStore);
+  pendingIds_.insert(node->getId());
 
   if (host)
   {
@@ -680,6 +814,7 @@ BeamNode* ScenarioManager::addBeam(const simData::BeamProperties& props, simData
     node->setHostMissileOffset(host->getFrontOffset());
   }
 
+  watchEntity_(node);
   notifyToolsOfAdd_(node);
 
   node->setLabelContentCallback(labelContentManager_->createLabelContentCallback(node->getId()));
@@ -711,10 +846,12 @@ GateNode* ScenarioManager::addGate(const simData::GateProperties& props, simData
     node,
     dataStore.gateUpdateSlice(node->getId()),
     &dataStore);
+  pendingIds_.insert(node->getId());
 
   if (host)
     hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
 
+  watchEntity_(node);
   notifyToolsOfAdd_(node);
 
   node->setLabelContentCallback(labelContentManager_->createLabelContentCallback(node->getId()));
@@ -740,10 +877,12 @@ LaserNode* ScenarioManager::addLaser(const simData::LaserProperties& props, simD
     node,
     dataStore.laserUpdateSlice(node->getId()),
     &dataStore);
+  pendingIds_.insert(node->getId());
 
   if (host)
     hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
 
+  watchEntity_(node);
   notifyToolsOfAdd_(node);
 
   node->setLabelContentCallback(labelContentManager_->createLabelContentCallback(node->getId()));
@@ -771,9 +910,13 @@ LobGroupNode* ScenarioManager::addLobGroup(const simData::LobGroupProperties& pr
     node,
     dataStore.lobGroupUpdateSlice(node->getId()),
     &dataStore);
+  pendingIds_.insert(node->getId());
+  // LOB flash state comes from a data table and can change without a change to the update slice
+  alwaysUpdateIds_.insert(node->getId());
 
   hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
 
+  watchEntity_(node);
   notifyToolsOfAdd_(node);
 
   node->setLabelContentCallback(labelContentManager_->createLabelContentCallback(node->getId()));
@@ -801,9 +944,13 @@ CustomRenderingNode* ScenarioManager::addCustomRendering(const simData::CustomRe
     node,
     NULL,
     &dataStore);
+  pendingIds_.insert(node->getId());
+  // custom rendering callbacks decide for themselves when there is an update to apply
+  alwaysUpdateIds_.insert(node->getId());
 
   hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
 
+  watchEntity_(node);
   notifyToolsOfAdd_(node);
 
   node->setLabelContentCallback(labelContentManager_->createLabelContentCallback(node->getId()));
@@ -828,12 +975,14 @@ ProjectorNode* ScenarioManager::addProjector(const simData::ProjectorProperties&
     node,
     dataStore.projectorUpdateSlice(node->getId()),
     &dataStore);
+  pendingIds_.insert(node->getId());
 
   if (host)
     hosterTable_.insert(std::make_pair(host->getId(), node->getId()));
 
   projectorManager_->registerProjector(node);
 
+  watchEntity_(node);
   notifyToolsOfAdd_(node);
 
   node->setLabelContentCallback(labelContentManager_->createLabelContentCallback(node->getId()));
@@ -851,6 +1000,7 @@ bool ScenarioManager::setPlatformPrefs(simData::ObjectId id, const simData::Plat
   {
     // Note that this may trigger the Beam Nose Fixer indirectly
     platform->setPrefs(prefs);
+    prefsChanged_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting platform prefs of ID " << id));
@@ -864,6 +1014,7 @@ bool ScenarioManager::setBeamPrefs(simData::ObjectId id, const simData::BeamPref
   if (beam)
   {
     beam->setPrefs(prefs);
+    prefsChanged_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting beam prefs of ID " << id));
@@ -877,6 +1028,7 @@ bool ScenarioManager::setGatePrefs(simData::ObjectId id, const simData::GatePref
   if (gate)
   {
     gate->setPrefs(prefs);
+    prefsChanged_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting gate prefs of ID " << id));
@@ -890,6 +1042,7 @@ bool ScenarioManager::setProjectorPrefs(simData::ObjectId id, const simData::Pro
   if (proj)
   {
     proj->setPrefs(prefs);
+    prefsChanged_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting projector prefs of ID " << id));
@@ -903,6 +1056,7 @@ bool ScenarioManager::setLaserPrefs(simData::ObjectId id, const simData::LaserPr
   if (obj)
   {
     obj->setPrefs(prefs);
+    prefsChanged_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting laser prefs of ID " << id));
@@ -916,6 +1070,7 @@ bool ScenarioManager::setLobGroupPrefs(simData::ObjectId id, const simData::LobG
   if (obj)
   {
     obj->setPrefs(prefs);
+    prefsChanged_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting LOB group prefs of ID " << id));
@@ -929,6 +1084,7 @@ bool ScenarioManager::setCustomRenderingPrefs(simData::ObjectId id, const simDat
   if (obj)
   {
     obj->setPrefs(prefs);
+    prefsChanged_(id);
     return true;
   }
   SAFETRYEND(std::string(osgEarth::Stringify() << "setting custom prefs of ID " << id));
@@ -1148,6 +1304,22 @@ void ScenarioManager::getTools(std::vector< osg::ref_ptr<ScenarioTool> >& tools)
   SAFETRYEND("retrieving scenario tools")
 }
 
+void ScenarioManager::watchEntity_(EntityNode* node)
+{
+  unwatchEntity_(node->getId());
+  revisionCallbacks_[node->getId()] = new EntityRevisionCallback(this, node->getLocator());
+  ++entityRevision_;
+}
+
+void ScenarioManager::unwatchEntity_(simData::ObjectId id)
+{
+  std::map<simData::ObjectId, osg::ref_ptr<EntityRevisionCallback> >::iterator i = revisionCallbacks_.find(id);
+  if (i == revisionCallbacks_.end())
+    return;
+  i->second->detach();
+  revisionCallbacks_.erase(i);
+}
+
 void ScenarioManager::notifyToolsOfAdd_(EntityNode* node)
 {
   for (ScenarioToolVector::iterator i = scenarioTools_.begin(); i != scenarioTools_.end(); ++i)
@@ -1164,28 +1336,118 @@ void ScenarioManager::notifyToolsOfRemove_(EntityNode* node)
   }
 }
 
+void ScenarioManager::prepareRecords_(const std::vector<EntityRecord*>& records, bool force)
+{
+  if (records.size() < 2 * MIN_RECORDS_PER_PREPARE_BATCH)
+  {
+    // Not worth waking threads for a handful of records
+    for (std::vector<EntityRecord*>::const_iterator i = records.begin(); i != records.end(); ++i)
+      (*i)->prepareUpdateFromDataStore(force);
+    return;
+  }
+
+  if (!workerPool_.valid())
+    workerPool_ = WorkerPool::instance();
+  // One batch per pool thread, plus one for this thread; parallelFor() waits for every claimed
+  // batch even if one throws, so no thread touches the records after this returns
+  const size_t numBatches = std::min<size_t>(workerPool_->threadCount() + 1, records.size() / MIN_RECORDS_PER_PREPARE_BATCH);
+  PrepareUpdateTask task(records, numBatches, force);
+  workerPool_->parallelFor(task, numBatches);
+}
+
+void ScenarioManager::updateRecord_(EntityRecord* record, bool force, EntityVector& updates)
+{
+  ++lastUpdateVisitCount_;
+  // Note that entity classes decide how to process 'force' and record->updateSlice_->hasChanged()
+  if (record->updateFromDataStore(force))
+  {
+    updates.push_back(record->getEntityNode());
+    entityGraph_->addOrUpdate(record);
+  }
+}
+
+void ScenarioManager::addHostedIds_(simData::ObjectId hostId, std::set<simData::ObjectId>& ids) const
+{
+  std::pair< HosterTable::const_iterator, HosterTable::const_iterator > range =
+    hosterTable_.equal_range(hostId);
+  for (HosterTable::const_iterator i = range.first; i != range.second; ++i)
+  {
+    // Gates are hosted by beams, so recurse into the hostees
+    ids.insert(i->second);
+    addHostedIds_(i->second, ids);
+  }
+}
+
+void ScenarioManager::requestUpdate(simData::ObjectId id)
+{
+  pendingIds_.insert(id);
+  addHostedIds_(id, pendingIds_);
+}
+
+void ScenarioManager::prefsChanged_(simData::ObjectId id)
+{
+  // Prefs changes can require an update even if the update slice is unchanged, e.g. a clamping change
+  requestUpdate(id);
+}
+
 void ScenarioManager::update(simData::DataStore* ds, bool force)
 {
   EntityVector updates;
+  lastUpdateVisitCount_ = 0;
 
   SAFETRYBEGIN;
-  for (EntityRepo::const_iterator i = entities_.begin(); i != entities_.end(); ++i)
+  std::vector<EntityRecord*> records;
+  if (force || pendingFullUpdate_)
   {
-    EntityRecord* record = i->second.get();
-
-    bool appliedUpdate = false;
+    records.reserve(entities_.size());
+    for (EntityRepo::const_iterator i = entities_.begin(); i != entities_.end(); ++i)
+      records.push_back(i->second.get());
+    pendingFullUpdate_ = false;
+    pendingIds_.clear();
+  }
+  else
+  {
+    // Visit only entities whose slices, generic data, or category data changed, the entities
+    // they host (which react to host activation changes), new, flushed, or otherwise changed
+    // entities, and those that always update.  Labels refresh when their entity is visited.
+    simData::DataStore::IdList changedIds;
+    ds->changedIdList(&changedIds);
+    std::set<simData::ObjectId> visitIds;
+    visitIds.swap(pendingIds_);
+    visitIds.insert(alwaysUpdateIds_.begin(), alwaysUpdateIds_.end());
+    for (simData::DataStore::IdList::const_iterator i = changedIds.begin(); i != changedIds.end(); ++i)
+    {
+      EntityRepo::const_iterator record = entities_.find(*i);
+      if (record == entities_.end() || !record->second->dataStoreMatches(ds))
+        continue;
+      visitIds.insert(*i);
+      addHostedIds_(*i, visitIds);
+    }
 
-    // Note that entity classes decide how to process 'force' and record->updateSlice_->hasChanged()
-    if (record->updateFromDataStore(force))
+    // Sets are ordered, so records are visited in the same ID order as a full scan
+    records.reserve(visitIds.size());
+    for (std::set<simData::ObjectId>::const_iterator i = visitIds.begin(); i != visitIds.end(); ++i)
     {
-      updates.push_back(record->getEntityNode());
-      appliedUpdate = true;
+      EntityRepo::const_iterator record = entities_.find(*i);
+      if (record != entities_.end())
+        records.push_back(record->second.get());
     }
+  }
 
-    if (appliedUpdate)
-      entityGraph_->addOrUpdate(record);
+  // Compute in parallel what does not depend on the scene graph, then apply serially in ID order
+  prepareRecords_(records, force);
+  for (std::vector<EntityRecord*>::const_iterator i = records.begin(); i != records.end(); ++i)
+  {
+    updateRecord_(*i, force, updates);
+    // Keep visiting entities that still require a forced update
+    const EntityNode* node = (*i)->getEntityNode();
+    if (node->isUpdateForced())
+      pendingIds_.insert(node->getId());
   }
   SAFETRYEND("checking scenario for updates");
+  lastUpdateChangeCount_ = static_cast<unsigned int>(updates.size());
+  if (!updates.empty())
+    ++entityRevision_;
 
   //if ( updated > 0 )
   //  SIM_INFO << LC << "Updated " << updated << std::endl;
@@ -1216,6 +1478,21 @@ void ScenarioManager::update(simData::DataStore* ds, bool force)
   }
 }
 
+unsigned int ScenarioManager::lastUpdateVisitCount() const
+{
+  return lastUpdateVisitCount_;
+}
+
+unsigned int ScenarioManager::lastUpdateChangeCount() const
+{
+  return lastUpdateChangeCount_;
+}
+
+unsigned int ScenarioManager::entityRevision() const
+{
+  return entityRevision_;
+}
+
 void ScenarioManager::removeAllTools_()
 {
   std::vector< osg::ref_ptr<ScenarioTool> > scenarioTools;
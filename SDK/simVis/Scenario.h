@@ -56,6 +56,7 @@ class PlatformTspiFilterManager;
 class ProjectorManager;
 class ProjectorNode;
 class ScenarioTool;
+class WorkerPool;
 
 /** Settings to configure the scenario manager for large numbers of entities */
 class ScenarioDisplayHints
@@ -414,6 +415,26 @@ public:
   /** Called internally when the platform size changes, to notify the beam so it can adjust to actual/visual size */
   void notifyBeamsOfNewHostSize(const PlatformNode& platform) const;
 
+  /**
+   * Visits the entity and the entities it hosts on the next update(), even if their update slices have
+   * not changed.  Use this when a change outside the update slice, such as to the entity name, can
+   * change how the entity is drawn.  Labels refresh only when their entity is visited, so a label
+   * content callback that reads other data, such as data tables, calls this when that data changes.
+   * @param id Entity to visit
+   */
+  void requestUpdate(simData::ObjectId id);
+
+  /** Number of entity records examined by the most recent update(); for profiling */
+  unsigned int lastUpdateVisitCount() const;
+  /** Number of entity records that applied an update in the most recent update(); for profiling */
+  unsigned int lastUpdateChangeCount() const;
+  /**
+   * Counter that changes whenever an entity is added, removed, or changed by update(), or an entity's
+   * locator changes for any reason.  Compare against a saved value to tell whether state derived
+   * from entity positions is stale.
+   */
+  unsigned int entityRevision() const;
+
   /** Return the proper library name */
   virtual const char* libraryName() const { return "simVis"; }
 
@@ -457,6 +478,8 @@ protected:
 
 protected:
   class ScenarioLosCreator;
+  class PrepareUpdateTask;
+  class EntityRevisionCallback;
   class SurfaceClamping;
   class AboveSurfaceClamping;
 
@@ -507,6 +530,8 @@ protected:
 
     /** Returns true if the data store passed in is the same as the entity's data store */
     bool dataStoreMatches(const simData::DataStore* dataStore) const;
+    /** Runs the entity's preparation phase of updateFromDataStore(); may be called on a worker thread */
+    void prepareUpdateFromDataStore(bool force) const;
     /** Updates the entity from the data store.  Returns true if update was applied, false otherwise */
     bool updateFromDataStore(bool force) const;
 
@@ -530,15 +555,44 @@ protected:
   /** Maps the hoster to the hostee, for hosted entity types */
   HosterTable hosterTable_;
 
+  /** Records to visit on the next update() regardless of data store changes, such as new or flushed entities */
+  std::set<simData::ObjectId> pendingIds_;
+  /** Records to visit on every update(), because their state depends on more than their update slice */
+  std::set<simData::ObjectId> alwaysUpdateIds_;
+  /** Set when the whole scenario is flushed; the next update() visits every record */
+  bool pendingFullUpdate_;
+  /** Number of records visited by the last update() */
+  unsigned int lastUpdateVisitCount_;
+  /** Number of records that applied an update in the last update() */
+  unsigned int lastUpdateChangeCount_;
+  /** Incremented when entities are added, removed, or changed, or when an entity locator changes */
+  unsigned int entityRevision_;
+  /** Watches each entity's locator for changes made outside of update(), such as clamping, offsets, or a moving host */
+  std::map<simData::ObjectId, osg::ref_ptr<EntityRevisionCallback> > revisionCallbacks_;
+  /** Shared threads that prepare entity updates in parallel, acquired on the first large update */
+  osg::ref_ptr<WorkerPool> workerPool_;
+
   /** Maintains a list of scenario tools, like Range Tool */
   ScenarioToolVector scenarioTools_;
   /** Currently unused revision */
   osgEarth::Revision scenarioToolRev_;
 
+  /// starts tracking changes to the entity's locator, bumping the entity revision
+  void watchEntity_(EntityNode* node);
+  /// stops tracking changes to the entity's locator
+  void unwatchEntity_(simData::ObjectId id);
   /// informs the scenario tools of an entity addition
   void notifyToolsOfAdd_(EntityNode* node);
   /// informs the scenario tools of an entity removal
   void notifyToolsOfRemove_(EntityNode* node);
+  /// adds the IDs of entities hosted by 'hostId', recursively, to 'ids'
+  void addHostedIds_(simData::ObjectId hostId, std::set<simData::ObjectId>& ids) const;
+  /// queues the entity and its hostees for the next update after a prefs change
+  void prefsChanged_(simData::ObjectId id);
+  /// runs the preparation phase of the update for all records, in parallel when there are enough of them
+  void prepareRecords_(const std::vector<EntityRecord*>& records, bool force);
+  /// applies the data store update to the record, appending to 'updates' if anything changed
+  void updateRecord_(EntityRecord* record, bool force, EntityVector& updates);
 
 private:
   /// Copy constructor, not implemented or available.
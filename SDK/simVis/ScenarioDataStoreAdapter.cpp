@@ -22,6 +22,7 @@
 #include "simNotify/Notify.h"
 #include "simCore/Time/Clock.h"
 #include "simVis/ScenarioDataStoreAdapter.h"
+#include "simVis/LabelContentCache.h"
 #include "simVis/LobGroup.h"
 #include "simVis/Scenario.h"
 
@@ -94,13 +95,19 @@ public:
   /// something has changed in the entity category data
   virtual void onCategoryDataChange(simData::DataStore *source, simData::ObjectId changedId, simData::ObjectType ot)
   {
-    // category data has no effect on visualization
+    // only label content that shows category data reads it
+    EntityNode* node = scenarioManager_->find(changedId);
+    if (node)
+      node->labelContentCache().invalidateCategoryData();
+    scenarioManager_->requestUpdate(changedId);
   }
 
   /// entity name has changed
   virtual void onNameChange(simData::DataStore *source, simData::ObjectId changeId)
   {
-    // already handled by the prefs change notification
+    // the prefs change notification applies the new name; the label content can also depend on the name
+    invalidateLabelContent_(changeId);
+    scenarioManager_->requestUpdate(changeId);
   }
 
   /// entity's data was flushed, 0 means entire scenario was flushed
@@ -116,6 +123,14 @@ public:
   }
 
 private: // methods
+  /// Discards the cached label content of the entity, for changes that are not in its prefs or updates
+  void invalidateLabelContent_(simData::ObjectId id) const
+  {
+    EntityNode* node = scenarioManager_->find(id);
+    if (node)
+      node->labelContentCache().invalidate();
+  }
+
   void addPlatform_(simData::DataStore &ds, simData::ObjectId newId) const
   {
     simData::PlatformProperties props;
@@ -19,6 +19,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <cassert>
 #include "osg/Geode"
 #include "osg/Geometry"
@@ -81,6 +82,7 @@ bool TrackChunkNode::addPoint(const osg::Matrix& matrix, double t, const osg::Ve
 
   // resolve the localized point and append it to the various geometries.
   append_(matrix, color, hostBounds);
+  dirtyPoints_();
 
   // advance the counter and update the psets.
   count_++;
@@ -89,6 +91,32 @@ bool TrackChunkNode::addPoint(const osg::Matrix& matrix, double t, const osg::Ve
   return true;
 }
 
+unsigned int TrackChunkNode::addPoints(const Point* points, unsigned int numPoints, const osg::Vec2& hostBounds)
+{
+  const unsigned int room = isFull() ? 0 : maxSize_ - (offset_ + count_);
+  const unsigned int toAdd = std::min(room, numPoints);
+  if (toAdd == 0)
+    return 0;
+
+  // if this is the first point added, set up the localization matrix.
+  if (offset_ == 0 && count_ == 0)
+  {
+    world2local_.invert(points[0].matrix);
+    this->setMatrix(points[0].matrix);
+  }
+
+  for (unsigned int k = 0; k < toAdd; ++k)
+  {
+    times_[offset_ + count_] = points[k].time;
+    // ribbon mode connects to the previous point, so count_ must advance with each append
+    append_(points[k].matrix, points[k].color, hostBounds);
+    count_++;
+  }
+  dirtyPoints_();
+  updatePrimitiveSets_();
+  return toAdd;
+}
+
 bool TrackChunkNode::getNewestData(osg::Matrix& out_matrix, double& out_time) const
 {
   if (count_ == 0)
@@ -119,11 +147,9 @@ bool TrackChunkNode::removeOldestPoint()
 unsigned int TrackChunkNode::removePointsBefore(double t)
 {
   const unsigned int origOffset = offset_;
-  while (count_ > 0 && times_[offset_] < t)
-  {
-    offset_++;
-    count_--;
-  }
+  const unsigned int numOlder = lowerBound_(t);
+  offset_ += numOlder;
+  count_ -= numOlder;
 
   if (origOffset != offset_)
   {
@@ -229,10 +255,7 @@ bool TrackChunkNode::isEmpty_() const
 unsigned int TrackChunkNode::removePointsAtAndBeyond_(double t)
 {
   const unsigned int origCount = count_;
-  while (count_ > 0 && times_[offset_+count_-1] >= t)
-  {
-    count_--;
-  }
+  count_ = lowerBound_(t);
 
   if (origCount != count_)
   {
@@ -257,11 +280,8 @@ void TrackChunkNode::append_(const osg::Matrix& matrix, const osg::Vec4& color,
     // and update the center points track as well:
     osg::Vec3Array& centerPointsVerts = static_cast<osg::Vec3Array&>(*centerPoints_->getVertexArray());
     centerPointsVerts[i] = local;
-    centerPointsVerts.dirty();
     osg::Vec4Array& centerPointsColors = static_cast<osg::Vec4Array&>(*centerPoints_->getColorArray());
     centerPointsColors[i] = color;
-    centerPointsColors.dirty();
-    centerPoints_->dirtyBound();
     return;
   }
 
@@ -309,6 +329,22 @@ void TrackChunkNode::append_(const osg::Matrix& matrix, const osg::Vec4& color,
   }
 }
 
+void TrackChunkNode::dirtyPoints_()
+{
+  if (mode_ != simData::TrackPrefs_Mode_POINT)
+    return;
+  centerPoints_->getVertexArray()->dirty();
+  centerPoints_->getColorArray()->dirty();
+  centerPoints_->dirtyBound();
+}
+
+unsigned int TrackChunkNode::lowerBound_(double t) const
+{
+  // points are added in increasing time order, so the active times are sorted
+  const std::vector<double>::const_iterator begin = times_.begin() + offset_;
+  return static_cast<unsigned int>(std::lower_bound(begin, begin + count_, t) - begin);
+}
+
 /// update the offset and count on each primitive set to draw the proper data.
 void TrackChunkNode::updatePrimitiveSets_()
 {
@@ -59,6 +59,14 @@ namespace simVis
   class TrackChunkNode : public osg::MatrixTransform
   {
   public:
+    /** Position, time, and color of a single track history point */
+    struct Point
+    {
+      osg::Matrix matrix;  ///< position matrix that corresponds to the platform update position
+      double time;         ///< draw time that corresponds to the platform update
+      osg::Vec4 color;     ///< color of the point
+    };
+
     /**
     * Create a new chunk with a maximum size
     * @param maxSize maximum chunk size, in points
@@ -89,6 +97,16 @@ namespace simVis
     */
     bool addPoint(const osg::Matrix& matrix, double t, const osg::Vec4& color, const osg::Vec2& hostBounds);
 
+    /**
+    * Add a run of points to the chunk, stopping when the chunk is full.  Equivalent to calling
+    * addPoint() for each, but updates the primitive sets and buffers once for the whole run.
+    * @param points points to add, in increasing time order
+    * @param numPoints number of points to add
+    * @param hostBounds left and right boundaries of the host model
+    * @return number of points added
+    */
+    unsigned int addPoints(const Point* points, unsigned int numPoints, const osg::Vec2& hostBounds);
+
     /**
     * Get the matrix and time associated with the newest point in this chunk
     * @param out_matrix position matrix for the newest point in the chunk
@@ -138,9 +156,15 @@ namespace simVis
     /// Remove all the points in this chunk that occur after the timestamp
     unsigned int removePointsAtAndBeyond_(double t);
 
-    /// Appends a new local point to each geometry set.
+    /// Appends a new local point to each geometry set; call dirtyPoints_() once done appending.
     void append_(const osg::Matrix& matrix, const osg::Vec4& color, const osg::Vec2& hostBounds);
 
+    /// Marks the point mode arrays dirty after appending
+    void dirtyPoints_();
+
+    /// Index of the first point at or after time t, among the active points
+    unsigned int lowerBound_(double t) const;
+
     /// Update the offset and count on each primitive set to draw the proper data.
     void updatePrimitiveSets_();
 
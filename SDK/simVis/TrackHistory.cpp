@@ -278,54 +278,68 @@ double TrackHistoryNode::toDrawTime_(double updateTime) const
   return updateTime * timeDirectionSign_;
 }
 
-// update the track given a new host update.
-void TrackHistoryNode::addUpdate_(const simData::PlatformUpdate& u, const simData::PlatformUpdate* prevUpdate)
+bool TrackHistoryNode::makePoint_(const simData::PlatformUpdate& u, TrackChunkNode::Point& point)
 {
-  osg::Matrix hostMatrix;
-  if (!getMatrix_(u, hostMatrix))
-    return;
+  if (!getMatrix_(u, point.matrix))
+    return false;
+  point.time = toDrawTime_(u.time());
+  point.color = historyColorAtTime_(point.time);
+  return true;
+}
 
-  // get a chunk to which to add the new point, creating a new one if necessary
-  TrackChunkNode* chunk = getCurrentChunk_();
-  if (!chunk)
-  {
-    // allocate a new chunk
-    chunk = new TrackChunkNode(chunkSize_, locator_->getSRS(), lastPlatformPrefs_.trackprefs().trackdrawmode());
+void TrackHistoryNode::setPoint_(const simData::PlatformUpdate& filtered, TrackChunkNode::Point& point)
+{
+  toMatrix_(filtered, point.matrix);
+  point.time = toDrawTime_(filtered.time());
+  point.color = historyColorAtTime_(point.time);
+}
 
-    // if there is a preceding chunk, duplicate its last point so there is no
-    // discontinuity from previous chunk to this new chunk - this matters for line, bridge drawing modes
-    int numc = chunkGroup_->getNumChildren();
-    if (numc > 0 && prevUpdate != NULL)
+void TrackHistoryNode::addPoints_(const std::vector<TrackChunkNode::Point>& points, const std::vector<bool>& followsPrevious, const simData::PlatformUpdate* prevUpdate)
+{
+  size_t next = 0;
+  while (next < points.size())
+  {
+    // get a chunk to which to add the new points, creating a new one if necessary
+    TrackChunkNode* chunk = getCurrentChunk_();
+    if (!chunk)
     {
-      osg::Matrix last;
-      double last_t = prevUpdate->time();
-      // Extra point needs to be removed during data limiting
-      if (getMatrix_(*prevUpdate, last))
-        chunk->addPoint(last, last_t, historyColorAtTime_(last_t), hostBounds_);
-    }
+      // allocate a new chunk
+      chunk = new TrackChunkNode(chunkSize_, locator_->getSRS(), lastPlatformPrefs_.trackprefs().trackdrawmode());
 
-    // add the new chunk and update its appearance
-    chunkGroup_->addChild(chunk);
-    chunk->addCullCallback(new osgEarth::HorizonCullCallback());
-  }
+      // if there is a preceding chunk, duplicate its last point so there is no
+      // discontinuity from previous chunk to this new chunk - this matters for line, bridge drawing modes
+      if (chunkGroup_->getNumChildren() > 0 && followsPrevious[next])
+      {
+        // Extra point needs to be removed during data limiting
+        TrackChunkNode::Point last;
+        if (next > 0)
+          chunk->addPoint(points[next - 1].matrix, points[next - 1].time, points[next - 1].color, hostBounds_);
+        else if (prevUpdate != NULL && makePoint_(*prevUpdate, last))
+          chunk->addPoint(last.matrix, last.time, last.color, hostBounds_);
+      }
 
-  const double drawTime = toDrawTime_(u.time());
+      // add the new chunk and update its appearance
+      chunkGroup_->addChild(chunk);
+      chunk->addCullCallback(new osgEarth::HorizonCullCallback());
+    }
 
-  // add the point (along with its timestamp)
-  bool addSuccess = chunk->addPoint(hostMatrix, drawTime, historyColorAtTime_(drawTime), hostBounds_);
-  if (!addSuccess)
-  {
-    // if assert fails, check that getCurrentChunk_ and previous code ensure that either chunk is not full, or new chunk created
-    assert(0);
-  }
-  else
-    totalPoints_++;
+    // fill the chunk with as many points as it holds
+    const unsigned int numAdded = chunk->addPoints(&points[next], static_cast<unsigned int>(points.size() - next), hostBounds_);
+    if (numAdded == 0)
+    {
+      // if assert fails, check that getCurrentChunk_ and previous code ensure that either chunk is not full, or new chunk created
+      assert(0);
+      break;
+    }
+    next += numAdded;
+    totalPoints_ += numAdded;
 
-  // record time of last draw update - must be an actual point time that can be found in the chunk
-  // in forward mode, lastDrawTime_ represents the newest point in the track history
-  // in reverse mode, lastDrawTime_ represents the earliest point in the track history
-  lastDrawTime_ = drawTime;
-  hasLastDrawTime_ = true;
+    // record time of last draw update - must be an actual point time that can be found in the chunk
+    // in forward mode, lastDrawTime_ represents the newest point in the track history
+    // in reverse mode, lastDrawTime_ represents the earliest point in the track history
+    lastDrawTime_ = points[next - 1].time;
+    hasLastDrawTime_ = true;
+  }
 }
 
 void TrackHistoryNode::updateClockMode(const simCore::Clock* clock)
@@ -723,35 +737,65 @@ void TrackHistoryNode::backfillTrackHistory_(double endTime, double beginTime)
     return;
   }
 
+  // gather the whole run, filter it as one batch, then convert to points and fill chunks by range
+  std::vector<simData::PlatformUpdate> updates;
+  const simData::PlatformUpdate* prevUpdate = NULL;
+
   if (timeDirection_ == simCore::FORWARD)
   {
     // get an iterator that will take us from beginTime up to and including endTime: [beginTime, endTime]
     simData::PlatformUpdateSlice::Iterator iter = updateSlice->lower_bound(beginTime);
+    simData::PlatformUpdateSlice::Iterator prevIter = iter;
+    prevUpdate = prevIter.previous();
     while (iter.hasNext() && iter.peekNext()->time() <= endTime)
     {
-      simData::PlatformUpdateSlice::Iterator prevIter = iter;
-      const simData::PlatformUpdate* prevUpdate = prevIter.previous();
       const simData::PlatformUpdate* u = iter.next();
       // if assert fails, hasNext() and next() are not in agreement, check iterator implementation
       assert(u);
-      addUpdate_(*u, prevUpdate);
+      updates.push_back(*u);
     }
   }
   else
   {
     // get an iterator that will take us from [endTime, beginTime]
     simData::PlatformUpdateSlice::Iterator iter = updateSlice->upper_bound(endTime);
+    // since this is going backwards in time, the previous update is actually next
+    simData::PlatformUpdateSlice::Iterator prevIter = iter;
+    prevUpdate = prevIter.next();
     while (iter.hasPrevious() && iter.peekPrevious()->time() >= beginTime)
     {
-      // since this is going backwards in time, prevIter is actually next, grab it before iterator moves backwards
-      simData::PlatformUpdateSlice::Iterator prevIter = iter;
-      const simData::PlatformUpdate* prevUpdate = prevIter.next();
       const simData::PlatformUpdate* u = iter.previous();
       // if assert fails, hasPrevious() and previous() are not in agreement, check iterator implementation
       assert(u);
-      addUpdate_(*u, prevUpdate);
+      updates.push_back(*u);
     }
   }
+  if (updates.empty())
+    return;
+
+  std::vector<PlatformTspiFilterManager::FilterResponse> responses;
+  platformTspiFilterManager_.filter(updates, lastPlatformPrefs_, lastPlatformProps_, responses);
+
+  std::vector<TrackChunkNode::Point> points;
+  std::vector<bool> followsPrevious;
+  points.reserve(updates.size());
+  followsPrevious.reserve(updates.size());
+  // the first point of the run follows prevUpdate
+  bool prevAccepted = true;
+  TrackChunkNode::Point point;
+  for (size_t k = 0; k < updates.size(); ++k)
+  {
+    const bool accepted = (responses[k] != PlatformTspiFilterManager::POINT_DROPPED);
+    if (accepted)
+    {
+      setPoint_(updates[k], point);
+      points.push_back(point);
+      followsPrevious.push_back(prevAccepted);
+    }
+    prevAccepted = accepted;
+  }
+
+  addPoints_(points, followsPrevious, prevUpdate);
 }
 
 // update the track's representation of the current point, if that point is interpolated
@@ -819,24 +863,15 @@ bool TrackHistoryNode::getMatrix_(const simData::PlatformUpdate& u, osg::Matrix&
   simData::PlatformUpdate update = u;
   if (platformTspiFilterManager_.filter(update, lastPlatformPrefs_, lastPlatformProps_) == PlatformTspiFilterManager::POINT_DROPPED)
     return false;
-
-  // update our locator for the current update
-  simCore::Coordinate ecefCoord(
-    simCore::COORD_SYS_ECEF,
-    simCore::Vec3(update.x(), update.y(), update.z()),
-    simCore::Vec3(update.psi(), update.theta(), update.phi()));
-
-  locator_->setCoordinate(ecefCoord, u.time());
-
-  // fetch the positioning matrix from the locator we are tracking
-  if (!locator_->getLocatorMatrix(hostMatrix))
-  {
-    // if assert fails, check that invalid platform updates are not being sent to track
-    assert(0);
-    return false;
-  }
-
+  toMatrix_(update, hostMatrix);
   return true;
 }
 
+void TrackHistoryNode::toMatrix_(const simData::PlatformUpdate& filtered, osg::Matrix& hostMatrix) const
+{
+  // equivalent to the matrix of a root locator set to this ECEF coordinate, without the locator overhead
+  simVis::Math::ecefEulerToEnuRotMatrix(simCore::Vec3(filtered.psi(), filtered.theta(), filtered.phi()), hostMatrix);
+  hostMatrix.postMultTranslate(osg::Vec3d(filtered.x(), filtered.y(), filtered.z()));
+}
+
 }
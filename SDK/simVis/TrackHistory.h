@@ -22,6 +22,7 @@
 #ifndef SIMVIS_TRACK_HISTORY_H
 #define SIMVIS_TRACK_HISTORY_H
 
+#include <vector>
 #include "simCore/Time/Clock.h"
 #include "simData/DataSlice.h"
 #include "simData/DataTable.h"
@@ -188,11 +189,28 @@ namespace simVis
     void updateCurrentPoint_(const simData::PlatformUpdateSlice& updateSlice);
 
     /**
-    * Update the track history visuals with a point to correspond to the specified platform update
-    * @param update platform update from which to obtain track position information
-    * @param prevUpdate the previous platform update
+    * Appends a run of points to the track history, filling chunks by range and creating new chunks as needed
+    * @param points points to add, in increasing draw time order
+    * @param followsPrevious for each point, true if the platform update preceding it was not dropped;
+    *   for the first point, true if it corresponds to the first update of the run
+    * @param prevUpdate platform update preceding the run, or NULL
     */
-    void addUpdate_(const simData::PlatformUpdate& update, const simData::PlatformUpdate* prevUpdate);
+    void addPoints_(const std::vector<TrackChunkNode::Point>& points, const std::vector<bool>& followsPrevious, const simData::PlatformUpdate* prevUpdate);
+
+    /**
+    * Creates the track point that corresponds to the platform update
+    * @param u platform update from which to obtain track position information
+    * @param point track point output
+    * @return true if the point is valid; false if it was dropped by a TSPI filter
+    */
+    bool makePoint_(const simData::PlatformUpdate& u, TrackChunkNode::Point& point);
+
+    /**
+    * Sets the track point for a platform update that has already been through the TSPI filters
+    * @param filtered filtered platform update from which to obtain track position information
+    * @param point track point output
+    */
+    void setPoint_(const simData::PlatformUpdate& filtered, TrackChunkNode::Point& point);
 
     /**
     * Convert update time to draw time
@@ -210,6 +228,8 @@ namespace simVis
 
     /// utility function to get an OSG ENU matrix that corresponds to platform update's position and orientation
     bool getMatrix_(const simData::PlatformUpdate& u, osg::Matrix& hostMatrix);
+    /// utility function to get the OSG ENU matrix for a platform update that has already been through the TSPI filters
+    void toMatrix_(const simData::PlatformUpdate& filtered, osg::Matrix& hostMatrix) const;
 
   private: // data
     /// data store for initializing data slice and accessing table manager
@@ -0,0 +1,197 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+*****                                                                  *****
+*****                   Classification: UNCLASSIFIED                   *****
+*****                    Classified By:                                *****
+*****                    Declassify On:                                *****
+*****                                                                  *****
+****************************************************************************
+*
+*
+* Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+*               EW Modeling & Simulation, Code 5773
+*               4555 Overlook Ave.
+*               Washington, D.C. 20375-5339
+*
+* License for source code at https://simdis.nrl.navy.mil/License.aspx
+*
+* The U.S. Government retains all rights to use, duplicate, distribute,
+* disclose, or release this software.
+*
+*/
+#include <algorithm>
+#include "OpenThreads/Condition"
+#include "OpenThreads/Mutex"
+#include "OpenThreads/ScopedLock"
+#include "OpenThreads/Thread"
+#include "osg/observer_ptr"
+#include "simCore/Calc/Math.h"
+#include "simVis/WorkerPool.h"
+
+namespace simVis
+{
+
+namespace
+{
+
+/** Most threads in the pool; the pool also leaves a processor for the update thread */
+const int MAX_POOL_THREADS = 4;
+
+/** Protects the shared pool pointer */
+OpenThreads::Mutex& instanceMutex()
+{
+  static OpenThreads::Mutex s_mutex;
+  return s_mutex;
+}
+
+/** Shared pool, if any client holds it; never destroyed, so that static destruction touches no OSG state */
+osg::observer_ptr<WorkerPool>& instancePointer()
+{
+  static osg::observer_ptr<WorkerPool>* s_instance = new osg::observer_ptr<WorkerPool>;
+  return *s_instance;
+}
+
+}
+
+/**
+ * Hands out the items of a parallelFor() to every thread that runs it.  The same operation is queued
+ * once per helper thread; a copy that runs after finish() finds no items left and returns without
+ * touching the task.
+ */
+class WorkerPool::ParallelForOperation : public osg::Operation
+{
+public:
+  ParallelForOperation(Task& task, size_t count)
+    : osg::Operation("simVis::WorkerPool::ParallelForOperation", false),
+      task_(&task),
+      count_(count),
+      next_(0),
+      active_(0)
+  {
+  }
+
+  /** Runs items until none are left; called on the pool's threads and the calling thread */
+  virtual void operator()(osg::Object*)
+  {
+    size_t index = 0;
+    while (claim_(index))
+    {
+      const ItemGuard guard(*this);
+      task_->run(index);
+    }
+  }
+
+  /** Stops handing out items and waits for the items in progress to finish */
+  void finish()
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    next_ = count_;
+    while (active_ > 0)
+      done_.wait(&mutex_);
+  }
+
+private:
+  /** Releases a claimed item even if the task throws */
+  class ItemGuard
+  {
+  public:
+    explicit ItemGuard(ParallelForOperation& op) : op_(op) {}
+    ~ItemGuard() { op_.release_(); }
+  private:
+    ParallelForOperation& op_;
+  };
+
+  /** Claims the next item; returns false if none are left */
+  bool claim_(size_t& index)
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    if (next_ >= count_)
+      return false;
+    index = next_++;
+    ++active_;
+    return true;
+  }
+
+  /** Marks a claimed item finished */
+  void release_()
+  {
+    OpenThreads::ScopedLock<OpenThreads::Mutex> lock(mutex_);
+    if (--active_ == 0)
+      done_.broadcast();
+  }
+
+  Task* task_;
+  size_t count_;
+  size_t next_;
+  size_t active_;
+  OpenThreads::Mutex mutex_;
+  OpenThreads::Condition done_;
+};
+
+WorkerPool::WorkerPool()
+  : queue_(new osg::OperationQueue)
+{
+  const int numThreads = simCore::sdkMax(1, simCore::sdkMin(OpenThreads::GetNumberOfProcessors() - 1, MAX_POOL_THREADS));
+  for (int k = 0; k < numThreads; ++k)
+  {
+    osg::ref_ptr<osg::OperationThread> thread = new osg::OperationThread;
+    thread->setOperationQueue(queue_.get());
+    thread->startThread();
+    threads_.push_back(thread);
+  }
+}
+
+WorkerPool::~WorkerPool()
+{
+  queue_->removeAllOperations();
+  // cancel() waits for the operation in progress, if any, and for the thread to exit
+  for (std::vector< osg::ref_ptr<osg::OperationThread> >::const_iterator i = threads_.begin(); i != threads_.end(); ++i)
+    (*i)->cancel();
+}
+
+osg::ref_ptr<WorkerPool> WorkerPool::instance()
+{
+  OpenThreads::ScopedLock<OpenThreads::Mutex> lock(instanceMutex());
+  osg::ref_ptr<WorkerPool> pool;
+  if (!instancePointer().lock(pool))
+  {
+    pool = new WorkerPool;
+    instancePointer() = pool.get();
+  }
+  return pool;
+}
+
+unsigned int WorkerPool::threadCount() const
+{
+  return static_cast<unsigned int>(threads_.size());
+}
+
+void WorkerPool::add(osg::Operation* operation)
+{
+  queue_->add(operation);
+}
+
+void WorkerPool::parallelFor(Task& task, size_t count)
+{
+  if (count == 0)
+    return;
+
+  osg::ref_ptr<ParallelForOperation> op = new ParallelForOperation(task, count);
+  // One helper per thread at most; this thread takes the remaining share
+  const size_t helpers = simCore::sdkMin(threads_.size(), count - 1);
+  for (size_t k = 0; k < helpers; ++k)
+    queue_->add(op.get());
+
+  try
+  {
+    (*op)(NULL);
+  }
+  catch (...)
+  {
+    op->finish();
+    throw;
+  }
+  op->finish();
+}
+
+}
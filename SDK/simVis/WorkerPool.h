@@ -0,0 +1,89 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+*****                                                                  *****
+*****                   Classification: UNCLASSIFIED                   *****
+*****                    Classified By:                                *****
+*****                    Declassify On:                                *****
+*****                                                                  *****
+****************************************************************************
+*
+*
+* Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+*               EW Modeling & Simulation, Code 5773
+*               4555 Overlook Ave.
+*               Washington, D.C. 20375-5339
+*
+* License for source code at https://simdis.nrl.navy.mil/License.aspx
+*
+* The U.S. Government retains all rights to use, duplicate, distribute,
+* disclose, or release this software.
+*
+*/
+#ifndef SIMVIS_WORKERPOOL_H
+#define SIMVIS_WORKERPOOL_H
+
+#include <vector>
+#include "osg/OperationThread"
+#include "osg/Referenced"
+#include "osg/ref_ptr"
+#include "simCore/Common/Common.h"
+
+namespace simVis
+{
+
+/**
+ * Threads shared across simVis for work done off the update thread, such as building geometry in the
+ * background or preparing entity updates in parallel.  The pool exists only while a client holds a
+ * reference to it; releasing the last reference drops queued operations and joins the threads, so the
+ * threads never outlive their clients into static destruction.  Operations added to the pool must not
+ * themselves hold a reference to the pool.
+ */
+class SDKVIS_EXPORT WorkerPool : public osg::Referenced
+{
+public:
+  /** Work divided into independent items, for parallelFor() */
+  class Task
+  {
+  public:
+    virtual ~Task() {}
+    /** Processes a single item; called concurrently for different items */
+    virtual void run(size_t index) = 0;
+  };
+
+  /** Returns the shared pool, creating it if no client currently holds it */
+  static osg::ref_ptr<WorkerPool> instance();
+
+  /** Number of threads in the pool */
+  unsigned int threadCount() const;
+
+  /** Queues the operation to run once on one of the pool's threads */
+  void add(osg::Operation* operation);
+
+  /**
+   * Runs task.run() for each index in [0, count) on the pool's threads and on the calling thread,
+   * returning once every item has finished.  The calling thread claims items as well, so it never waits
+   * on unrelated work queued to the pool.  If run() throws on the calling thread, items already claimed
+   * by other threads finish before the exception propagates.
+   * @param task Work to run; not used after this returns
+   * @param count Number of items
+   */
+  void parallelFor(Task& task, size_t count);
+
+protected:
+  /** Drops queued operations and joins the threads */
+  virtual ~WorkerPool();
+
+private:
+  class ParallelForOperation;
+
+  WorkerPool();
+
+  /** Queue shared by all the threads */
+  osg::ref_ptr<osg::OperationQueue> queue_;
+  /** Threads servicing queue_ */
+  std::vector< osg::ref_ptr<osg::OperationThread> > threads_;
+};
+
+}
+
+#endif /* SIMVIS_WORKERPOOL_H */
@@ -0,0 +1,191 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Calc/GridIndex.h"
+
+namespace
+{
+
+/** Point used for brute force comparisons */
+struct TestPoint
+{
+  double x;
+  double y;
+};
+
+/** Deterministic pseudo-random coordinates in [0, range) */
+double coordinate(size_t k, size_t salt, double range)
+{
+  const size_t hash = (k * 2654435761u + salt * 40503u) % 1000003u;
+  return range * hash / 1000003.0;
+}
+
+int testEmpty()
+{
+  int rv = 0;
+  simCore::GridIndex index;
+  index.build();
+  rv += SDK_ASSERT(index.empty());
+  std::vector<simCore::GridIndex::Neighbor> neighbors;
+  index.findWithinRadius(0.0, 0.0, 100.0, neighbors);
+  rv += SDK_ASSERT(neighbors.empty());
+  std::vector<size_t> items;
+  index.findInBox(-10.0, -10.0, 10.0, 10.0, items);
+  rv += SDK_ASSERT(items.empty());
+
+  // Non-finite points are ignored
+  index.insert(std::numeric_limits<double>::infinity(), 0.0, 0);
+  index.insert(0.0, std::numeric_limits<double>::quiet_NaN(), 1);
+  rv += SDK_ASSERT(index.empty());
+  return rv;
+}
+
+int testSinglePoint()
+{
+  int rv = 0;
+  simCore::GridIndex index(10.0);
+  index.insert(5.0, 5.0, 7);
+  index.build();
+  std::vector<simCore::GridIndex::Neighbor> neighbors;
+  index.findWithinRadius(8.0, 9.0, 5.0, neighbors);
+  rv += SDK_ASSERT(neighbors.size() == 1);
+  if (neighbors.size() == 1)
+  {
+    rv += SDK_ASSERT(neighbors[0].first == 25.0);
+    rv += SDK_ASSERT(neighbors[0].second == 7);
+  }
+  index.findWithinRadius(8.0, 9.0, 4.9, neighbors);
+  rv += SDK_ASSERT(neighbors.empty());
+  index.findWithinRadius(1000.0, 1000.0, 10.0, neighbors);
+  rv += SDK_ASSERT(neighbors.empty());
+
+  std::vector<size_t> items;
+  // Corners in reverse order, boundaries inclusive
+  index.findInBox(5.0, 5.0, 0.0, 0.0, items);
+  rv += SDK_ASSERT(items.size() == 1);
+  index.findInBox(5.1, 0.0, 10.0, 10.0, items);
+  rv += SDK_ASSERT(items.empty());
+
+  // Points are not visible until rebuilt
+  index.insert(6.0, 6.0, 8);
+  index.findInBox(0.0, 0.0, 10.0, 10.0, items);
+  rv += SDK_ASSERT(items.size() == 1);
+  index.build();
+  index.findInBox(0.0, 0.0, 10.0, 10.0, items);
+  rv += SDK_ASSERT(items.size() == 2);
+  index.clear();
+  index.build();
+  index.findInBox(0.0, 0.0, 10.0, 10.0, items);
+  rv += SDK_ASSERT(items.empty());
+  return rv;
+}
+
+/** Points spread across the whole range of a double, whose extent overflows */
+int testExtremePoints()
+{
+  int rv = 0;
+  simCore::GridIndex index(1.0);
+  const double maxValue = std::numeric_limits<double>::max();
+  index.insert(-maxValue, -maxValue, 0);
+  index.insert(maxValue, maxValue, 1);
+  index.insert(0.0, 0.0, 2);
+  index.build();
+
+  std::vector<simCore::GridIndex::Neighbor> neighbors;
+  index.findWithinRadius(0.0, 0.0, 1.0, neighbors);
+  rv += SDK_ASSERT(neighbors.size() == 1 && neighbors[0].second == 2);
+  std::vector<size_t> items;
+  index.findInBox(-maxValue, -maxValue, maxValue, maxValue, items);
+  rv += SDK_ASSERT(items.size() == 3);
+  index.findInBox(maxValue, maxValue, maxValue, maxValue, items);
+  rv += SDK_ASSERT(items.size() == 1 && items[0] == 1);
+  return rv;
+}
+
+/** Compares radius and box queries against a brute force search */
+int testAgainstBruteForce(size_t numPoints, double range, double cellSize)
+{
+  int rv = 0;
+  std::vector<TestPoint> points(numPoints);
+  simCore::GridIndex index(cellSize);
+  index.reserve(numPoints);
+  for (size_t k = 0; k < numPoints; ++k)
+  {
+    points[k].x = coordinate(k, 1, range) - range / 4.0;
+    points[k].y = coordinate(k, 2, range) - range / 4.0;
+    index.insert(points[k].x, points[k].y, k);
+  }
+  index.build();
+  rv += SDK_ASSERT(index.size() == numPoints);
+
+  std::vector<simCore::GridIndex::Neighbor> neighbors;
+  std::vector<size_t> items;
+  for (size_t q = 0; q < 200; ++q)
+  {
+    const double x = coordinate(q, 3, range * 1.5) - range / 2.0;
+    const double y = coordinate(q, 4, range * 1.5) - range / 2.0;
+    const double radius = coordinate(q, 5, range / 4.0);
+
+    std::vector<simCore::GridIndex::Neighbor> expected;
+    std::vector<size_t> expectedItems;
+    for (size_t k = 0; k < numPoints; ++k)
+    {
+      const double dx = points[k].x - x;
+      const double dy = points[k].y - y;
+      if (dx * dx + dy * dy <= radius * radius)
+        expected.push_back(simCore::GridIndex::Neighbor(dx * dx + dy * dy, k));
+      if (points[k].x >= x - radius && points[k].x <= x + radius && points[k].y >= y - radius && points[k].y <= y + radius)
+        expectedItems.push_back(k);
+    }
+    std::sort(expected.begin(), expected.end());
+
+    index.findWithinRadius(x, y, radius, neighbors);
+    rv += SDK_ASSERT(neighbors == expected);
+    index.findInBox(x - radius, y - radius, x + radius, y + radius, items);
+    std::sort(items.begin(), items.end());
+    rv += SDK_ASSERT(items == expectedItems);
+  }
+  return rv;
+}
+
+}
+
+int GridIndexTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += SDK_ASSERT(testEmpty() == 0);
+  rv += SDK_ASSERT(testSinglePoint() == 0);
+  rv += SDK_ASSERT(testExtremePoints() == 0);
+  // Dense points, sparse points, and points spread far enough to force larger cells
+  rv += SDK_ASSERT(testAgainstBruteForce(5000, 1000.0, 32.0) == 0);
+  rv += SDK_ASSERT(testAgainstBruteForce(50, 1000.0, 32.0) == 0);
+  rv += SDK_ASSERT(testAgainstBruteForce(1000, 1e7, 1.0) == 0);
+
+  std::cout << "simCore GridIndexTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
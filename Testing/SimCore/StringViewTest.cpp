@@ -0,0 +1,272 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/String/StringView.h"
+#include "simCore/String/Tokenizer.h"
+#include "simCore/String/ValidNumber.h"
+#include "simCore/Time/Utils.h"
+
+namespace
+{
+
+/** Returns 0 if the view tokens match the string tokens */
+int compareTokens(const std::vector<std::string>& strings, const std::vector<simCore::StringView>& views)
+{
+  if (strings.size() != views.size())
+    return 1;
+  int rv = 0;
+  for (size_t k = 0; k < strings.size(); ++k)
+  {
+    if (views[k] != strings[k])
+      ++rv;
+  }
+  return rv;
+}
+
+int testStringView()
+{
+  int rv = 0;
+  const std::string source = "abc def abc";
+  const simCore::StringView view(source);
+  rv += SDK_ASSERT(view.size() == source.size());
+  rv += SDK_ASSERT(view == source);
+  rv += SDK_ASSERT(view.substr(4, 3) == "def");
+  rv += SDK_ASSERT(view.substr(8) == "abc");
+  rv += SDK_ASSERT(view.substr(20).empty());
+  rv += SDK_ASSERT(view.find('c') == 2);
+  rv += SDK_ASSERT(view.find('c', 3) == 10);
+  rv += SDK_ASSERT(view.find('x') == simCore::StringView::npos);
+  rv += SDK_ASSERT(view.find("abc", 1) == 8);
+  rv += SDK_ASSERT(view.find("abcd") == simCore::StringView::npos);
+  rv += SDK_ASSERT(view.find_first_of(simCore::StringView(" ")) == 3);
+  rv += SDK_ASSERT(view.find_first_not_of(simCore::StringView("abc")) == 3);
+  rv += SDK_ASSERT(view.find_last_not_of(simCore::StringView("abc")) == 7);
+  rv += SDK_ASSERT(simCore::StringView("abc") < simCore::StringView("abd"));
+  rv += SDK_ASSERT(simCore::StringView("ab") < simCore::StringView("abc"));
+  rv += SDK_ASSERT(simCore::StringView().empty());
+  rv += SDK_ASSERT(view.str() == source);
+
+  std::ostringstream os;
+  os << view.substr(4, 3);
+  rv += SDK_ASSERT(os.str() == "def");
+  return rv;
+}
+
+/** Verifies that the view tokenizers produce the same tokens as the std::string tokenizers */
+int testTokenizers()
+{
+  int rv = 0;
+  std::vector<std::string> lines;
+  lines.push_back("");
+  lines.push_back("   ");
+  lines.push_back("one");
+  lines.push_back("  one two\tthree  ");
+  lines.push_back("one,,two,three,");
+  lines.push_back("cmd \"quoted string\" 'single quoted' plain");
+  lines.push_back("cmd \"\"\"triple quoted\"\"\" after");
+  lines.push_back("cmd \"unterminated");
+  lines.push_back("a \"b\" \"c d\"e f // comment here");
+  lines.push_back("name \"x y\" # trailing comment");
+
+  for (std::vector<std::string>::const_iterator i = lines.begin(); i != lines.end(); ++i)
+  {
+    const simCore::StringView line(*i);
+    std::vector<std::string> strings;
+    std::vector<simCore::StringView> views;
+
+    simCore::stringTokenizer(strings, *i);
+    simCore::stringTokenizer(views, line);
+    rv += SDK_ASSERT(compareTokens(strings, views) == 0);
+
+    simCore::stringTokenizer(strings, *i, ",", true, false);
+    simCore::stringTokenizer(views, line, simCore::StringView(","), true, false);
+    rv += SDK_ASSERT(compareTokens(strings, views) == 0);
+
+    simCore::quoteTokenizer(strings, *i);
+    simCore::quoteTokenizer(views, line);
+    rv += SDK_ASSERT(compareTokens(strings, views) == 0);
+
+    simCore::quoteCommentTokenizer(*i, strings);
+    simCore::quoteCommentTokenizer(line, views);
+    rv += SDK_ASSERT(compareTokens(strings, views) == 0);
+
+    // The std::string version does not terminate on a trailing lone quote
+    if (i->find("unterminated") == std::string::npos)
+    {
+      simCore::tokenizeWithQuotes(strings, *i);
+      simCore::tokenizeWithQuotes(views, line);
+      rv += SDK_ASSERT(compareTokens(strings, views) == 0);
+    }
+
+    for (size_t pos = 0; pos < i->size(); ++pos)
+      rv += SDK_ASSERT(simCore::getTerminateForStringPos(line, pos) == simCore::getTerminateForStringPos(*i, pos));
+  }
+
+  rv += SDK_ASSERT(simCore::removeQuotes(simCore::StringView("\"abc\"")) == "abc");
+  rv += SDK_ASSERT(simCore::removeQuotes(simCore::StringView("'abc'")) == "abc");
+  rv += SDK_ASSERT(simCore::removeQuotes(simCore::StringView("\"abc")) == "\"abc");
+
+  // Trailing lone quote must terminate
+  std::vector<simCore::StringView> views;
+  simCore::tokenizeWithQuotes(views, simCore::StringView("abc \""));
+  rv += SDK_ASSERT(!views.empty());
+  return rv;
+}
+
+/** Returns 0 if the view and string conversions agree on validity and value */
+template <typename T>
+int compareNumber(const std::string& token, bool permitPlus)
+{
+  T strValue = 1;
+  T viewValue = 1;
+  const bool strOk = simCore::isValidNumber(token, strValue, permitPlus);
+  // Embed the token in a larger buffer to verify the parser does not rely on a NULL terminator
+  const std::string padded = token + "9x";
+  const bool viewOk = simCore::isValidNumber(simCore::StringView(padded.data(), token.size()), viewValue, permitPlus);
+  if (strOk != viewOk || strValue != viewValue)
+  {
+    std::cerr << "Mismatch on \"" << token << "\": " << strOk << "/" << viewOk << " " << strValue << "/" << viewValue << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+int testNumbers()
+{
+  int rv = 0;
+  const char* integers[] = {
+    "0", "1", "-1", "+1", "-0", "00012", "-", "+", "", " 1", "1 ", "1.0", "1e3", "abc", "0x10",
+    "127", "128", "-128", "-129", "255", "256", "32767", "32768", "-32768", "-32769", "65535", "65536",
+    "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295", "4294967296",
+    "9223372036854775807", "9223372036854775808", "-9223372036854775808", "-9223372036854775809",
+    "18446744073709551615", "18446744073709551616", "99999999999999999999999"
+  };
+  for (size_t k = 0; k < sizeof(integers) / sizeof(integers[0]); ++k)
+  {
+    for (int plus = 0; plus < 2; ++plus)
+    {
+      rv += SDK_ASSERT(compareNumber<uint64_t>(integers[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<uint32_t>(integers[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<uint16_t>(integers[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<uint8_t>(integers[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<int64_t>(integers[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<int32_t>(integers[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<int16_t>(integers[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<int8_t>(integers[k], plus != 0) == 0);
+    }
+  }
+
+  const char* reals[] = {
+    "0", "-0", "0.0", "1", "-1", "+1", "1.5", "-1.5", ".5", "5.", ".", "-.5", "1e3", "1E-3", "1e+3", "1e", "1e-",
+    "e5", "1.e5", "3.14159265358979", "0.1", "0.3", "123456789012345678", "1234567890123456789012345",
+    "0.000000000000000000000000123", "1e22", "1e23", "1e-22", "1e-23", "1e308", "1e309", "-1e309", "1e-400",
+    "4.9406564584124654e-324", "2.2250738585072014e-308", "1.7976931348623157e308", "9007199254740993",
+    "0x1p3", "inf", "nan", " 1", "1 ", "1.0.0", "--1", "1d", "123.456e-7", "00000000000000000000000001.5"
+  };
+  for (size_t k = 0; k < sizeof(reals) / sizeof(reals[0]); ++k)
+  {
+    for (int plus = 0; plus < 2; ++plus)
+    {
+      rv += SDK_ASSERT(compareNumber<double>(reals[k], plus != 0) == 0);
+      rv += SDK_ASSERT(compareNumber<float>(reals[k], plus != 0) == 0);
+    }
+  }
+
+  // Sweep fast path values against strtod()
+  for (int k = 0; k < 20000; ++k)
+  {
+    std::ostringstream os;
+    os << (k * 7919) % 100003 << "." << (k * 104729) % 1000;
+    if (k % 3 == 0)
+      os << "e" << (k % 45) - 22;
+    rv += SDK_ASSERT(compareNumber<double>(os.str(), true) == 0);
+  }
+  return rv;
+}
+
+/** Compares std::string and StringView parsing of a representative data file; reports times without failing on them */
+int testPerformance()
+{
+  std::vector<std::string> lines;
+  for (int k = 0; k < 20000; ++k)
+  {
+    std::ostringstream os;
+    os << "data " << k << " " << (k * 0.125) << " " << (k * -3.75e-2) << " \"platform name " << (k % 16) << "\" 1e" << (k % 10);
+    lines.push_back(os.str());
+  }
+
+  int rv = 0;
+  double strSum = 0.0;
+  double viewSum = 0.0;
+
+  const double strStart = simCore::getSystemTime();
+  std::vector<std::string> strTokens;
+  for (std::vector<std::string>::const_iterator i = lines.begin(); i != lines.end(); ++i)
+  {
+    simCore::quoteTokenizer(strTokens, *i);
+    double value = 0.0;
+    for (size_t k = 1; k < strTokens.size(); ++k)
+    {
+      if (simCore::isValidNumber(strTokens[k], value))
+        strSum += value;
+    }
+  }
+  const double strElapsed = simCore::getSystemTime() - strStart;
+
+  const double viewStart = simCore::getSystemTime();
+  std::vector<simCore::StringView> viewTokens;
+  for (std::vector<std::string>::const_iterator i = lines.begin(); i != lines.end(); ++i)
+  {
+    simCore::quoteTokenizer(viewTokens, simCore::StringView(*i));
+    double value = 0.0;
+    for (size_t k = 1; k < viewTokens.size(); ++k)
+    {
+      if (simCore::isValidNumber(viewTokens[k], value))
+        viewSum += value;
+    }
+  }
+  const double viewElapsed = simCore::getSystemTime() - viewStart;
+
+  rv += SDK_ASSERT(strSum == viewSum);
+  std::cout << "Tokenize and parse " << lines.size() << " lines: std::string " << strElapsed << "s, StringView " << viewElapsed << "s" << std::endl;
+  return rv;
+}
+
+}
+
+int StringViewTest(int argc, char *argv[])
+{
+  int rv = 0;
+
+  rv += SDK_ASSERT(testStringView() == 0);
+  rv += SDK_ASSERT(testTokenizers() == 0);
+  rv += SDK_ASSERT(testNumbers() == 0);
+  rv += SDK_ASSERT(testPerformance() == 0);
+
+  std::cout << "simCore StringViewTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
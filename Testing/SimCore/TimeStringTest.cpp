@@ -19,6 +19,9 @@
  * disclose, or release this software.
  *
  */
+#include <iostream>
+#include <string>
+#include <vector>
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Time/TimeClass.h"
 #include "simCore/Time/Utils.h"
@@ -741,6 +744,94 @@ int canConvertTest()
   return rv;
 }
 
+/** Returns 0 if bulk conversion matches converting each string individually */
+int compareBulk(const simCore::TimeFormatterRegistry& registry, const std::vector<std::string>& timeStrings, size_t expectedErrors)
+{
+  int rv = 0;
+  std::vector<simCore::TimeStamp> bulk;
+  rv += SDK_ASSERT(registry.fromStrings(timeStrings, bulk, 1970) == expectedErrors);
+  rv += SDK_ASSERT(bulk.size() == timeStrings.size());
+
+  std::vector<simCore::StringView> views;
+  for (std::vector<std::string>::const_iterator i = timeStrings.begin(); i != timeStrings.end(); ++i)
+    views.push_back(simCore::StringView(*i));
+  std::vector<simCore::TimeStamp> bulkViews;
+  rv += SDK_ASSERT(registry.fromStrings(views, bulkViews, 1970) == expectedErrors);
+
+  for (size_t k = 0; k < timeStrings.size() && k < bulk.size() && k < bulkViews.size(); ++k)
+  {
+    simCore::TimeStamp single;
+    registry.fromString(timeStrings[k], single, 1970);
+    if (single != bulk[k] || single != bulkViews[k])
+    {
+      std::cerr << "Bulk mismatch on \"" << timeStrings[k] << "\"" << std::endl;
+      ++rv;
+    }
+  }
+  return rv;
+}
+
+int testBulkFromStrings()
+{
+  int rv = 0;
+  simCore::TimeFormatterRegistry registry;
+
+  const simCore::TimeFormat formats[] = { simCore::TIMEFORMAT_SECONDS, simCore::TIMEFORMAT_ORDINAL, simCore::TIMEFORMAT_MONTHDAY, simCore::TIMEFORMAT_DTG };
+  const size_t numRows = 20000;
+  for (size_t f = 0; f < sizeof(formats) / sizeof(formats[0]); ++f)
+  {
+    std::vector<std::string> timeStrings;
+    for (size_t k = 0; k < numRows; ++k)
+    {
+      const simCore::TimeStamp stamp(1970 + static_cast<int>(k % 60), (k * 7919.123) + k * 0.001);
+      timeStrings.push_back(registry.toString(formats[f], stamp, 1970, static_cast<unsigned short>(k % 6)));
+    }
+    rv += SDK_ASSERT(compareBulk(registry, timeStrings, 0) == 0);
+
+    // Invalid rows fail individually without disturbing the rest of the column
+    timeStrings[numRows / 2] = "not a time";
+    timeStrings[numRows / 3] = "";
+    rv += SDK_ASSERT(compareBulk(registry, timeStrings, 2) == 0);
+
+    // Compare throughput with individual conversion
+    std::vector<simCore::TimeStamp> stamps;
+    const double bulkStart = simCore::getSystemTime();
+    registry.fromStrings(timeStrings, stamps, 1970);
+    const double bulkElapsed = simCore::getSystemTime() - bulkStart;
+    const double singleStart = simCore::getSystemTime();
+    for (std::vector<std::string>::const_iterator i = timeStrings.begin(); i != timeStrings.end(); ++i)
+    {
+      simCore::TimeStamp stamp;
+      registry.fromString(*i, stamp, 1970);
+    }
+    const double singleElapsed = simCore::getSystemTime() - singleStart;
+    std::cout << "Format " << formats[f] << ": " << numRows << " rows, fromStrings() " << bulkElapsed << "s, fromString() " << singleElapsed << "s" << std::endl;
+  }
+
+  // Mixed columns and deprecated formats fall back to per-string conversion
+  std::vector<std::string> mixed;
+  mixed.push_back("12.5");
+  mixed.push_back("001 1971 00:00:01");
+  mixed.push_back("Jan 13 2014 00:01:02.03");
+  mixed.push_back("061435:03.010 Z Apr07");
+  mixed.push_back("\"100.25\"");
+  mixed.push_back("  045 1999 12:00:00 ");
+  rv += SDK_ASSERT(compareBulk(registry, mixed, 0) == 0);
+
+  // Quoted and padded strings match the individual conversion
+  std::vector<std::string> quoted;
+  quoted.push_back("'001 1971 00:00:01'");
+  quoted.push_back(" 002 1971 00:00:01.5 ");
+  quoted.push_back("\"366 1972 23:59:59\"");
+  quoted.push_back("367 1972 23:59:59");
+  quoted.push_back("001  1971  24:00:00");
+  rv += SDK_ASSERT(compareBulk(registry, quoted, 2) == 0);
+
+  std::vector<std::string> empty;
+  rv += SDK_ASSERT(compareBulk(registry, empty, 0) == 0);
+  return rv;
+}
+
 }
 
 int TimeStringTest(int argc, char* argv[])
@@ -755,5 +846,6 @@ int TimeStringTest(int argc, char* argv[])
   rv += SDK_ASSERT(testPrintDtg() == 0);
   rv += SDK_ASSERT(testPrintDeprecated() == 0);
   rv += SDK_ASSERT(canConvertTest() == 0);
+  rv += SDK_ASSERT(testBulkFromStrings() == 0);
   return rv;
 }
@@ -19,6 +19,7 @@
  * disclose, or release this software.
  *
  */
+#include <algorithm>
 #include <cfloat>
 #include <iostream>
 #include <limits>
@@ -1384,6 +1385,87 @@ int testScenarioDeleteCallback()
   return rv;
 }
 
+/** Returns 0 if the changed ID list matches the hasChanged() state of each slice */
+int checkChangedIds(simData::DataStore* ds, uint64_t platform1, uint64_t platform2, uint64_t beam)
+{
+  simData::DataStore::IdList ids;
+  ds->changedIdList(&ids);
+  int rv = SDK_ASSERT(std::is_sorted(ids.begin(), ids.end()));
+  rv += SDK_ASSERT(ds->platformUpdateSlice(platform1)->hasChanged() == (std::count(ids.begin(), ids.end(), platform1) == 1));
+  rv += SDK_ASSERT(ds->platformUpdateSlice(platform2)->hasChanged() == (std::count(ids.begin(), ids.end(), platform2) == 1));
+  rv += SDK_ASSERT(ds->beamUpdateSlice(beam)->hasChanged() == (std::count(ids.begin(), ids.end(), beam) == 1));
+  return rv;
+}
+
+int testChangedIdList()
+{
+  int rv = 0;
+  simUtil::DataStoreTestHelper testHelper;
+  simData::DataStore* ds = testHelper.dataStore();
+
+  const uint64_t platform1 = testHelper.addPlatform();
+  const uint64_t platform2 = testHelper.addPlatform();
+  const uint64_t beam = testHelper.addBeam(platform1);
+  testHelper.addPlatformUpdate(1.0, platform1);
+  testHelper.addPlatformUpdate(2.0, platform1);
+  testHelper.addPlatformUpdate(1.0, platform2);
+  testHelper.addBeamUpdate(1.0, beam);
+
+  // Nothing has been updated yet
+  simData::DataStore::IdList ids;
+  ds->changedIdList(&ids);
+  rv += SDK_ASSERT(ids.empty());
+
+  // First update changes both platforms
+  ds->update(1.0);
+  rv += SDK_ASSERT(checkChangedIds(ds, platform1, platform2, beam) == 0);
+  ds->changedIdList(&ids);
+  rv += SDK_ASSERT(std::count(ids.begin(), ids.end(), platform1) == 1);
+  rv += SDK_ASSERT(std::count(ids.begin(), ids.end(), platform2) == 1);
+
+  ds->update(2.0);
+  rv += SDK_ASSERT(checkChangedIds(ds, platform1, platform2, beam) == 0);
+
+  // New data for platform 2 at the current time changes platform 2 but not platform 1
+  testHelper.addPlatformUpdate(2.0, platform2);
+  ds->update(2.0);
+  rv += SDK_ASSERT(checkChangedIds(ds, platform1, platform2, beam) == 0);
+  ids.clear();
+  ds->changedIdList(&ids);
+  rv += SDK_ASSERT(ids.size() == 1);
+  rv += SDK_ASSERT(!ids.empty() && ids[0] == platform2);
+
+  // List is appended to, not replaced
+  ds->changedIdList(&ids);
+  rv += SDK_ASSERT(ids.size() == 2);
+
+  // Generic data changes are listed even when the update slice is unchanged
+  {
+    simData::DataStore::Transaction t;
+    simData::GenericData* gd = ds->addGenericData(platform1, &t);
+    gd->set_time(3.0);
+    gd->set_duration(-1.0);
+    simData::GenericData_Entry* entry = gd->add_entry();
+    entry->set_key("key");
+    entry->set_value("value");
+    t.commit();
+  }
+  ds->update(3.0);
+  rv += SDK_ASSERT(!ds->platformUpdateSlice(platform1)->hasChanged());
+  ids.clear();
+  ds->changedIdList(&ids);
+  rv += SDK_ASSERT(ids.size() == 1);
+  rv += SDK_ASSERT(!ids.empty() && ids[0] == platform1);
+
+  // The default implementation, for data stores without change tracking, lists every entity in order
+  ids.clear();
+  ds->simData::DataStore::changedIdList(&ids);
+  rv += SDK_ASSERT(ids.size() == 3);
+  rv += SDK_ASSERT(std::is_sorted(ids.begin(), ids.end()));
+  rv += SDK_ASSERT(std::count(ids.begin(), ids.end(), beam) == 1);
+  return rv;
+}
+
 int TestMemoryDataStore(int argc, char* argv[])
 {
   simCore::checkVersionThrow();
@@ -1401,6 +1483,7 @@ int TestMemoryDataStore(int argc, char* argv[])
     rv += testCategoryData_update();
     rv += testCategoryData_change();
     rv += testScenarioDeleteCallback();
+    rv += testChangedIdList();
     return rv;
   }
   catch (AssertionException& e)
@@ -0,0 +1,304 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "simNotify/Notify.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/Version.h"
+#include "simCore/Time/Utils.h"
+
+namespace
+{
+
+/// Number of logging threads
+static const int NUM_THREADS = 8;
+/// Messages logged by each thread
+static const int NUM_MESSAGES = 20000;
+
+/** Collects all output into a single string; not thread safe, like most handlers */
+class CollectNotifyHandler : public simNotify::NotifyHandler
+{
+public:
+  virtual void notify(const std::string& message)
+  {
+    text_ += message;
+  }
+
+  /** Retrieves the output and clears it */
+  std::string takeText()
+  {
+    std::string rv;
+    rv.swap(text_);
+    return rv;
+  }
+
+private:
+  std::string text_;
+};
+
+/** Collects output like CollectNotifyHandler, but safe for the synchronous writes that follow a stop */
+class LockedCollectNotifyHandler : public simNotify::NotifyHandler
+{
+public:
+  virtual void notify(const std::string& message)
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    text_ += message;
+  }
+
+  /** Returns true once any output arrived */
+  bool hasText() const
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return !text_.empty();
+  }
+
+  /** Retrieves the output and clears it */
+  std::string takeText()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string rv;
+    rv.swap(text_);
+    return rv;
+  }
+
+private:
+  mutable std::mutex mutex_;
+  std::string text_;
+};
+
+/** Logs a second message from inside notify() the first time it sees the trigger text */
+class ReentrantNotifyHandler : public LockedCollectNotifyHandler
+{
+public:
+  ReentrantNotifyHandler()
+    : logged_(false)
+  {
+  }
+
+  virtual void notify(const std::string& message)
+  {
+    LockedCollectNotifyHandler::notify(message);
+    if (!logged_ && message.find("trigger") != std::string::npos)
+    {
+      logged_ = true;
+      SIM_INFO << "nested" << std::endl;
+      simNotify::flushNotify();
+    }
+  }
+
+private:
+  bool logged_;
+};
+
+/// Guards logging in the synchronous comparison, as callers had to do before asynchronous mode
+std::mutex g_syncMutex;
+
+/** Logs NUM_MESSAGES messages, each built from several insertions */
+void logMessages(int threadNum, bool lockEach)
+{
+  for (int k = 0; k < NUM_MESSAGES; ++k)
+  {
+    if (lockEach)
+    {
+      std::lock_guard<std::mutex> lock(g_syncMutex);
+      SIM_INFO << "thread " << threadNum << " message " << k << " value " << k * 0.5 << std::endl;
+    }
+    else
+      SIM_INFO << "thread " << threadNum << " message " << k << " value " << k * 0.5 << std::endl;
+  }
+}
+
+/** Runs the logging threads, returning the elapsed seconds including the final flush */
+double runThreads(bool lockEach)
+{
+  const double start = simCore::getSystemTime();
+  std::vector<std::thread> threads;
+  for (int k = 0; k < NUM_THREADS; ++k)
+    threads.push_back(std::thread(logMessages, k, lockEach));
+  for (size_t k = 0; k < threads.size(); ++k)
+    threads[k].join();
+  simNotify::flushNotify();
+  return simCore::getSystemTime() - start;
+}
+
+/** Returns 0 if every message appears exactly once, whole, and in order per thread */
+int checkOutput(const std::string& text)
+{
+  int rv = 0;
+  std::vector<int> nextMessage(NUM_THREADS, 0);
+  std::istringstream is(text);
+  std::string line;
+  int lines = 0;
+  while (std::getline(is, line))
+  {
+    ++lines;
+    std::istringstream lineStream(line);
+    std::string prefix;
+    std::string threadLabel;
+    std::string messageLabel;
+    std::string valueLabel;
+    int threadNum = -1;
+    int message = -1;
+    double value = -1.0;
+    lineStream >> prefix >> threadLabel >> threadNum >> messageLabel >> message >> valueLabel >> value;
+    if (prefix != "INFO:" || threadLabel != "thread" || messageLabel != "message" || valueLabel != "value" ||
+      threadNum < 0 || threadNum >= NUM_THREADS || message != nextMessage[threadNum] || value != message * 0.5)
+    {
+      ++rv;
+      continue;
+    }
+    ++nextMessage[threadNum];
+  }
+  rv += SDK_ASSERT(lines == NUM_THREADS * NUM_MESSAGES);
+  return rv;
+}
+
+int testAsyncOutput(CollectNotifyHandler& collect)
+{
+  int rv = 0;
+  simNotify::setAsynchronousNotify(true);
+  rv += SDK_ASSERT(simNotify::asynchronousNotify());
+
+  // Partial message completes on flush
+  SIM_INFO << "partial";
+  simNotify::flushNotify();
+  rv += SDK_ASSERT(collect.takeText() == "INFO:  partial");
+
+  // Starting a new message completes the previous one
+  SIM_INFO << "first ";
+  SIM_INFO << "second" << std::endl;
+  simNotify::flushNotify();
+  rv += SDK_ASSERT(collect.takeText() == "INFO:  first INFO:  second\n");
+
+  // Disabled severities are not queued
+  SIM_DEBUG_FP << "hidden" << std::endl;
+  simNotify::flushNotify();
+  rv += SDK_ASSERT(collect.takeText().empty());
+
+  // Concurrent logging produces whole messages
+  const double asyncSeconds = runThreads(false);
+  rv += SDK_ASSERT(checkOutput(collect.takeText()) == 0);
+
+  // Disabling writes everything queued
+  SIM_INFO << "last" << std::endl;
+  simNotify::setAsynchronousNotify(false);
+  rv += SDK_ASSERT(!simNotify::asynchronousNotify());
+  rv += SDK_ASSERT(collect.takeText() == "INFO:  last\n");
+
+  // Compare against synchronous logging with a lock around each message
+  const double syncSeconds = runThreads(true);
+  rv += SDK_ASSERT(checkOutput(collect.takeText()) == 0);
+
+  const int total = NUM_THREADS * NUM_MESSAGES;
+  std::cout << "Messages/second with " << NUM_THREADS << " threads: asynchronous " << total / asyncSeconds
+    << ", synchronous with lock " << total / syncSeconds << std::endl;
+  return rv;
+}
+
+/** Disables asynchronous mode while threads are logging; no message may be lost or reordered */
+int testStopWhileLogging()
+{
+  int rv = 0;
+  LockedCollectNotifyHandler* collect = new LockedCollectNotifyHandler;
+  simNotify::NotifyHandlerPtr collectPtr(collect);
+  simNotify::setNotifyHandlers(collectPtr);
+
+  for (int pass = 0; pass < 3; ++pass)
+  {
+    simNotify::setAsynchronousNotify(true);
+    // Lock each message, since the writes after the stop are synchronous and may interleave otherwise
+    std::vector<std::thread> threads;
+    for (int k = 0; k < NUM_THREADS; ++k)
+      threads.push_back(std::thread(logMessages, k, true));
+    // Stop once the writer is busy, so producers are racing with the shutdown
+    while (!collect->hasText())
+      std::this_thread::yield();
+    simNotify::setAsynchronousNotify(false);
+    for (size_t k = 0; k < threads.size(); ++k)
+      threads[k].join();
+    rv += SDK_ASSERT(checkOutput(collect->takeText()) == 0);
+  }
+  return rv;
+}
+
+/** A handler that logs while the writer is stopping must not deadlock the stop */
+int testLogFromHandler()
+{
+  int rv = 0;
+  for (int pass = 0; pass < 20; ++pass)
+  {
+    ReentrantNotifyHandler* reentrant = new ReentrantNotifyHandler;
+    simNotify::NotifyHandlerPtr reentrantPtr(reentrant);
+    simNotify::setNotifyHandlers(reentrantPtr);
+    simNotify::setAsynchronousNotify(true);
+    SIM_INFO << "trigger" << std::endl;
+    // Stop right away, so the handler usually logs while the stop is joining the writer
+    simNotify::setAsynchronousNotify(false);
+    rv += SDK_ASSERT(reentrant->takeText() == "INFO:  trigger\nINFO:  nested\n");
+  }
+  return rv;
+}
+
+/** Reports the cost of a disabled severity check; does not fail on timing */
+int testDisabledCost()
+{
+  static const int NUM_CHECKS = 10000000;
+  int enabled = 0;
+  const double start = simCore::getSystemTime();
+  for (int k = 0; k < NUM_CHECKS; ++k)
+  {
+    if (simNotify::isNotifyEnabled(simNotify::NOTIFY_DEBUG_FP))
+      ++enabled;
+  }
+  const double elapsed = simCore::getSystemTime() - start;
+  std::cout << "Disabled severity check: " << elapsed * 1e9 / NUM_CHECKS << " ns" << std::endl;
+  return SDK_ASSERT(enabled == 0);
+}
+
+}
+
+int AsyncNotifyTest(int argc, char* argv[])
+{
+  simCore::checkVersionThrow();
+  int rv = 0;
+
+  CollectNotifyHandler* collect = new CollectNotifyHandler;
+  simNotify::NotifyHandlerPtr collectPtr(collect);
+  const simNotify::NotifySeverity oldLevel = simNotify::notifyLevel();
+  simNotify::setNotifyHandlers(collectPtr);
+  simNotify::setNotifyLevel(simNotify::NOTIFY_INFO);
+
+  rv += SDK_ASSERT(testAsyncOutput(*collect) == 0);
+  rv += SDK_ASSERT(testStopWhileLogging() == 0);
+  rv += SDK_ASSERT(testLogFromHandler() == 0);
+  rv += SDK_ASSERT(testDisabledCost() == 0);
+
+  simNotify::setNotifyLevel(oldLevel);
+  simNotify::setNotifyHandlers(simNotify::defaultNotifyHandler());
+  std::cout << "AsyncNotifyTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+  return rv;
+}
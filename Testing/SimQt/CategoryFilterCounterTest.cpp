@@ -0,0 +1,351 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <QCoreApplication>
+#include <QEventLoop>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
+#include "simData/CategoryData/CategoryFilter.h"
+#include "simData/CategoryData/CategoryNameManager.h"
+#include "simData/MemoryDataStore.h"
+#include "simQt/CategoryFilterCounter.h"
+#include "simQt/RegExpImpl.h"
+
+namespace
+{
+
+uint64_t addPlatform(simData::DataStore& ds)
+{
+  simData::DataStore::Transaction t;
+  simData::PlatformProperties* props = ds.addPlatform(&t);
+  const uint64_t id = props->id();
+  t.commit();
+  return id;
+}
+
+void addCategoryData(simData::DataStore& ds, uint64_t id, const std::string& name, const std::string& value, double time)
+{
+  simData::DataStore::Transaction t;
+  simData::CategoryData* cd = ds.addCategoryData(id, &t);
+  cd->set_time(time);
+  simData::CategoryData_Entry* entry = cd->add_entry();
+  entry->set_key(name);
+  entry->set_value(value);
+  t.commit();
+}
+
+/** Counts by toggling each value in a copy of the filter, one category at a time; the results the counter must reproduce */
+void bruteForceCount(const simData::CategoryFilter& filter, simQt::CategoryCountResults& results)
+{
+  simData::DataStore* ds = filter.getDataStore();
+  std::vector<simData::ObjectId> ids;
+  ds->idList(&ids);
+  std::vector<simData::CategoryFilter::CurrentCategoryValues> categories(ids.size());
+  for (size_t k = 0; k < ids.size(); ++k)
+    simData::CategoryFilter::getCurrentCategoryValues(*ds, ids[k], categories[k]);
+
+  const simData::CategoryNameManager& nameManager = ds->categoryNameManager();
+  std::vector<int> names;
+  nameManager.allCategoryNameInts(names);
+  results.allCategories.clear();
+  for (auto i = names.begin(); i != names.end(); ++i)
+  {
+    std::vector<int> values;
+    nameManager.allValueIntsInCategory(*i, values);
+    values.push_back(simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME);
+    simQt::CategoryCountResults::ValueToCountMap& countMap = results.allCategories[*i];
+    for (auto vi = values.begin(); vi != values.end(); ++vi)
+    {
+      simData::CategoryFilter valueFilter(ds);
+      valueFilter.assign(filter, false);
+      valueFilter.removeName(*i);
+      valueFilter.setValue(*i, *vi, true);
+      size_t& count = countMap[*vi];
+      count = 0;
+      for (auto ci = categories.begin(); ci != categories.end(); ++ci)
+      {
+        if (valueFilter.matchData(*ci))
+          ++count;
+      }
+    }
+  }
+}
+
+/** Returns 0 if the counter matches the brute force count for the filter */
+int compareCounts(const simData::CategoryFilter& filter)
+{
+  simQt::CategoryFilterCounter counter;
+  counter.setFilter(filter);
+  counter.testAllCategories();
+  simQt::CategoryCountResults expected;
+  bruteForceCount(filter, expected);
+  return (counter.results().allCategories == expected.allCategories) ? 0 : 1;
+}
+
+/** Creates platforms with values in several categories; every 7th platform has no value in "Size" */
+void populate(simData::DataStore& ds, size_t numPlatforms, double time)
+{
+  for (size_t k = 0; k < numPlatforms; ++k)
+  {
+    const uint64_t id = addPlatform(ds);
+    std::ostringstream color;
+    color << "Color" << (k % 5);
+    addCategoryData(ds, id, "Color", color.str(), time);
+    addCategoryData(ds, id, "Type", (k % 3 == 0) ? "Ship" : "Aircraft", time);
+    if (k % 7 != 0)
+    {
+      std::ostringstream size;
+      size << (100 + k % 11);
+      addCategoryData(ds, id, "Size", size.str(), time);
+    }
+  }
+  ds.update(time);
+}
+
+int testCounts()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  populate(ds, 200, 0.0);
+  simData::CategoryNameManager& nameManager = ds.categoryNameManager();
+  const int colorInt = nameManager.nameToInt("Color");
+  const int typeInt = nameManager.nameToInt("Type");
+  const int sizeInt = nameManager.nameToInt("Size");
+
+  // Empty filter counts everything
+  simData::CategoryFilter filter(&ds);
+  rv += SDK_ASSERT(compareCounts(filter) == 0);
+
+  // One value in one category
+  filter.setValue(typeInt, nameManager.valueToInt("Ship"), true);
+  rv += SDK_ASSERT(compareCounts(filter) == 0);
+
+  // Values in several categories, including no value and unlisted values
+  filter.setValue(colorInt, nameManager.valueToInt("Color1"), true);
+  filter.setValue(colorInt, nameManager.valueToInt("Color3"), true);
+  filter.setValue(sizeInt, simData::CategoryNameManager::NO_CATEGORY_VALUE_AT_TIME, true);
+  filter.setValue(sizeInt, nameManager.valueToInt("105"), true);
+  rv += SDK_ASSERT(compareCounts(filter) == 0);
+  filter.setValue(sizeInt, simData::CategoryNameManager::UNLISTED_CATEGORY_VALUE, true);
+  filter.setValue(sizeInt, nameManager.valueToInt("106"), false);
+  rv += SDK_ASSERT(compareCounts(filter) == 0);
+
+  // Regular expressions
+  simQt::RegExpFilterFactoryImpl regExpFactory;
+  filter.setCategoryRegExp(sizeInt, regExpFactory.createRegExpFilter("^10[2-6]$"));
+  rv += SDK_ASSERT(compareCounts(filter) == 0);
+  simData::CategoryFilter deserialized(&ds);
+  rv += SDK_ASSERT(deserialized.deserialize("Color(1)^^Color[0-2]$", regExpFactory));
+  deserialized.setValue(typeInt, nameManager.valueToInt("Ship"), true);
+  rv += SDK_ASSERT(compareCounts(deserialized) == 0);
+
+  // Spot check a known value: Ships whose color is Color1, counted toward Color1
+  simData::CategoryFilter spot(&ds);
+  spot.setValue(typeInt, nameManager.valueToInt("Ship"), true);
+  simQt::CategoryFilterCounter counter;
+  counter.setFilter(spot);
+  counter.testAllCategories();
+  size_t ships = 0;
+  for (size_t k = 0; k < 200; ++k)
+  {
+    if (k % 3 == 0 && k % 5 == 1)
+      ++ships;
+  }
+  const simQt::CategoryCountResults::AllCategories& all = counter.results().allCategories;
+  rv += SDK_ASSERT(all.find(colorInt)->second.find(nameManager.valueToInt("Color1"))->second == ships);
+  // Values of the filtered category itself are counted as if selected
+  rv += SDK_ASSERT(all.find(typeInt)->second.find(nameManager.valueToInt("Aircraft"))->second == 200 - 67);
+  return rv;
+}
+
+int testUpdateEntities()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  populate(ds, 100, 0.0);
+  simData::CategoryNameManager& nameManager = ds.categoryNameManager();
+  simData::CategoryFilter filter(&ds);
+  filter.setValue(nameManager.nameToInt("Type"), nameManager.valueToInt("Ship"), true);
+  filter.setValue(nameManager.nameToInt("Color"), nameManager.valueToInt("Color2"), true);
+
+  simQt::CategoryFilterCounter counter;
+  counter.setFilter(filter);
+  counter.testAllCategories();
+
+  std::vector<simData::ObjectId> ids;
+  ds.idList(&ids);
+  std::vector<simData::ObjectId> changed;
+
+  // Change existing values
+  addCategoryData(ds, ids[0], "Color", "Color2", 1.0);
+  addCategoryData(ds, ids[1], "Type", "Ship", 1.0);
+  ds.update(1.0);
+  changed.push_back(ids[0]);
+  changed.push_back(ids[1]);
+  rv += SDK_ASSERT(counter.updateEntities(changed));
+  simQt::CategoryCountResults expected;
+  bruteForceCount(filter, expected);
+  rv += SDK_ASSERT(counter.results().allCategories == expected.allCategories);
+
+  // Add a platform with known values, and remove another
+  changed.clear();
+  const uint64_t newId = addPlatform(ds);
+  addCategoryData(ds, newId, "Color", "Color2", 1.0);
+  addCategoryData(ds, newId, "Type", "Ship", 1.0);
+  ds.update(1.0);
+  changed.push_back(newId);
+  changed.push_back(ids[5]);
+  ds.removeEntity(ids[5]);
+  rv += SDK_ASSERT(counter.updateEntities(changed));
+  bruteForceCount(filter, expected);
+  rv += SDK_ASSERT(counter.results().allCategories == expected.allCategories);
+
+  // A value not seen before needs a full recount, left to the caller
+  changed.clear();
+  addCategoryData(ds, ids[2], "Color", "Color99", 2.0);
+  ds.update(2.0);
+  changed.push_back(ids[2]);
+  rv += SDK_ASSERT(!counter.updateEntities(changed));
+  counter.testAllCategories();
+  bruteForceCount(filter, expected);
+  rv += SDK_ASSERT(counter.results().allCategories == expected.allCategories);
+  return rv;
+}
+
+/** Runs the event loop until the counter's next results */
+void waitForResults(simQt::AsyncCategoryCounter& counter)
+{
+  QEventLoop loop;
+  QObject::connect(&counter, SIGNAL(resultsReady(simQt::CategoryCountResults)), &loop, SLOT(quit()));
+  loop.exec();
+}
+
+int testAsyncIncremental()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  populate(ds, 100, 0.0);
+  simData::CategoryNameManager& nameManager = ds.categoryNameManager();
+  simData::CategoryFilter filter(&ds);
+  filter.setValue(nameManager.nameToInt("Type"), nameManager.valueToInt("Ship"), true);
+  filter.setValue(nameManager.nameToInt("Size"), nameManager.valueToInt("103"), true);
+
+  simQt::AsyncCategoryCounter counter;
+  counter.setFilter(filter);
+  waitForResults(counter);
+  simQt::CategoryCountResults expected;
+  bruteForceCount(filter, expected);
+  rv += SDK_ASSERT(counter.lastResults().allCategories == expected.allCategories);
+
+  // Incremental updates are counted immediately, and match a full recount
+  std::vector<simData::ObjectId> ids;
+  ds.idList(&ids);
+  std::vector<simData::ObjectId> changed;
+  addCategoryData(ds, ids[0], "Type", "Ship", 1.0);
+  addCategoryData(ds, ids[1], "Size", "103", 1.0);
+  const uint64_t newId = addPlatform(ds);
+  addCategoryData(ds, newId, "Type", "Ship", 1.0);
+  ds.update(1.0);
+  ds.removeEntity(ids[5]);
+  changed.push_back(ids[0]);
+  changed.push_back(ids[1]);
+  changed.push_back(newId);
+  changed.push_back(ids[5]);
+  counter.updateEntities(changed);
+  bruteForceCount(filter, expected);
+  rv += SDK_ASSERT(counter.lastResults().allCategories == expected.allCategories);
+  counter.asyncCountEntities();
+  waitForResults(counter);
+  rv += SDK_ASSERT(counter.lastResults().allCategories == expected.allCategories);
+
+  // Changes made during a background count are applied once it finishes
+  counter.asyncCountEntities();
+  changed.clear();
+  addCategoryData(ds, ids[2], "Type", "Ship", 2.0);
+  addCategoryData(ds, ids[3], "Size", "103", 2.0);
+  ds.update(2.0);
+  changed.push_back(ids[2]);
+  changed.push_back(ids[3]);
+  counter.updateEntities(changed);
+  waitForResults(counter);
+  bruteForceCount(filter, expected);
+  rv += SDK_ASSERT(counter.lastResults().allCategories == expected.allCategories);
+
+  // A value not seen before is recounted in the background
+  changed.clear();
+  addCategoryData(ds, ids[4], "Size", "199", 3.0);
+  ds.update(3.0);
+  changed.push_back(ids[4]);
+  counter.updateEntities(changed);
+  waitForResults(counter);
+  bruteForceCount(filter, expected);
+  rv += SDK_ASSERT(counter.lastResults().allCategories == expected.allCategories);
+  return rv;
+}
+
+/** Compares the counter to the brute force count on a larger data set; reports times without failing on them */
+int testPerformance()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  populate(ds, 5000, 0.0);
+  simData::CategoryNameManager& nameManager = ds.categoryNameManager();
+  simData::CategoryFilter filter(&ds);
+  filter.setValue(nameManager.nameToInt("Type"), nameManager.valueToInt("Ship"), true);
+  filter.setValue(nameManager.nameToInt("Size"), nameManager.valueToInt("104"), true);
+
+  const double bruteStart = simCore::getSystemTime();
+  simQt::CategoryCountResults expected;
+  bruteForceCount(filter, expected);
+  const double bruteElapsed = simCore::getSystemTime() - bruteStart;
+
+  const double counterStart = simCore::getSystemTime();
+  simQt::CategoryFilterCounter counter;
+  counter.setFilter(filter);
+  counter.testAllCategories();
+  const double counterElapsed = simCore::getSystemTime() - counterStart;
+
+  rv += SDK_ASSERT(counter.results().allCategories == expected.allCategories);
+  std::cout << "Count 5000 entities: per value " << bruteElapsed << "s, single pass " << counterElapsed << "s" << std::endl;
+  return rv;
+}
+
+}
+
+int CategoryFilterCounterTest(int argc, char* argv[])
+{
+  int rv = 0;
+  // Needed for the asynchronous counter's event processing
+  QCoreApplication app(argc, argv);
+
+  rv += SDK_ASSERT(testCounts() == 0);
+  rv += SDK_ASSERT(testUpdateEntities() == 0);
+  rv += SDK_ASSERT(testAsyncIncremental() == 0);
+  rv += SDK_ASSERT(testPerformance() == 0);
+
+  std::cout << "simQt CategoryFilterCounterTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
@@ -0,0 +1,147 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+*****                                                                  *****
+*****                   Classification: UNCLASSIFIED                   *****
+*****                    Classified By:                                *****
+*****                    Declassify On:                                *****
+*****                                                                  *****
+****************************************************************************
+*
+*
+* Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+*               EW Modeling and Simulation, Code 5770
+*               4555 Overlook Ave.
+*               Washington, D.C. 20375-5339
+*
+* For more information please send email to simdis@enews.nrl.navy.mil
+*
+* U.S. Naval Research Laboratory.
+*
+* The U.S. Government retains all rights to use, duplicate, distribute,
+* disclose, or release this software.
+****************************************************************************
+*
+*
+*/
+#include <iostream>
+#include <QCoreApplication>
+#include "simCore/Common/SDKAssert.h"
+#include "simQt/ConsoleDataModel.h"
+
+namespace
+{
+
+/** Counts the entries that reach the filters, which are those the spam filter lets through */
+class CountingFilter : public simQt::ConsoleDataModel::EntryFilter
+{
+public:
+  CountingFilter()
+    : count(0)
+  {
+  }
+
+  virtual bool acceptEntry(simQt::ConsoleDataModel::ConsoleEntry& entry) const
+  {
+    ++count;
+    return true;
+  }
+
+  mutable int count;
+};
+
+int testSpamFilterReset()
+{
+  int rv = 0;
+  simQt::ConsoleDataModel model;
+  model.setSpamFilterTimeout(60.0);
+  std::shared_ptr<CountingFilter> counter(new CountingFilter);
+  model.addEntryFilter(counter);
+
+  // Repeats within the timeout are dropped
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Repeated");
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Repeated");
+  rv += SDK_ASSERT(counter->count == 1);
+
+  // Clearing forgets the text
+  model.clear();
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Repeated");
+  rv += SDK_ASSERT(counter->count == 2);
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Repeated");
+  rv += SDK_ASSERT(counter->count == 2);
+
+  // Raising the minimum severity removes the lines, and forgets their text
+  model.addEntry(simNotify::NOTIFY_WARN, "Channel", "Warning");
+  rv += SDK_ASSERT(counter->count == 3);
+  model.setMinimumSeverity(simNotify::NOTIFY_WARN);
+  model.setMinimumSeverity(simNotify::NOTIFY_INFO);
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Repeated");
+  rv += SDK_ASSERT(counter->count == 4);
+  // Lines that passed the severity are still remembered
+  model.addEntry(simNotify::NOTIFY_WARN, "Channel", "Warning");
+  rv += SDK_ASSERT(counter->count == 4);
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Repeated");
+  rv += SDK_ASSERT(counter->count == 4);
+  return rv;
+}
+
+}
+
+/** Adds the pending lines to the model, as its timer would */
+void processPending(simQt::ConsoleDataModel& model)
+{
+  QMetaObject::invokeMethod(&model, "processPendingAdds_");
+}
+
+int testSpamFilterLineLimit()
+{
+  int rv = 0;
+  simQt::ConsoleDataModel model;
+  model.setSpamFilterTimeout(60.0);
+  model.setNumLines(2);
+  std::shared_ptr<CountingFilter> counter(new CountingFilter);
+  model.addEntryFilter(counter);
+
+  // Lines pushed out of the model no longer suppress their text
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "First");
+  processPending(model);
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Second");
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Third");
+  processPending(model);
+  rv += SDK_ASSERT(model.rowCount(QModelIndex()) == 2);
+  rv += SDK_ASSERT(counter->count == 3);
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "First");
+  rv += SDK_ASSERT(counter->count == 4);
+  // Lines still in the model do
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Third");
+  rv += SDK_ASSERT(counter->count == 4);
+
+  // Pending lines that never fit are forgotten too
+  model.clear();
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Dropped");
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Kept1");
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Kept2");
+  processPending(model);
+  rv += SDK_ASSERT(model.rowCount(QModelIndex()) == 2);
+  rv += SDK_ASSERT(counter->count == 7);
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Dropped");
+  rv += SDK_ASSERT(counter->count == 8);
+  model.addEntry(simNotify::NOTIFY_INFO, "Channel", "Kept2");
+  rv += SDK_ASSERT(counter->count == 8);
+  return rv;
+}
+
+}
+
+int ConsoleDataModelTest(int argc, char* argv[])
+{
+  int rv = 0;
+  // Needed for the model's timer
+  QCoreApplication app(argc, argv);
+
+  rv += SDK_ASSERT(testSpamFilterReset() == 0);
+  rv += SDK_ASSERT(testSpamFilterLineLimit() == 0);
+
+  std::cout << "simQt ConsoleDataModelTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
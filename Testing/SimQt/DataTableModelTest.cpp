@@ -0,0 +1,238 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+*****                                                                  *****
+*****                   Classification: UNCLASSIFIED                   *****
+*****                    Classified By:                                *****
+*****                    Declassify On:                                *****
+*****                                                                  *****
+****************************************************************************
+*
+*
+* Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+*               EW Modeling and Simulation, Code 5770
+*               4555 Overlook Ave.
+*               Washington, D.C. 20375-5339
+*
+* For more information please send email to simdis@enews.nrl.navy.mil
+*
+* U.S. Naval Research Laboratory.
+*
+* The U.S. Government retains all rights to use, duplicate, distribute,
+* disclose, or release this software.
+****************************************************************************
+*
+*
+*/
+#include <iostream>
+#include <set>
+#include "simCore/Common/SDKAssert.h"
+#include "simData/DataTable.h"
+#include "simData/MemoryDataStore.h"
+#include "simQt/DataTableModel.h"
+
+namespace
+{
+
+// Enough rows to span many more blocks than the model caches at once
+const int NUM_ROWS = 64 * 256;
+
+uint64_t addPlatform(simData::DataStore& ds)
+{
+  simData::DataStore::Transaction t;
+  simData::PlatformProperties* props = ds.addPlatform(&t);
+  const uint64_t id = props->id();
+  t.commit();
+  return id;
+}
+
+/** Returns the model's value at the row and column as an int, or -1 if the cell is empty */
+int cellValue(const simQt::DataTableModel& model, int row, int column)
+{
+  const QVariant value = model.data(model.index(row, column, QModelIndex()), Qt::DisplayRole);
+  bool ok = false;
+  const int rv = value.toInt(&ok);
+  return ok ? rv : -1;
+}
+
+int testInvalidateAndEvict()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  const uint64_t id = addPlatform(ds);
+  simData::DataTable* table = NULL;
+  rv += SDK_ASSERT(ds.dataTableManager().addDataTable(id, "Table", &table).isSuccess());
+  simData::TableColumn* colA = NULL;
+  simData::TableColumn* colB = NULL;
+  rv += SDK_ASSERT(table->addColumn("A", simData::VT_INT32, 0, &colA).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("B", simData::VT_INT32, 0, &colB).isSuccess());
+  for (int k = 0; k < NUM_ROWS; ++k)
+  {
+    simData::TableRow row;
+    row.setTime(k);
+    row.setValue(colA->columnId(), k);
+    rv += SDK_ASSERT(table->addRow(row).isSuccess());
+  }
+
+  simQt::DataTableModel model(NULL, table);
+  rv += SDK_ASSERT(model.rowCount() == NUM_ROWS);
+  rv += SDK_ASSERT(model.columnCount() == 3);
+  rv += SDK_ASSERT(model.headerData(1, Qt::Horizontal, Qt::DisplayRole).toString() == "A");
+  rv += SDK_ASSERT(model.headerData(2, Qt::Horizontal, Qt::DisplayRole).toString() == "B");
+
+  // read every row, cycling blocks through the cache
+  for (int k = 0; k < NUM_ROWS; ++k)
+  {
+    rv += SDK_ASSERT(cellValue(model, k, 1) == k);
+    rv += SDK_ASSERT(cellValue(model, k, 2) == -1);
+  }
+
+  // fill column B into existing rows, invalidating their blocks, while reading rows far away to evict others
+  for (int k = 0; k < NUM_ROWS; k += 97)
+  {
+    rv += SDK_ASSERT(cellValue(model, k, 2) == -1);
+    simData::TableRow row;
+    row.setTime(k);
+    row.setValue(colB->columnId(), -k - 2);
+    rv += SDK_ASSERT(table->addRow(row).isSuccess());
+    rv += SDK_ASSERT(cellValue(model, k, 2) == -k - 2);
+    const int farRow = (k + NUM_ROWS / 2) % NUM_ROWS;
+    rv += SDK_ASSERT(cellValue(model, farRow, 1) == farRow);
+  }
+  rv += SDK_ASSERT(model.rowCount() == NUM_ROWS);
+
+  // every cell still matches the table after the mix of invalidation and eviction
+  for (int k = NUM_ROWS - 1; k >= 0; --k)
+  {
+    rv += SDK_ASSERT(cellValue(model, k, 1) == k);
+    rv += SDK_ASSERT(cellValue(model, k, 2) == ((k % 97 == 0) ? -k - 2 : -1));
+  }
+  return rv;
+}
+
+/** Returns the column's value at exactly the given time as an int, or -1 if it has none */
+int tableValue(const simData::TableColumn& column, double time)
+{
+  simData::TableColumn::Iterator iter = column.findAtOrBeforeTime(time);
+  if (!iter.hasNext() || iter.peekNext()->time() != time)
+    return -1;
+  int32_t value = 0;
+  iter.next()->getValue(value);
+  return value;
+}
+
+/** Removes the rows the table dropped, as the queued call would */
+void processPending(simQt::DataTableModel& model)
+{
+  QMetaObject::invokeMethod(&model, "processPendingRemovals_");
+}
+
+int testDataLimiting()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  const uint64_t id = addPlatform(ds);
+  ds.setDataLimiting(true);
+  simData::DataStore::Transaction t;
+  simData::PlatformPrefs* prefs = ds.mutable_platformPrefs(id, &t);
+  // keep a few blocks of rows
+  prefs->mutable_commonprefs()->set_datalimitpoints(1000);
+  t.commit();
+
+  simData::DataTable* table = NULL;
+  rv += SDK_ASSERT(ds.dataTableManager().addDataTable(id, "Table", &table).isSuccess());
+  simData::TableColumn* colA = NULL;
+  simData::TableColumn* colB = NULL;
+  rv += SDK_ASSERT(table->addColumn("A", simData::VT_INT32, 0, &colA).isSuccess());
+  rv += SDK_ASSERT(table->addColumn("B", simData::VT_INT32, 0, &colB).isSuccess());
+  simQt::DataTableModel model(NULL, table);
+
+  // column B is sparse, so its oldest rows outlive the rows of column A around them
+  for (int k = 0; k < NUM_ROWS; ++k)
+  {
+    simData::TableRow row;
+    row.setTime(k);
+    row.setValue(colA->columnId(), k);
+    if (k % 10 == 0)
+      row.setValue(colB->columnId(), -k - 2);
+    rv += SDK_ASSERT(table->addRow(row).isSuccess());
+
+    // read the oldest and newest rows between removals, so their blocks stay cached
+    if (k % 100 == 0)
+    {
+      processPending(model);
+      const int lastRow = model.rowCount() - 1;
+      rv += SDK_ASSERT(cellValue(model, lastRow, 1) == k);
+      rv += SDK_ASSERT(cellValue(model, 0, 2) == tableValue(*colB, model.getTime(model.index(0, 0, QModelIndex()))));
+    }
+  }
+  processPending(model);
+
+  // the model holds exactly the times left in the table, with the values left in the table
+  std::set<double> times;
+  for (simData::TableColumn::Iterator i = colA->begin(); i.hasNext(); )
+    times.insert(i.next()->time());
+  for (simData::TableColumn::Iterator i = colB->begin(); i.hasNext(); )
+    times.insert(i.next()->time());
+  rv += SDK_ASSERT(times.size() < static_cast<size_t>(NUM_ROWS));
+  rv += SDK_ASSERT(model.rowCount() == static_cast<int>(times.size()));
+  int row = 0;
+  for (std::set<double>::const_iterator i = times.begin(); i != times.end() && row < model.rowCount(); ++i, ++row)
+  {
+    rv += SDK_ASSERT(model.getTime(model.index(row, 0, QModelIndex())) == *i);
+    rv += SDK_ASSERT(cellValue(model, row, 1) == tableValue(*colA, *i));
+    rv += SDK_ASSERT(cellValue(model, row, 2) == tableValue(*colB, *i));
+  }
+  return rv;
+}
+
+int testDeleteTable()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  const uint64_t id = addPlatform(ds);
+  simData::DataTable* table = NULL;
+  rv += SDK_ASSERT(ds.dataTableManager().addDataTable(id, "Table", &table).isSuccess());
+  simData::TableColumn* col = NULL;
+  rv += SDK_ASSERT(table->addColumn("A", simData::VT_INT32, 0, &col).isSuccess());
+  simData::TableRow row;
+  row.setTime(1.0);
+  row.setValue(col->columnId(), 5);
+  rv += SDK_ASSERT(table->addRow(row).isSuccess());
+  simData::DataTable* other = NULL;
+  rv += SDK_ASSERT(ds.dataTableManager().addDataTable(id, "Other", &other).isSuccess());
+
+  simQt::DataTableModel model(NULL, table);
+  model.setDataTableManager(&ds.dataTableManager());
+  rv += SDK_ASSERT(model.rowCount() == 1);
+
+  // deleting some other table leaves the model alone
+  rv += SDK_ASSERT(ds.dataTableManager().deleteTable(other->tableId()).isSuccess());
+  rv += SDK_ASSERT(model.dataTable() == table);
+  rv += SDK_ASSERT(model.rowCount() == 1);
+
+  // deleting the model's table clears the model, so it never touches the deleted table
+  rv += SDK_ASSERT(ds.dataTableManager().deleteTable(table->tableId()).isSuccess());
+  rv += SDK_ASSERT(model.dataTable() == NULL);
+  rv += SDK_ASSERT(model.rowCount() == 0);
+  rv += SDK_ASSERT(model.columnCount() == 0);
+
+  // the model keeps following the manager after a new table is set
+  rv += SDK_ASSERT(ds.dataTableManager().addDataTable(id, "Table", &table).isSuccess());
+  model.setDataTable(table);
+  ds.dataTableManager().deleteTablesByOwner(id);
+  rv += SDK_ASSERT(model.dataTable() == NULL);
+  return rv;
+}
+
+}
+
+int DataTableModelTest(int argc, char* argv[])
+{
+  int rv = 0;
+  rv += testInvalidateAndEvict();
+  rv += testDataLimiting();
+  rv += testDeleteTable();
+
+  std::cout << "DataTableModelTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+  return rv;
+}
@@ -0,0 +1,131 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include <vector>
+#include <QCoreApplication>
+#include <QThread>
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/Version.h"
+#include "simCore/Time/Utils.h"
+#include "simData/MemoryDataStore.h"
+#include "simQt/EntityTreeModel.h"
+
+namespace
+{
+
+/// Number of platforms to add; each tenth platform also gets a beam
+static const int NUM_PLATFORMS = 100000;
+
+/** Adds the platforms and beams to the data store */
+void addEntities(simData::DataStore& dataStore, std::vector<uint64_t>& platformIds)
+{
+  for (int k = 0; k < NUM_PLATFORMS; ++k)
+  {
+    simData::DataStore::Transaction txn;
+    simData::PlatformProperties* props = dataStore.addPlatform(&txn);
+    const uint64_t id = props->id();
+    props->set_originalid(k + 1);
+    txn.complete(&props);
+    platformIds.push_back(id);
+
+    if (k % 10 == 0)
+    {
+      simData::BeamProperties* beamProps = dataStore.addBeam(&txn);
+      beamProps->set_hostid(id);
+      txn.complete(&beamProps);
+    }
+  }
+}
+
+/** Waits out the model's delay for committing adds and removals, then returns the seconds spent processing them */
+double commitChanges()
+{
+  QThread::msleep(150);
+  const double start = simCore::getSystemTime();
+  QCoreApplication::processEvents();
+  return simCore::getSystemTime() - start;
+}
+
+/** Returns 0 if every item under the parent, recursively, reports the row and parent at which it is found */
+int checkRows(const simQt::EntityTreeModel& model, const QModelIndex& parent = QModelIndex())
+{
+  int rv = 0;
+  const int rows = model.rowCount(parent);
+  for (int row = 0; row < rows; ++row)
+  {
+    const QModelIndex index = model.index(row, 0, parent);
+    const QModelIndex found = model.index(model.uniqueId(index));
+    if (found.row() != row || model.parent(found) != parent)
+      ++rv;
+    rv += checkRows(model, index);
+  }
+  return rv;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+  simCore::checkVersionThrow();
+  QCoreApplication app(argc, argv);
+
+  int rv = 0;
+  simData::MemoryDataStore dataStore;
+  simQt::EntityTreeModel model(NULL, &dataStore);
+  model.setToTreeView();
+
+  std::vector<uint64_t> platformIds;
+  addEntities(dataStore, platformIds);
+  const double addSeconds = commitChanges();
+  rv += SDK_ASSERT(model.rowCount(QModelIndex()) == NUM_PLATFORMS);
+  rv += SDK_ASSERT(model.rowCount(model.index(platformIds[0])) == 1);
+  std::cout << "Add " << NUM_PLATFORMS << " platforms: " << addSeconds << "s" << std::endl;
+
+  double start = simCore::getSystemTime();
+  model.forceRefresh();
+  const double refreshSeconds = simCore::getSystemTime() - start;
+  rv += SDK_ASSERT(model.rowCount(QModelIndex()) == NUM_PLATFORMS);
+  std::cout << "Refresh: " << refreshSeconds << "s" << std::endl;
+
+  // Remove a contiguous block, as from data limiting the oldest platforms
+  for (int k = 0; k < NUM_PLATFORMS / 4; ++k)
+    dataStore.removeEntity(platformIds[k]);
+  const double blockSeconds = commitChanges();
+  rv += SDK_ASSERT(model.rowCount(QModelIndex()) == NUM_PLATFORMS - NUM_PLATFORMS / 4);
+  rv += SDK_ASSERT(checkRows(model) == 0);
+  std::cout << "Remove " << NUM_PLATFORMS / 4 << " contiguous platforms: " << blockSeconds << "s" << std::endl;
+
+  // Remove scattered platforms
+  int scattered = 0;
+  for (int k = NUM_PLATFORMS / 4; k < NUM_PLATFORMS; k += 3)
+  {
+    dataStore.removeEntity(platformIds[k]);
+    ++scattered;
+  }
+  const double scatteredSeconds = commitChanges();
+  rv += SDK_ASSERT(model.rowCount(QModelIndex()) == NUM_PLATFORMS - NUM_PLATFORMS / 4 - scattered);
+  rv += SDK_ASSERT(checkRows(model) == 0);
+  std::cout << "Remove " << scattered << " scattered platforms: " << scatteredSeconds << "s" << std::endl;
+
+  std::cout << "EntityTreeModelPerformanceTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+  return rv;
+}
@@ -0,0 +1,127 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include "OpenThreads/Thread"
+#include "osg/NodeVisitor"
+#include "osg/ref_ptr"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Time/Utils.h"
+#include "simData/DataTypes.h"
+#include "simVis/Antenna.h"
+
+namespace
+{
+
+/** Returns prefs that draw a Gaussian antenna pattern */
+simData::BeamPrefs gaussPrefs()
+{
+  simData::BeamPrefs prefs;
+  prefs.set_drawtype(simData::BeamPrefs_DrawType_ANTENNA_PATTERN);
+  prefs.mutable_antennapattern()->set_type(simData::BeamPrefs_AntennaPattern_Type_ALGORITHM);
+  prefs.mutable_antennapattern()->set_algorithm(simData::BeamPrefs_AntennaPattern_Algorithm_GAUSS);
+  prefs.set_horizontalwidth(10.0 * simCore::DEG2RAD);
+  prefs.set_verticalwidth(5.0 * simCore::DEG2RAD);
+  prefs.set_gain(20.0);
+  prefs.set_frequency(7000.0);
+  prefs.set_detail(2.0);
+  prefs.mutable_commonprefs()->set_color(0xff0000ff);
+  return prefs;
+}
+
+/** Runs update traversals until the node installs its mesh; returns false on timeout */
+bool waitForMesh(simVis::AntennaNode& node)
+{
+  const double start = simCore::getSystemTime();
+  while (node.getNumChildren() == 0)
+  {
+    if (simCore::getSystemTime() - start > 30.0)
+      return false;
+    // Gain calculations share the pattern with the mesh builder
+    node.PatternGain(0.0f, 0.0f, simCore::POLARITY_UNKNOWN);
+    OpenThreads::Thread::microSleep(1000);
+    osg::NodeVisitor update(osg::NodeVisitor::UPDATE_VISITOR, osg::NodeVisitor::TRAVERSE_ALL_CHILDREN);
+    node.accept(update);
+  }
+  return true;
+}
+
+int testSharedMesh()
+{
+  int rv = 0;
+  const simData::BeamPrefs prefs = gaussPrefs();
+  osg::ref_ptr<simVis::AntennaNode> first = new simVis::AntennaNode;
+  rv += SDK_ASSERT(first->setPrefs(prefs));
+  rv += SDK_ASSERT(first->isValid());
+  // Gain is highest on boresight
+  rv += SDK_ASSERT(first->PatternGain(0.0f, 0.0f, simCore::POLARITY_UNKNOWN) > first->PatternGain(0.2f, 0.0f, simCore::POLARITY_UNKNOWN));
+  rv += SDK_ASSERT(waitForMesh(*first));
+
+  // Same prefs share the mesh
+  osg::ref_ptr<simVis::AntennaNode> second = new simVis::AntennaNode;
+  rv += SDK_ASSERT(second->setPrefs(prefs));
+  rv += SDK_ASSERT(waitForMesh(*second));
+  if (first->getNumChildren() != 0 && second->getNumChildren() != 0)
+    rv += SDK_ASSERT(first->getChild(0) == second->getChild(0));
+
+  // Beam scale does not change the mesh, but color does
+  simData::BeamPrefs scaled = prefs;
+  scaled.set_beamscale(2.0);
+  second->setPrefs(scaled);
+  rv += SDK_ASSERT(second->getNumChildren() == 1 && second->getChild(0) == first->getChild(0));
+  simData::BeamPrefs colored = scaled;
+  colored.mutable_commonprefs()->set_color(0x00ff00ff);
+  rv += SDK_ASSERT(second->setPrefs(colored));
+  rv += SDK_ASSERT(waitForMesh(*second));
+  if (first->getNumChildren() != 0 && second->getNumChildren() != 0)
+    rv += SDK_ASSERT(first->getChild(0) != second->getChild(0));
+  return rv;
+}
+
+int testInvalidPattern()
+{
+  int rv = 0;
+  simData::BeamPrefs prefs = gaussPrefs();
+  prefs.mutable_antennapattern()->set_type(simData::BeamPrefs_AntennaPattern_Type_FILE);
+  prefs.mutable_antennapattern()->set_filename("no_such_pattern_file.aprf");
+  osg::ref_ptr<simVis::AntennaNode> node = new simVis::AntennaNode;
+  rv += SDK_ASSERT(!node->setPrefs(prefs));
+  rv += SDK_ASSERT(!node->isValid());
+  rv += SDK_ASSERT(node->getNumChildren() == 0);
+  // Without a pattern, gain is the prefs gain
+  rv += SDK_ASSERT(node->PatternGain(0.0f, 0.0f, simCore::POLARITY_UNKNOWN) == prefs.gain());
+  return rv;
+}
+
+}
+
+int AntennaTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += SDK_ASSERT(testSharedMesh() == 0);
+  rv += SDK_ASSERT(testInvalidPattern() == 0);
+
+  std::cout << "simVis AntennaTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
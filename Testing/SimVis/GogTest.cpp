@@ -25,6 +25,7 @@
 #include "simNotify/Notify.h"
 #include "simCore/Common/SDKAssert.h"
 #include "simCore/Common/Version.h"
+#include "simVis/GOG/BinaryFormat.h"
 #include "simVis/GOG/GogNodeInterface.h"
 #include "simVis/GOG/Parser.h"
 
@@ -414,6 +415,157 @@ int testParseMetaData()
   return rv;
 }
 
+/** Load callback that records node names and can cancel after the first batch */
+class TestLoadCallback : public simVis::GOG::Parser::LoadCallback
+{
+public:
+  explicit TestLoadCallback(bool cancelAfterFirstBatch)
+    : cancelAfterFirstBatch_(cancelAfterFirstBatch),
+      numBatches(0),
+      linesProcessed(0)
+  {
+  }
+
+  virtual void addGOGs(const simVis::GOG::Parser::OverlayNodeVector& nodes, const std::vector<simVis::GOG::GogFollowData>& followData)
+  {
+    ++numBatches;
+    for (auto iter = nodes.begin(); iter != nodes.end(); ++iter)
+    {
+      std::ostringstream os;
+      (*iter)->serializeToStream(os);
+      serialized.push_back(os.str());
+      delete *iter;
+    }
+  }
+
+  virtual void progress(size_t processed, size_t read)
+  {
+    linesProcessed = processed;
+  }
+
+  virtual bool isCanceled() const
+  {
+    return cancelAfterFirstBatch_ && numBatches > 0;
+  }
+
+  bool cancelAfterFirstBatch_;
+  size_t numBatches;
+  size_t linesProcessed;
+  std::vector<std::string> serialized;
+};
+
+// Test that loading in parallel and in batches matches loading serially
+int testStreamingLoad()
+{
+  int rv = 0;
+
+  std::ostringstream gog;
+  gog << FILE_VERSION;
+  const size_t numShapes = 2000;
+  for (size_t k = 0; k < numShapes; ++k)
+  {
+    gog << "start\n line\n 3d name Line " << k << "\n lla 25.2 53.2 10.\n lla 22.3 " << (54.0 + k * 0.001) << " 10.\n end\n";
+    // Error and comment outside of a block should not disturb splitting
+    if (k % 500 == 0)
+      gog << "# comment\n end\n";
+  }
+
+  simVis::GOG::Parser parser;
+  parser.setNumLoadThreads(0);
+  std::stringstream serialInput(gog.str());
+  TestLoadCallback serial(false);
+  rv += SDK_ASSERT(parser.createGOGs(serialInput, simVis::GOG::GOGNODE_GEOGRAPHIC, serial));
+  rv += SDK_ASSERT(serial.serialized.size() == numShapes);
+  rv += SDK_ASSERT(serial.numBatches > 1);
+
+  parser.setNumLoadThreads(4);
+  std::stringstream parallelInput(gog.str());
+  TestLoadCallback parallel(false);
+  rv += SDK_ASSERT(parser.createGOGs(parallelInput, simVis::GOG::GOGNODE_GEOGRAPHIC, parallel));
+  rv += SDK_ASSERT(parallel.serialized == serial.serialized);
+  rv += SDK_ASSERT(parallel.linesProcessed == serial.linesProcessed);
+
+  // Canceling stops after the first batch
+  std::stringstream canceledInput(gog.str());
+  TestLoadCallback canceled(true);
+  rv += SDK_ASSERT(!parser.createGOGs(canceledInput, simVis::GOG::GOGNODE_GEOGRAPHIC, canceled));
+  rv += SDK_ASSERT(canceled.numBatches == 1);
+  rv += SDK_ASSERT(canceled.serialized.size() < numShapes);
+
+  return rv;
+}
+
+// Test that GOGs written in binary load the same as the text they were written from
+int testBinaryRoundTrip()
+{
+  int rv = 0;
+
+  const std::string textGog = FILE_VERSION +
+    "start\n line\n 3d name Line 1\n linecolor hex 0xff00ff00\n linewidth 3\n lla 26.13568698 55.28931414 5000.\n lla \"26.0 N\" \"55.0 E\" 5000.\n end\n"
+    "start\n poly\n filled\n fillcolor yellow\n altitudemode relativetoground\n lla 25.2 53.2 10.\n lla 22.3 54.1 10.\n lla 24.1 53.8 10.\n end\n"
+    "start\n circle\n centerlla 24.0 54.0 0.\n radius 1000\n linestyle dashed\n end\n"
+    "start\n annotation First Label\n lla 22.0 55.0 0.\n annotation Second Label\n lla 22.5 55.5 0.\n fontsize 18\n end\n";
+
+  simVis::GOG::Parser parser;
+
+  // Meta data must survive the round trip exactly
+  std::stringstream textInput(textGog);
+  osgEarth::Config textConfig;
+  std::vector<simVis::GOG::GogMetaData> textMetaData;
+  rv += SDK_ASSERT(parser.parse(textInput, textConfig, textMetaData));
+
+  std::stringstream binary(std::ios::in | std::ios::out | std::ios::binary);
+  rv += SDK_ASSERT(simVis::GOG::BinaryFormat::write(textConfig, textMetaData, binary));
+  rv += SDK_ASSERT(simVis::GOG::BinaryFormat::isBinary(binary));
+  osgEarth::Config binaryConfig;
+  std::vector<simVis::GOG::GogMetaData> binaryMetaData;
+  rv += SDK_ASSERT(simVis::GOG::BinaryFormat::read(binary, binaryConfig, binaryMetaData));
+  rv += SDK_ASSERT(binaryConfig.toJSON() == textConfig.toJSON());
+  rv += SDK_ASSERT(binaryMetaData.size() == textMetaData.size());
+  for (size_t k = 0; k < textMetaData.size() && k < binaryMetaData.size(); ++k)
+  {
+    rv += SDK_ASSERT(binaryMetaData[k].metadata == textMetaData[k].metadata);
+    rv += SDK_ASSERT(binaryMetaData[k].shape == textMetaData[k].shape);
+    rv += SDK_ASSERT(binaryMetaData[k].isSetExplicitly(simVis::GOG::GOG_LINE_STYLE_SET) == textMetaData[k].isSetExplicitly(simVis::GOG::GOG_LINE_STYLE_SET));
+    rv += SDK_ASSERT(binaryMetaData[k].isSetExplicitly(simVis::GOG::GOG_FONT_SIZE_SET) == textMetaData[k].isSetExplicitly(simVis::GOG::GOG_FONT_SIZE_SET));
+  }
+
+  // Nodes loaded from binary must serialize the same as nodes loaded from text
+  simVis::GOG::Parser::OverlayNodeVector textGogs;
+  std::vector<simVis::GOG::GogFollowData> textFollowData;
+  std::stringstream input(textGog);
+  rv += SDK_ASSERT(parser.loadGOGs(input, simVis::GOG::GOGNODE_GEOGRAPHIC, textGogs, textFollowData));
+
+  std::stringstream textForBinary(textGog);
+  std::stringstream binaryGog(std::ios::in | std::ios::out | std::ios::binary);
+  rv += SDK_ASSERT(parser.writeBinaryGOGs(textForBinary, binaryGog));
+  simVis::GOG::Parser::OverlayNodeVector binaryGogs;
+  std::vector<simVis::GOG::GogFollowData> binaryFollowData;
+  rv += SDK_ASSERT(parser.loadGOGs(binaryGog, simVis::GOG::GOGNODE_GEOGRAPHIC, binaryGogs, binaryFollowData));
+
+  rv += SDK_ASSERT(textGogs.size() == 5);
+  rv += SDK_ASSERT(binaryGogs.size() == textGogs.size());
+  for (size_t k = 0; k < textGogs.size() && k < binaryGogs.size(); ++k)
+  {
+    std::ostringstream textOs;
+    textGogs[k]->serializeToStream(textOs);
+    std::ostringstream binaryOs;
+    binaryGogs[k]->serializeToStream(binaryOs);
+    rv += SDK_ASSERT(textOs.str() == binaryOs.str());
+  }
+  clearItems(textGogs, textFollowData, input);
+  clearItems(binaryGogs, binaryFollowData, binaryGog);
+
+  // Truncated data fails cleanly
+  std::stringstream truncated(std::ios::in | std::ios::out | std::ios::binary);
+  truncated.str(binary.str().substr(0, binary.str().size() / 2));
+  osgEarth::Config truncatedConfig;
+  std::vector<simVis::GOG::GogMetaData> truncatedMetaData;
+  rv += SDK_ASSERT(!simVis::GOG::BinaryFormat::read(truncated, truncatedConfig, truncatedMetaData));
+
+  return rv;
+}
+
 }
 
 int GogTest(int argc, char* argv[])
@@ -426,6 +578,8 @@ int GogTest(int argc, char* argv[])
   // Run tests
   rv += testLoadRelativeAndAbsolute();
   rv += testParseMetaData();
+  rv += testStreamingLoad();
+  rv += testBinaryRoundTrip();
 
   // Shut down protobuf lib for valgrind testing
   google::protobuf::ShutdownProtobufLibrary();
@@ -0,0 +1,211 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include "osg/ref_ptr"
+#include "simCore/Common/SDKAssert.h"
+#include "simVis/LabelContentCache.h"
+#include "simVis/LabelContentManager.h"
+
+namespace
+{
+
+/** Counts the strings it creates, and returns the count as the string */
+class CountingCallback : public simVis::NullEntityCallback
+{
+public:
+  CountingCallback()
+    : count(0)
+  {
+  }
+
+  virtual std::string createString(const simData::PlatformPrefs& prefs, const simData::PlatformUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+  {
+    return next_();
+  }
+
+  virtual std::string createString(const simData::BeamPrefs& prefs, const simData::BeamUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+  {
+    return next_();
+  }
+
+  virtual std::string createString(const simData::GatePrefs& prefs, const simData::GateUpdate& lastUpdate, const simData::LabelPrefs_DisplayFields& fields)
+  {
+    return next_();
+  }
+
+  int count;
+
+private:
+  std::string next_()
+  {
+    ++count;
+    return std::string(1, static_cast<char>('a' + count));
+  }
+};
+
+/** Counting callback that does not opt in to caching */
+class UncachedCallback : public CountingCallback
+{
+public:
+  virtual bool cacheable() const
+  {
+    return false;
+  }
+};
+
+int testPlatform()
+{
+  int rv = 0;
+  osg::ref_ptr<CountingCallback> callback = new CountingCallback;
+  osg::ref_ptr<simVis::LabelContentCache> cache = new simVis::LabelContentCache;
+  simData::PlatformPrefs prefs;
+  simData::PlatformUpdate update;
+  update.set_time(1.0);
+  update.set_x(100.0);
+  simData::LabelPrefs_DisplayFields fields;
+  fields.set_xlat(true);
+  simVis::LabelContentCache::resetStatistics();
+
+  // Same inputs reuse the string
+  const std::string first = cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields) == first);
+  rv += SDK_ASSERT(callback->count == 1);
+  // Time alone does not change the inputs of the position fields
+  update.set_time(2.0);
+  rv += SDK_ASSERT(cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields) == first);
+  rv += SDK_ASSERT(callback->count == 1);
+  rv += SDK_ASSERT(simVis::LabelContentCache::statistics().requests == 3);
+  rv += SDK_ASSERT(simVis::LabelContentCache::statistics().generated == 1);
+
+  // Slots are independent
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_HOVER, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 2);
+  rv += SDK_ASSERT(cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields) == first);
+
+  // Changing a value, the fields, or invalidating regenerates
+  update.set_x(101.0);
+  rv += SDK_ASSERT(cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields) != first);
+  rv += SDK_ASSERT(callback->count == 3);
+  fields.set_speed(true);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 4);
+  cache->invalidate();
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 5);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 5);
+
+  // Fields that depend on other data always regenerate
+  fields.set_genericdata(true);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 7);
+
+  // Category data is cached until it changes
+  fields.set_genericdata(false);
+  fields.set_categorydata(true);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 8);
+  cache->invalidateCategoryData();
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 9);
+  // Strings without category data survive a category data change
+  fields.set_categorydata(false);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_HOVER, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 10);
+  cache->invalidateCategoryData();
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_HOVER, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 10);
+  return rv;
+}
+
+int testBeamGate()
+{
+  int rv = 0;
+  osg::ref_ptr<CountingCallback> callback = new CountingCallback;
+  osg::ref_ptr<simVis::LabelContentCache> cache = new simVis::LabelContentCache;
+  simData::BeamPrefs beamPrefs;
+  simData::BeamUpdate beamUpdate;
+  beamUpdate.set_azimuth(0.5);
+  simData::LabelPrefs_DisplayFields fields;
+  fields.set_yaw(true);
+
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, beamPrefs, beamUpdate, fields);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, beamPrefs, beamUpdate, fields);
+  rv += SDK_ASSERT(callback->count == 1);
+  beamUpdate.set_range(1000.0);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, beamPrefs, beamUpdate, fields);
+  rv += SDK_ASSERT(callback->count == 2);
+
+  // Position comes from the host platform, so it is not cached
+  fields.set_xlat(true);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, beamPrefs, beamUpdate, fields);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, beamPrefs, beamUpdate, fields);
+  rv += SDK_ASSERT(callback->count == 4);
+
+  simData::GatePrefs gatePrefs;
+  simData::GateUpdate gateUpdate;
+  fields.set_xlat(false);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_HOOK, gatePrefs, gateUpdate, fields);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_HOOK, gatePrefs, gateUpdate, fields);
+  rv += SDK_ASSERT(callback->count == 5);
+  gateUpdate.set_centroid(20.0);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_HOOK, gatePrefs, gateUpdate, fields);
+  rv += SDK_ASSERT(callback->count == 6);
+  return rv;
+}
+
+int testUncached()
+{
+  int rv = 0;
+  osg::ref_ptr<UncachedCallback> callback = new UncachedCallback;
+  osg::ref_ptr<simVis::LabelContentCache> cache = new simVis::LabelContentCache;
+  simData::PlatformPrefs prefs;
+  simData::PlatformUpdate update;
+  simData::LabelPrefs_DisplayFields fields;
+  fields.set_xlat(true);
+  simVis::LabelContentCache::resetStatistics();
+
+  // Callbacks that do not opt in are called for every request
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  cache->createString(*callback, simVis::LabelContentCache::SLOT_LABEL, prefs, update, fields);
+  rv += SDK_ASSERT(callback->count == 2);
+  rv += SDK_ASSERT(simVis::LabelContentCache::statistics().requests == 2);
+  rv += SDK_ASSERT(simVis::LabelContentCache::statistics().generated == 2);
+  return rv;
+}
+
+}
+
+int LabelContentCacheTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += SDK_ASSERT(testPlatform() == 0);
+  rv += SDK_ASSERT(testBeamGate() == 0);
+  rv += SDK_ASSERT(testUncached() == 0);
+
+  std::cout << "simVis LabelContentCacheTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
@@ -0,0 +1,179 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include <vector>
+#include "osg/MatrixTransform"
+#include "osg/observer_ptr"
+#include "osg/ref_ptr"
+#include "osgEarth/SpatialReference"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simVis/LocalGrid.h"
+#include "simVis/Locator.h"
+
+namespace
+{
+
+typedef std::vector<osg::ref_ptr<simVis::LocalGridNode> > GridVector;
+
+/** Returns the transform holding the grid lines */
+const osg::MatrixTransform* graphicsTransform(const simVis::LocalGridNode& grid)
+{
+  for (unsigned int k = 0; k < grid.getNumChildren(); ++k)
+  {
+    const osg::MatrixTransform* xform = dynamic_cast<const osg::MatrixTransform*>(grid.getChild(k));
+    if (xform)
+      return xform;
+  }
+  return NULL;
+}
+
+/** Returns the grid lines currently displayed by the grid */
+const osg::Node* graphics(const simVis::LocalGridNode& grid)
+{
+  const osg::MatrixTransform* xform = graphicsTransform(grid);
+  return (xform && xform->getNumChildren() != 0) ? xform->getChild(0) : NULL;
+}
+
+/** Returns true if every grid displays the same, non-NULL, grid lines */
+bool allShareGraphics(const GridVector& grids)
+{
+  const osg::Node* first = graphics(*grids.front());
+  if (first == NULL)
+    return false;
+  for (GridVector::const_iterator i = grids.begin(); i != grids.end(); ++i)
+  {
+    if (graphics(**i) != first)
+      return false;
+  }
+  return true;
+}
+
+/** Applies the prefs to all grids */
+void setPrefs(const GridVector& grids, const simData::LocalGridPrefs& prefs)
+{
+  for (GridVector::const_iterator i = grids.begin(); i != grids.end(); ++i)
+    (*i)->setPrefs(prefs);
+}
+
+int testRangeRings(simVis::Locator* hostLocator)
+{
+  int rv = 0;
+
+  simData::LocalGridPrefs prefs;
+  prefs.set_drawgrid(true);
+  prefs.set_gridtype(simData::LocalGridPrefs_Type_RANGE_RINGS);
+  prefs.set_gridlabeldraw(false);
+  prefs.set_sizeunits(simData::UNITS_METERS);
+  prefs.set_size(2000.0);
+
+  // All grids with the same prefs share one set of lines
+  GridVector grids;
+  for (int k = 0; k < 10; ++k)
+    grids.push_back(new simVis::LocalGridNode(hostLocator));
+  setPrefs(grids, prefs);
+  rv += SDK_ASSERT(allShareGraphics(grids));
+
+  // Label changes rebuild the labels, but not the lines
+  const osg::ref_ptr<const osg::Node> before = graphics(*grids[0]);
+  prefs.set_gridlabeldraw(true);
+  prefs.set_gridlabelcolor(0x00ff00ff);
+  setPrefs(grids, prefs);
+  rv += SDK_ASSERT(allShareGraphics(grids));
+  rv += SDK_ASSERT(graphics(*grids[0]) == before.get());
+
+  // A small size change rescales the existing lines
+  prefs.set_size(1800.0);
+  setPrefs(grids, prefs);
+  rv += SDK_ASSERT(allShareGraphics(grids));
+  rv += SDK_ASSERT(graphics(*grids[0]) == before.get());
+  const osg::MatrixTransform* xform = graphicsTransform(*grids[0]);
+  rv += SDK_ASSERT(xform != NULL);
+  if (xform)
+  {
+    // Rings are generated at 1024 m, and displayed at a radius of 900 m
+    rv += SDK_ASSERT(simCore::areEqual(xform->getMatrix().getScale().x(), 900.0 / 1024.0, 1e-6));
+  }
+
+  // Color change needs new lines, shared again by all grids
+  prefs.set_gridcolor(0xff0000ff);
+  setPrefs(grids, prefs);
+  rv += SDK_ASSERT(allShareGraphics(grids));
+  rv += SDK_ASSERT(graphics(*grids[0]) != before.get());
+
+  // Lines are released with the grids that display them
+  const osg::observer_ptr<const osg::Node> colored = graphics(*grids[0]);
+  rv += SDK_ASSERT(colored.valid());
+  grids.clear();
+  rv += SDK_ASSERT(!colored.valid());
+  osg::ref_ptr<simVis::LocalGridNode> grid = new simVis::LocalGridNode(hostLocator);
+  grid->setPrefs(prefs);
+  rv += SDK_ASSERT(graphics(*grid) != NULL);
+  return rv;
+}
+
+int testCartesian(simVis::Locator* hostLocator)
+{
+  int rv = 0;
+
+  simData::LocalGridPrefs prefs;
+  prefs.set_drawgrid(true);
+  prefs.set_gridtype(simData::LocalGridPrefs_Type_CARTESIAN);
+  prefs.set_gridlabeldraw(false);
+  prefs.set_sizeunits(simData::UNITS_METERS);
+
+  // Cartesian lines scale exactly, so any size shares the same lines
+  osg::ref_ptr<simVis::LocalGridNode> small = new simVis::LocalGridNode(hostLocator);
+  osg::ref_ptr<simVis::LocalGridNode> large = new simVis::LocalGridNode(hostLocator);
+  prefs.set_size(10.0);
+  small->setPrefs(prefs);
+  prefs.set_size(50000.0);
+  large->setPrefs(prefs);
+  rv += SDK_ASSERT(graphics(*small) != NULL);
+  rv += SDK_ASSERT(graphics(*small) == graphics(*large));
+  const osg::MatrixTransform* xform = graphicsTransform(*large);
+  if (xform)
+    rv += SDK_ASSERT(simCore::areEqual(xform->getMatrix().getScale().x(), 25000.0));
+
+  // Switching types needs different lines
+  prefs.set_gridtype(simData::LocalGridPrefs_Type_POLAR);
+  large->setPrefs(prefs);
+  rv += SDK_ASSERT(graphics(*large) != NULL);
+  rv += SDK_ASSERT(graphics(*small) != graphics(*large));
+  return rv;
+}
+
+}
+
+int LocalGridTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  osg::ref_ptr<osgEarth::SpatialReference> srs = osgEarth::SpatialReference::create("wgs84");
+  osg::ref_ptr<simVis::Locator> hostLocator = new simVis::Locator(srs.get());
+  rv += SDK_ASSERT(testRangeRings(hostLocator.get()) == 0);
+  rv += SDK_ASSERT(testCartesian(hostLocator.get()) == 0);
+
+  std::cout << "simVis LocalGridTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
@@ -152,6 +152,140 @@ int testGetLocatorPositionOrientation(simVis::Locator* loc)
   return rv;
 }
 
+/** Returns true if the two matrices are equal within a small tolerance */
+bool matricesEqual(const osg::Matrixd& a, const osg::Matrixd& b)
+{
+  for (int row = 0; row < 4; ++row)
+  {
+    for (int col = 0; col < 4; ++col)
+    {
+      if (!simCore::areEqual(a(row, col), b(row, col), 1e-6))
+        return false;
+    }
+  }
+  return true;
+}
+
+/** Host with an offset child, a partially inheriting grandchild, and a resolved locator on the grandchild */
+struct LocatorChain
+{
+  osg::ref_ptr<simVis::Locator> host;
+  osg::ref_ptr<simVis::Locator> child;
+  osg::ref_ptr<simVis::Locator> grandchild;
+  osg::ref_ptr<simVis::Locator> resolved;
+
+  LocatorChain(const osgEarth::SpatialReference* srs, const simCore::Coordinate& hostCoord)
+  {
+    host = new simVis::Locator(srs);
+    host->setCoordinate(hostCoord, 100.0);
+    child = new simVis::Locator(host.get());
+    child->setLocalOffsets(simCore::Vec3(10.0, 20.0, 30.0), simCore::Vec3(0.1, 0.2, 0.3));
+    grandchild = new simVis::Locator(child.get(), simVis::Locator::COMP_POSITION | simVis::Locator::COMP_HEADING);
+    grandchild->setLocalOffsets(simCore::Vec3(-5.0, 0.0, 2.0), simCore::Vec3(0.5, 0.0, 0.0));
+    resolved = new simVis::ResolvedPositionOrientationLocator(grandchild.get(), simVis::Locator::COMP_ALL);
+  }
+};
+
+/** Returns 0 if every locator in the chains reports the same matrices */
+int compareChains(const LocatorChain& cached, const LocatorChain& fresh)
+{
+  const unsigned int masks[] = {
+    simVis::Locator::COMP_ALL,
+    simVis::Locator::COMP_POSITION,
+    simVis::Locator::COMP_POSITION | simVis::Locator::COMP_HEADING,
+    simVis::Locator::COMP_ORIENTATION
+  };
+  int rv = 0;
+  for (size_t k = 0; k < sizeof(masks) / sizeof(masks[0]); ++k)
+  {
+    osg::Matrixd a;
+    osg::Matrixd b;
+    cached.host->getLocatorMatrix(a, masks[k]);
+    fresh.host->getLocatorMatrix(b, masks[k]);
+    rv += SDK_ASSERT(matricesEqual(a, b));
+    cached.child->getLocatorMatrix(a, masks[k]);
+    fresh.child->getLocatorMatrix(b, masks[k]);
+    rv += SDK_ASSERT(matricesEqual(a, b));
+    cached.grandchild->getLocatorMatrix(a, masks[k]);
+    fresh.grandchild->getLocatorMatrix(b, masks[k]);
+    rv += SDK_ASSERT(matricesEqual(a, b));
+    cached.resolved->getLocatorMatrix(a, masks[k]);
+    fresh.resolved->getLocatorMatrix(b, masks[k]);
+    rv += SDK_ASSERT(matricesEqual(a, b));
+  }
+  return rv;
+}
+
+/** Verifies that cached locator matrices follow changes anywhere up the parent chain, notified or not */
+int testMatrixCache(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  const simCore::Coordinate coord1(simCore::COORD_SYS_LLA, simCore::Vec3(0.4, -1.2, 1000.0), simCore::Vec3(0.3, 0.1, -0.2));
+  const simCore::Coordinate coord2(simCore::COORD_SYS_LLA, simCore::Vec3(-0.2, 2.1, 50.0), simCore::Vec3(-1.0, 0.4, 0.6));
+
+  LocatorChain cached(srs, coord1);
+  // Fill the caches, and verify repeated queries are stable
+  rv += SDK_ASSERT(compareChains(cached, LocatorChain(srs, coord1)) == 0);
+  rv += SDK_ASSERT(compareChains(cached, LocatorChain(srs, coord1)) == 0);
+
+  // Host change without notification must still reach the grandchildren
+  cached.host->setCoordinate(coord2, 101.0, std::numeric_limits<double>::max(), false);
+  rv += SDK_ASSERT(compareChains(cached, LocatorChain(srs, coord2)) == 0);
+
+  // Middle of the chain changes
+  cached.child->setLocalOffsets(simCore::Vec3(1.0, 2.0, 3.0), simCore::Vec3(), std::numeric_limits<double>::max(), false);
+  LocatorChain fresh(srs, coord2);
+  fresh.child->setLocalOffsets(simCore::Vec3(1.0, 2.0, 3.0), simCore::Vec3());
+  rv += SDK_ASSERT(compareChains(cached, fresh) == 0);
+
+  cached.grandchild->setComponentsToInherit(simVis::Locator::COMP_ALL);
+  fresh.grandchild->setComponentsToInherit(simVis::Locator::COMP_ALL);
+  rv += SDK_ASSERT(compareChains(cached, fresh) == 0);
+
+  // Reparenting the grandchild onto the host skips the child's offsets
+  cached.grandchild->setParentLocator(cached.host.get());
+  fresh.grandchild->setParentLocator(fresh.host.get());
+  rv += SDK_ASSERT(compareChains(cached, fresh) == 0);
+  return rv;
+}
+
+
+/** Verifies that LLA values prepared ahead of time match the ones a caching locator computes on demand */
+int testPreparedLla(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  const simCore::Coordinate lla(simCore::COORD_SYS_LLA, simCore::Vec3(0.4, -1.2, 1000.0), simCore::Vec3(0.3, 0.1, -0.2));
+  simCore::Coordinate ecef;
+  simCore::CoordinateConverter::convertGeodeticToEcef(lla, ecef);
+
+  osg::ref_ptr<simVis::CachingLocator> computed = new simVis::CachingLocator(srs);
+  computed->setCoordinate(ecef, 100.0, 0.0);
+  simCore::Vec3 expectedPos;
+  simCore::Vec3 expectedOri;
+  rv += SDK_ASSERT(computed->getLocatorPositionOrientation(&expectedPos, &expectedOri, simCore::COORD_SYS_LLA));
+
+  simCore::Vec3 preparedPos;
+  simCore::Vec3 preparedOri;
+  simVis::CachingLocator::computeLlaPositionOrientation(ecef, preparedPos, preparedOri);
+  rv += SDK_ASSERT(simCore::v3AreEqual(preparedPos, expectedPos, 1e-9));
+  rv += SDK_ASSERT(simCore::v3AreEqual(preparedOri, expectedOri, 1e-9));
+
+  // Seeded values are returned as-is
+  osg::ref_ptr<simVis::CachingLocator> seeded = new simVis::CachingLocator(srs);
+  seeded->setCoordinate(ecef, preparedPos, preparedOri, 100.0, 0.0);
+  simCore::Vec3 pos;
+  simCore::Vec3 ori;
+  rv += SDK_ASSERT(seeded->getLocatorPositionOrientation(&pos, &ori, simCore::COORD_SYS_LLA));
+  rv += SDK_ASSERT(pos == preparedPos && ori == preparedOri);
+  rv += SDK_ASSERT(seeded->getLocatorPosition(&pos, simCore::COORD_SYS_LLA) && pos == preparedPos);
+
+  // Seed is ignored when offsets make the locator differ from its coordinate
+  seeded->setLocalOffsets(simCore::Vec3(10.0, 0.0, 0.0), simCore::Vec3(), 100.0, false);
+  seeded->setCoordinate(ecef, preparedPos, preparedOri, 100.0, 0.0);
+  rv += SDK_ASSERT(seeded->getLocatorPosition(&pos, simCore::COORD_SYS_LLA) && !simCore::v3AreEqual(pos, preparedPos, 1e-9));
+  return rv;
+}
+
 }
 
 int LocatorTest(int argc, char* argv[])
@@ -168,6 +302,8 @@ int LocatorTest(int argc, char* argv[])
 
   // Run tests
   rv += testGetLocatorPositionOrientation(loc.get());
+  rv += testMatrixCache(srs.get());
+  rv += testPreparedLla(srs.get());
 
   return rv;
 }
@@ -0,0 +1,270 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include <limits>
+#include <string>
+#include "osg/Geode"
+#include "osg/Geometry"
+#include "osg/Group"
+#include "osg/ref_ptr"
+#include "osg/ValueObject"
+#include "osgDB/FileNameUtils"
+#include "osgDB/ReaderWriter"
+#include "osgDB/Registry"
+#include "simCore/Common/SDKAssert.h"
+#include "simVis/ModelCache.h"
+
+namespace
+{
+
+/** Extension handled by the in-memory test reader */
+static const std::string TEST_EXT = "modelcachetest";
+
+/** Creates models in memory; file names starting with "big" produce larger geometry than the rest */
+class TestModelReader : public osgDB::ReaderWriter
+{
+public:
+  TestModelReader()
+  {
+    supportsExtension(TEST_EXT, "simVis ModelCache test models");
+  }
+
+  virtual const char* className() const { return "ModelCacheTest Reader"; }
+
+  virtual ReadResult readNode(const std::string& filename, const osgDB::ReaderWriter::Options* options) const
+  {
+    if (!acceptsExtension(osgDB::getLowerCaseFileExtension(filename)))
+      return ReadResult::FILE_NOT_HANDLED;
+    const std::string name = osgDB::getSimpleFileName(filename);
+    const unsigned int numVerts = (name.compare(0, 3, "big") == 0) ? 1000 : 10;
+    osg::ref_ptr<osg::Geometry> geom = new osg::Geometry;
+    geom->setVertexArray(new osg::Vec3Array(numVerts));
+    osg::ref_ptr<osg::Geode> geode = new osg::Geode;
+    geode->addDrawable(geom.get());
+    return geode.release();
+  }
+};
+
+/** Counts the models it receives, and reports a fixed load priority */
+class CountingCallback : public simVis::ModelCache::ModelReadyCallback
+{
+public:
+  explicit CountingCallback(double priority)
+    : count(0),
+      priority_(priority)
+  {
+  }
+
+  virtual void loadFinished(const osg::ref_ptr<osg::Node>& model, bool isImage, const std::string& uri)
+  {
+    ++count;
+    lastUri = uri;
+  }
+
+  virtual double loadPriority(const osg::Vec3d& eye) const
+  {
+    return priority_;
+  }
+
+  int count;
+  std::string lastUri;
+
+private:
+  double priority_;
+};
+
+/** Returns the URI of the only active load in the cache's loader node, or empty string if not exactly one */
+std::string activeLoad(const simVis::ModelCache& cache)
+{
+  const osg::Group* loader = cache.asyncLoaderNode()->asGroup();
+  std::string uri;
+  if (loader->getNumChildren() == 1)
+    loader->getChild(0)->getUserValue("uri", uri);
+  return uri;
+}
+
+std::string uriFor(const std::string& name)
+{
+  return name + "." + TEST_EXT;
+}
+
+int testEvictionOrder()
+{
+  int rv = 0;
+  simVis::ModelCache cache;
+  cache.setMaxCacheEntries(2);
+
+  osg::ref_ptr<osg::Node> a = cache.getOrCreateIconModel(uriFor("a"));
+  osg::ref_ptr<osg::Node> b = cache.getOrCreateIconModel(uriFor("b"));
+  rv += SDK_ASSERT(a.valid() && b.valid());
+  rv += SDK_ASSERT(cache.statistics().misses == 2);
+  rv += SDK_ASSERT(cache.statistics().syncLoads == 2);
+  rv += SDK_ASSERT(cache.statistics().cachedEntries == 2);
+
+  // Touching "a" makes "b" the least recently used
+  rv += SDK_ASSERT(cache.getOrCreateIconModel(uriFor("a")) == a.get());
+  rv += SDK_ASSERT(cache.statistics().hits == 1);
+  cache.getOrCreateIconModel(uriFor("c"));
+  rv += SDK_ASSERT(cache.statistics().evictions == 1);
+  rv += SDK_ASSERT(cache.statistics().cachedEntries == 2);
+
+  // "a" survived, "b" needs a reload
+  rv += SDK_ASSERT(cache.getOrCreateIconModel(uriFor("a")) == a.get());
+  rv += SDK_ASSERT(cache.statistics().hits == 2);
+  rv += SDK_ASSERT(cache.getOrCreateIconModel(uriFor("b")) != b.get());
+  rv += SDK_ASSERT(cache.statistics().misses == 4);
+  // Reloading "b" evicted "c", the least recently used after "a" was touched
+  rv += SDK_ASSERT(cache.statistics().evictions == 2);
+  cache.getOrCreateIconModel(uriFor("a"));
+  rv += SDK_ASSERT(cache.statistics().hits == 3);
+  rv += SDK_ASSERT(cache.statistics().misses == 4);
+  rv += SDK_ASSERT(cache.statistics().hitRate() == 3.0 / 7.0);
+
+  // Shrinking the limit evicts immediately
+  cache.setMaxCacheEntries(1);
+  rv += SDK_ASSERT(cache.statistics().cachedEntries == 1);
+  rv += SDK_ASSERT(cache.getOrCreateIconModel(uriFor("a")) == a.get());
+  rv += SDK_ASSERT(cache.statistics().hits == 4);
+
+  cache.resetStatistics();
+  rv += SDK_ASSERT(cache.statistics().hits == 0);
+  rv += SDK_ASSERT(cache.statistics().cachedEntries == 1);
+  return rv;
+}
+
+int testByteLimit()
+{
+  int rv = 0;
+  simVis::ModelCache cache;
+  osg::ref_ptr<osg::Node> small1 = cache.getOrCreateIconModel(uriFor("small1"));
+  osg::ref_ptr<osg::Node> small2 = cache.getOrCreateIconModel(uriFor("small2"));
+  const size_t smallBytes = simVis::ModelCache::estimateByteSize(small1.get());
+  rv += SDK_ASSERT(smallBytes > 0);
+  rv += SDK_ASSERT(cache.statistics().cachedBytes == 2 * smallBytes);
+
+  // Room for the big model plus one small model, but not both small models
+  simVis::ModelCache sizingCache;
+  osg::ref_ptr<osg::Node> bigNode = sizingCache.getOrCreateIconModel(uriFor("big"));
+  const size_t bigBytes = simVis::ModelCache::estimateByteSize(bigNode.get());
+  rv += SDK_ASSERT(bigBytes > 2 * smallBytes);
+  cache.setMaxCacheBytes(bigBytes + smallBytes);
+  rv += SDK_ASSERT(cache.statistics().evictions == 0);
+
+  cache.getOrCreateIconModel(uriFor("big"));
+  rv += SDK_ASSERT(cache.statistics().evictions == 1);
+  rv += SDK_ASSERT(cache.statistics().cachedEntries == 2);
+  rv += SDK_ASSERT(cache.statistics().cachedBytes <= cache.maxCacheBytes());
+  // Oldest entry went first
+  rv += SDK_ASSERT(cache.getOrCreateIconModel(uriFor("small2")) == small2.get());
+
+  // A single entry is kept even if it alone exceeds the limit
+  cache.setMaxCacheBytes(1);
+  rv += SDK_ASSERT(cache.statistics().cachedEntries == 1);
+  rv += SDK_ASSERT(cache.statistics().cachedBytes == smallBytes);
+  rv += SDK_ASSERT(cache.getOrCreateIconModel(uriFor("small2")) == small2.get());
+
+  // Erasing returns the bytes
+  cache.erase(uriFor("small2"));
+  rv += SDK_ASSERT(cache.statistics().cachedEntries == 0);
+  rv += SDK_ASSERT(cache.statistics().cachedBytes == 0);
+  return rv;
+}
+
+int testPriority()
+{
+  int rv = 0;
+  rv += SDK_ASSERT(simVis::ModelCache::loadPriority(true, 1.0e6) > simVis::ModelCache::loadPriority(false, 0.0));
+  rv += SDK_ASSERT(simVis::ModelCache::loadPriority(true, 10.0) > simVis::ModelCache::loadPriority(true, 100.0));
+  rv += SDK_ASSERT(simVis::ModelCache::loadPriority(false, 10.0) > simVis::ModelCache::loadPriority(false, 100.0));
+  // Distances on the scale of ECEF coordinates stay ordered
+  rv += SDK_ASSERT(simVis::ModelCache::loadPriority(true, 2.0e7) > simVis::ModelCache::loadPriority(true, 2.0e7 + 10.0));
+  rv += SDK_ASSERT(simVis::ModelCache::loadPriority(false, 0.0) > simVis::ModelCache::loadPriority(false, std::numeric_limits<double>::max()));
+
+  simVis::ModelCache cache;
+  // The loader needs a parent to accept asynchronous requests; it is never traversed here
+  osg::ref_ptr<osg::Group> scene = new osg::Group;
+  scene->addChild(cache.asyncLoaderNode());
+  cache.setMaxConcurrentLoads(1);
+
+  osg::ref_ptr<CountingCallback> first = new CountingCallback(0.f);
+  osg::ref_ptr<CountingCallback> low = new CountingCallback(1.f);
+  osg::ref_ptr<CountingCallback> high = new CountingCallback(5.f);
+  osg::ref_ptr<CountingCallback> highToo = new CountingCallback(0.f);
+  cache.asyncLoad(uriFor("first"), first.get());
+  cache.asyncLoad(uriFor("low"), low.get());
+  cache.asyncLoad(uriFor("high"), high.get());
+  cache.asyncLoad(uriFor("high"), highToo.get());
+  rv += SDK_ASSERT(cache.statistics().misses == 3);
+  rv += SDK_ASSERT(cache.statistics().coalesced == 1);
+  rv += SDK_ASSERT(activeLoad(cache) == uriFor("first"));
+
+  // A synchronous load fulfills the active request, and the highest priority waiting request starts next
+  cache.getOrCreateIconModel(uriFor("first"));
+  rv += SDK_ASSERT(first->count == 1);
+  rv += SDK_ASSERT(first->lastUri == uriFor("first"));
+  rv += SDK_ASSERT(activeLoad(cache) == uriFor("high"));
+
+  // Fulfilling a request delivers to every coalesced callback
+  cache.getOrCreateIconModel(uriFor("high"));
+  rv += SDK_ASSERT(high->count == 1);
+  rv += SDK_ASSERT(highToo->count == 1);
+  rv += SDK_ASSERT(low->count == 0);
+  rv += SDK_ASSERT(activeLoad(cache) == uriFor("low"));
+
+  // Fulfilling a waiting request that is not yet active also works
+  osg::ref_ptr<CountingCallback> waiting = new CountingCallback(0.f);
+  cache.asyncLoad(uriFor("waiting"), waiting.get());
+  rv += SDK_ASSERT(activeLoad(cache) == uriFor("low"));
+  cache.getOrCreateIconModel(uriFor("waiting"));
+  rv += SDK_ASSERT(waiting->count == 1);
+  rv += SDK_ASSERT(activeLoad(cache) == uriFor("low"));
+
+  // Cached models are delivered immediately without a request
+  cache.asyncLoad(uriFor("first"), first.get());
+  rv += SDK_ASSERT(first->count == 2);
+  rv += SDK_ASSERT(activeLoad(cache) == uriFor("low"));
+
+  cache.getOrCreateIconModel(uriFor("low"));
+  rv += SDK_ASSERT(low->count == 1);
+  rv += SDK_ASSERT(cache.asyncLoaderNode()->asGroup()->getNumChildren() == 0);
+  return rv;
+}
+
+}
+
+int ModelCacheTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  osg::ref_ptr<osgDB::ReaderWriter> reader = new TestModelReader;
+  osgDB::Registry::instance()->addReaderWriter(reader.get());
+
+  rv += SDK_ASSERT(testEvictionOrder() == 0);
+  rv += SDK_ASSERT(testByteLimit() == 0);
+  rv += SDK_ASSERT(testPriority() == 0);
+
+  osgDB::Registry::instance()->removeReaderWriter(reader.get());
+
+  std::cout << "simVis ModelCacheTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
@@ -0,0 +1,277 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include "OpenThreads/Atomic"
+#include "osgEarth/GeoData"
+#include "osgEarth/SpatialReference"
+#include "simCore/Calc/Angle.h"
+#include "simCore/Calc/Coordinate.h"
+#include "simCore/Calc/Math.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/Version.h"
+#include "simVis/RadialLOS.h"
+
+namespace
+{
+
+/** Approximate meters per degree at the equator */
+static const double METERS_PER_DEGREE = 111319.49;
+
+/** Synthetic elevation layer: flat ground at sea level with an optional rectangular block */
+class SyntheticElevation : public simVis::RadialLOS::HeightSampler
+{
+public:
+  SyntheticElevation()
+    : west_(0.0),
+      south_(0.0),
+      east_(0.0),
+      north_(0.0),
+      height_(0.0)
+  {
+  }
+
+  /** Raises a block of terrain, in degrees, to the height in meters */
+  void setBlock(double west, double south, double east, double north, double height)
+  {
+    west_ = west;
+    south_ = south;
+    east_ = east;
+    north_ = north;
+    height_ = height;
+  }
+
+  virtual bool getHeight(osg::Node* patch, const osgEarth::GeoPoint& point, double& hamsl, double& hae) const
+  {
+    ++calls_;
+    const bool inBlock = point.x() >= west_ && point.x() <= east_ && point.y() >= south_ && point.y() <= north_;
+    hamsl = inBlock ? height_ : 0.0;
+    hae = hamsl;
+    return true;
+  }
+
+  /** Returns the number of samples taken since the last call */
+  unsigned int takeCalls()
+  {
+    return calls_.exchange(0);
+  }
+
+private:
+  double west_;
+  double south_;
+  double east_;
+  double north_;
+  double height_;
+  mutable OpenThreads::Atomic calls_;
+};
+
+/** Returns the radial closest to the azimuth, in degrees */
+const simVis::RadialLOS::Radial* findRadial(const simVis::RadialLOS& los, double azimDeg)
+{
+  const simVis::RadialLOS::Radial* closest = NULL;
+  double closestDelta = 0.0;
+  const simVis::RadialLOS::RadialVector& radials = los.getRadials();
+  for (simVis::RadialLOS::RadialVector::const_iterator i = radials.begin(); i != radials.end(); ++i)
+  {
+    const double delta = fabs(simCore::angFixPI(i->azim_rad_ - azimDeg * simCore::DEG2RAD));
+    if (closest == NULL || delta < closestDelta)
+    {
+      closest = &*i;
+      closestDelta = delta;
+    }
+  }
+  return closest;
+}
+
+/** Returns the sample closest to the range, in meters */
+const simVis::RadialLOS::Sample* findSample(const simVis::RadialLOS::Radial* radial, double range)
+{
+  if (radial == NULL)
+    return NULL;
+  for (simVis::RadialLOS::SampleVector::const_iterator i = radial->samples_.begin(); i != radial->samples_.end(); ++i)
+  {
+    if (fabs(i->range_m_ - range) < 1.0)
+      return &*i;
+  }
+  return NULL;
+}
+
+/** Configures a full circle LOS of 10 km at 100 m and 1 degree resolution, which samples in parallel */
+void configure(simVis::RadialLOS& los)
+{
+  los.setMaxRange(simVis::Distance(10.0, osgEarth::Units::KILOMETERS));
+  los.setRangeResolution(simVis::Distance(100.0, osgEarth::Units::METERS));
+  los.setAzimuthalResolution(simVis::Angle(1.0, osgEarth::Units::DEGREES));
+  los.setFieldOfView(simVis::Angle(360.0, osgEarth::Units::DEGREES));
+}
+
+simCore::Coordinate origin(double northMeters)
+{
+  return simCore::Coordinate(simCore::COORD_SYS_LLA, simCore::Vec3(northMeters / METERS_PER_DEGREE * simCore::DEG2RAD, 0.0, 10.0));
+}
+
+int testCompute(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  SyntheticElevation elevation;
+  simVis::RadialLOS los;
+  configure(los);
+
+  // Flat terrain is visible everywhere
+  rv += SDK_ASSERT(los.compute(srs, elevation, origin(0.0)));
+  rv += SDK_ASSERT(los.getRadials().size() >= 360);
+  rv += SDK_ASSERT(los.getNumSamplesPerRadial() >= 100);
+  rv += SDK_ASSERT(elevation.takeCalls() == los.getRadials().size() * los.getNumSamplesPerRadial());
+  const simVis::RadialLOS::RadialVector& radials = los.getRadials();
+  for (simVis::RadialLOS::RadialVector::const_iterator i = radials.begin(); i != radials.end(); ++i)
+  {
+    for (simVis::RadialLOS::SampleVector::const_iterator j = i->samples_.begin(); j != i->samples_.end(); ++j)
+      rv += SDK_ASSERT(j->valid_ && j->visible_);
+  }
+
+  // A block 3 to 4 km east hides the terrain behind it
+  elevation.setBlock(3000.0 / METERS_PER_DEGREE, -500.0 / METERS_PER_DEGREE, 4000.0 / METERS_PER_DEGREE, 500.0 / METERS_PER_DEGREE, 500.0);
+  rv += SDK_ASSERT(los.compute(srs, elevation, origin(0.0)));
+  const simVis::RadialLOS::Radial* east = findRadial(los, 90.0);
+  const simVis::RadialLOS::Sample* before = findSample(east, 2000.0);
+  const simVis::RadialLOS::Sample* behind = findSample(east, 6000.0);
+  rv += SDK_ASSERT(before != NULL && before->visible_);
+  rv += SDK_ASSERT(behind != NULL && !behind->visible_);
+  const simVis::RadialLOS::Sample* west = findSample(findRadial(los, -90.0), 6000.0);
+  rv += SDK_ASSERT(west != NULL && west->visible_);
+
+  // A single radial computed alone matches the same radial computed in parallel with the others
+  simVis::RadialLOS single;
+  configure(single);
+  single.setCentralAzimuth(simVis::Angle(east->azim_rad_, osgEarth::Units::RADIANS));
+  single.setFieldOfView(simVis::Angle(0.0, osgEarth::Units::DEGREES));
+  rv += SDK_ASSERT(single.compute(srs, elevation, origin(0.0)));
+  rv += SDK_ASSERT(single.getRadials().size() == 1);
+  if (single.getRadials().size() == 1)
+  {
+    const simVis::RadialLOS::SampleVector& samples = single.getRadials().front().samples_;
+    rv += SDK_ASSERT(samples.size() == east->samples_.size());
+    for (size_t k = 0; k < samples.size() && k < east->samples_.size(); ++k)
+    {
+      rv += SDK_ASSERT(samples[k].visible_ == east->samples_[k].visible_);
+      rv += SDK_ASSERT(samples[k].hae_m_ == east->samples_[k].hae_m_);
+      rv += SDK_ASSERT(samples[k].elev_rad_ == east->samples_[k].elev_rad_);
+    }
+  }
+  return rv;
+}
+
+int testCache(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+
+  // Keys and cell centers
+  const simVis::ElevationSampleCache::Key key = simVis::ElevationSampleCache::makeKey(1.3, -2.6, 0.5);
+  rv += SDK_ASSERT(key.level == 1 && key.x == 2 && key.y == -6);
+  const osg::Vec2d center = simVis::ElevationSampleCache::cellCenter(key);
+  rv += SDK_ASSERT(center.x() == 1.25 && center.y() == -2.75);
+  // Sizes between powers of two round down to the finer level
+  rv += SDK_ASSERT(simVis::ElevationSampleCache::makeKey(0.0, 0.0, 0.3).level == 2);
+
+  SyntheticElevation elevation;
+  elevation.setBlock(3000.0 / METERS_PER_DEGREE, -500.0 / METERS_PER_DEGREE, 4000.0 / METERS_PER_DEGREE, 500.0 / METERS_PER_DEGREE, 500.0);
+  osg::ref_ptr<simVis::ElevationSampleCache> cache = new simVis::ElevationSampleCache();
+  simVis::RadialLOS los;
+  configure(los);
+  los.setElevationCache(cache.get());
+
+  rv += SDK_ASSERT(los.compute(srs, elevation, origin(0.0)));
+  const unsigned int firstCalls = elevation.takeCalls();
+  const size_t numSamples = los.getRadials().size() * los.getNumSamplesPerRadial();
+  rv += SDK_ASSERT(firstCalls > 0 && firstCalls <= numSamples);
+  // Threads may both miss on a cell before either stores it
+  rv += SDK_ASSERT(cache->size() > 0 && cache->size() <= firstCalls);
+  rv += SDK_ASSERT(!findSample(findRadial(los, 90.0), 6000.0)->visible_);
+
+  // Recomputing in place samples nothing, and a slight move reuses most samples
+  rv += SDK_ASSERT(los.compute(srs, elevation, origin(0.0)));
+  rv += SDK_ASSERT(elevation.takeCalls() == 0);
+  rv += SDK_ASSERT(los.compute(srs, elevation, origin(1.0)));
+  rv += SDK_ASSERT(elevation.takeCalls() < numSamples / 3);
+  rv += SDK_ASSERT(!findSample(findRadial(los, 90.0), 6000.0)->visible_);
+
+  // A second computation shares the cache
+  simVis::RadialLOS other;
+  configure(other);
+  other.setElevationCache(cache.get());
+  rv += SDK_ASSERT(other.compute(srs, elevation, origin(0.0)));
+  rv += SDK_ASSERT(elevation.takeCalls() == 0);
+
+  // Invalidating an extent discards only the cells inside it
+  const size_t before = cache->size();
+  const osgEarth::GeoExtent extent(srs, -0.001, 0.02, 0.001, 0.03);
+  cache->invalidate(extent);
+  rv += SDK_ASSERT(cache->size() < before);
+  rv += SDK_ASSERT(cache->size() > before / 2);
+  cache->clear();
+  rv += SDK_ASSERT(cache->size() == 0);
+  return rv;
+}
+
+int testUpdate(const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  SyntheticElevation elevation;
+  simVis::RadialLOS los;
+  configure(los);
+  rv += SDK_ASSERT(los.compute(srs, elevation, origin(0.0)));
+  const size_t numSamples = los.getRadials().size() * los.getNumSamplesPerRadial();
+  elevation.takeCalls();
+
+  // A tower rises 3 km north; only samples in its extent are re-sampled
+  const double west = -500.0 / METERS_PER_DEGREE;
+  const double south = 2950.0 / METERS_PER_DEGREE;
+  const double east = 500.0 / METERS_PER_DEGREE;
+  const double north = 3450.0 / METERS_PER_DEGREE;
+  elevation.setBlock(west, south, east, north, 1000.0);
+  rv += SDK_ASSERT(los.update(elevation, osgEarth::GeoExtent(srs, west, south, east, north)));
+  const unsigned int calls = elevation.takeCalls();
+  rv += SDK_ASSERT(calls > 0 && calls < numSamples / 10);
+  rv += SDK_ASSERT(!findSample(findRadial(los, 0.0), 6000.0)->visible_);
+  rv += SDK_ASSERT(findSample(findRadial(los, 180.0), 6000.0)->visible_);
+
+  // An extent away from every radial samples nothing
+  rv += SDK_ASSERT(los.update(elevation, osgEarth::GeoExtent(srs, 10.0, 10.0, 11.0, 11.0)));
+  rv += SDK_ASSERT(elevation.takeCalls() == 0);
+  return rv;
+}
+
+}
+
+int RadialLOSTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  // Check the SIMDIS SDK version
+  simCore::checkVersionThrow();
+
+  osg::ref_ptr<osgEarth::SpatialReference> srs = osgEarth::SpatialReference::create("wgs84");
+  rv += SDK_ASSERT(testCompute(srs.get()) == 0);
+  rv += SDK_ASSERT(testCache(srs.get()) == 0);
+  rv += SDK_ASSERT(testUpdate(srs.get()) == 0);
+
+  return rv;
+}
@@ -0,0 +1,134 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <iostream>
+#include "osg/ref_ptr"
+#include "simCore/Common/SDKAssert.h"
+#include "simData/MemoryDataStore.h"
+#include "simVis/Scenario.h"
+#include "simVis/SceneManager.h"
+
+namespace
+{
+
+/** Adds a platform with a single static point on the surface */
+simData::ObjectId addStaticPlatform(simData::DataStore& ds)
+{
+  simData::DataStore::Transaction t;
+  simData::PlatformProperties* props = ds.addPlatform(&t);
+  const simData::ObjectId id = props->id();
+  t.complete(&props);
+
+  simData::PlatformUpdate* update = ds.addPlatformUpdate(id, &t);
+  update->set_time(-1.0);
+  update->set_x(6378137.0);
+  update->set_y(0.0);
+  update->set_z(0.0);
+  t.complete(&update);
+  return id;
+}
+
+/** Changes whether the platform label is drawn, and toggles surface clamping so that the locator must be recomputed */
+void changePrefs(simData::DataStore& ds, simData::ObjectId id, bool drawLabel)
+{
+  simData::DataStore::Transaction t;
+  simData::PlatformPrefs* prefs = ds.mutable_platformPrefs(id, &t);
+  prefs->mutable_commonprefs()->set_draw(true);
+  prefs->mutable_commonprefs()->mutable_labelprefs()->set_draw(drawLabel);
+  prefs->set_surfaceclamping(!prefs->surfaceclamping());
+  t.complete(&prefs);
+}
+
+/** A static platform is visited only when something outside its update slice changes */
+int testStaticPlatform()
+{
+  int rv = 0;
+  simData::MemoryDataStore ds;
+  osg::ref_ptr<simVis::SceneManager> scene = new simVis::SceneManager;
+  simVis::ScenarioManager* scenario = scene->getScenario();
+  scenario->bind(&ds);
+
+  const simData::ObjectId id = addStaticPlatform(ds);
+  changePrefs(ds, id, false);
+  ds.update(1.0);
+  rv += SDK_ASSERT(scenario->find(id) != NULL);
+  ds.update(2.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 0);
+
+  // Prefs-only change on an unchanged slice must still be applied
+  changePrefs(ds, id, false);
+  ds.update(3.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 1);
+  ds.update(4.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 0);
+
+  // Displayed labels refresh when the entity changes, not on every update
+  changePrefs(ds, id, true);
+  ds.update(5.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 1);
+  ds.update(6.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 0);
+
+  // Generic data can change the label content, so a change visits the entity
+  {
+    simData::DataStore::Transaction t;
+    simData::GenericData* gd = ds.addGenericData(id, &t);
+    gd->set_time(6.5);
+    gd->set_duration(-1.0);
+    simData::GenericData_Entry* entry = gd->add_entry();
+    entry->set_key("key");
+    entry->set_value("value");
+    t.commit();
+  }
+  ds.update(6.5);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 1);
+  ds.update(6.75);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 0);
+
+  changePrefs(ds, id, false);
+  ds.update(7.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 1);
+  ds.update(8.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 0);
+
+  // Explicit requests, such as for category data changes, are visited on the next update
+  scenario->requestUpdate(id);
+  ds.update(9.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 1);
+  ds.update(10.0);
+  rv += SDK_ASSERT(scenario->lastUpdateVisitCount() == 0);
+
+  scenario->unbind(&ds, true);
+  return rv;
+}
+
+}
+
+int ScenarioTest(int argc, char* argv[])
+{
+  int rv = 0;
+
+  rv += SDK_ASSERT(testStaticPlatform() == 0);
+
+  std::cout << "simVis ScenarioTest " << ((rv == 0) ? "passed" : "failed") << std::endl;
+
+  return rv;
+}
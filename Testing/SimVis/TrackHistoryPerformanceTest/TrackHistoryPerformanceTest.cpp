@@ -0,0 +1,139 @@
+/* -*- mode: c++ -*- */
+/****************************************************************************
+ *****                                                                  *****
+ *****                   Classification: UNCLASSIFIED                   *****
+ *****                    Classified By:                                *****
+ *****                    Declassify On:                                *****
+ *****                                                                  *****
+ ****************************************************************************
+ *
+ *
+ * Developed by: Naval Research Laboratory, Tactical Electronic Warfare Div.
+ *               EW Modeling & Simulation, Code 5773
+ *               4555 Overlook Ave.
+ *               Washington, D.C. 20375-5339
+ *
+ * License for source code at https://simdis.nrl.navy.mil/License.aspx
+ *
+ * The U.S. Government retains all rights to use, duplicate, distribute,
+ * disclose, or release this software.
+ *
+ */
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "osgEarth/SpatialReference"
+#include "simCore/Calc/Vec3.h"
+#include "simCore/Common/SDKAssert.h"
+#include "simCore/Common/Version.h"
+#include "simCore/Time/Utils.h"
+#include "simVis/TrackChunkNode.h"
+#include "simVis/Utils.h"
+
+namespace
+{
+
+/// Number of track points to backfill on each pass
+static const unsigned int NUM_POINTS = 200000;
+/// Points per chunk, matching the default track history chunk size
+static const unsigned int CHUNK_SIZE = 64;
+
+/** Builds the track points of a synthetic platform flying along the equator */
+void makePoints(std::vector<simVis::TrackChunkNode::Point>& points)
+{
+  points.resize(NUM_POINTS);
+  for (unsigned int k = 0; k < NUM_POINTS; ++k)
+  {
+    simVis::TrackChunkNode::Point& point = points[k];
+    const double angle = k * 1e-6;
+    simVis::Math::ecefEulerToEnuRotMatrix(simCore::Vec3(0.1, 0.0, 0.0), point.matrix);
+    point.matrix.postMultTranslate(osg::Vec3d(6378137.0 * cos(angle), 6378137.0 * sin(angle), 0.0));
+    point.time = k;
+    point.color = osg::Vec4(1.f, 1.f, 0.f, 1.f);
+  }
+}
+
+/** Fills chunks one point at a time, the way track history used to backfill; returns the number of chunks */
+size_t fillByPoint(const std::vector<simVis::TrackChunkNode::Point>& points, const osgEarth::SpatialReference* srs, simData::TrackPrefs_Mode mode)
+{
+  std::vector<osg::ref_ptr<simVis::TrackChunkNode> > chunks;
+  const osg::Vec2 hostBounds(-1.f, 1.f);
+  for (std::vector<simVis::TrackChunkNode::Point>::const_iterator i = points.begin(); i != points.end(); ++i)
+  {
+    if (chunks.empty() || chunks.back()->isFull())
+      chunks.push_back(new simVis::TrackChunkNode(CHUNK_SIZE, srs, mode));
+    chunks.back()->addPoint(i->matrix, i->time, i->color, hostBounds);
+  }
+  return chunks.size();
+}
+
+/** Fills chunks by range; returns the number of chunks */
+size_t fillByRange(const std::vector<simVis::TrackChunkNode::Point>& points, const osgEarth::SpatialReference* srs, simData::TrackPrefs_Mode mode)
+{
+  std::vector<osg::ref_ptr<simVis::TrackChunkNode> > chunks;
+  const osg::Vec2 hostBounds(-1.f, 1.f);
+  size_t next = 0;
+  while (next < points.size())
+  {
+    chunks.push_back(new simVis::TrackChunkNode(CHUNK_SIZE, srs, mode));
+    next += chunks.back()->addPoints(&points[next], static_cast<unsigned int>(points.size() - next), hostBounds);
+  }
+  return chunks.size();
+}
+
+/** Times point-by-point and range fills for the given draw mode */
+int testBackfill(const std::vector<simVis::TrackChunkNode::Point>& points, const osgEarth::SpatialReference* srs, simData::TrackPrefs_Mode mode, const std::string& modeName)
+{
+  int rv = 0;
+  const double pointStart = simCore::getSystemTime();
+  const size_t pointChunks = fillByPoint(points, srs, mode);
+  const double pointElapsed = simCore::getSystemTime() - pointStart;
+
+  const double rangeStart = simCore::getSystemTime();
+  const size_t rangeChunks = fillByRange(points, srs, mode);
+  const double rangeElapsed = simCore::getSystemTime() - rangeStart;
+
+  rv += SDK_ASSERT(pointChunks == rangeChunks);
+  std::cout << "Backfill " << points.size() << " " << modeName << " points: by point " << pointElapsed << "s, by range " << rangeElapsed << "s" << std::endl;
+  return rv;
+}
+
+/** Times trimming a full chunk from the front by time */
+int testTrim(const std::vector<simVis::TrackChunkNode::Point>& points, const osgEarth::SpatialReference* srs)
+{
+  int rv = 0;
+  const osg::Vec2 hostBounds(-1.f, 1.f);
+  osg::ref_ptr<simVis::TrackChunkNode> chunk = new simVis::TrackChunkNode(NUM_POINTS, srs, simData::TrackPrefs_Mode_LINE);
+  rv += SDK_ASSERT(chunk->addPoints(&points[0], static_cast<unsigned int>(points.size()), hostBounds) == points.size());
+
+  const double start = simCore::getSystemTime();
+  unsigned int removed = 0;
+  for (unsigned int k = 1; k <= NUM_POINTS; k += 7)
+    removed += chunk->removePointsBefore(k);
+  const double elapsed = simCore::getSystemTime() - start;
+
+  rv += SDK_ASSERT(chunk->size() + removed == points.size());
+  std::cout << "Trim " << points.size() << " points by time: " << elapsed << "s" << std::endl;
+  return rv;
+}
+
+}
+
+int main(int argc, char *argv[])
+{
+  simCore::checkVersionThrow();
+
+  osg::ref_ptr<const osgEarth::SpatialReference> srs = osgEarth::SpatialReference::create("wgs84");
+  std::vector<simVis::TrackChunkNode::Point> points;
+  const double convertStart = simCore::getSystemTime();
+  makePoints(points);
+  std::cout << "Convert " << points.size() << " updates to matrices: " << (simCore::getSystemTime() - convertStart) << "s" << std::endl;
+
+  int rv = 0;
+  rv += SDK_ASSERT(testBackfill(points, srs.get(), simData::TrackPrefs_Mode_POINT, "point") == 0);
+  rv += SDK_ASSERT(testBackfill(points, srs.get(), simData::TrackPrefs_Mode_LINE, "line") == 0);
+  rv += SDK_ASSERT(testBackfill(points, srs.get(), simData::TrackPrefs_Mode_RIBBON, "ribbon") == 0);
+  rv += SDK_ASSERT(testTrim(points, srs.get()) == 0);
+  return rv;
+}